@@ -2,7 +2,9 @@
 #define BENCHMARK_H
 
 #include <chrono>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,11 +25,40 @@ struct BenchmarkResult {
     std::string error_message;
 };
 
+// One point on a latency-vs-offered-load curve from an open-loop run
+struct LoadStepResult {
+    double offered_rate { 0.0 };
+    double achieved_rate { 0.0 };
+    uint64_t sent { 0 };
+    uint64_t completed { 0 };
+    double avg_us { 0.0 };
+    double min_us { 0.0 };
+    double p50_us { 0.0 };
+    double p90_us { 0.0 };
+    double p99_us { 0.0 };
+    double p999_us { 0.0 };
+    double max_us { 0.0 };
+};
+
+// Open-loop workload whose offered rate is chosen by the harness
+class RateControlledWorkload {
+public:
+    virtual ~RateControlledWorkload() = default;
+    virtual std::string getName() const = 0;
+    virtual std::string getRateUnit() const = 0;
+    virtual void setUp() { }
+    virtual void tearDown() { }
+    // rate <= 0 runs closed-loop to estimate capacity
+    virtual LoadStepResult runAtRate(double rate, int duration_seconds) = 0;
+};
+
 class Benchmark {
 public:
     virtual ~Benchmark() = default;
     virtual BenchmarkResult run(int duration_seconds, int iterations, bool verbose) = 0;
     virtual std::string getName() const = 0;
+    // Modules that can be driven at a fixed offered rate return a workload for SLO search
+    virtual std::unique_ptr<RateControlledWorkload> createRateControlledWorkload() { return nullptr; }
 };
 
 #endif
\ No newline at end of file
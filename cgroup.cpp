@@ -0,0 +1,224 @@
+#include "cgroup.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::string readFirstLine(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// memory.max and friends hold a byte count or "max"
+uint64_t readByteLimit(const std::string& path)
+{
+    std::string value = readFirstLine(path);
+    if (value.empty() || value == "max") {
+        return 0;
+    }
+    try {
+        return std::stoull(value);
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+std::string formatMegabytes(uint64_t bytes)
+{
+    std::ostringstream out;
+    out << bytes / (1024 * 1024) << " MB";
+    return out.str();
+}
+
+}
+
+std::string CgroupLimits::describeCpuLimit() const
+{
+    if (cpu_quota_cores <= 0.0) {
+        return "unlimited";
+    }
+    std::ostringstream out;
+    out << cpu_quota_cores << " cores (" << cpu_quota_us << "/" << cpu_period_us << " us)";
+    return out.str();
+}
+
+std::string CgroupLimits::describeMemoryLimit() const
+{
+    if (memory_max_bytes == 0 && memory_high_bytes == 0) {
+        return "unlimited";
+    }
+    std::string description = memory_max_bytes > 0 ? "max " + formatMegabytes(memory_max_bytes) : "";
+    if (memory_high_bytes > 0) {
+        description += (description.empty() ? "" : ", ") + std::string("high ") + formatMegabytes(memory_high_bytes);
+    }
+    return description;
+}
+
+namespace Cgroup {
+
+std::string findV2Directory()
+{
+    std::ifstream cgroup_file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(cgroup_file, line)) {
+        if (line.compare(0, 3, "0::") != 0) {
+            continue;
+        }
+        std::string path = line.substr(3);
+        for (const char* mount : { "/sys/fs/cgroup", "/sys/fs/cgroup/unified" }) {
+            std::string directory = std::string(mount) + (path == "/" ? "" : path);
+            std::ifstream controllers(directory + "/cgroup.controllers");
+            if (controllers.is_open()) {
+                return directory;
+            }
+        }
+    }
+    return "";
+}
+
+std::vector<int> parseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        try {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+CgroupLimits readLimits()
+{
+    CgroupLimits limits;
+#ifdef __linux__
+    limits.directory = findV2Directory();
+    if (limits.directory.empty()) {
+        return limits;
+    }
+    limits.available = true;
+    limits.effective_cpus = parseCpuList(readFirstLine(limits.directory + "/cpuset.cpus.effective"));
+    limits.memory_current_bytes = readByteLimit(limits.directory + "/memory.current");
+
+    // A parent's cpu.max or memory.max binds its children too, so walk up to
+    // the mount root (which has no limit files) and keep the tightest
+    bool memory_limited = false;
+    std::string root = limits.directory.compare(0, 22, "/sys/fs/cgroup/unified") == 0 ? "/sys/fs/cgroup/unified" : "/sys/fs/cgroup";
+    for (std::string level = limits.directory; level.size() > root.size(); level.resize(level.rfind('/'))) {
+        // cpu.max: "<quota|max> <period>"
+        std::istringstream cpu_max(readFirstLine(level + "/cpu.max"));
+        std::string quota;
+        uint64_t period = 0;
+        if (cpu_max >> quota >> period && quota != "max" && period > 0) {
+            try {
+                uint64_t quota_us = std::stoull(quota);
+                double cores = static_cast<double>(quota_us) / period;
+                if (limits.cpu_quota_cores <= 0.0 || cores < limits.cpu_quota_cores) {
+                    limits.cpu_quota_us = quota_us;
+                    limits.cpu_period_us = period;
+                    limits.cpu_quota_cores = cores;
+                }
+            } catch (const std::exception&) {
+            }
+        }
+
+        uint64_t memory_max = readByteLimit(level + "/memory.max");
+        uint64_t memory_high = readByteLimit(level + "/memory.high");
+        if (memory_max > 0 && (limits.memory_max_bytes == 0 || memory_max < limits.memory_max_bytes)) {
+            limits.memory_max_bytes = memory_max;
+        }
+        if (memory_high > 0 && (limits.memory_high_bytes == 0 || memory_high < limits.memory_high_bytes)) {
+            limits.memory_high_bytes = memory_high;
+        }
+
+        uint64_t level_limit = memory_max;
+        if (memory_high > 0) {
+            level_limit = level_limit > 0 ? std::min(level_limit, memory_high) : memory_high;
+        }
+        if (level_limit > 0) {
+            uint64_t current = readByteLimit(level + "/memory.current");
+            uint64_t headroom = level_limit > current ? level_limit - current : 0;
+            if (!memory_limited || headroom < limits.memory_headroom_bytes) {
+                limits.memory_headroom_bytes = headroom;
+                memory_limited = true;
+            }
+        }
+    }
+#endif
+    return limits;
+}
+
+CgroupCpuStat readCpuStat()
+{
+    CgroupCpuStat stat;
+#ifdef __linux__
+    std::string directory = findV2Directory();
+    if (directory.empty()) {
+        return stat;
+    }
+    std::ifstream file(directory + "/cpu.stat");
+    std::string key;
+    uint64_t value = 0;
+    while (file >> key >> value) {
+        stat.valid = true;
+        if (key == "usage_usec") {
+            stat.usage_usec = value;
+        } else if (key == "nr_periods") {
+            stat.nr_periods = value;
+        } else if (key == "nr_throttled") {
+            stat.nr_throttled = value;
+        } else if (key == "throttled_usec") {
+            stat.throttled_usec = value;
+        }
+    }
+#endif
+    return stat;
+}
+
+int effectiveCpuCount()
+{
+    int cpus = static_cast<int>(CPUAffinity::getCurrentAffinity().size());
+    if (cpus <= 0) {
+        cpus = CPUAffinity::getNumCores();
+    }
+
+    CgroupLimits limits = readLimits();
+    if (!limits.effective_cpus.empty()) {
+        cpus = std::min(cpus, static_cast<int>(limits.effective_cpus.size()));
+    }
+    // More runnable threads than the quota only buys throttling
+    if (limits.cpu_quota_cores > 0.0) {
+        cpus = std::min(cpus, static_cast<int>(std::ceil(limits.cpu_quota_cores)));
+    }
+    return std::max(1, cpus);
+}
+
+size_t fitWorkingSet(size_t desired_bytes, size_t minimum_bytes)
+{
+    CgroupLimits limits = readLimits();
+    if (limits.memory_max_bytes == 0 && limits.memory_high_bytes == 0) {
+        return desired_bytes;
+    }
+
+    size_t budget = static_cast<size_t>(limits.memory_headroom_bytes / 2);
+    return std::max(std::min(desired_bytes, budget), std::min(desired_bytes, minimum_bytes));
+}
+
+}
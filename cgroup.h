@@ -0,0 +1,55 @@
+#ifndef CGROUP_H
+#define CGROUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Effective resource limits of this process's cgroup v2: the tightest of the
+// leaf and every ancestor below the mount root. Zero means the limit is
+// absent (unlimited) or could not be read.
+struct CgroupLimits {
+    bool available { false };
+    std::string directory;
+    double cpu_quota_cores { 0.0 }; // cpu.max quota / period
+    uint64_t cpu_quota_us { 0 };
+    uint64_t cpu_period_us { 0 };
+    std::vector<int> effective_cpus; // cpuset.cpus.effective
+    uint64_t memory_max_bytes { 0 }; // memory.max
+    uint64_t memory_high_bytes { 0 }; // memory.high
+    uint64_t memory_current_bytes { 0 }; // the leaf's own usage
+    uint64_t memory_headroom_bytes { 0 }; // least (limit - usage) of any limited level
+
+    std::string describeCpuLimit() const;
+    std::string describeMemoryLimit() const;
+};
+
+// Cumulative CPU accounting from cpu.stat
+struct CgroupCpuStat {
+    bool valid { false };
+    uint64_t usage_usec { 0 };
+    uint64_t nr_periods { 0 };
+    uint64_t nr_throttled { 0 };
+    uint64_t throttled_usec { 0 };
+};
+
+namespace Cgroup {
+    // Directory of this process's cgroup on a unified or hybrid hierarchy, or "" without cgroup v2
+    std::string findV2Directory();
+
+    CgroupLimits readLimits();
+    CgroupCpuStat readCpuStat();
+
+    // Parses kernel CPU lists such as "0-3,8,10-11"
+    std::vector<int> parseCpuList(const std::string& list);
+
+    // CPUs the benchmarks can actually use: the affinity mask narrowed by the
+    // cpuset and by the CPU quota (rounded up), at least 1
+    int effectiveCpuCount();
+
+    // Shrinks a working set so it fits in half of the memory the cgroup has left
+    size_t fitWorkingSet(size_t desired_bytes, size_t minimum_bytes = 16 * 1024 * 1024);
+}
+
+#endif
@@ -0,0 +1,634 @@
+#include "colscan_bench.h"
+#include "cgroup.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COLSCAN_HAS_X86 1
+#endif
+
+namespace {
+
+constexpr size_t MORSEL_ROWS = 64 * 1024;
+constexpr size_t COLUMN_ALIGNMENT = 4096;
+constexpr size_t DICTIONARY_ENTRY_SIZE = 16;
+constexpr size_t WRITE_CHUNK_ROWS = 1024 * 1024;
+constexpr int WARM_RUNS = 3;
+constexpr int COLUMN_COUNT = 4;
+constexpr size_t REGION_COUNT = 16;
+const char FILE_MAGIC[8] = { 'C', 'O', 'L', 'S', 'C', 'A', 'N', '1' };
+const char* const REGION_NAMES[REGION_COUNT] = { "AFRICA", "AMERICA", "ASIA", "EUROPE", "MIDDLE EAST", "OCEANIA",
+    "ARCTIC", "ANTARCTICA", "CARIBBEAN", "BALTIC", "NORDIC", "IBERIA", "LEVANT", "PACIFIC", "ANDES", "SAHEL" };
+
+enum ColumnType : uint32_t {
+    COLUMN_INT32 = 1,
+    COLUMN_FLOAT32 = 2,
+    COLUMN_STRING = 3
+};
+
+enum ColumnEncoding : uint32_t {
+    ENCODING_PLAIN = 1,
+    ENCODING_DICTIONARY = 2, // fixed-width dictionary then one uint8 code per row
+    ENCODING_RLE = 3 // (int32 value, uint32 run length) pairs
+};
+
+struct ColumnDescriptor {
+    char name[16];
+    uint32_t type;
+    uint32_t encoding;
+    uint64_t offset;
+    uint64_t length;
+    uint64_t entries; // dictionary entries or RLE runs
+};
+
+struct FileHeader {
+    char magic[8];
+    uint64_t rows;
+    uint32_t columns;
+    uint32_t reserved;
+    ColumnDescriptor descriptors[COLUMN_COUNT];
+};
+
+struct RleRun {
+    int32_t value;
+    uint32_t length;
+};
+
+// Read-only view of a mapped columnar file
+struct ColumnarTable {
+    uint64_t rows { 0 };
+    const int32_t* quantity { nullptr };
+    const float* price { nullptr };
+    const uint8_t* region_codes { nullptr };
+    std::vector<std::string> region_dictionary;
+    const RleRun* status_runs { nullptr };
+    size_t status_run_count { 0 };
+    std::vector<uint64_t> status_run_starts; // first row of each run, for morsel lookup
+};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t nextRandom(uint64_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+void writeAt(int fd, const void* data, size_t length, uint64_t offset)
+{
+    const char* bytes = static_cast<const char*>(data);
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = pwrite(fd, bytes + done, length - done, static_cast<off_t>(offset + done));
+        if (n <= 0) {
+            throw std::runtime_error("Failed to write columnar file");
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+// Writes the four columns; returns the file size
+uint64_t writeColumnarFile(int fd, uint64_t rows)
+{
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.rows = rows;
+    header.columns = COLUMN_COUNT;
+
+    const char* names[COLUMN_COUNT] = { "quantity", "price", "region", "status" };
+    const uint32_t types[COLUMN_COUNT] = { COLUMN_INT32, COLUMN_FLOAT32, COLUMN_STRING, COLUMN_INT32 };
+    const uint32_t encodings[COLUMN_COUNT] = { ENCODING_PLAIN, ENCODING_PLAIN, ENCODING_DICTIONARY, ENCODING_RLE };
+    for (int c = 0; c < COLUMN_COUNT; ++c) {
+        strncpy(header.descriptors[c].name, names[c], sizeof(header.descriptors[c].name) - 1);
+        header.descriptors[c].type = types[c];
+        header.descriptors[c].encoding = encodings[c];
+    }
+
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    uint64_t offset = alignUp(sizeof(FileHeader), COLUMN_ALIGNMENT);
+
+    // quantity: uniform 1..50
+    header.descriptors[0].offset = offset;
+    header.descriptors[0].length = rows * sizeof(int32_t);
+    std::vector<int32_t> ints(WRITE_CHUNK_ROWS);
+    for (uint64_t row = 0; row < rows; row += WRITE_CHUNK_ROWS) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(WRITE_CHUNK_ROWS, rows - row));
+        for (size_t i = 0; i < count; ++i) {
+            ints[i] = 1 + static_cast<int32_t>(nextRandom(rng) % 50);
+        }
+        writeAt(fd, ints.data(), count * sizeof(int32_t), offset + row * sizeof(int32_t));
+    }
+    offset = alignUp(offset + header.descriptors[0].length, COLUMN_ALIGNMENT);
+
+    // price: 1.00..1000.99
+    header.descriptors[1].offset = offset;
+    header.descriptors[1].length = rows * sizeof(float);
+    std::vector<float> floats(WRITE_CHUNK_ROWS);
+    for (uint64_t row = 0; row < rows; row += WRITE_CHUNK_ROWS) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(WRITE_CHUNK_ROWS, rows - row));
+        for (size_t i = 0; i < count; ++i) {
+            floats[i] = 1.0f + static_cast<float>(nextRandom(rng) % 100000) / 100.0f;
+        }
+        writeAt(fd, floats.data(), count * sizeof(float), offset + row * sizeof(float));
+    }
+    offset = alignUp(offset + header.descriptors[1].length, COLUMN_ALIGNMENT);
+
+    // region: dictionary-encoded, skewed towards low codes
+    std::vector<char> dictionary(REGION_COUNT * DICTIONARY_ENTRY_SIZE, 0);
+    for (size_t i = 0; i < REGION_COUNT; ++i) {
+        strncpy(&dictionary[i * DICTIONARY_ENTRY_SIZE], REGION_NAMES[i], DICTIONARY_ENTRY_SIZE - 1);
+    }
+    uint64_t codes_offset = alignUp(offset + dictionary.size(), 64);
+    header.descriptors[2].offset = offset;
+    header.descriptors[2].length = codes_offset - offset + rows;
+    header.descriptors[2].entries = REGION_COUNT;
+    writeAt(fd, dictionary.data(), dictionary.size(), offset);
+    std::vector<uint8_t> codes(WRITE_CHUNK_ROWS);
+    for (uint64_t row = 0; row < rows; row += WRITE_CHUNK_ROWS) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(WRITE_CHUNK_ROWS, rows - row));
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t r = nextRandom(rng);
+            codes[i] = static_cast<uint8_t>((r & 1) ? (r >> 8) % 4 : (r >> 8) % REGION_COUNT);
+        }
+        writeAt(fd, codes.data(), count, codes_offset + row);
+    }
+    offset = alignUp(offset + header.descriptors[2].length, COLUMN_ALIGNMENT);
+
+    // status: long runs of order states, RLE-encoded
+    std::vector<RleRun> runs;
+    for (uint64_t row = 0; row < rows;) {
+        uint32_t length = static_cast<uint32_t>(std::min<uint64_t>(1 + nextRandom(rng) % 8192, rows - row));
+        runs.push_back(RleRun { static_cast<int32_t>(nextRandom(rng) % 5), length });
+        row += length;
+    }
+    header.descriptors[3].offset = offset;
+    header.descriptors[3].length = runs.size() * sizeof(RleRun);
+    header.descriptors[3].entries = runs.size();
+    writeAt(fd, runs.data(), header.descriptors[3].length, offset);
+    offset = alignUp(offset + header.descriptors[3].length, COLUMN_ALIGNMENT);
+
+    writeAt(fd, &header, sizeof(header), 0);
+    if (ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+        throw std::runtime_error("Failed to size columnar file");
+    }
+    return offset;
+}
+
+ColumnarTable openTable(const char* base, uint64_t file_size)
+{
+    if (file_size < sizeof(FileHeader)) {
+        throw std::runtime_error("Columnar file is truncated");
+    }
+    FileHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.columns != COLUMN_COUNT) {
+        throw std::runtime_error("Columnar file has an unexpected layout");
+    }
+    for (const auto& descriptor : header.descriptors) {
+        if (descriptor.offset + descriptor.length > file_size) {
+            throw std::runtime_error("Columnar file column extends past end of file");
+        }
+    }
+
+    ColumnarTable table;
+    table.rows = header.rows;
+    table.quantity = reinterpret_cast<const int32_t*>(base + header.descriptors[0].offset);
+    table.price = reinterpret_cast<const float*>(base + header.descriptors[1].offset);
+
+    const ColumnDescriptor& region = header.descriptors[2];
+    for (uint64_t i = 0; i < region.entries; ++i) {
+        table.region_dictionary.emplace_back(base + region.offset + i * DICTIONARY_ENTRY_SIZE);
+    }
+    table.region_codes = reinterpret_cast<const uint8_t*>(base + alignUp(region.offset + region.entries * DICTIONARY_ENTRY_SIZE, 64));
+
+    const ColumnDescriptor& status = header.descriptors[3];
+    table.status_runs = reinterpret_cast<const RleRun*>(base + status.offset);
+    table.status_run_count = static_cast<size_t>(status.entries);
+    uint64_t start = 0;
+    for (size_t i = 0; i < table.status_run_count; ++i) {
+        table.status_run_starts.push_back(start);
+        start += table.status_runs[i].length;
+    }
+    return table;
+}
+
+// Q1: SUM(price * quantity), COUNT(*) WHERE quantity < 24 AND price BETWEEN 100 AND 500
+struct Q1Result {
+    double revenue { 0.0 };
+    uint64_t count { 0 };
+};
+constexpr int32_t Q1_MAX_QUANTITY = 24;
+constexpr float Q1_PRICE_LOW = 100.0f;
+constexpr float Q1_PRICE_HIGH = 500.0f;
+
+void q1Scalar(const ColumnarTable& table, size_t begin, size_t end, Q1Result& out)
+{
+    for (size_t i = begin; i < end; ++i) {
+        int32_t q = table.quantity[i];
+        float p = table.price[i];
+        if (q < Q1_MAX_QUANTITY && p >= Q1_PRICE_LOW && p <= Q1_PRICE_HIGH) {
+            out.revenue += p * static_cast<float>(q);
+            ++out.count;
+        }
+    }
+}
+
+// Q2: COUNT(*), SUM(price) GROUP BY region WHERE region IN (selected dictionary entries)
+struct Q2Result {
+    uint64_t counts[REGION_COUNT] = {};
+    double sums[REGION_COUNT] = {};
+};
+
+void q2Scalar(const ColumnarTable& table, size_t begin, size_t end, const uint8_t* selected, Q2Result& out)
+{
+    for (size_t i = begin; i < end; ++i) {
+        uint8_t code = table.region_codes[i];
+        if (selected[code]) {
+            ++out.counts[code];
+            out.sums[code] += table.price[i];
+        }
+    }
+}
+
+// Q3: SUM(quantity) WHERE status = 2, evaluated run-by-run on the RLE column
+constexpr int32_t Q3_STATUS = 2;
+struct Q3Result {
+    int64_t quantity { 0 };
+    uint64_t count { 0 };
+};
+
+int64_t sumRangeScalar(const int32_t* values, size_t begin, size_t end)
+{
+    int64_t sum = 0;
+    for (size_t i = begin; i < end; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+#ifdef COLSCAN_HAS_X86
+__attribute__((target("avx2"))) void q1Avx2(const ColumnarTable& table, size_t begin, size_t end, Q1Result& out)
+{
+    const __m256i max_quantity = _mm256_set1_epi32(Q1_MAX_QUANTITY);
+    const __m256 low = _mm256_set1_ps(Q1_PRICE_LOW);
+    const __m256 high = _mm256_set1_ps(Q1_PRICE_HIGH);
+    __m256d sum_low = _mm256_setzero_pd();
+    __m256d sum_high = _mm256_setzero_pd();
+    __m256i counts = _mm256_setzero_si256();
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(table.quantity + i));
+        __m256 p = _mm256_loadu_ps(table.price + i);
+        __m256 mask = _mm256_and_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(max_quantity, q)),
+            _mm256_and_ps(_mm256_cmp_ps(p, low, _CMP_GE_OQ), _mm256_cmp_ps(p, high, _CMP_LE_OQ)));
+        __m256 revenue = _mm256_and_ps(_mm256_mul_ps(p, _mm256_cvtepi32_ps(q)), mask);
+        sum_low = _mm256_add_pd(sum_low, _mm256_cvtps_pd(_mm256_castps256_ps128(revenue)));
+        sum_high = _mm256_add_pd(sum_high, _mm256_cvtps_pd(_mm256_extractf128_ps(revenue, 1)));
+        counts = _mm256_sub_epi32(counts, _mm256_castps_si256(mask)); // true lanes are -1
+    }
+
+    alignas(32) double sums[4];
+    _mm256_store_pd(sums, _mm256_add_pd(sum_low, sum_high));
+    alignas(32) int32_t lane_counts[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_counts), counts);
+    out.revenue += sums[0] + sums[1] + sums[2] + sums[3];
+    for (int32_t c : lane_counts) {
+        out.count += static_cast<uint64_t>(c);
+    }
+    q1Scalar(table, i, end, out);
+}
+
+// Codes are below 16, so one byte shuffle maps each code to its selection flag
+__attribute__((target("avx2"))) void q2Avx2(const ColumnarTable& table, size_t begin, size_t end,
+    const uint8_t* selected, Q2Result& out)
+{
+    const __m256i lookup = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(selected)));
+    size_t i = begin;
+    for (; i + 32 <= end; i += 32) {
+        __m256i codes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(table.region_codes + i));
+        uint32_t matches = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_shuffle_epi8(lookup, codes)));
+        while (matches) {
+            size_t row = i + static_cast<size_t>(__builtin_ctz(matches));
+            uint8_t code = table.region_codes[row];
+            ++out.counts[code];
+            out.sums[code] += table.price[row];
+            matches &= matches - 1;
+        }
+    }
+    q2Scalar(table, i, end, selected, out);
+}
+
+__attribute__((target("avx2"))) int64_t sumRangeAvx2(const int32_t* values, size_t begin, size_t end)
+{
+    __m256i sum_low = _mm256_setzero_si256();
+    __m256i sum_high = _mm256_setzero_si256();
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        sum_low = _mm256_add_epi64(sum_low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        sum_high = _mm256_add_epi64(sum_high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(sum_low, sum_high));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumRangeScalar(values, i, end);
+}
+#endif
+
+void q1Morsel(const ColumnarTable& table, size_t begin, size_t end, bool simd, Q1Result& out)
+{
+#ifdef COLSCAN_HAS_X86
+    if (simd) {
+        q1Avx2(table, begin, end, out);
+        return;
+    }
+#endif
+    (void)simd;
+    q1Scalar(table, begin, end, out);
+}
+
+void q2Morsel(const ColumnarTable& table, size_t begin, size_t end, const uint8_t* selected, bool simd, Q2Result& out)
+{
+#ifdef COLSCAN_HAS_X86
+    if (simd) {
+        q2Avx2(table, begin, end, selected, out);
+        return;
+    }
+#endif
+    (void)simd;
+    q2Scalar(table, begin, end, selected, out);
+}
+
+void q3Morsel(const ColumnarTable& table, size_t begin, size_t end, bool simd, Q3Result& out)
+{
+    // Find the run containing the first row, then walk runs until the morsel ends
+    size_t run = static_cast<size_t>(std::upper_bound(table.status_run_starts.begin(), table.status_run_starts.end(), begin) -
+        table.status_run_starts.begin()) - 1;
+    for (; run < table.status_run_count && table.status_run_starts[run] < end; ++run) {
+        if (table.status_runs[run].value != Q3_STATUS) {
+            continue;
+        }
+        size_t first = std::max<size_t>(begin, table.status_run_starts[run]);
+        size_t last = std::min<size_t>(end, table.status_run_starts[run] + table.status_runs[run].length);
+#ifdef COLSCAN_HAS_X86
+        out.quantity += simd ? sumRangeAvx2(table.quantity, first, last) : sumRangeScalar(table.quantity, first, last);
+#else
+        (void)simd;
+        out.quantity += sumRangeScalar(table.quantity, first, last);
+#endif
+        out.count += last - first;
+    }
+}
+
+struct QueryRun {
+    double seconds { 0.0 };
+    uint64_t bytes_scanned { 0 };
+    double checksum { 0.0 };
+};
+
+// Runs one query over all morsels with per-thread partial aggregates
+QueryRun runQuery(const ColumnarTable& table, int query, int threads, bool simd)
+{
+    size_t morsels = static_cast<size_t>((table.rows + MORSEL_ROWS - 1) / MORSEL_ROWS);
+    std::atomic<size_t> next_morsel(0);
+    std::vector<Q1Result> q1(threads);
+    std::vector<Q2Result> q2(threads);
+    std::vector<Q3Result> q3(threads);
+
+    uint8_t selected[REGION_COUNT] = {};
+    for (size_t code = 0; code < table.region_dictionary.size() && code < REGION_COUNT; ++code) {
+        // Predicate is evaluated once on the dictionary, not per row
+        const std::string& name = table.region_dictionary[code];
+        selected[code] = (name == "ASIA" || name == "EUROPE" || name == "AMERICA" || name == "NORDIC") ? 0xFF : 0;
+    }
+
+    auto worker = [&](int index) {
+        while (true) {
+            size_t morsel = next_morsel.fetch_add(1, std::memory_order_relaxed);
+            if (morsel >= morsels) {
+                break;
+            }
+            size_t begin = morsel * MORSEL_ROWS;
+            size_t end = static_cast<size_t>(std::min<uint64_t>(table.rows, begin + MORSEL_ROWS));
+            if (query == 1) {
+                q1Morsel(table, begin, end, simd, q1[index]);
+            } else if (query == 2) {
+                q2Morsel(table, begin, end, selected, simd, q2[index]);
+            } else {
+                q3Morsel(table, begin, end, simd, q3[index]);
+            }
+        }
+    };
+
+    Timer timer;
+    timer.start();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    QueryRun run;
+    run.seconds = timer.elapsedSeconds();
+    if (query == 1) {
+        Q1Result total;
+        for (const auto& partial : q1) {
+            total.revenue += partial.revenue;
+            total.count += partial.count;
+        }
+        run.checksum = total.revenue + static_cast<double>(total.count);
+        run.bytes_scanned = table.rows * (sizeof(int32_t) + sizeof(float));
+    } else if (query == 2) {
+        uint64_t matched = 0;
+        for (const auto& partial : q2) {
+            for (size_t g = 0; g < REGION_COUNT; ++g) {
+                run.checksum += partial.sums[g] + static_cast<double>(partial.counts[g]);
+                matched += partial.counts[g];
+            }
+        }
+        run.bytes_scanned = table.rows * sizeof(uint8_t) + matched * sizeof(float);
+    } else {
+        Q3Result total;
+        for (const auto& partial : q3) {
+            total.quantity += partial.quantity;
+            total.count += partial.count;
+        }
+        run.checksum = static_cast<double>(total.quantity) + static_cast<double>(total.count);
+        run.bytes_scanned = total.count * sizeof(int32_t) + table.status_run_count * sizeof(RleRun);
+    }
+    return run;
+}
+
+class MappedFile {
+private:
+    int fd;
+    uint64_t size;
+    char* base { nullptr };
+
+public:
+    MappedFile(int fd, uint64_t size)
+        : fd(fd)
+        , size(size)
+    {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Failed to map columnar file");
+        }
+        base = static_cast<char*>(mapping);
+        madvise(base, size, MADV_SEQUENTIAL);
+    }
+
+    ~MappedFile() { munmap(base, size); }
+
+    const char* data() const { return base; }
+    int descriptor() const { return fd; }
+};
+
+}
+
+ColumnarScanBenchmark::ColumnarScanBenchmark()
+    : ColumnarScanBenchmark(ColScanBenchmarkConfig())
+{
+}
+
+ColumnarScanBenchmark::ColumnarScanBenchmark(const ColScanBenchmarkConfig& config)
+    : config(config)
+{
+}
+
+BenchmarkResult ColumnarScanBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)duration_seconds;
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    std::string path = config.directory + "/colscan_" + std::to_string(getpid()) + ".col";
+    int fd = -1;
+
+    try {
+        uint64_t rows = std::max<size_t>(MORSEL_ROWS, config.rows);
+        int threads = config.threads > 0 ? config.threads : Cgroup::effectiveCpuCount();
+        bool simd = CpuFeatures::host().avx2;
+
+        fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create columnar file in " + config.directory);
+        }
+        if (verbose) {
+            std::cout << "  Writing " << rows << " rows...\n";
+        }
+        Timer write_timer;
+        write_timer.start();
+        uint64_t file_size = writeColumnarFile(fd, rows);
+        fdatasync(fd);
+        double write_seconds = write_timer.elapsedSeconds();
+
+        const char* query_names[] = { "q1_filter_sum", "q2_dict_groupby", "q3_rle_sum" };
+        double warm_seconds_total = 0.0;
+        double cold_seconds_total = 0.0;
+        uint64_t warm_bytes_total = 0;
+        double scalar_seconds_total = 0.0;
+
+        for (int query = 1; query <= 3; ++query) {
+            std::string prefix = std::string("colscan_") + query_names[query - 1] + "_";
+
+            // Cold: drop the file from the page cache and map it afresh
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            QueryRun cold;
+            std::vector<QueryRun> warm;
+            QueryRun scalar;
+            {
+                MappedFile mapping(fd, file_size);
+                ColumnarTable table = openTable(mapping.data(), file_size);
+                cold = runQuery(table, query, threads, simd);
+                for (int i = 0; i < WARM_RUNS; ++i) {
+                    warm.push_back(runQuery(table, query, threads, simd));
+                }
+                scalar = simd ? runQuery(table, query, threads, false) : warm.front();
+            }
+
+            std::sort(warm.begin(), warm.end(), [](const QueryRun& a, const QueryRun& b) { return a.seconds < b.seconds; });
+            const QueryRun& median = warm[warm.size() / 2];
+            if (std::fabs(scalar.checksum - median.checksum) > 1e-6 * std::max(1.0, std::fabs(scalar.checksum))) {
+                throw std::runtime_error(std::string("Columnar scan ") + query_names[query - 1] +
+                    " failed verification against the scalar pass");
+            }
+
+            double gb = median.bytes_scanned / (1024.0 * 1024.0 * 1024.0);
+            result.extra_metrics[prefix + "cold_seconds"] = cold.seconds;
+            result.extra_metrics[prefix + "cold_rows_sec"] = cold.seconds > 0.0 ? rows / cold.seconds : 0.0;
+            result.extra_metrics[prefix + "cold_gbps"] = cold.seconds > 0.0 ? gb / cold.seconds : 0.0;
+            result.extra_metrics[prefix + "warm_seconds"] = median.seconds;
+            result.extra_metrics[prefix + "warm_rows_sec"] = median.seconds > 0.0 ? rows / median.seconds : 0.0;
+            result.extra_metrics[prefix + "warm_gbps"] = median.seconds > 0.0 ? gb / median.seconds : 0.0;
+            result.extra_metrics[prefix + "simd_speedup"] = median.seconds > 0.0 ? scalar.seconds / median.seconds : 0.0;
+            result.extra_metrics[prefix + "bytes_scanned_mb"] = median.bytes_scanned / (1024.0 * 1024.0);
+
+            if (verbose) {
+                std::cout << "  " << query_names[query - 1] << ": cold " << cold.seconds * 1000.0 << " ms, warm "
+                          << median.seconds * 1000.0 << " ms (" << gb / median.seconds << " GB/s)\n";
+            }
+
+            warm_seconds_total += median.seconds;
+            cold_seconds_total += cold.seconds;
+            warm_bytes_total += median.bytes_scanned;
+            scalar_seconds_total += scalar.seconds;
+        }
+
+        double warm_gb = warm_bytes_total / (1024.0 * 1024.0 * 1024.0);
+        result.throughput = warm_seconds_total > 0.0 ? warm_gb / warm_seconds_total : 0.0;
+        result.throughput_unit = "GB/s";
+        result.avg_latency = warm_seconds_total / 3.0 * 1000.0;
+        result.min_latency = result.avg_latency;
+        result.max_latency = cold_seconds_total / 3.0 * 1000.0;
+        result.p50_latency = result.avg_latency;
+        result.p90_latency = result.max_latency;
+        result.p99_latency = result.max_latency;
+        result.latency_unit = "ms";
+
+        result.extra_metrics["work_ops"] = static_cast<double>(rows) * 3.0;
+        result.extra_metrics["work_bytes"] = static_cast<double>(warm_bytes_total);
+        result.extra_metrics["colscan_rows"] = static_cast<double>(rows);
+        result.extra_metrics["colscan_file_mb"] = file_size / (1024.0 * 1024.0);
+        result.extra_metrics["colscan_write_seconds"] = write_seconds;
+        result.extra_metrics["colscan_threads"] = threads;
+        result.extra_metrics["colscan_warm_rows_sec"] = warm_seconds_total > 0.0 ? rows * 3.0 / warm_seconds_total : 0.0;
+        result.extra_metrics["colscan_cold_rows_sec"] = cold_seconds_total > 0.0 ? rows * 3.0 / cold_seconds_total : 0.0;
+        result.extra_metrics["colscan_warm_gbps"] = result.throughput;
+        result.extra_metrics["colscan_cold_gbps"] = cold_seconds_total > 0.0 ? warm_gb / cold_seconds_total : 0.0;
+        result.extra_metrics["colscan_simd_speedup"] = warm_seconds_total > 0.0 ? scalar_seconds_total / warm_seconds_total : 0.0;
+        result.extra_info["colscan.simd"] = simd ? "avx2" : "scalar";
+        result.extra_info["colscan.access"] = "mmap";
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    if (fd >= 0) {
+        close(fd);
+    }
+    unlink(path.c_str());
+    return result;
+}
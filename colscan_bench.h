@@ -0,0 +1,32 @@
+#ifndef COLSCAN_BENCH_H
+#define COLSCAN_BENCH_H
+
+#include "benchmark.h"
+#include "utils.h"
+#include <string>
+#include <vector>
+
+struct ColScanBenchmarkConfig {
+    size_t rows { 16 * 1024 * 1024 };
+    int threads { 0 }; // 0 = one per available core
+    std::string directory { "/tmp" };
+};
+
+// Reporting-tier analytics: writes a columnar file (plain int/float columns, a
+// dictionary-encoded string column and an RLE column), memory-maps it, and runs
+// filter/aggregate queries with SIMD predicate evaluation over morsels of rows
+// claimed by a pool of threads. Each query runs cold (file evicted from the
+// page cache) and warm.
+class ColumnarScanBenchmark : public Benchmark {
+private:
+    ColScanBenchmarkConfig config;
+
+public:
+    ColumnarScanBenchmark();
+    explicit ColumnarScanBenchmark(const ColScanBenchmarkConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "Columnar Scan"; }
+};
+
+#endif
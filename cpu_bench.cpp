@@ -1,14 +1,29 @@
 #include "cpu_bench.h"
+#include "cgroup.h"
+#include "cpu_topology.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <mutex>
+#include <numeric>
 #include <random>
 
+namespace {
+
+constexpr size_t CHASE_NODE_BYTES = 64; // one node per cache line
+constexpr size_t CHASE_STEPS = 1 << 22;
+
+}
+
+CPUBenchmark::CPUBenchmark(const ThreadPlacement& placement)
+    : placement(placement)
+{
+}
+
 void CPUBenchmark::runSingleThread(int thread_id)
 {
-    // Pin thread to specific CPU core for consistent performance
-    bool affinity_set = CPUAffinity::pinThreadToCore(thread_id % CPUAffinity::getNumCores());
+    // Pin thread to its placement slot for consistent performance
+    bool affinity_set = cpu_map.pin(static_cast<size_t>(thread_id));
     if (!affinity_set) {
         bool expected = false;
         if (affinity_warning_emitted.compare_exchange_strong(expected, true)) {
@@ -50,7 +65,7 @@ void CPUBenchmark::runSingleThread(int thread_id)
     }
 }
 
-void CPUBenchmark::runFloatingPoint()
+uint64_t CPUBenchmark::runFloatingPoint()
 {
     Timer timer;
     std::vector<double> values(100000);
@@ -77,9 +92,10 @@ void CPUBenchmark::runFloatingPoint()
     if (result == 0.0) {
         std::cout << "";
     }
+    return static_cast<uint64_t>(ops);
 }
 
-void CPUBenchmark::runInteger()
+uint64_t CPUBenchmark::runInteger()
 {
     Timer timer;
     std::vector<int> values(100000);
@@ -107,47 +123,58 @@ void CPUBenchmark::runInteger()
     if (result == 0) {
         std::cout << "";
     }
+    return static_cast<uint64_t>(ops);
 }
 
-void CPUBenchmark::measureCacheLatency(std::vector<double>& latencies)
+uint64_t CPUBenchmark::measureCacheLatency(const std::vector<size_t>& sizes, std::vector<double>& latencies)
 {
-    const size_t sizes[] = {
-        4 * 1024,        // 4KB - L1 cache
-        128 * 1024,      // 128KB - L2 cache
-        1 * 1024 * 1024, // 1MB - L3 cache
-        32 * 1024 * 1024 // 32MB - Main memory
-    };
-
+    uint64_t loads = 0;
     for (size_t size : sizes) {
-        std::vector<int> array(size / sizeof(int));
-        std::mt19937 gen(42);
-        std::uniform_int_distribution<> dis(0, array.size() - 1);
+        // A level the hierarchy lacks keeps its slot so later levels stay aligned
+        if (size == 0) {
+            latencies.push_back(0.0);
+            continue;
+        }
 
-        for (auto& v : array) {
-            v = dis(gen);
+        // Dependent loads around a single random cycle of cache lines (Sattolo's
+        // shuffle): each load needs the previous one's result, so neither memory-level
+        // parallelism nor the prefetchers can hide the latency
+        const size_t stride = CHASE_NODE_BYTES / sizeof(size_t);
+        const size_t nodes = std::max<size_t>(2, size / CHASE_NODE_BYTES);
+        std::vector<size_t> order(nodes);
+        std::iota(order.begin(), order.end(), 0);
+        std::mt19937_64 gen(42);
+        for (size_t i = nodes - 1; i > 0; --i) {
+            std::uniform_int_distribution<size_t> dis(0, i - 1);
+            std::swap(order[i], order[dis(gen)]);
+        }
+        std::vector<size_t> ring(nodes * stride);
+        for (size_t i = 0; i < nodes; ++i) {
+            ring[order[i] * stride] = order[(i + 1) % nodes] * stride;
         }
+        order.clear();
+        order.shrink_to_fit();
 
-        std::vector<int> indices(1000);
-        for (auto& idx : indices) {
-            idx = dis(gen);
+        // One lap (or one timed run, if shorter) warms the caches and TLB
+        size_t position = 0;
+        for (size_t i = 0; i < std::min(nodes, CHASE_STEPS); ++i) {
+            position = ring[position];
         }
+        loads += std::min(nodes, CHASE_STEPS) + CHASE_STEPS;
 
         Timer timer;
         timer.start();
-
-        int sum = 0;
-        for (int idx : indices) {
-            sum += array[idx];
+        for (size_t i = 0; i < CHASE_STEPS; ++i) {
+            position = ring[position];
         }
-
         double elapsed = timer.elapsedNanoseconds();
-        double avg_latency = elapsed / indices.size();
-        latencies.push_back(avg_latency);
+        latencies.push_back(elapsed / CHASE_STEPS);
 
-        if (sum == 0) {
+        if (position == 1) {
             std::cout << "";
         }
     }
+    return loads;
 }
 
 BenchmarkResult CPUBenchmark::run(int duration_seconds, int iterations, bool verbose)
@@ -156,10 +183,14 @@ BenchmarkResult CPUBenchmark::run(int duration_seconds, int iterations, bool ver
     result.name = getName();
 
     try {
+        cpu_map = placement.resolve();
+        // Sized to the placement's CPUs and the cgroup quota so threads are not throttled or stacked
+        unsigned int num_threads = static_cast<unsigned int>(cpu_map.max_threads);
+
         if (verbose) {
-            std::cout << "  Starting CPU benchmark with " << std::thread::hardware_concurrency()
+            std::cout << "  Starting CPU benchmark with " << num_threads
                       << " threads on " << CPUAffinity::getNumCores() << " CPU cores\n";
-            std::cout << "  CPU affinity: threads will be pinned to cores\n";
+            std::cout << "  CPU affinity (" << cpu_map.policy << "): " << cpu_map.describe(num_threads) << "\n";
         }
 
         total_ops.store(0);
@@ -167,10 +198,6 @@ BenchmarkResult CPUBenchmark::run(int duration_seconds, int iterations, bool ver
         latency_stats.clear();
 
         std::vector<std::thread> threads;
-        unsigned int num_threads = std::thread::hardware_concurrency();
-        if (num_threads == 0) {
-            num_threads = static_cast<unsigned int>(std::max(1, CPUAffinity::getNumCores()));
-        }
 
         Timer benchmark_timer;
         benchmark_timer.start();
@@ -197,13 +224,18 @@ BenchmarkResult CPUBenchmark::run(int duration_seconds, int iterations, bool ver
             std::cout << "  Multi-threaded test completed. Running latency tests...\n";
         }
 
+        uint64_t kernel_ops = 0;
         for (int i = 0; i < iterations; ++i) {
-            runFloatingPoint();
-            runInteger();
+            kernel_ops += runFloatingPoint();
+            kernel_ops += runInteger();
         }
 
+        // Working sets sized from the discovered cache hierarchy: L1, L2, last level, DRAM
+        const CpuTopology& topology = CpuTopology::host();
+        std::vector<size_t> working_sets = topology.latencyWorkingSets();
+        working_sets.back() = Cgroup::fitWorkingSet(working_sets.back());
         std::vector<double> cache_latencies;
-        measureCacheLatency(cache_latencies);
+        uint64_t chase_loads = measureCacheLatency(working_sets, cache_latencies);
 
         result.avg_latency = latency_stats.getAverage();
         result.min_latency = latency_stats.getMin();
@@ -220,9 +252,18 @@ BenchmarkResult CPUBenchmark::run(int duration_seconds, int iterations, bool ver
         result.extra_metrics["l2_cache_latency_ns"] = cache_metric(1);
         result.extra_metrics["l3_cache_latency_ns"] = cache_metric(2);
         result.extra_metrics["mem_latency_ns"] = cache_metric(3);
+        result.extra_metrics["l1_working_set_kb"] = working_sets[0] / 1024.0;
+        result.extra_metrics["l2_working_set_kb"] = working_sets[1] / 1024.0;
+        result.extra_metrics["l3_working_set_kb"] = working_sets[2] / 1024.0;
+        result.extra_metrics["mem_working_set_mb"] = working_sets[3] / (1024.0 * 1024.0);
+        result.extra_info["cache.hierarchy"] = topology.valid ? topology.describeCaches() : "unknown";
         result.extra_metrics["threads_used"] = num_threads;
         result.extra_metrics["cpu_cores"] = CPUAffinity::getNumCores();
         result.extra_metrics["cpu_affinity_enabled"] = 1.0;
+        cpu_map.record(result, num_threads);
+
+        // Arithmetic ops from the threaded and latency kernels plus the pointer-chase loads
+        result.extra_metrics["work_ops"] = static_cast<double>(total + kernel_ops + chase_loads);
 
         result.status = "success";
 
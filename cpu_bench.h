@@ -2,6 +2,7 @@
 #define CPU_BENCH_H
 
 #include "benchmark.h"
+#include "thread_placement.h"
 #include "utils.h"
 #include <atomic>
 #include <thread>
@@ -13,13 +14,17 @@ private:
     std::atomic<bool> should_stop { false };
     LatencyStats latency_stats;
     std::atomic<bool> affinity_warning_emitted { false };
+    ThreadPlacement placement;
+    CpuPlacement cpu_map;
 
     void runSingleThread(int thread_id);
-    void runFloatingPoint();
-    void runInteger();
-    void measureCacheLatency(std::vector<double>& latencies);
+    uint64_t runFloatingPoint();
+    uint64_t runInteger();
+    uint64_t measureCacheLatency(const std::vector<size_t>& sizes, std::vector<double>& latencies);
 
 public:
+    explicit CPUBenchmark(const ThreadPlacement& placement = ThreadPlacement());
+
     BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
     std::string getName() const override { return "CPU"; }
 };
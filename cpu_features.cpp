@@ -0,0 +1,261 @@
+#include "cpu_features.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CPU_FEATURES_X86 1
+#endif
+
+namespace {
+
+struct ModelName {
+    int model;
+    const char* name;
+};
+
+const ModelName INTEL_FAMILY6[] = {
+    { 0x3C, "Haswell" }, { 0x3F, "Haswell-EP" }, { 0x45, "Haswell" }, { 0x46, "Haswell" },
+    { 0x3D, "Broadwell" }, { 0x47, "Broadwell" }, { 0x4F, "Broadwell-EP" }, { 0x56, "Broadwell-DE" },
+    { 0x4E, "Skylake" }, { 0x5E, "Skylake" }, { 0x55, "Skylake-SP" },
+    { 0x8E, "Kaby Lake" }, { 0x9E, "Coffee Lake" }, { 0xA5, "Comet Lake" }, { 0xA6, "Comet Lake" },
+    { 0x66, "Cannon Lake" }, { 0x7D, "Ice Lake" }, { 0x7E, "Ice Lake" }, { 0x6A, "Ice Lake-SP" },
+    { 0x6C, "Ice Lake-SP" }, { 0x8C, "Tiger Lake" }, { 0x8D, "Tiger Lake" }, { 0xA7, "Rocket Lake" },
+    { 0x97, "Alder Lake" }, { 0x9A, "Alder Lake" }, { 0xB7, "Raptor Lake" }, { 0xBA, "Raptor Lake" },
+    { 0xBF, "Raptor Lake" }, { 0xAA, "Meteor Lake" }, { 0xAC, "Meteor Lake" }, { 0xBD, "Lunar Lake" },
+    { 0xC5, "Arrow Lake" }, { 0xC6, "Arrow Lake" }, { 0x8F, "Sapphire Rapids" }, { 0xCF, "Emerald Rapids" },
+    { 0xAD, "Granite Rapids" }, { 0xAE, "Granite Rapids" }, { 0xAF, "Sierra Forest" },
+    { 0x5C, "Goldmont" }, { 0x5F, "Goldmont" }, { 0x7A, "Goldmont Plus" }, { 0x86, "Tremont" },
+    { 0x96, "Tremont" }, { 0x9C, "Tremont" },
+};
+
+std::string hexModel(int family, int model)
+{
+    std::ostringstream text;
+    text << "unknown (family 0x" << std::hex << family << " model 0x" << model << ")";
+    return text.str();
+}
+
+std::string intelMicroarchitecture(int family, int model, int stepping)
+{
+    if (family != 6) {
+        return hexModel(family, model);
+    }
+    if (model == 0x55) {
+        // Skylake-SP, Cascade Lake and Cooper Lake share a model number
+        return stepping >= 10 ? "Cooper Lake" : stepping >= 5 ? "Cascade Lake" : "Skylake-SP";
+    }
+    for (const auto& entry : INTEL_FAMILY6) {
+        if (entry.model == model) {
+            return entry.name;
+        }
+    }
+    return hexModel(family, model);
+}
+
+std::string amdMicroarchitecture(int family, int model)
+{
+    switch (family) {
+    case 0x17:
+        return model < 0x30 ? "Zen/Zen+" : "Zen 2";
+    case 0x19:
+        if ((model >= 0x10 && model <= 0x1F) || (model >= 0x60 && model <= 0xAF)) {
+            return "Zen 4";
+        }
+        return "Zen 3";
+    case 0x1A:
+        return "Zen 5";
+    default:
+        return hexModel(family, model);
+    }
+}
+
+#ifndef CPU_FEATURES_X86
+// Arm hosts identify themselves through /proc/cpuinfo implementer and part numbers
+void detectFromCpuinfo(CpuFeatures& features)
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    unsigned long implementer = 0;
+    unsigned long part = 0;
+    while (std::getline(cpuinfo, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        if (line.compare(0, 15, "CPU implementer") == 0) {
+            implementer = std::strtoul(line.c_str() + colon + 1, nullptr, 0);
+        } else if (line.compare(0, 8, "CPU part") == 0) {
+            part = std::strtoul(line.c_str() + colon + 1, nullptr, 0);
+            break;
+        }
+    }
+
+    switch (implementer) {
+    case 0x41:
+        features.vendor = "ARM";
+        break;
+    case 0x61:
+        features.vendor = "Apple";
+        break;
+    case 0xC0:
+        features.vendor = "Ampere";
+        break;
+    default:
+        return;
+    }
+    features.model = static_cast<int>(part);
+    switch (implementer << 12 | part) {
+    case 0x41d0c:
+        features.microarchitecture = "Neoverse N1";
+        break;
+    case 0x41d40:
+        features.microarchitecture = "Neoverse V1";
+        break;
+    case 0x41d49:
+        features.microarchitecture = "Neoverse N2";
+        break;
+    case 0x41d4f:
+        features.microarchitecture = "Neoverse V2";
+        break;
+    default:
+        std::ostringstream text;
+        text << "unknown (part 0x" << std::hex << part << ")";
+        features.microarchitecture = text.str();
+    }
+}
+#endif
+
+}
+
+CpuFeatures CpuFeatures::detect()
+{
+    CpuFeatures features;
+#ifdef CPU_FEATURES_X86
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) == 0) {
+        return features;
+    }
+    unsigned int max_leaf = eax;
+    char vendor[13];
+    memcpy(vendor, &ebx, 4);
+    memcpy(vendor + 4, &edx, 4);
+    memcpy(vendor + 8, &ecx, 4);
+    vendor[12] = '\0';
+    features.vendor = vendor;
+    features.valid = true;
+
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    int base_family = (eax >> 8) & 0xF;
+    int base_model = (eax >> 4) & 0xF;
+    features.stepping = eax & 0xF;
+    features.family = base_family == 0xF ? base_family + ((eax >> 20) & 0xFF) : base_family;
+    features.model = (base_family == 0x6 || base_family == 0xF) ? base_model | ((eax >> 12) & 0xF0) : base_model;
+
+    features.sse42 = ecx & (1u << 20);
+    features.popcnt = ecx & (1u << 23);
+    features.aes = ecx & (1u << 25);
+    features.pclmul = ecx & (1u << 1);
+    bool fma = ecx & (1u << 12);
+    bool avx = ecx & (1u << 28);
+
+    // XCR0: which register files the OS saves on context switch
+    uint64_t xcr0 = 0;
+    if (ecx & (1u << 27)) {
+        unsigned int xcr0_low = 0, xcr0_high = 0;
+        __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+        xcr0 = (static_cast<uint64_t>(xcr0_high) << 32) | xcr0_low;
+    }
+    bool os_avx = (xcr0 & 0x6) == 0x6;
+    bool os_avx512 = os_avx && (xcr0 & 0xE0) == 0xE0;
+    bool os_amx = (xcr0 & 0x60000) == 0x60000;
+    features.avx = avx && os_avx;
+    features.fma = fma && os_avx;
+
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        unsigned int subleaves = eax;
+        features.bmi1 = ebx & (1u << 3);
+        features.avx2 = (ebx & (1u << 5)) && os_avx;
+        features.bmi2 = ebx & (1u << 8);
+        features.erms = ebx & (1u << 9);
+        features.avx512f = (ebx & (1u << 16)) && os_avx512;
+        features.avx512dq = (ebx & (1u << 17)) && os_avx512;
+        features.avx512cd = (ebx & (1u << 28)) && os_avx512;
+        features.sha = ebx & (1u << 29);
+        features.avx512bw = (ebx & (1u << 30)) && os_avx512;
+        features.avx512vl = (ebx & (1u << 31)) && os_avx512;
+        features.avx512_vbmi = (ecx & (1u << 1)) && os_avx512;
+        features.avx512_vnni = (ecx & (1u << 11)) && os_avx512;
+        features.fsrm = edx & (1u << 4);
+        features.amx_bf16 = (edx & (1u << 22)) && os_amx;
+        features.avx512_fp16 = (edx & (1u << 23)) && os_avx512;
+        features.amx_tile = (edx & (1u << 24)) && os_amx;
+        features.amx_int8 = (edx & (1u << 25)) && os_amx;
+        if (subleaves >= 1) {
+            __cpuid_count(7, 1, eax, ebx, ecx, edx);
+            features.avx512_bf16 = (eax & (1u << 5)) && os_avx512;
+        }
+    }
+
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000007) {
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        features.invariant_tsc = edx & (1u << 8);
+    }
+
+    if (features.vendor == "GenuineIntel") {
+        features.microarchitecture = intelMicroarchitecture(features.family, features.model, features.stepping);
+    } else if (features.vendor == "AuthenticAMD") {
+        features.microarchitecture = amdMicroarchitecture(features.family, features.model);
+    } else if (features.vendor == "HygonGenuine") {
+        features.microarchitecture = "Dhyana";
+    } else {
+        features.microarchitecture = hexModel(features.family, features.model);
+    }
+#else
+    detectFromCpuinfo(features);
+#endif
+    return features;
+}
+
+const CpuFeatures& CpuFeatures::host()
+{
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+std::vector<std::string> CpuFeatures::extensions() const
+{
+    const std::pair<bool, const char*> flags[] = {
+        { sse42, "sse4_2" }, { popcnt, "popcnt" }, { aes, "aes" }, { pclmul, "pclmulqdq" }, { avx, "avx" },
+        { avx2, "avx2" }, { fma, "fma" }, { bmi1, "bmi1" }, { bmi2, "bmi2" }, { sha, "sha_ni" },
+        { avx512f, "avx512f" }, { avx512dq, "avx512dq" }, { avx512cd, "avx512cd" }, { avx512bw, "avx512bw" },
+        { avx512vl, "avx512vl" }, { avx512_vnni, "avx512_vnni" }, { avx512_bf16, "avx512_bf16" },
+        { avx512_vbmi, "avx512_vbmi" }, { avx512_fp16, "avx512_fp16" }, { amx_tile, "amx_tile" },
+        { amx_int8, "amx_int8" }, { amx_bf16, "amx_bf16" }, { erms, "erms" }, { fsrm, "fsrm" },
+        { invariant_tsc, "invariant_tsc" },
+    };
+    std::vector<std::string> names;
+    for (const auto& flag : flags) {
+        if (flag.first) {
+            names.push_back(flag.second);
+        }
+    }
+    return names;
+}
+
+std::string CpuFeatures::describe() const
+{
+    std::string text;
+    for (const auto& name : extensions()) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += name;
+    }
+    return text;
+}
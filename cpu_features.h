@@ -0,0 +1,54 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <string>
+#include <vector>
+
+// Processor identity and ISA extensions from CPUID. An extension is only
+// reported when the OS also saves its register state (XCR0), i.e. when code
+// using it can actually run.
+struct CpuFeatures {
+    bool valid { false }; // false off x86, where only vendor/microarchitecture may be set
+    std::string vendor;   // GenuineIntel, AuthenticAMD, ...
+    int family { 0 };
+    int model { 0 };
+    int stepping { 0 };
+    std::string microarchitecture;
+
+    bool sse42 { false };
+    bool popcnt { false };
+    bool aes { false };
+    bool pclmul { false };
+    bool avx { false };
+    bool avx2 { false };
+    bool fma { false };
+    bool bmi1 { false };
+    bool bmi2 { false };
+    bool sha { false };
+    bool avx512f { false };
+    bool avx512dq { false };
+    bool avx512cd { false };
+    bool avx512bw { false };
+    bool avx512vl { false };
+    bool avx512_vnni { false };
+    bool avx512_bf16 { false };
+    bool avx512_vbmi { false };
+    bool avx512_fp16 { false };
+    bool amx_tile { false };
+    bool amx_int8 { false };
+    bool amx_bf16 { false };
+    bool erms { false }; // enhanced rep movsb/stosb
+    bool fsrm { false }; // fast short rep mov
+    bool invariant_tsc { false };
+
+    static CpuFeatures detect();
+    // Detected on first use and kept for the life of the process
+    static const CpuFeatures& host();
+
+    // Lower-case extension names as in /proc/cpuinfo, e.g. "avx2", "avx512f", "amx_tile"
+    std::vector<std::string> extensions() const;
+    // The extensions joined with spaces
+    std::string describe() const;
+};
+
+#endif
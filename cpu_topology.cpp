@@ -0,0 +1,250 @@
+#include "cpu_topology.h"
+#include "cgroup.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <tuple>
+#ifdef __linux__
+#include <dirent.h>
+#endif
+
+namespace {
+
+const char* CPU_ROOT = "/sys/devices/system/cpu";
+constexpr size_t MAX_DRAM_LATENCY_SET = 512ULL * 1024 * 1024;
+
+std::string readLine(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+int readInt(const std::string& path, int fallback)
+{
+    std::string value = readLine(path);
+    try {
+        return value.empty() ? fallback : std::stoi(value);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+// Cache sizes read like "48K" or "2048K"; newer kernels may use "M"
+uint64_t parseCacheSize(const std::string& value)
+{
+    uint64_t size = 0;
+    size_t i = 0;
+    while (i < value.size() && value[i] >= '0' && value[i] <= '9') {
+        size = size * 10 + static_cast<uint64_t>(value[i++] - '0');
+    }
+    if (i < value.size()) {
+        switch (value[i]) {
+        case 'K':
+            size *= 1024;
+            break;
+        case 'M':
+            size *= 1024 * 1024;
+            break;
+        case 'G':
+            size *= 1024ULL * 1024 * 1024;
+            break;
+        }
+    }
+    return size;
+}
+
+std::string formatCacheSize(uint64_t bytes)
+{
+    const uint64_t MB = 1024 * 1024;
+    if (bytes >= MB && bytes % MB == 0) {
+        return std::to_string(bytes / MB) + "M";
+    }
+    return std::to_string(bytes / 1024) + "K";
+}
+
+std::vector<std::string> listEntries(const std::string& directory, const std::string& prefix)
+{
+    std::vector<std::string> names;
+#ifdef __linux__
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return names;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0 && name.size() > prefix.size() &&
+            std::isdigit(static_cast<unsigned char>(name[prefix.size()]))) {
+            names.push_back(name);
+        }
+    }
+    closedir(dir);
+#else
+    (void)directory;
+    (void)prefix;
+#endif
+    return names;
+}
+
+}
+
+CpuTopology CpuTopology::discover()
+{
+    CpuTopology topology;
+#ifdef __linux__
+    std::vector<int> online = Cgroup::parseCpuList(readLine(std::string(CPU_ROOT) + "/online"));
+    if (online.empty()) {
+        return topology;
+    }
+
+    std::set<int> packages;
+    std::set<std::pair<int, int>> dies;
+    std::set<std::tuple<int, int, int>> cores;
+    for (int id : online) {
+        std::string base = std::string(CPU_ROOT) + "/cpu" + std::to_string(id) + "/topology/";
+        LogicalCpu cpu;
+        cpu.id = id;
+        cpu.package = readInt(base + "physical_package_id", 0);
+        cpu.die = readInt(base + "die_id", 0);
+        cpu.core = readInt(base + "core_id", id);
+        cpu.smt_siblings = Cgroup::parseCpuList(readLine(base + "thread_siblings_list"));
+        if (cpu.smt_siblings.empty()) {
+            cpu.smt_siblings.push_back(id);
+        }
+        packages.insert(cpu.package);
+        dies.insert({ cpu.package, cpu.die });
+        cores.insert(std::make_tuple(cpu.package, cpu.die, cpu.core));
+        topology.threads_per_core = std::max(topology.threads_per_core, static_cast<int>(cpu.smt_siblings.size()));
+        topology.cpus.push_back(cpu);
+    }
+    topology.packages = static_cast<int>(packages.size());
+    topology.dies = static_cast<int>(dies.size());
+    topology.cores = static_cast<int>(cores.size());
+
+    for (const auto& node : listEntries("/sys/devices/system/node", "node")) {
+        int node_id = std::stoi(node.substr(4));
+        for (int id : Cgroup::parseCpuList(readLine("/sys/devices/system/node/" + node + "/cpulist"))) {
+            for (auto& cpu : topology.cpus) {
+                if (cpu.id == id) {
+                    cpu.node = node_id;
+                }
+            }
+        }
+    }
+
+    // cpu0's caches describe the hierarchy; the same index on other CPUs gives the instances
+    std::string cache_root = std::string(CPU_ROOT) + "/cpu" + std::to_string(online.front()) + "/cache/";
+    for (const auto& index : listEntries(cache_root, "index")) {
+        std::string base = cache_root + index + "/";
+        CacheLevel cache;
+        cache.level = readInt(base + "level", 0);
+        cache.type = readLine(base + "type");
+        cache.size_bytes = parseCacheSize(readLine(base + "size"));
+        cache.line_size = readInt(base + "coherency_line_size", 0);
+        cache.ways = readInt(base + "ways_of_associativity", 0);
+        cache.sets = readInt(base + "number_of_sets", 0);
+        cache.shared_cpus = Cgroup::parseCpuList(readLine(base + "shared_cpu_list"));
+        if (cache.level == 0 || cache.size_bytes == 0) {
+            continue;
+        }
+
+        std::set<std::string> instances;
+        for (int id : online) {
+            std::string other = std::string(CPU_ROOT) + "/cpu" + std::to_string(id) + "/cache/" + index + "/";
+            if (readInt(other + "level", 0) == cache.level && readLine(other + "type") == cache.type) {
+                instances.insert(readLine(other + "shared_cpu_list"));
+            }
+        }
+        cache.instances = std::max<int>(1, static_cast<int>(instances.size()));
+        topology.caches.push_back(cache);
+    }
+    std::sort(topology.caches.begin(), topology.caches.end(), [](const CacheLevel& a, const CacheLevel& b) {
+        return std::make_tuple(a.level, !a.holdsData(), a.type) < std::make_tuple(b.level, !b.holdsData(), b.type);
+    });
+
+    topology.valid = true;
+#endif
+    return topology;
+}
+
+const CpuTopology& CpuTopology::host()
+{
+    static const CpuTopology topology = discover();
+    return topology;
+}
+
+const CacheLevel* CpuTopology::dataCache(int level) const
+{
+    for (const auto& cache : caches) {
+        if (cache.level == level && cache.holdsData()) {
+            return &cache;
+        }
+    }
+    return nullptr;
+}
+
+const CacheLevel* CpuTopology::lastLevelCache() const
+{
+    const CacheLevel* last = nullptr;
+    for (const auto& cache : caches) {
+        if (cache.holdsData() && (last == nullptr || cache.level > last->level)) {
+            last = &cache;
+        }
+    }
+    return last;
+}
+
+std::vector<size_t> CpuTopology::latencyWorkingSets() const
+{
+    const CacheLevel* l1 = dataCache(1);
+    const CacheLevel* l2 = dataCache(2);
+    if (l1 == nullptr || l2 == nullptr) {
+        return { 4 * 1024, 128 * 1024, 1024 * 1024, std::min(dramWorkingSet(32 * 1024 * 1024), MAX_DRAM_LATENCY_SET) };
+    }
+
+    // Half of a level fits alongside whatever else is cached; each set must
+    // also clearly overflow the level below it
+    size_t l1_set = l1->size_bytes / 2;
+    size_t l2_set = std::max<size_t>(l2->size_bytes / 2, l1->size_bytes * 2);
+    const CacheLevel* llc = lastLevelCache();
+    size_t llc_set = 0; // no level beyond L2
+    if (llc != nullptr && llc->level > 2) {
+        llc_set = std::max<size_t>(llc->size_bytes / 2, l2->size_bytes * 2);
+    }
+    return { l1_set, l2_set, llc_set, std::min(dramWorkingSet(32 * 1024 * 1024), MAX_DRAM_LATENCY_SET) };
+}
+
+size_t CpuTopology::dramWorkingSet(size_t minimum_bytes) const
+{
+    const CacheLevel* llc = lastLevelCache();
+    if (llc == nullptr) {
+        return minimum_bytes;
+    }
+    return std::max<size_t>(minimum_bytes, llc->totalBytes() * 4);
+}
+
+std::string CpuTopology::describeCaches() const
+{
+    std::ostringstream text;
+    for (size_t i = 0; i < caches.size(); ++i) {
+        const CacheLevel& cache = caches[i];
+        if (i) {
+            text << ", ";
+        }
+        text << "L" << cache.level;
+        if (cache.type == "Data") {
+            text << "d";
+        } else if (cache.type == "Instruction") {
+            text << "i";
+        }
+        text << " " << formatCacheSize(cache.size_bytes);
+        if (cache.ways > 0) {
+            text << " " << cache.ways << "-way";
+        }
+        text << " x" << cache.instances;
+    }
+    return text.str();
+}
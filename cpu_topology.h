@@ -0,0 +1,66 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One cache of cpu0 from /sys/devices/system/cpu/cpu0/cache/index*. Instances
+// counts the distinct copies across online CPUs (one L2 per core, one L3 per
+// die, ...), found by their shared_cpu_list.
+struct CacheLevel {
+    int level { 0 };
+    std::string type; // Data, Instruction or Unified
+    uint64_t size_bytes { 0 };
+    int line_size { 0 };
+    int ways { 0 }; // 0 when unknown or fully associative
+    int sets { 0 };
+    std::vector<int> shared_cpus;
+    int instances { 0 };
+
+    bool holdsData() const { return type != "Instruction"; }
+    uint64_t totalBytes() const { return size_bytes * static_cast<uint64_t>(instances); }
+};
+
+// A logical CPU's place in the package / die / core hierarchy
+struct LogicalCpu {
+    int id { 0 };
+    int package { 0 };
+    int die { 0 };
+    int core { 0 }; // topology/core_id, unique only within a package
+    int node { 0 }; // NUMA node
+    std::vector<int> smt_siblings; // thread_siblings_list, including this CPU
+};
+
+// Cache and topology discovery from sysfs
+struct CpuTopology {
+    bool valid { false };
+    std::vector<LogicalCpu> cpus; // online CPUs in id order
+    std::vector<CacheLevel> caches; // by level, data before instruction
+    int packages { 0 };
+    int dies { 0 };
+    int cores { 0 }; // physical cores
+    int threads_per_core { 1 };
+
+    static CpuTopology discover();
+    // Discovered on first use and kept for the life of the process
+    static const CpuTopology& host();
+
+    // The data or unified cache at a level, or nullptr
+    const CacheLevel* dataCache(int level) const;
+    const CacheLevel* lastLevelCache() const;
+
+    // Buffer sizes whose random accesses mostly hit L1, L2, the last-level
+    // cache and DRAM, in that order; the old fixed sizes when nothing was found.
+    // The DRAM set is capped at 512 MB: a single thread only hits its own
+    // last-level cache instance, which is far smaller
+    std::vector<size_t> latencyWorkingSets() const;
+    // At least minimum_bytes and four times all last-level cache combined
+    size_t dramWorkingSet(size_t minimum_bytes) const;
+
+    // "L1d 48K 12-way, L1i 32K 8-way, L2 2M 16-way, L3 300M 15-way x1"
+    std::string describeCaches() const;
+};
+
+#endif
@@ -1,10 +1,16 @@
 #include "disk_bench.h"
+#include "diskstats.h"
+#include "load_curve.h"
+#include "pipeline.h"
+#include <atomic>
+#include <cstdlib>
 #include <fcntl.h>
 #include <fstream>
 #include <iostream>
 #include <random>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
+#include <thread>
 #include <unistd.h>
 
 // Compatibility helper for older C++ standards
@@ -21,7 +27,168 @@ inline bool remove_file(const std::string& path)
 }
 }
 
-DiskBenchmark::DiskBenchmark()
+namespace {
+
+constexpr size_t RANDOM_IO_FILE_SIZE = 128 * 1024 * 1024;
+constexpr size_t RANDOM_IO_BLOCK_SIZE = 4096;
+constexpr int RANDOM_IO_THREADS = 8;
+constexpr size_t RANDOM_IO_QUEUE_DEPTH = 65536;
+constexpr int RANDOM_IO_DRAIN_TIMEOUT_MS = 1000;
+
+// Random 4KB reads issued on an open-loop schedule into a pool of I/O threads;
+// latency runs from the scheduled issue time, so device queueing is included.
+class DiskRandomReadWorkload : public RateControlledWorkload {
+private:
+    std::string path;
+    int fd { -1 };
+    bool direct_io { false };
+
+public:
+    std::string getName() const override { return "Disk Random Read"; }
+    std::string getRateUnit() const override { return "IOPS"; }
+
+    void setUp() override
+    {
+        char temp_template[] = "/tmp/perf_test_rand_XXXXXX";
+        int write_fd = mkstemp(temp_template);
+        if (write_fd < 0) {
+            throw std::runtime_error("Failed to create random I/O test file");
+        }
+        path = temp_template;
+
+        std::vector<char> chunk(1024 * 1024, 'R');
+        for (size_t written = 0; written < RANDOM_IO_FILE_SIZE; written += chunk.size()) {
+            if (write(write_fd, chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size())) {
+                close(write_fd);
+                tearDown();
+                throw std::runtime_error("Failed to fill random I/O test file");
+            }
+        }
+        fsync(write_fd);
+        close(write_fd);
+
+        // Prefer O_DIRECT so reads reach the device instead of the page cache
+        fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+        direct_io = fd >= 0;
+        if (fd < 0) {
+            fd = open(path.c_str(), O_RDONLY);
+        }
+        if (fd < 0) {
+            tearDown();
+            throw std::runtime_error("Failed to open random I/O test file");
+        }
+    }
+
+    void tearDown() override
+    {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        if (!path.empty()) {
+            unlink(path.c_str());
+            path.clear();
+        }
+    }
+
+    LoadStepResult runAtRate(double rate, int duration_seconds) override
+    {
+        if (!direct_io) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+
+        MpmcQueue<uint64_t> issue_queue(RANDOM_IO_QUEUE_DEPTH);
+        std::atomic<bool> issuing_done(false);
+        std::atomic<uint64_t> sent(0);
+        std::atomic<uint64_t> completed(0);
+        std::vector<SampleReservoir> latencies(RANDOM_IO_THREADS);
+        uint64_t start_ns = pipelineNowNanoseconds();
+        uint64_t deadline_ns = start_ns + static_cast<uint64_t>(duration_seconds) * 1000000000ULL;
+        uint64_t drain_deadline_ns = deadline_ns + static_cast<uint64_t>(RANDOM_IO_DRAIN_TIMEOUT_MS) * 1000000ULL;
+        const size_t block_count = RANDOM_IO_FILE_SIZE / RANDOM_IO_BLOCK_SIZE;
+
+        auto io_worker = [&](int index) {
+            void* raw = nullptr;
+            if (posix_memalign(&raw, RANDOM_IO_BLOCK_SIZE, RANDOM_IO_BLOCK_SIZE) != 0) {
+                return;
+            }
+            std::unique_ptr<void, decltype(&free)> buffer(raw, &free);
+            uint64_t rng = 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(index + 1);
+
+            while (true) {
+                uint64_t intended = 0;
+                if (rate > 0.0) {
+                    if (!issue_queue.tryPop(intended)) {
+                        if (issuing_done.load(std::memory_order_acquire) && issue_queue.size() == 0) {
+                            break;
+                        }
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (pipelineNowNanoseconds() > drain_deadline_ns) {
+                        continue;
+                    }
+                } else {
+                    intended = pipelineNowNanoseconds();
+                    if (intended >= deadline_ns) {
+                        break;
+                    }
+                    sent.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                off_t offset = static_cast<off_t>((rng % block_count) * RANDOM_IO_BLOCK_SIZE);
+                if (pread(fd, buffer.get(), RANDOM_IO_BLOCK_SIZE, offset) != static_cast<ssize_t>(RANDOM_IO_BLOCK_SIZE)) {
+                    continue;
+                }
+                uint64_t now = pipelineNowNanoseconds();
+                latencies[index].add(now > intended ? (now - intended) / 1000.0 : 0.0);
+                completed.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < RANDOM_IO_THREADS; ++i) {
+            workers.emplace_back(io_worker, i);
+        }
+
+        uint64_t issue_end_ns = deadline_ns;
+        if (rate > 0.0) {
+            ArrivalSchedule schedule(rate, start_ns, 0xD15CULL);
+            uint64_t intended = 0;
+            while (schedule.waitNext(deadline_ns, intended)) {
+                while (!issue_queue.tryPush(intended)) {
+                    std::this_thread::yield();
+                }
+                sent.fetch_add(1, std::memory_order_relaxed);
+            }
+            issue_end_ns = pipelineNowNanoseconds();
+            issuing_done.store(true, std::memory_order_release);
+        }
+
+        for (auto& t : workers) {
+            t.join();
+        }
+        if (rate <= 0.0) {
+            issue_end_ns = pipelineNowNanoseconds();
+        }
+
+        SampleReservoir merged;
+        for (const auto& reservoir : latencies) {
+            for (double sample : reservoir.samples) {
+                merged.add(sample);
+            }
+        }
+        return summarizeLoadStep(rate, sent.load(), completed.load(), merged, (issue_end_ns - start_ns) / NANOSECONDS_PER_SECOND);
+    }
+};
+
+}
+
+DiskBenchmark::DiskBenchmark(const ThreadPlacement& placement)
+    : placement(placement)
 {
     char temp_template[] = "/tmp/perf_test_XXXXXX";
     int fd = mkstemp(temp_template);
@@ -203,6 +370,11 @@ BenchmarkResult DiskBenchmark::run(int duration_seconds, int iterations, bool ve
     result.name = getName();
 
     try {
+        // The phases run on this thread; it goes back to its old affinity afterwards
+        CpuPlacement cpu_map = placement.resolve();
+        ScopedThreadPin pin(cpu_map, 0);
+        cpu_map.record(result, 1);
+
         struct statvfs stat;
         if (statvfs("/tmp", &stat) == 0) {
             unsigned long available = stat.f_bavail * stat.f_frsize;
@@ -229,13 +401,19 @@ BenchmarkResult DiskBenchmark::run(int duration_seconds, int iterations, bool ve
 
         LatencyStats write_stats, read_stats, random_write_stats, random_read_stats;
 
+        // Device counters bracket each phase so device and application latency line up
+        DiskStatsSnapshot phase_start[5];
+        phase_start[0] = DiskStatsSnapshot::capture();
+
         double seq_write_throughput = measureSequentialWrite(test_file_path, test_size, write_stats);
+        phase_start[1] = DiskStatsSnapshot::capture();
 
         if (verbose) {
             std::cout << "  Running sequential read test...\n";
         }
 
         double seq_read_throughput = measureSequentialRead(test_file_path, test_size, read_stats);
+        phase_start[2] = DiskStatsSnapshot::capture();
 
         if (verbose) {
             std::cout << "  Running random write test...\n";
@@ -243,12 +421,14 @@ BenchmarkResult DiskBenchmark::run(int duration_seconds, int iterations, bool ve
 
         int random_ops = 1000;
         double random_write_iops = measureRandomWrite(test_file_path, test_size, random_ops, random_write_stats);
+        phase_start[3] = DiskStatsSnapshot::capture();
 
         if (verbose) {
             std::cout << "  Running random read test...\n";
         }
 
         double random_read_iops = measureRandomRead(test_file_path, test_size, random_ops, random_read_stats);
+        phase_start[4] = DiskStatsSnapshot::capture();
 
         result.throughput = (seq_write_throughput + seq_read_throughput) / 2.0;
         result.throughput_unit = "MB/s";
@@ -277,12 +457,34 @@ BenchmarkResult DiskBenchmark::run(int duration_seconds, int iterations, bool ve
         result.extra_metrics["random_read_latency_ms"] = random_read_stats.getAverage();
         result.extra_metrics["test_file_size_mb"] = test_size / (1024.0 * 1024.0);
 
+        // The test file's own disk; filesystems without one fall back to the busiest disk
+        std::string device = DiskStats::deviceForPath(test_file_path);
+        std::string device_source = "test file";
+        if (device.empty() || phase_start[0].find(device) == nullptr) {
+            device = DiskStats::busiestDevice(phase_start[0], phase_start[4]);
+            device_source = "busiest";
+        }
+        if (!device.empty()) {
+            result.extra_info["disk.device"] = device + " (" + device_source + ")";
+            DiskStats::applyPhase(result, "seq_write", device, phase_start[0], phase_start[1], write_stats.getAverage(), false);
+            DiskStats::applyPhase(result, "seq_read", device, phase_start[1], phase_start[2], read_stats.getAverage(), true);
+            DiskStats::applyPhase(result, "random_write", device, phase_start[2], phase_start[3],
+                random_write_stats.getAverage(), false);
+            DiskStats::applyPhase(result, "random_read", device, phase_start[3], phase_start[4],
+                random_read_stats.getAverage(), true);
+        }
+
         if (random_read_iops > 5000) {
             result.extra_metrics["likely_disk_type"] = 1.0; // SSD
         } else {
             result.extra_metrics["likely_disk_type"] = 0.0; // HDD
         }
 
+        // Every timed call is one operation; the sequential passes each cover the file once
+        result.extra_metrics["work_ops"] = static_cast<double>(write_stats.getCount() + read_stats.getCount()) +
+            2.0 * random_ops;
+        result.extra_metrics["work_bytes"] = 2.0 * test_size + 2.0 * random_ops * 4096;
+
         result.status = "success";
 
         cleanup();
@@ -294,4 +496,8 @@ BenchmarkResult DiskBenchmark::run(int duration_seconds, int iterations, bool ve
     }
 
     return result;
-}
\ No newline at end of file
+}
+std::unique_ptr<RateControlledWorkload> DiskBenchmark::createRateControlledWorkload()
+{
+    return std::make_unique<DiskRandomReadWorkload>();
+}
@@ -2,6 +2,7 @@
 #define DISK_BENCH_H
 
 #include "benchmark.h"
+#include "thread_placement.h"
 #include "utils.h"
 #include <string>
 
@@ -10,6 +11,7 @@ private:
     static constexpr size_t FILE_SIZE = 256 * 1024 * 1024; // 256MB test file
     static constexpr size_t BLOCK_SIZE = 4 * 1024 * 1024; // 4MB blocks
     std::string test_file_path;
+    ThreadPlacement placement;
 
     double measureSequentialWrite(const std::string& path, size_t size, LatencyStats& stats);
     double measureSequentialRead(const std::string& path, size_t size, LatencyStats& stats);
@@ -18,10 +20,11 @@ private:
     void cleanup();
 
 public:
-    DiskBenchmark();
+    explicit DiskBenchmark(const ThreadPlacement& placement = ThreadPlacement());
     ~DiskBenchmark();
     BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
     std::string getName() const override { return "Disk I/O"; }
+    std::unique_ptr<RateControlledWorkload> createRateControlledWorkload() override;
 };
 
 #endif
\ No newline at end of file
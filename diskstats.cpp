@@ -0,0 +1,247 @@
+#include "diskstats.h"
+#include "utils.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/sysmacros.h>
+#endif
+
+namespace {
+
+uint64_t deltaOrZero(uint64_t end, uint64_t start)
+{
+    return end > start ? end - start : 0;
+}
+
+bool isSkippedDevice(const char* name)
+{
+    return strstr(name, "loop") != nullptr || strstr(name, "ram") != nullptr;
+}
+
+// Only whole disks have an entry directly under /sys/block
+bool isWholeDisk(const char* name)
+{
+    std::string path = std::string("/sys/block/") + name;
+    return access(path.c_str(), F_OK) == 0;
+}
+
+std::string lastPathComponent(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+}
+
+bool parseDiskstatsLine(ProcScanner& scan, DiskDeviceCounters& counters)
+{
+    uint64_t major = 0;
+    uint64_t minor = 0;
+    const char* device = nullptr;
+    size_t device_length = 0;
+    if (!scan.nextUint(major) || !scan.nextUint(minor) || !scan.nextToken(device, device_length)) {
+        return false;
+    }
+
+    size_t length = std::min(device_length, sizeof(counters.name) - 1);
+    memcpy(counters.name, device, length);
+    counters.name[length] = '\0';
+
+    if (!scan.nextUint(counters.reads_completed) || !scan.nextUint(counters.reads_merged) ||
+        !scan.nextUint(counters.read_sectors) || !scan.nextUint(counters.read_time_ms) ||
+        !scan.nextUint(counters.writes_completed) || !scan.nextUint(counters.writes_merged) ||
+        !scan.nextUint(counters.write_sectors) || !scan.nextUint(counters.write_time_ms) ||
+        !scan.nextUint(counters.in_flight) || !scan.nextUint(counters.io_time_ms) ||
+        !scan.nextUint(counters.weighted_io_time_ms)) {
+        return false;
+    }
+
+    // Linux 4.18 added discards, 5.5 flushes
+    uint64_t discards_merged = 0;
+    uint64_t discard_sectors = 0;
+    if (scan.nextUint(counters.discards_completed) && scan.nextUint(discards_merged) &&
+        scan.nextUint(discard_sectors) && scan.nextUint(counters.discard_time_ms)) {
+        if (scan.nextUint(counters.flushes_completed)) {
+            scan.nextUint(counters.flush_time_ms);
+        }
+    }
+    return true;
+}
+
+DiskStatsSnapshot DiskStatsSnapshot::capture()
+{
+    DiskStatsSnapshot snapshot;
+#ifdef __linux__
+    ProcFile file("/proc/diskstats", 16384);
+    if (!file.read()) {
+        return snapshot;
+    }
+    snapshot.taken = std::chrono::steady_clock::now();
+    ProcScanner scan(file);
+    for (; !scan.atEnd(); scan.skipLine()) {
+        DiskDeviceCounters counters;
+        if (parseDiskstatsLine(scan, counters) && !isSkippedDevice(counters.name) && isWholeDisk(counters.name)) {
+            snapshot.devices.push_back(counters);
+        }
+    }
+    snapshot.valid = true;
+#endif
+    return snapshot;
+}
+
+const DiskDeviceCounters* DiskStatsSnapshot::find(const std::string& device) const
+{
+    for (const auto& counters : devices) {
+        if (device == counters.name) {
+            return &counters;
+        }
+    }
+    return nullptr;
+}
+
+namespace DiskStats {
+
+DiskDeviceStats delta(const DiskDeviceCounters& start, const DiskDeviceCounters& end, double seconds)
+{
+    DiskDeviceStats stats;
+    stats.name = end.name;
+    stats.interval_seconds = seconds;
+    stats.reads = deltaOrZero(end.reads_completed, start.reads_completed);
+    stats.writes = deltaOrZero(end.writes_completed, start.writes_completed);
+    stats.flushes = deltaOrZero(end.flushes_completed, start.flushes_completed);
+    uint64_t reads_merged = deltaOrZero(end.reads_merged, start.reads_merged);
+    uint64_t writes_merged = deltaOrZero(end.writes_merged, start.writes_merged);
+    uint64_t read_sectors = deltaOrZero(end.read_sectors, start.read_sectors);
+    uint64_t write_sectors = deltaOrZero(end.write_sectors, start.write_sectors);
+
+    if (stats.reads > 0) {
+        stats.r_await_ms = static_cast<double>(deltaOrZero(end.read_time_ms, start.read_time_ms)) / stats.reads;
+    }
+    if (stats.writes > 0) {
+        stats.w_await_ms = static_cast<double>(deltaOrZero(end.write_time_ms, start.write_time_ms)) / stats.writes;
+    }
+    if (stats.flushes > 0) {
+        stats.flush_await_ms = static_cast<double>(deltaOrZero(end.flush_time_ms, start.flush_time_ms)) / stats.flushes;
+    }
+    if (reads_merged + stats.reads > 0) {
+        stats.read_merge_percent = 100.0 * reads_merged / (reads_merged + stats.reads);
+    }
+    if (writes_merged + stats.writes > 0) {
+        stats.write_merge_percent = 100.0 * writes_merged / (writes_merged + stats.writes);
+    }
+    if (stats.reads + stats.writes > 0) {
+        stats.avg_request_kb = (read_sectors + write_sectors) * 512.0 / 1024.0 / (stats.reads + stats.writes);
+    }
+
+    if (seconds > 0.0) {
+        double interval_ms = seconds * MILLISECONDS_PER_SECOND;
+        stats.read_iops = stats.reads / seconds;
+        stats.write_iops = stats.writes / seconds;
+        stats.read_mbps = read_sectors * 512.0 / (1024.0 * 1024.0) / seconds;
+        stats.write_mbps = write_sectors * 512.0 / (1024.0 * 1024.0) / seconds;
+        stats.avg_queue_depth = deltaOrZero(end.weighted_io_time_ms, start.weighted_io_time_ms) / interval_ms;
+        stats.utilization_percent = std::min(100.0, deltaOrZero(end.io_time_ms, start.io_time_ms) / interval_ms * 100.0);
+    }
+    return stats;
+}
+
+std::string deviceForPath(const std::string& path)
+{
+#ifdef __linux__
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || major(info.st_dev) == 0) {
+        return "";
+    }
+
+    std::string sys_path = "/sys/dev/block/" + std::to_string(major(info.st_dev)) + ":" +
+        std::to_string(minor(info.st_dev));
+    char resolved[PATH_MAX];
+    if (realpath(sys_path.c_str(), resolved) == nullptr) {
+        return "";
+    }
+    std::string device_path = resolved;
+
+    // A partition's sysfs directory sits inside its disk's
+    if (access((device_path + "/partition").c_str(), F_OK) == 0) {
+        device_path = device_path.substr(0, device_path.find_last_of('/'));
+    }
+    return lastPathComponent(device_path);
+#else
+    (void)path;
+    return "";
+#endif
+}
+
+std::string busiestDevice(const DiskStatsSnapshot& start, const DiskStatsSnapshot& end)
+{
+    std::string busiest;
+    uint64_t busiest_time = 0;
+    for (const auto& counters : end.devices) {
+        const DiskDeviceCounters* before = start.find(counters.name);
+        if (before == nullptr) {
+            continue;
+        }
+        uint64_t busy = deltaOrZero(counters.io_time_ms, before->io_time_ms);
+        if (busy > busiest_time) {
+            busiest_time = busy;
+            busiest = counters.name;
+        }
+    }
+    return busiest;
+}
+
+void applyPhase(BenchmarkResult& result, const std::string& phase, const std::string& device,
+    const DiskStatsSnapshot& start, const DiskStatsSnapshot& end, double app_latency_ms, bool read_phase)
+{
+    const DiskDeviceCounters* before = start.find(device);
+    const DiskDeviceCounters* after = end.find(device);
+    if (!start.valid || !end.valid || before == nullptr || after == nullptr) {
+        return;
+    }
+
+    double seconds = std::chrono::duration<double>(end.taken - start.taken).count();
+    DiskDeviceStats stats = delta(*before, *after, seconds);
+    std::string prefix = "device_" + phase + "_";
+    result.extra_metrics[prefix + "reads"] = static_cast<double>(stats.reads);
+    result.extra_metrics[prefix + "writes"] = static_cast<double>(stats.writes);
+    result.extra_metrics[prefix + "read_mbps"] = stats.read_mbps;
+    result.extra_metrics[prefix + "write_mbps"] = stats.write_mbps;
+    result.extra_metrics[prefix + "r_await_ms"] = stats.r_await_ms;
+    result.extra_metrics[prefix + "w_await_ms"] = stats.w_await_ms;
+    result.extra_metrics[prefix + "queue_depth"] = stats.avg_queue_depth;
+    result.extra_metrics[prefix + "util_percent"] = stats.utilization_percent;
+    result.extra_metrics[prefix + "read_merge_percent"] = stats.read_merge_percent;
+    result.extra_metrics[prefix + "write_merge_percent"] = stats.write_merge_percent;
+    result.extra_metrics[prefix + "avg_request_kb"] = stats.avg_request_kb;
+    if (stats.flushes > 0) {
+        result.extra_metrics[prefix + "flush_await_ms"] = stats.flush_await_ms;
+    }
+
+    // Time the application saw beyond the device's own service time was spent
+    // in the page cache, filesystem or block layer above the device
+    double device_latency_ms = read_phase ? stats.r_await_ms : stats.w_await_ms;
+    uint64_t device_ops = read_phase ? stats.reads : stats.writes;
+    result.extra_metrics[phase + "_app_latency_ms"] = app_latency_ms;
+    std::string where;
+    if (device_ops == 0) {
+        where = read_phase ? "page cache (no device reads)" : "page cache (writes not yet flushed)";
+    } else {
+        result.extra_metrics[phase + "_device_latency_ms"] = device_latency_ms;
+        result.extra_metrics[phase + "_latency_gap_ms"] = app_latency_ms - device_latency_ms;
+        if (app_latency_ms > 2.0 * device_latency_ms) {
+            where = "above the device (filesystem/block layer)";
+        } else if (app_latency_ms < 0.5 * device_latency_ms) {
+            // The device was slower than the calls that fed it: writeback or other processes
+            where = "device, shared with background I/O";
+        } else {
+            where = "device";
+        }
+    }
+    result.extra_info["disk." + phase + ".latency_dominated_by"] = where;
+}
+
+}
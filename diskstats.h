@@ -0,0 +1,87 @@
+#ifndef DISKSTATS_H
+#define DISKSTATS_H
+
+#include "benchmark.h"
+#include "proc_reader.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Cumulative counters of one /proc/diskstats line. Times are in milliseconds
+// as the kernel reports them; discard and flush fields are zero on kernels
+// that predate them.
+struct DiskDeviceCounters {
+    static constexpr size_t NAME_LENGTH = 32;
+
+    char name[NAME_LENGTH] {};
+    uint64_t reads_completed { 0 };
+    uint64_t reads_merged { 0 };
+    uint64_t read_sectors { 0 };
+    uint64_t read_time_ms { 0 };
+    uint64_t writes_completed { 0 };
+    uint64_t writes_merged { 0 };
+    uint64_t write_sectors { 0 };
+    uint64_t write_time_ms { 0 };
+    uint64_t in_flight { 0 };
+    uint64_t io_time_ms { 0 };          // time with at least one request in flight
+    uint64_t weighted_io_time_ms { 0 }; // time in flight summed over requests
+    uint64_t discards_completed { 0 };
+    uint64_t discard_time_ms { 0 };
+    uint64_t flushes_completed { 0 };
+    uint64_t flush_time_ms { 0 };
+};
+
+// Parses one line at the scanner's position; the scanner stays on that line
+bool parseDiskstatsLine(ProcScanner& scan, DiskDeviceCounters& counters);
+
+// What a device did between two snapshots, in iostat terms
+struct DiskDeviceStats {
+    std::string name;
+    double interval_seconds { 0.0 };
+    uint64_t reads { 0 };
+    uint64_t writes { 0 };
+    double read_iops { 0.0 };
+    double write_iops { 0.0 };
+    double read_mbps { 0.0 };
+    double write_mbps { 0.0 };
+    double r_await_ms { 0.0 };           // average read service time, queueing included
+    double w_await_ms { 0.0 };
+    double avg_queue_depth { 0.0 };      // aqu-sz: weighted I/O time / interval
+    double utilization_percent { 0.0 };  // share of the interval with I/O in flight
+    double read_merge_percent { 0.0 };   // requests merged into neighbours before dispatch
+    double write_merge_percent { 0.0 };
+    double avg_request_kb { 0.0 };
+    uint64_t flushes { 0 };
+    double flush_await_ms { 0.0 };
+
+    bool idle() const { return reads + writes + flushes == 0; }
+};
+
+// Whole-disk counters (partitions, loop and ram devices skipped) at one instant
+struct DiskStatsSnapshot {
+    bool valid { false };
+    std::chrono::steady_clock::time_point taken {};
+    std::vector<DiskDeviceCounters> devices;
+
+    static DiskStatsSnapshot capture();
+    const DiskDeviceCounters* find(const std::string& device) const;
+};
+
+namespace DiskStats {
+    DiskDeviceStats delta(const DiskDeviceCounters& start, const DiskDeviceCounters& end, double seconds);
+
+    // Whole disk backing the filesystem that holds path ("vda" for a file on
+    // vda1), or "" for filesystems without one (tmpfs, overlay, network)
+    std::string deviceForPath(const std::string& path);
+
+    // The device with the most busy time between the snapshots, or "" if all were idle
+    std::string busiestDevice(const DiskStatsSnapshot& start, const DiskStatsSnapshot& end);
+
+    // Adds device_<phase>_* metrics for device over [start, end], next to the
+    // latency the application observed in the same phase
+    void applyPhase(BenchmarkResult& result, const std::string& phase, const std::string& device,
+        const DiskStatsSnapshot& start, const DiskStatsSnapshot& end, double app_latency_ms, bool read_phase);
+}
+
+#endif
@@ -0,0 +1,697 @@
+#include "extsort_bench.h"
+#include "cgroup.h"
+#include "pipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t RECORD_SIZE = 100;
+constexpr size_t KEY_SIZE = 10;
+constexpr size_t IO_SIZE = 4 * 1024 * 1024; // large sequential reads and writes
+constexpr size_t MIN_MERGE_BLOCK = 64 * 1024;
+constexpr int RUN_BUFFERS = 2; // double buffering between each pair of stages
+constexpr int END_OF_STREAM = -1;
+
+struct SortEntry {
+    uint64_t prefix;
+    uint32_t tail;
+    uint32_t index;
+
+    bool operator<(const SortEntry& other) const
+    {
+        return prefix < other.prefix || (prefix == other.prefix && tail < other.tail);
+    }
+};
+
+// Keys compare as big-endian byte strings: 8-byte prefix plus 2-byte tail
+inline void loadKey(const char* record, uint64_t& prefix, uint32_t& tail)
+{
+    const unsigned char* key = reinterpret_cast<const unsigned char*>(record);
+    prefix = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        prefix = (prefix << 8) | key[i];
+    }
+    tail = (static_cast<uint32_t>(key[8]) << 8) | key[9];
+}
+
+bool preadFully(int fd, char* buffer, size_t length, uint64_t offset)
+{
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool pwriteFully(int fd, const char* buffer, size_t length, uint64_t offset)
+{
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = pwrite(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Writes in IO_SIZE pieces so spills stay large and sequential
+bool writeSequential(int fd, const char* buffer, size_t length, uint64_t offset)
+{
+    for (size_t done = 0; done < length; done += IO_SIZE) {
+        if (!pwriteFully(fd, buffer + done, std::min(IO_SIZE, length - done), offset + done)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void pushBlocking(SpscQueue<T>& queue, const T& value)
+{
+    while (!queue.tryPush(value)) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename T>
+T popBlocking(SpscQueue<T>& queue, uint64_t* stall_ns = nullptr)
+{
+    T value;
+    if (queue.tryPop(value)) {
+        return value;
+    }
+    uint64_t start = pipelineNowNanoseconds();
+    while (!queue.tryPop(value)) {
+        std::this_thread::yield();
+    }
+    if (stall_ns) {
+        *stall_ns += pipelineNowNanoseconds() - start;
+    }
+    return value;
+}
+
+// Drops written data from the page cache so later phases read from the device
+void evictFromPageCache(int fd)
+{
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+uint64_t readMemAvailableBytes()
+{
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        if (line.find("MemAvailable:") == 0) {
+            std::istringstream ss(line);
+            std::string label;
+            uint64_t kb = 0;
+            ss >> label >> kb;
+            return kb * 1024;
+        }
+    }
+    return 0;
+}
+
+// Fraction of the shorter of CPU and I/O time hidden under the other
+double overlapEfficiency(double cpu_seconds, double io_seconds, double wall_seconds)
+{
+    double shorter = std::min(cpu_seconds, io_seconds);
+    if (shorter <= 0.0) {
+        return 0.0;
+    }
+    double overlapped = cpu_seconds + io_seconds - wall_seconds;
+    return std::max(0.0, std::min(1.0, overlapped / shorter));
+}
+
+}
+
+ExternalSortBenchmark::ExternalSortBenchmark()
+    : ExternalSortBenchmark(ExtSortBenchmarkConfig())
+{
+}
+
+ExternalSortBenchmark::ExternalSortBenchmark(const ExtSortBenchmarkConfig& config)
+    : config(config)
+{
+}
+
+ExternalSortBenchmark::PhaseStats ExternalSortBenchmark::generateInput(int fd, uint64_t dataset_bytes)
+{
+    PhaseStats stats;
+    Timer timer;
+    timer.start();
+
+    std::vector<char> buffer(IO_SIZE / RECORD_SIZE * RECORD_SIZE);
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    uint64_t offset = 0;
+    uint64_t record_number = 0;
+
+    while (offset < dataset_bytes) {
+        size_t length = static_cast<size_t>(std::min<uint64_t>(buffer.size(), dataset_bytes - offset));
+        uint64_t cpu_start = pipelineNowNanoseconds();
+        for (size_t pos = 0; pos < length; pos += RECORD_SIZE) {
+            char* record = buffer.data() + pos;
+            for (size_t k = 0; k < KEY_SIZE; k += 8) {
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                memcpy(record + k, &rng, std::min<size_t>(8, KEY_SIZE - k));
+            }
+            memcpy(record + KEY_SIZE, &record_number, sizeof(record_number));
+            memset(record + KEY_SIZE + sizeof(record_number), 'A' + static_cast<char>(record_number % 26),
+                RECORD_SIZE - KEY_SIZE - sizeof(record_number));
+            ++record_number;
+        }
+        uint64_t io_start = pipelineNowNanoseconds();
+        stats.cpu_busy_seconds += (io_start - cpu_start) / NANOSECONDS_PER_SECOND;
+
+        if (!pwriteFully(fd, buffer.data(), length, offset)) {
+            throw std::runtime_error("Failed to write external sort input");
+        }
+        stats.write_busy_seconds += (pipelineNowNanoseconds() - io_start) / NANOSECONDS_PER_SECOND;
+        offset += length;
+    }
+
+    uint64_t sync_start = pipelineNowNanoseconds();
+    evictFromPageCache(fd);
+    stats.write_busy_seconds += (pipelineNowNanoseconds() - sync_start) / NANOSECONDS_PER_SECOND;
+    stats.bytes_written = dataset_bytes;
+    stats.wall_seconds = timer.elapsedSeconds();
+    return stats;
+}
+
+ExternalSortBenchmark::PhaseStats ExternalSortBenchmark::formRuns(int input_fd, int runs_fd, uint64_t dataset_bytes,
+    size_t chunk_bytes, int threads, std::vector<RunExtent>& runs)
+{
+    PhaseStats stats;
+    Timer timer;
+    timer.start();
+
+    struct Chunk {
+        std::vector<char> data;
+        size_t length { 0 };
+    };
+    std::vector<Chunk> inputs(RUN_BUFFERS);
+    std::vector<Chunk> outputs(RUN_BUFFERS);
+    for (int i = 0; i < RUN_BUFFERS; ++i) {
+        inputs[i].data.resize(chunk_bytes);
+        outputs[i].data.resize(chunk_bytes);
+    }
+
+    // Reader -> sorter -> writer, each handing buffer indices through SPSC queues
+    SpscQueue<int> free_inputs(RUN_BUFFERS * 2);
+    SpscQueue<int> full_inputs(RUN_BUFFERS * 2);
+    SpscQueue<int> free_outputs(RUN_BUFFERS * 2);
+    SpscQueue<int> full_outputs(RUN_BUFFERS * 2);
+    for (int i = 0; i < RUN_BUFFERS; ++i) {
+        free_inputs.tryPush(i);
+        free_outputs.tryPush(i);
+    }
+
+    std::atomic<bool> io_failed(false);
+    uint64_t read_busy_ns = 0;
+    uint64_t write_busy_ns = 0;
+
+    std::thread reader([&]() {
+        uint64_t offset = 0;
+        while (offset < dataset_bytes && !io_failed.load()) {
+            int index = popBlocking(free_inputs);
+            Chunk& chunk = inputs[index];
+            chunk.length = static_cast<size_t>(std::min<uint64_t>(chunk.data.size(), dataset_bytes - offset));
+            uint64_t start = pipelineNowNanoseconds();
+            for (size_t done = 0; done < chunk.length; done += IO_SIZE) {
+                if (!preadFully(input_fd, chunk.data.data() + done, std::min(IO_SIZE, chunk.length - done), offset + done)) {
+                    io_failed.store(true);
+                    break;
+                }
+            }
+            read_busy_ns += pipelineNowNanoseconds() - start;
+            offset += chunk.length;
+            pushBlocking(full_inputs, index);
+        }
+        pushBlocking(full_inputs, END_OF_STREAM);
+    });
+
+    std::thread writer([&]() {
+        uint64_t offset = 0;
+        while (true) {
+            int index = popBlocking(full_outputs);
+            if (index == END_OF_STREAM) {
+                break;
+            }
+            Chunk& chunk = outputs[index];
+            uint64_t start = pipelineNowNanoseconds();
+            if (!writeSequential(runs_fd, chunk.data.data(), chunk.length, offset)) {
+                io_failed.store(true);
+            }
+            write_busy_ns += pipelineNowNanoseconds() - start;
+            runs.push_back(RunExtent { offset, chunk.length });
+            offset += chunk.length;
+            pushBlocking(free_outputs, index);
+        }
+        uint64_t start = pipelineNowNanoseconds();
+        evictFromPageCache(runs_fd);
+        write_busy_ns += pipelineNowNanoseconds() - start;
+    });
+
+    // Sort on this thread plus helpers: slices are sorted in parallel, then merged pairwise
+    std::vector<SortEntry> entries;
+    uint64_t sort_busy_ns = 0;
+    uint64_t stall_ns = 0;
+    while (true) {
+        int input_index = popBlocking(full_inputs, &stall_ns);
+        if (input_index == END_OF_STREAM) {
+            break;
+        }
+        uint64_t start = pipelineNowNanoseconds();
+        Chunk& input = inputs[input_index];
+        size_t records = input.length / RECORD_SIZE;
+        entries.resize(records);
+        for (size_t i = 0; i < records; ++i) {
+            loadKey(input.data.data() + i * RECORD_SIZE, entries[i].prefix, entries[i].tail);
+            entries[i].index = static_cast<uint32_t>(i);
+        }
+
+        size_t slice_count = std::max<size_t>(1, std::min<size_t>(threads, records / 1024 + 1));
+        std::vector<size_t> bounds(slice_count + 1);
+        for (size_t s = 0; s <= slice_count; ++s) {
+            bounds[s] = records * s / slice_count;
+        }
+        std::vector<std::thread> sorters;
+        for (size_t s = 1; s < slice_count; ++s) {
+            sorters.emplace_back([&, s]() { std::sort(entries.begin() + bounds[s], entries.begin() + bounds[s + 1]); });
+        }
+        std::sort(entries.begin() + bounds[0], entries.begin() + bounds[1]);
+        for (auto& t : sorters) {
+            t.join();
+        }
+        for (size_t width = 1; width < slice_count; width *= 2) {
+            std::vector<std::thread> mergers;
+            for (size_t s = 0; s + width < slice_count; s += 2 * width) {
+                size_t first = bounds[s];
+                size_t middle = bounds[s + width];
+                size_t last = bounds[std::min(slice_count, s + 2 * width)];
+                mergers.emplace_back([&entries, first, middle, last]() {
+                    std::inplace_merge(entries.begin() + first, entries.begin() + middle, entries.begin() + last);
+                });
+            }
+            for (auto& t : mergers) {
+                t.join();
+            }
+        }
+        sort_busy_ns += pipelineNowNanoseconds() - start;
+
+        int output_index = popBlocking(free_outputs, &stall_ns);
+        start = pipelineNowNanoseconds();
+        Chunk& output = outputs[output_index];
+        for (size_t i = 0; i < records; ++i) {
+            memcpy(output.data.data() + i * RECORD_SIZE, input.data.data() + entries[i].index * RECORD_SIZE, RECORD_SIZE);
+        }
+        output.length = records * RECORD_SIZE;
+        sort_busy_ns += pipelineNowNanoseconds() - start;
+
+        pushBlocking(free_inputs, input_index);
+        pushBlocking(full_outputs, output_index);
+    }
+    pushBlocking(full_outputs, END_OF_STREAM);
+
+    reader.join();
+    writer.join();
+    if (io_failed.load()) {
+        throw std::runtime_error("External sort run formation I/O failed");
+    }
+
+    stats.wall_seconds = timer.elapsedSeconds();
+    stats.cpu_busy_seconds = sort_busy_ns / NANOSECONDS_PER_SECOND;
+    stats.cpu_stall_seconds = stall_ns / NANOSECONDS_PER_SECOND;
+    stats.read_busy_seconds = read_busy_ns / NANOSECONDS_PER_SECOND;
+    stats.write_busy_seconds = write_busy_ns / NANOSECONDS_PER_SECOND;
+    stats.bytes_read = dataset_bytes;
+    stats.bytes_written = dataset_bytes;
+    return stats;
+}
+
+ExternalSortBenchmark::PhaseStats ExternalSortBenchmark::mergeRuns(int runs_fd, int output_fd,
+    const std::vector<RunExtent>& runs, size_t budget_bytes, uint64_t& records_out, bool& sorted)
+{
+    PhaseStats stats;
+    Timer timer;
+    timer.start();
+
+    // Two readahead blocks per run plus two output blocks share the budget
+    size_t block_bytes = budget_bytes / (2 * runs.size() + 2);
+    block_bytes = std::max(MIN_MERGE_BLOCK, block_bytes / RECORD_SIZE * RECORD_SIZE);
+
+    struct RunCursor {
+        uint64_t next_offset { 0 };
+        uint64_t end { 0 };
+        std::vector<char> blocks[2];
+        size_t block_length[2] { 0, 0 };
+        uint64_t block_offset[2] { 0, 0 };
+        bool requested[2] { false, false };
+        std::atomic<bool> ready[2];
+        int current { 0 };
+        size_t position { 0 };
+    };
+    std::vector<std::unique_ptr<RunCursor>> cursors;
+
+    // A single readahead thread keeps per-run block order
+    MpmcQueue<uint32_t> requests(roundUpToPowerOfTwo(runs.size() * 2 + 2));
+    std::atomic<bool> merge_done(false);
+    std::atomic<bool> io_failed(false);
+    uint64_t read_busy_ns = 0;
+
+    std::thread prefetcher([&]() {
+        while (true) {
+            uint32_t request = 0;
+            if (!requests.tryPop(request)) {
+                if (merge_done.load(std::memory_order_acquire)) {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            RunCursor& cursor = *cursors[request / 2];
+            int block = static_cast<int>(request % 2);
+            uint64_t start = pipelineNowNanoseconds();
+            if (!preadFully(runs_fd, cursor.blocks[block].data(), cursor.block_length[block], cursor.block_offset[block])) {
+                io_failed.store(true);
+            }
+            read_busy_ns += pipelineNowNanoseconds() - start;
+            cursor.ready[block].store(true, std::memory_order_release);
+        }
+    });
+
+    auto issue = [&](uint32_t run, int block) {
+        RunCursor& cursor = *cursors[run];
+        cursor.block_offset[block] = cursor.next_offset;
+        cursor.block_length[block] = static_cast<size_t>(std::min<uint64_t>(block_bytes, cursor.end - cursor.next_offset));
+        cursor.next_offset += cursor.block_length[block];
+        cursor.requested[block] = true;
+        cursor.ready[block].store(false, std::memory_order_relaxed);
+        while (!requests.tryPush(run * 2 + static_cast<uint32_t>(block))) {
+            std::this_thread::yield();
+        }
+    };
+
+    uint64_t stall_ns = 0;
+    auto waitReady = [&](RunCursor& cursor, int block) {
+        if (cursor.ready[block].load(std::memory_order_acquire)) {
+            return;
+        }
+        uint64_t start = pipelineNowNanoseconds();
+        while (!cursor.ready[block].load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        stall_ns += pipelineNowNanoseconds() - start;
+    };
+
+    for (uint32_t r = 0; r < runs.size(); ++r) {
+        cursors.emplace_back(new RunCursor());
+        RunCursor& cursor = *cursors.back();
+        cursor.next_offset = runs[r].offset;
+        cursor.end = runs[r].offset + runs[r].length;
+        cursor.ready[0].store(false);
+        cursor.ready[1].store(false);
+        cursor.blocks[0].resize(block_bytes);
+        cursor.blocks[1].resize(block_bytes);
+    }
+    for (uint32_t r = 0; r < runs.size(); ++r) {
+        for (int b = 0; b < 2 && cursors[r]->next_offset < cursors[r]->end; ++b) {
+            issue(r, b);
+        }
+    }
+
+    // Output is double-buffered to a writer thread
+    std::vector<std::vector<char>> out_blocks(RUN_BUFFERS, std::vector<char>(block_bytes));
+    std::vector<size_t> out_lengths(RUN_BUFFERS, 0);
+    SpscQueue<int> free_out(RUN_BUFFERS * 2);
+    SpscQueue<int> full_out(RUN_BUFFERS * 2);
+    for (int i = 0; i < RUN_BUFFERS; ++i) {
+        free_out.tryPush(i);
+    }
+    uint64_t write_busy_ns = 0;
+    uint64_t bytes_written = 0;
+
+    std::thread writer([&]() {
+        while (true) {
+            int index = popBlocking(full_out);
+            if (index == END_OF_STREAM) {
+                break;
+            }
+            uint64_t start = pipelineNowNanoseconds();
+            if (!writeSequential(output_fd, out_blocks[index].data(), out_lengths[index], bytes_written)) {
+                io_failed.store(true);
+            }
+            write_busy_ns += pipelineNowNanoseconds() - start;
+            bytes_written += out_lengths[index];
+            pushBlocking(free_out, index);
+        }
+        uint64_t start = pipelineNowNanoseconds();
+        fdatasync(output_fd);
+        write_busy_ns += pipelineNowNanoseconds() - start;
+    });
+
+    struct HeapEntry {
+        uint64_t prefix;
+        uint32_t tail;
+        uint32_t run;
+        bool operator>(const HeapEntry& other) const
+        {
+            return prefix > other.prefix || (prefix == other.prefix && tail > other.tail);
+        }
+    };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+
+    for (uint32_t r = 0; r < runs.size(); ++r) {
+        RunCursor& cursor = *cursors[r];
+        if (!cursor.requested[0]) {
+            continue;
+        }
+        waitReady(cursor, 0);
+        HeapEntry entry { 0, 0, r };
+        loadKey(cursor.blocks[0].data(), entry.prefix, entry.tail);
+        heap.push(entry);
+    }
+
+    uint64_t merge_start = pipelineNowNanoseconds();
+    int out_index = popBlocking(free_out, &stall_ns);
+    size_t out_pos = 0;
+    uint64_t previous_prefix = 0;
+    uint32_t previous_tail = 0;
+    records_out = 0;
+    sorted = true;
+
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+        RunCursor& cursor = *cursors[top.run];
+        const char* record = cursor.blocks[cursor.current].data() + cursor.position;
+
+        if (records_out > 0 && (top.prefix < previous_prefix || (top.prefix == previous_prefix && top.tail < previous_tail))) {
+            sorted = false;
+        }
+        previous_prefix = top.prefix;
+        previous_tail = top.tail;
+
+        memcpy(out_blocks[out_index].data() + out_pos, record, RECORD_SIZE);
+        out_pos += RECORD_SIZE;
+        ++records_out;
+        if (out_pos + RECORD_SIZE > block_bytes) {
+            out_lengths[out_index] = out_pos;
+            pushBlocking(full_out, out_index);
+            out_index = popBlocking(free_out, &stall_ns);
+            out_pos = 0;
+        }
+
+        // Advance the run, recycling its drained block for the next readahead
+        cursor.position += RECORD_SIZE;
+        if (cursor.position >= cursor.block_length[cursor.current]) {
+            int drained = cursor.current;
+            cursor.requested[drained] = false;
+            if (cursor.next_offset < cursor.end) {
+                issue(top.run, drained);
+            }
+            cursor.current ^= 1;
+            cursor.position = 0;
+            if (!cursor.requested[cursor.current]) {
+                continue;
+            }
+            waitReady(cursor, cursor.current);
+        }
+        HeapEntry next { 0, 0, top.run };
+        loadKey(cursor.blocks[cursor.current].data() + cursor.position, next.prefix, next.tail);
+        heap.push(next);
+    }
+
+    if (out_pos > 0) {
+        out_lengths[out_index] = out_pos;
+        pushBlocking(full_out, out_index);
+    }
+    pushBlocking(full_out, END_OF_STREAM);
+    uint64_t merge_end = pipelineNowNanoseconds();
+
+    merge_done.store(true, std::memory_order_release);
+    prefetcher.join();
+    writer.join();
+    if (io_failed.load()) {
+        throw std::runtime_error("External sort merge I/O failed");
+    }
+
+    uint64_t total_bytes = 0;
+    for (const auto& run : runs) {
+        total_bytes += run.length;
+    }
+    stats.wall_seconds = timer.elapsedSeconds();
+    stats.cpu_stall_seconds = stall_ns / NANOSECONDS_PER_SECOND;
+    stats.cpu_busy_seconds = std::max<double>(0.0, (merge_end - merge_start) / NANOSECONDS_PER_SECOND - stats.cpu_stall_seconds);
+    stats.read_busy_seconds = read_busy_ns / NANOSECONDS_PER_SECOND;
+    stats.write_busy_seconds = write_busy_ns / NANOSECONDS_PER_SECOND;
+    stats.bytes_read = total_bytes;
+    stats.bytes_written = bytes_written;
+    return stats;
+}
+
+BenchmarkResult ExternalSortBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)duration_seconds;
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    std::string base = config.directory + "/extsort_" + std::to_string(getpid());
+    std::string input_path = base + "_input.dat";
+    std::string runs_path = base + "_runs.dat";
+    std::string output_path = base + "_output.dat";
+    int input_fd = -1;
+    int runs_fd = -1;
+    int output_fd = -1;
+
+    auto cleanup = [&]() {
+        for (int* fd : { &input_fd, &runs_fd, &output_fd }) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+        unlink(input_path.c_str());
+        unlink(runs_path.c_str());
+        unlink(output_path.c_str());
+    };
+
+    try {
+        uint64_t budget_bytes = config.memory_budget_mb > 0 ? config.memory_budget_mb * 1024ULL * 1024ULL : readMemAvailableBytes();
+        budget_bytes = Cgroup::fitWorkingSet(budget_bytes);
+        if (budget_bytes < 4 * 1024 * 1024) {
+            throw std::runtime_error("External sort memory budget is too small");
+        }
+        uint64_t dataset_bytes = static_cast<uint64_t>(budget_bytes * std::max(1.0, config.dataset_factor));
+        dataset_bytes = dataset_bytes / RECORD_SIZE * RECORD_SIZE;
+        int threads = config.threads > 0 ? config.threads : Cgroup::effectiveCpuCount();
+
+        // Two input and two output chunks plus the sort index fit in the budget
+        size_t chunk_bytes = static_cast<size_t>(budget_bytes / 5 / RECORD_SIZE * RECORD_SIZE);
+
+        input_fd = open(input_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        runs_fd = open(runs_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        output_fd = open(output_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (input_fd < 0 || runs_fd < 0 || output_fd < 0) {
+            throw std::runtime_error("Failed to create external sort files in " + config.directory);
+        }
+
+        if (verbose) {
+            std::cout << "  Generating " << dataset_bytes / (1024 * 1024) << " MB for a "
+                      << budget_bytes / (1024 * 1024) << " MB budget...\n";
+        }
+        PhaseStats generate = generateInput(input_fd, dataset_bytes);
+
+        if (verbose) {
+            std::cout << "  Forming sorted runs...\n";
+        }
+        std::vector<RunExtent> runs;
+        PhaseStats run_phase = formRuns(input_fd, runs_fd, dataset_bytes, chunk_bytes, threads, runs);
+
+        if (verbose) {
+            std::cout << "  Merging " << runs.size() << " runs...\n";
+        }
+        uint64_t records_out = 0;
+        bool sorted = false;
+        PhaseStats merge_phase = mergeRuns(runs_fd, output_fd, runs, static_cast<size_t>(budget_bytes), records_out, sorted);
+
+        uint64_t records_in = dataset_bytes / RECORD_SIZE;
+        if (records_out != records_in || !sorted) {
+            throw std::runtime_error("External sort output failed verification");
+        }
+
+        double sort_seconds = run_phase.wall_seconds + merge_phase.wall_seconds;
+        double dataset_mb = dataset_bytes / (1024.0 * 1024.0);
+
+        result.throughput = sort_seconds > 0.0 ? dataset_mb / sort_seconds : 0.0;
+        result.throughput_unit = "MB/s";
+        result.avg_latency = sort_seconds;
+        result.min_latency = std::min(run_phase.wall_seconds, merge_phase.wall_seconds);
+        result.max_latency = std::max(run_phase.wall_seconds, merge_phase.wall_seconds);
+        result.p50_latency = sort_seconds;
+        result.p90_latency = sort_seconds;
+        result.p99_latency = sort_seconds;
+        result.latency_unit = "s";
+
+        result.extra_metrics["work_ops"] = static_cast<double>(records_in);
+        result.extra_metrics["work_bytes"] = static_cast<double>(dataset_bytes);
+        result.extra_metrics["extsort_dataset_mb"] = dataset_mb;
+        result.extra_metrics["extsort_memory_budget_mb"] = budget_bytes / (1024.0 * 1024.0);
+        result.extra_metrics["extsort_dataset_factor"] = dataset_bytes / static_cast<double>(budget_bytes);
+        result.extra_metrics["extsort_records"] = static_cast<double>(records_in);
+        result.extra_metrics["extsort_runs"] = static_cast<double>(runs.size());
+        result.extra_metrics["extsort_threads"] = threads;
+        result.extra_metrics["extsort_total_seconds"] = sort_seconds;
+        result.extra_metrics["extsort_records_sec"] = sort_seconds > 0.0 ? records_in / sort_seconds : 0.0;
+        result.extra_metrics["extsort_generate_seconds"] = generate.wall_seconds;
+
+        double total_cpu = 0.0;
+        double total_io = 0.0;
+        for (const auto& phase : { std::make_pair("run", &run_phase), std::make_pair("merge", &merge_phase) }) {
+            const PhaseStats& stats = *phase.second;
+            std::string prefix = std::string("extsort_") + phase.first + "_";
+            double io_seconds = stats.read_busy_seconds + stats.write_busy_seconds;
+            result.extra_metrics[prefix + "seconds"] = stats.wall_seconds;
+            result.extra_metrics[prefix + "cpu_busy_seconds"] = stats.cpu_busy_seconds;
+            result.extra_metrics[prefix + "cpu_stall_seconds"] = stats.cpu_stall_seconds;
+            result.extra_metrics[prefix + "read_busy_seconds"] = stats.read_busy_seconds;
+            result.extra_metrics[prefix + "write_busy_seconds"] = stats.write_busy_seconds;
+            result.extra_metrics[prefix + "read_mbps"] = stats.read_busy_seconds > 0.0 ? stats.bytes_read / (1024.0 * 1024.0) / stats.read_busy_seconds : 0.0;
+            result.extra_metrics[prefix + "write_mbps"] = stats.write_busy_seconds > 0.0 ? stats.bytes_written / (1024.0 * 1024.0) / stats.write_busy_seconds : 0.0;
+            result.extra_metrics[prefix + "overlap_efficiency"] = overlapEfficiency(stats.cpu_busy_seconds, io_seconds, stats.wall_seconds);
+            total_cpu += stats.cpu_busy_seconds;
+            total_io += io_seconds;
+        }
+        result.extra_metrics["extsort_overlap_efficiency"] = overlapEfficiency(total_cpu, total_io, sort_seconds);
+        result.extra_info["extsort.verified"] = "true";
+        result.extra_info["extsort.record_format"] = "100B records, 10B keys";
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    cleanup();
+    return result;
+}
@@ -0,0 +1,53 @@
+#ifndef EXTSORT_BENCH_H
+#define EXTSORT_BENCH_H
+
+#include "benchmark.h"
+#include "utils.h"
+#include <string>
+#include <vector>
+
+struct ExtSortBenchmarkConfig {
+    size_t memory_budget_mb { 64 }; // 0 = MemAvailable from /proc/meminfo
+    double dataset_factor { 4.0 }; // dataset size as a multiple of the memory budget
+    int threads { 0 }; // sort threads, 0 = one per available core
+    std::string directory { "/tmp" };
+};
+
+// Batch-style external merge sort of 100-byte records (10-byte keys) over a
+// dataset several times larger than its memory budget: parallel in-memory sort
+// of budget-sized chunks spilled as sorted runs, then a k-way merge that reads
+// every run through double-buffered readahead.
+class ExternalSortBenchmark : public Benchmark {
+private:
+    struct PhaseStats {
+        double wall_seconds { 0.0 };
+        double cpu_busy_seconds { 0.0 };
+        double read_busy_seconds { 0.0 };
+        double write_busy_seconds { 0.0 };
+        double cpu_stall_seconds { 0.0 }; // CPU stage waiting on I/O
+        uint64_t bytes_read { 0 };
+        uint64_t bytes_written { 0 };
+    };
+
+    struct RunExtent {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    ExtSortBenchmarkConfig config;
+
+    PhaseStats generateInput(int fd, uint64_t dataset_bytes);
+    PhaseStats formRuns(int input_fd, int runs_fd, uint64_t dataset_bytes, size_t chunk_bytes, int threads,
+        std::vector<RunExtent>& runs);
+    PhaseStats mergeRuns(int runs_fd, int output_fd, const std::vector<RunExtent>& runs, size_t budget_bytes,
+        uint64_t& records_out, bool& sorted);
+
+public:
+    ExternalSortBenchmark();
+    explicit ExternalSortBenchmark(const ExtSortBenchmarkConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "External Sort"; }
+};
+
+#endif
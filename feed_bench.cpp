@@ -0,0 +1,572 @@
+#include "feed_bench.h"
+#include "pipeline.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+constexpr const char* MULTICAST_GROUP = "239.255.0.1";
+constexpr int BOOK_LEVELS = 4096;
+constexpr int MAX_ACTIVE_ORDERS = 50000;
+constexpr size_t DECISION_RING_CAPACITY = 65536;
+constexpr int HANDLER_IDLE_EXIT_MS = 50;
+constexpr uint64_t SPIN_THRESHOLD_NS = 50000;
+
+enum MessageType : uint8_t {
+    MSG_ADD = 'A',
+    MSG_CANCEL = 'X',
+    MSG_EXECUTE = 'E'
+};
+
+enum Side : uint8_t {
+    SIDE_BID = 'B',
+    SIDE_ASK = 'S'
+};
+
+// Wire layout, little-endian, no padding on the wire
+struct PacketHeader {
+    uint64_t sequence;
+    uint64_t tick_ns;
+    uint16_t count;
+    uint16_t reserved;
+};
+
+struct OrderMessage {
+    uint8_t type;
+    uint8_t side;
+    uint16_t reserved;
+    uint32_t quantity;
+    int32_t price;
+    uint64_t order_id;
+};
+
+constexpr size_t HEADER_WIRE_SIZE = 8 + 8 + 2 + 2;
+constexpr size_t MESSAGE_WIRE_SIZE = 1 + 1 + 2 + 4 + 4 + 8;
+
+void encodeHeader(char* out, const PacketHeader& header)
+{
+    memcpy(out, &header.sequence, 8);
+    memcpy(out + 8, &header.tick_ns, 8);
+    memcpy(out + 16, &header.count, 2);
+    memcpy(out + 18, &header.reserved, 2);
+}
+
+void decodeHeader(const char* in, PacketHeader& header)
+{
+    memcpy(&header.sequence, in, 8);
+    memcpy(&header.tick_ns, in + 8, 8);
+    memcpy(&header.count, in + 16, 2);
+    memcpy(&header.reserved, in + 18, 2);
+}
+
+void encodeMessage(char* out, const OrderMessage& message)
+{
+    out[0] = static_cast<char>(message.type);
+    out[1] = static_cast<char>(message.side);
+    memcpy(out + 2, &message.reserved, 2);
+    memcpy(out + 4, &message.quantity, 4);
+    memcpy(out + 8, &message.price, 4);
+    memcpy(out + 12, &message.order_id, 8);
+}
+
+void decodeMessage(const char* in, OrderMessage& message)
+{
+    message.type = static_cast<uint8_t>(in[0]);
+    message.side = static_cast<uint8_t>(in[1]);
+    memcpy(&message.reserved, in + 2, 2);
+    memcpy(&message.quantity, in + 4, 4);
+    memcpy(&message.price, in + 8, 4);
+    memcpy(&message.order_id, in + 12, 8);
+}
+
+struct Decision {
+    uint64_t sequence { 0 };
+    uint64_t tick_ns { 0 };
+    int8_t action { 0 }; // -1 sell, 0 hold, +1 buy
+    int32_t price { 0 };
+};
+
+// Aggregated price-level book with per-order state for cancels and executions
+class OrderBook {
+private:
+    struct Order {
+        uint8_t side;
+        int32_t price;
+        uint32_t quantity;
+    };
+
+    std::vector<uint64_t> bid_levels;
+    std::vector<uint64_t> ask_levels;
+    std::unordered_map<uint64_t, Order> orders;
+    int best_bid { -1 };
+    int best_ask { BOOK_LEVELS };
+
+    void reduce(Order& order, uint32_t quantity)
+    {
+        quantity = std::min(quantity, order.quantity);
+        order.quantity -= quantity;
+        if (order.side == SIDE_BID) {
+            bid_levels[order.price] -= quantity;
+            while (best_bid >= 0 && bid_levels[best_bid] == 0) {
+                --best_bid;
+            }
+        } else {
+            ask_levels[order.price] -= quantity;
+            while (best_ask < BOOK_LEVELS && ask_levels[best_ask] == 0) {
+                ++best_ask;
+            }
+        }
+    }
+
+public:
+    OrderBook()
+        : bid_levels(BOOK_LEVELS, 0)
+        , ask_levels(BOOK_LEVELS, 0)
+    {
+        orders.reserve(MAX_ACTIVE_ORDERS * 2);
+    }
+
+    void apply(const OrderMessage& message)
+    {
+        if (message.type == MSG_ADD) {
+            if (message.price < 0 || message.price >= BOOK_LEVELS) {
+                return;
+            }
+            orders[message.order_id] = Order { message.side, message.price, message.quantity };
+            if (message.side == SIDE_BID) {
+                bid_levels[message.price] += message.quantity;
+                best_bid = std::max(best_bid, message.price);
+            } else {
+                ask_levels[message.price] += message.quantity;
+                best_ask = std::min(best_ask, message.price);
+            }
+            return;
+        }
+
+        auto it = orders.find(message.order_id);
+        if (it == orders.end()) {
+            return;
+        }
+        uint32_t quantity = message.type == MSG_CANCEL ? it->second.quantity : message.quantity;
+        reduce(it->second, quantity);
+        if (it->second.quantity == 0) {
+            orders.erase(it);
+        }
+    }
+
+    Decision decide() const
+    {
+        Decision decision;
+        if (best_bid < 0 || best_ask >= BOOK_LEVELS) {
+            return decision;
+        }
+        double bid_qty = static_cast<double>(bid_levels[best_bid]);
+        double ask_qty = static_cast<double>(ask_levels[best_ask]);
+        double imbalance = (bid_qty - ask_qty) / std::max(1.0, bid_qty + ask_qty);
+        if (imbalance > 0.6) {
+            decision.action = 1;
+            decision.price = best_ask;
+        } else if (imbalance < -0.6) {
+            decision.action = -1;
+            decision.price = best_bid;
+        } else {
+            decision.price = (best_bid + best_ask) / 2;
+        }
+        return decision;
+    }
+};
+
+// Synthetic exchange: random-walk mid price with adds, cancels and executions
+class OrderFlowGenerator {
+private:
+    struct ActiveOrder {
+        uint64_t id;
+        uint8_t side;
+        int32_t price;
+        uint32_t quantity;
+    };
+
+    std::vector<ActiveOrder> active;
+    uint64_t next_order_id { 1 };
+    int32_t mid { BOOK_LEVELS / 2 };
+    uint64_t rng { 0x2545F4914F6CDD1DULL };
+
+    uint64_t nextRandom()
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return rng;
+    }
+
+public:
+    OrderFlowGenerator() { active.reserve(MAX_ACTIVE_ORDERS + 1); }
+
+    OrderMessage next()
+    {
+        OrderMessage message {};
+        uint64_t roll = nextRandom() % 100;
+        bool must_add = active.size() < 64;
+        bool must_remove = active.size() >= MAX_ACTIVE_ORDERS;
+
+        if (must_add || (!must_remove && roll < 60)) {
+            if (nextRandom() % 8 == 0) {
+                mid += static_cast<int32_t>(nextRandom() % 3) - 1;
+                mid = std::max(64, std::min(BOOK_LEVELS - 64, mid));
+            }
+            ActiveOrder order;
+            order.id = next_order_id++;
+            order.side = (nextRandom() & 1) ? SIDE_BID : SIDE_ASK;
+            int32_t distance = 1 + static_cast<int32_t>(nextRandom() % 16);
+            order.price = order.side == SIDE_BID ? mid - distance : mid + distance;
+            order.quantity = 100 * (1 + static_cast<uint32_t>(nextRandom() % 10));
+            active.push_back(order);
+
+            message.type = MSG_ADD;
+            message.side = order.side;
+            message.price = order.price;
+            message.quantity = order.quantity;
+            message.order_id = order.id;
+            return message;
+        }
+
+        size_t index = nextRandom() % active.size();
+        ActiveOrder& order = active[index];
+        message.side = order.side;
+        message.price = order.price;
+        message.order_id = order.id;
+
+        if (must_remove || roll < 90) {
+            message.type = MSG_CANCEL;
+            message.quantity = order.quantity;
+            order.quantity = 0;
+        } else {
+            message.type = MSG_EXECUTE;
+            message.quantity = std::min<uint32_t>(order.quantity, 100);
+            order.quantity -= message.quantity;
+        }
+
+        if (order.quantity == 0) {
+            active[index] = active.back();
+            active.pop_back();
+        }
+        return message;
+    }
+};
+
+}
+
+FeedHandlerBenchmark::FeedHandlerBenchmark()
+    : FeedHandlerBenchmark(FeedBenchmarkConfig())
+{
+}
+
+FeedHandlerBenchmark::FeedHandlerBenchmark(const FeedBenchmarkConfig& config)
+    : config(config)
+{
+}
+
+FeedHandlerBenchmark::RateStepResult FeedHandlerBenchmark::runRateStep(double rate, int duration_seconds, bool& used_multicast)
+{
+    RateStepResult step;
+    step.offered_rate = rate;
+
+    const int messages_per_packet = std::max(1, config.messages_per_packet);
+    const size_t packet_size = HEADER_WIRE_SIZE + MESSAGE_WIRE_SIZE * messages_per_packet;
+
+    int recv_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int send_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (recv_fd < 0 || send_fd < 0) {
+        if (recv_fd >= 0)
+            close(recv_fd);
+        if (send_fd >= 0)
+            close(send_fd);
+        throw std::runtime_error("Failed to create feed sockets");
+    }
+
+    int opt = 1;
+    setsockopt(recv_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct timeval timeout { 0, 10000 };
+    setsockopt(recv_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    sockaddr_in bind_addr;
+    memset(&bind_addr, 0, sizeof(bind_addr));
+    bind_addr.sin_family = AF_INET;
+    bind_addr.sin_port = htons(static_cast<uint16_t>(config.port));
+    bind_addr.sin_addr.s_addr = htonl(config.multicast ? INADDR_ANY : INADDR_LOOPBACK);
+    if (bind(recv_fd, reinterpret_cast<sockaddr*>(&bind_addr), sizeof(bind_addr)) < 0) {
+        close(recv_fd);
+        close(send_fd);
+        throw std::runtime_error("Failed to bind feed handler to port " + std::to_string(config.port));
+    }
+
+    sockaddr_in dest_addr = bind_addr;
+    dest_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    used_multicast = false;
+    if (config.multicast) {
+        ip_mreq membership;
+        inet_pton(AF_INET, MULTICAST_GROUP, &membership.imr_multiaddr);
+        membership.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+        in_addr loopback_if;
+        loopback_if.s_addr = htonl(INADDR_LOOPBACK);
+        unsigned char loop = 1;
+        if (setsockopt(recv_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) == 0 &&
+            setsockopt(send_fd, IPPROTO_IP, IP_MULTICAST_IF, &loopback_if, sizeof(loopback_if)) == 0 &&
+            setsockopt(send_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0) {
+            dest_addr.sin_addr = membership.imr_multiaddr;
+            used_multicast = true;
+        }
+    }
+
+    SpscQueue<Decision> decision_ring(DECISION_RING_CAPACITY);
+    std::atomic<bool> publisher_done(false);
+    std::atomic<bool> handler_done(false);
+    std::atomic<uint64_t> gaps(0);
+    std::atomic<uint64_t> ring_overflows(0);
+    uint64_t ticks_sent = 0;
+    double publish_seconds = 0.0;
+
+    // Handler: decode, update the book, decide, publish the decision on the ring
+    std::thread handler([&]() {
+        OrderBook book;
+        std::vector<char> packet(packet_size + 64);
+        uint64_t expected_sequence = 0;
+        uint64_t idle_since = pipelineNowNanoseconds();
+
+        while (true) {
+            ssize_t n = recv(recv_fd, packet.data(), packet.size(), 0);
+            if (n < static_cast<ssize_t>(HEADER_WIRE_SIZE)) {
+                uint64_t now = pipelineNowNanoseconds();
+                if (publisher_done.load(std::memory_order_acquire) &&
+                    now - idle_since >= static_cast<uint64_t>(HANDLER_IDLE_EXIT_MS) * 1000000ULL) {
+                    break;
+                }
+                continue;
+            }
+            idle_since = pipelineNowNanoseconds();
+
+            PacketHeader header;
+            decodeHeader(packet.data(), header);
+            if (header.sequence > expected_sequence) {
+                gaps.fetch_add(header.sequence - expected_sequence, std::memory_order_relaxed);
+            }
+            expected_sequence = header.sequence + 1;
+
+            size_t count = std::min<size_t>(header.count, (n - HEADER_WIRE_SIZE) / MESSAGE_WIRE_SIZE);
+            for (size_t i = 0; i < count; ++i) {
+                OrderMessage message;
+                decodeMessage(packet.data() + HEADER_WIRE_SIZE + i * MESSAGE_WIRE_SIZE, message);
+                book.apply(message);
+            }
+
+            Decision decision = book.decide();
+            decision.sequence = header.sequence;
+            decision.tick_ns = header.tick_ns;
+            if (!decision_ring.tryPush(decision)) {
+                ring_overflows.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        handler_done.store(true, std::memory_order_release);
+    });
+
+    // Gateway: consumes decisions and measures tick-to-decision latency
+    SampleReservoir latency_us;
+    uint64_t decisions = 0;
+    std::thread gateway([&]() {
+        Decision decision;
+        while (true) {
+            if (decision_ring.tryPop(decision)) {
+                uint64_t now = pipelineNowNanoseconds();
+                latency_us.add(now > decision.tick_ns ? (now - decision.tick_ns) / 1000.0 : 0.0);
+                ++decisions;
+                continue;
+            }
+            if (handler_done.load(std::memory_order_acquire) && decision_ring.size() == 0) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    // Publisher: open-loop schedule; ticks carry their scheduled time so a
+    // publisher that falls behind shows up as latency rather than hiding it
+    std::thread publisher([&]() {
+        OrderFlowGenerator flow;
+        std::vector<char> packet(packet_size);
+        const double interval_ns = NANOSECONDS_PER_SECOND / rate;
+        uint64_t start_ns = pipelineNowNanoseconds();
+        uint64_t end_ns = start_ns + static_cast<uint64_t>(duration_seconds) * 1000000000ULL;
+        uint64_t sequence = 0;
+
+        while (true) {
+            uint64_t scheduled_ns = start_ns + static_cast<uint64_t>(sequence * interval_ns);
+            if (scheduled_ns >= end_ns) {
+                break;
+            }
+            uint64_t now = pipelineNowNanoseconds();
+            if (scheduled_ns > now + SPIN_THRESHOLD_NS) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(scheduled_ns - now - SPIN_THRESHOLD_NS / 2));
+            }
+            while (pipelineNowNanoseconds() < scheduled_ns) {
+                std::this_thread::yield();
+            }
+
+            PacketHeader header { sequence, scheduled_ns, static_cast<uint16_t>(messages_per_packet), 0 };
+            encodeHeader(packet.data(), header);
+            for (int i = 0; i < messages_per_packet; ++i) {
+                encodeMessage(packet.data() + HEADER_WIRE_SIZE + i * MESSAGE_WIRE_SIZE, flow.next());
+            }
+            sendto(send_fd, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr*>(&dest_addr), sizeof(dest_addr));
+            ++sequence;
+        }
+
+        ticks_sent = sequence;
+        publish_seconds = (pipelineNowNanoseconds() - start_ns) / NANOSECONDS_PER_SECOND;
+        publisher_done.store(true, std::memory_order_release);
+    });
+
+    publisher.join();
+    handler.join();
+    gateway.join();
+    close(recv_fd);
+    close(send_fd);
+
+    step.ticks_sent = ticks_sent;
+    step.decisions = decisions;
+    step.gaps = gaps.load();
+    step.ring_overflows = ring_overflows.load();
+    if (publish_seconds > 0.0) {
+        step.achieved_rate = decisions / publish_seconds;
+    }
+    if (ticks_sent > 0) {
+        uint64_t lost = ticks_sent > decisions ? ticks_sent - decisions : 0;
+        step.drop_percent = lost * 100.0 / ticks_sent;
+    }
+
+    LatencyStats stats;
+    for (double sample : latency_us.samples) {
+        stats.addSample(sample);
+    }
+    step.p50_us = stats.getPercentile(50);
+    step.p90_us = stats.getPercentile(90);
+    step.p99_us = stats.getPercentile(99);
+    step.p999_us = stats.getPercentile(99.9);
+    step.max_us = stats.getMax();
+    step.latencies_us = std::move(latency_us.samples);
+
+    return step;
+}
+
+BenchmarkResult FeedHandlerBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    try {
+        if (config.rates.empty()) {
+            throw std::runtime_error("Feed handler needs at least one message rate");
+        }
+        std::vector<double> rates = config.rates;
+        std::sort(rates.begin(), rates.end());
+        int step_seconds = std::max(1, duration_seconds / static_cast<int>(rates.size()));
+
+        std::vector<RateStepResult> steps;
+        bool used_multicast = false;
+        double baseline_p99 = 0.0;
+        double breakdown_rate = 0.0;
+        size_t sustainable_index = 0;
+        bool any_sustainable = false;
+        uint64_t total_ticks = 0;
+        uint64_t total_ring_overflows = 0;
+
+        for (double rate : rates) {
+            if (verbose) {
+                std::cout << "  Feed step: " << rate << " ticks/s for " << step_seconds << "s...\n";
+            }
+            RateStepResult step = runRateStep(rate, step_seconds, used_multicast);
+            total_ticks += step.ticks_sent;
+            total_ring_overflows += step.ring_overflows;
+
+            // Baseline is the best p99 seen so far, so a noisy warm-up step does not mask breakdown
+            if (steps.empty() || (step.p99_us > 0.0 && step.p99_us < baseline_p99)) {
+                baseline_p99 = step.p99_us;
+            }
+            bool latency_ok = baseline_p99 <= 0.0 || step.p99_us <= baseline_p99 * config.breakdown_p99_factor;
+            bool drops_ok = step.drop_percent <= config.max_drop_percent;
+            bool rate_ok = step.achieved_rate >= 0.9 * rate;
+
+            if (verbose) {
+                std::cout << "    p50=" << step.p50_us << "us p99=" << step.p99_us << "us drops=" << step.drop_percent << "%\n";
+            }
+
+            steps.push_back(std::move(step));
+            if (latency_ok && drops_ok && rate_ok) {
+                if (breakdown_rate == 0.0) {
+                    sustainable_index = steps.size() - 1;
+                    any_sustainable = true;
+                }
+            } else if (breakdown_rate == 0.0) {
+                breakdown_rate = rate;
+            }
+        }
+
+        for (const auto& step : steps) {
+            std::string prefix = "feed_rate_" + std::to_string(static_cast<long long>(step.offered_rate)) + "_";
+            result.extra_metrics[prefix + "achieved_ticks_sec"] = step.achieved_rate;
+            result.extra_metrics[prefix + "p50_us"] = step.p50_us;
+            result.extra_metrics[prefix + "p90_us"] = step.p90_us;
+            result.extra_metrics[prefix + "p99_us"] = step.p99_us;
+            result.extra_metrics[prefix + "p999_us"] = step.p999_us;
+            result.extra_metrics[prefix + "max_us"] = step.max_us;
+            result.extra_metrics[prefix + "drop_percent"] = step.drop_percent;
+            result.extra_metrics[prefix + "sequence_gaps"] = static_cast<double>(step.gaps);
+            result.extra_metrics[prefix + "ring_overflows"] = static_cast<double>(step.ring_overflows);
+        }
+
+        // Headline numbers come from the highest rate that still met the latency/drop criteria
+        const RateStepResult& headline = steps[sustainable_index];
+        LatencyStats headline_stats;
+        for (double sample : headline.latencies_us) {
+            headline_stats.addSample(sample);
+        }
+
+        result.throughput = any_sustainable ? headline.offered_rate : 0.0;
+        result.throughput_unit = "ticks/s";
+        result.avg_latency = headline_stats.getAverage();
+        result.min_latency = headline_stats.getMin();
+        result.max_latency = headline.max_us;
+        result.p50_latency = headline.p50_us;
+        result.p90_latency = headline.p90_us;
+        result.p99_latency = headline.p99_us;
+        result.latency_unit = "us";
+
+        result.extra_metrics["work_ops"] = static_cast<double>(total_ticks);
+        result.extra_metrics["feed_max_sustainable_ticks_sec"] = any_sustainable ? headline.offered_rate : 0.0;
+        result.extra_metrics["feed_breakdown_ticks_sec"] = breakdown_rate;
+        result.extra_metrics["feed_baseline_p99_us"] = baseline_p99;
+        result.extra_metrics["feed_messages_per_tick"] = config.messages_per_packet;
+        result.extra_metrics["feed_ring_overflows"] = static_cast<double>(total_ring_overflows);
+        result.extra_info["feed.transport"] = used_multicast ? "udp_multicast" : "udp_unicast";
+        result.extra_info["feed.decision_path"] = "spsc_shared_memory_ring";
+        result.extra_info["feed.breakdown"] = breakdown_rate > 0.0 ? "reached" : "not_reached";
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    return result;
+}
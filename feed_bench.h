@@ -0,0 +1,53 @@
+#ifndef FEED_BENCH_H
+#define FEED_BENCH_H
+
+#include "benchmark.h"
+#include "utils.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct FeedBenchmarkConfig {
+    int port { 9300 };
+    bool multicast { false }; // loopback multicast group instead of unicast
+    std::vector<double> rates { 10000, 25000, 50000, 100000, 200000, 400000 }; // packets/s per step
+    int messages_per_packet { 2 };
+    double breakdown_p99_factor { 10.0 }; // p99 this many times the best p99 so far counts as breakdown
+    double max_drop_percent { 1.0 };
+};
+
+// Market-data feed handler: a publisher sends binary order messages over
+// loopback UDP, the handler decodes them into a price-level order book and
+// makes a decision per tick, and the decision returns over a shared-memory
+// ring to the gateway thread that measures tick-to-decision latency.
+class FeedHandlerBenchmark : public Benchmark {
+private:
+    struct RateStepResult {
+        double offered_rate { 0.0 };
+        double achieved_rate { 0.0 };
+        uint64_t ticks_sent { 0 };
+        uint64_t decisions { 0 };
+        uint64_t gaps { 0 };
+        uint64_t ring_overflows { 0 }; // decisions dropped because the ring was full
+        double drop_percent { 0.0 };
+        double p50_us { 0.0 };
+        double p90_us { 0.0 };
+        double p99_us { 0.0 };
+        double p999_us { 0.0 };
+        double max_us { 0.0 };
+        std::vector<double> latencies_us;
+    };
+
+    FeedBenchmarkConfig config;
+
+    RateStepResult runRateStep(double rate, int duration_seconds, bool& used_multicast);
+
+public:
+    FeedHandlerBenchmark();
+    explicit FeedHandlerBenchmark(const FeedBenchmarkConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "Feed Handler"; }
+};
+
+#endif
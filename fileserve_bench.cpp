@@ -0,0 +1,602 @@
+#include "fileserve_bench.h"
+#include "cgroup.h"
+#include "pipeline.h"
+#include "vmstat.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr int MAX_EPOLL_EVENTS = 64;
+constexpr size_t SENDFILE_CHUNK = 1024 * 1024;
+constexpr size_t FILL_CHUNK = 1024 * 1024;
+constexpr size_t CLIENT_BUFFER = 256 * 1024;
+constexpr size_t MIN_FILE_BYTES = 4 * 1024;
+constexpr size_t MAX_FILE_BYTES = 8 * 1024 * 1024;
+constexpr double PARETO_ALPHA = 1.2;
+constexpr size_t REQUEST_HEADER_LIMIT = 8192;
+
+uint64_t readMemTotalBytes()
+{
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        if (line.find("MemTotal:") == 0) {
+            return std::stoull(line.substr(9)) * 1024ULL;
+        }
+    }
+    return 0;
+}
+
+size_t sampleFileSize(const std::string& distribution, std::mt19937_64& gen)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    if (distribution == "small") {
+        return MIN_FILE_BYTES + static_cast<size_t>(unit(gen) * (64 * 1024 - MIN_FILE_BYTES));
+    }
+    if (distribution == "large") {
+        return 1024 * 1024 + static_cast<size_t>(unit(gen) * (MAX_FILE_BYTES - 1024 * 1024));
+    }
+    // Heavy-tailed: mostly small objects with occasional multi-megabyte ones
+    double size = MIN_FILE_BYTES / std::pow(1.0 - unit(gen), 1.0 / PARETO_ALPHA);
+    return static_cast<size_t>(std::min(size, static_cast<double>(MAX_FILE_BYTES)));
+}
+
+// One epoll loop per worker thread; all workers share the listen socket and
+// each owns the connections it accepts
+class FileServer {
+private:
+    struct Connection {
+        int fd { -1 };
+        std::string request;
+        std::string header;
+        size_t header_sent { 0 };
+        int file_fd { -1 };
+        off_t file_offset { 0 };
+        size_t file_remaining { 0 };
+        bool want_write { false };
+    };
+
+    const std::string& root;
+    int listen_fd { -1 };
+    int wake_fd { -1 };
+    std::vector<std::thread> workers;
+
+    void closeConnection(int epoll_fd, Connection* connection)
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr);
+        close(connection->fd);
+        connection->fd = -1;
+        if (connection->file_fd >= 0) {
+            close(connection->file_fd);
+            connection->file_fd = -1;
+        }
+    }
+
+    void startResponse(Connection* connection, const std::string& path)
+    {
+        std::string file = root + path;
+        int fd = path.find("..") == std::string::npos ? open(file.c_str(), O_RDONLY) : -1;
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            connection->header = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            connection->header_sent = 0;
+            return;
+        }
+        connection->header = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(st.st_size) + "\r\n\r\n";
+        connection->header_sent = 0;
+        connection->file_fd = fd;
+        connection->file_offset = 0;
+        connection->file_remaining = static_cast<size_t>(st.st_size);
+    }
+
+    // Returns false when the socket is full and the response must wait for EPOLLOUT
+    bool pumpResponse(Connection* connection, bool& failed)
+    {
+        while (connection->header_sent < connection->header.size()) {
+            ssize_t n = send(connection->fd, connection->header.data() + connection->header_sent,
+                connection->header.size() - connection->header_sent, MSG_NOSIGNAL | (connection->file_remaining > 0 ? MSG_MORE : 0));
+            if (n < 0) {
+                failed = errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+                return false;
+            }
+            connection->header_sent += static_cast<size_t>(n);
+        }
+        while (connection->file_remaining > 0) {
+            ssize_t n = sendfile(connection->fd, connection->file_fd, &connection->file_offset,
+                std::min(connection->file_remaining, SENDFILE_CHUNK));
+            if (n <= 0) {
+                failed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+                return false;
+            }
+            connection->file_remaining -= static_cast<size_t>(n);
+        }
+        if (connection->file_fd >= 0) {
+            close(connection->file_fd);
+            connection->file_fd = -1;
+        }
+        connection->header.clear();
+        connection->header_sent = 0;
+        return true;
+    }
+
+    bool responsePending(const Connection* connection) const
+    {
+        return connection->header_sent < connection->header.size() || connection->file_remaining > 0;
+    }
+
+    void serve(int epoll_fd, Connection* connection)
+    {
+        bool failed = false;
+        if (responsePending(connection) && !pumpResponse(connection, failed)) {
+            if (failed) {
+                closeConnection(epoll_fd, connection);
+            }
+            return;
+        }
+
+        char buffer[4096];
+        while (true) {
+            ssize_t n = recv(connection->fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                connection->request.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                closeConnection(epoll_fd, connection);
+                return;
+            }
+            break;
+        }
+
+        // Requests may be pipelined; answer them in order until one blocks
+        while (true) {
+            size_t end = connection->request.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                if (connection->request.size() > REQUEST_HEADER_LIMIT) {
+                    closeConnection(epoll_fd, connection);
+                    return;
+                }
+                break;
+            }
+            std::string path;
+            if (connection->request.compare(0, 4, "GET ") == 0) {
+                size_t path_end = connection->request.find(' ', 4);
+                path = connection->request.substr(4, path_end == std::string::npos || path_end > end ? 0 : path_end - 4);
+            }
+            connection->request.erase(0, end + 4);
+            startResponse(connection, path);
+            if (!pumpResponse(connection, failed)) {
+                if (failed) {
+                    closeConnection(epoll_fd, connection);
+                    return;
+                }
+                break;
+            }
+        }
+
+        bool want_write = responsePending(connection);
+        if (want_write != connection->want_write) {
+            epoll_event event {};
+            event.events = want_write ? EPOLLOUT : EPOLLIN;
+            event.data.ptr = connection;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection->fd, &event);
+            connection->want_write = want_write;
+        }
+    }
+
+    void workerLoop()
+    {
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd < 0) {
+            return;
+        }
+        epoll_event event {};
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.ptr = &listen_fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) != 0) {
+            event.events = EPOLLIN;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+        }
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+        std::vector<std::unique_ptr<Connection>> connections;
+        epoll_event events[MAX_EPOLL_EVENTS];
+        bool running = true;
+        while (running) {
+            int ready = epoll_wait(epoll_fd, events, MAX_EPOLL_EVENTS, -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            for (int i = 0; i < ready; ++i) {
+                if (events[i].data.ptr == nullptr) {
+                    running = false;
+                    continue;
+                }
+                if (events[i].data.ptr == &listen_fd) {
+                    while (true) {
+                        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+                        if (fd < 0) {
+                            break;
+                        }
+                        int opt = 1;
+                        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+                        connections.emplace_back(new Connection());
+                        Connection* connection = connections.back().get();
+                        connection->fd = fd;
+                        epoll_event accepted {};
+                        accepted.events = EPOLLIN;
+                        accepted.data.ptr = connection;
+                        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &accepted);
+                    }
+                    continue;
+                }
+                Connection* connection = static_cast<Connection*>(events[i].data.ptr);
+                if (connection->fd >= 0) {
+                    serve(epoll_fd, connection);
+                }
+            }
+        }
+
+        for (auto& connection : connections) {
+            if (connection->fd >= 0) {
+                closeConnection(epoll_fd, connection.get());
+            }
+        }
+        close(epoll_fd);
+    }
+
+public:
+    explicit FileServer(const std::string& root)
+        : root(root)
+    {
+    }
+
+    ~FileServer() { stop(); }
+
+    void start(int port, int worker_count)
+    {
+        listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listen_fd < 0) {
+            throw std::runtime_error("Failed to create file server listen socket");
+        }
+        int opt = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd, 1024) < 0) {
+            throw std::runtime_error("Failed to bind file server to port " + std::to_string(port));
+        }
+        wake_fd = eventfd(0, EFD_NONBLOCK);
+        if (wake_fd < 0) {
+            throw std::runtime_error("Failed to create file server wake descriptor");
+        }
+        for (int i = 0; i < worker_count; ++i) {
+            workers.emplace_back(&FileServer::workerLoop, this);
+        }
+    }
+
+    void stop()
+    {
+        if (!workers.empty()) {
+            // The eventfd stays readable, so every worker sees it
+            uint64_t one = 1;
+            if (write(wake_fd, &one, sizeof(one)) < 0) {
+                // Workers also exit once epoll_wait fails on close
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            workers.clear();
+        }
+        for (int* fd : { &listen_fd, &wake_fd }) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+};
+
+struct ClientStats {
+    SampleReservoir latency_us;
+    SampleReservoir first_byte_us;
+    double max_us { 0.0 };
+    uint64_t requests { 0 };
+    uint64_t bytes { 0 };
+    uint64_t errors { 0 };
+};
+
+// Closed-loop keep-alive client: one outstanding request per connection
+void clientLoop(int port, const std::vector<double>& popularity_cdf, uint64_t seed, uint64_t deadline_ns, ClientStats& stats)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        ++stats.errors;
+        return;
+    }
+    int opt = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ++stats.errors;
+        close(fd);
+        return;
+    }
+
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<char> buffer(CLIENT_BUFFER);
+
+    while (pipelineNowNanoseconds() < deadline_ns) {
+        size_t file = static_cast<size_t>(std::lower_bound(popularity_cdf.begin(), popularity_cdf.end(), unit(gen)) - popularity_cdf.begin());
+        file = std::min(file, popularity_cdf.size() - 1);
+        std::string request = "GET /" + std::to_string(file) + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+
+        uint64_t start_ns = pipelineNowNanoseconds();
+        if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+            ++stats.errors;
+            break;
+        }
+
+        // Header first, then drain exactly Content-Length bytes of body
+        std::string header;
+        size_t body_received = 0;
+        size_t header_end = std::string::npos;
+        uint64_t first_byte_ns = 0;
+        while (header_end == std::string::npos) {
+            ssize_t n = recv(fd, buffer.data(), buffer.size(), 0);
+            if (n <= 0) {
+                break;
+            }
+            if (first_byte_ns == 0) {
+                first_byte_ns = pipelineNowNanoseconds();
+            }
+            header.append(buffer.data(), static_cast<size_t>(n));
+            header_end = header.find("\r\n\r\n");
+        }
+        if (header_end == std::string::npos) {
+            ++stats.errors;
+            break;
+        }
+        body_received = header.size() - header_end - 4;
+        size_t length_pos = header.find("Content-Length: ");
+        size_t content_length = length_pos == std::string::npos || length_pos > header_end ? 0 : std::stoull(header.substr(length_pos + 16));
+        if (header.compare(0, 12, "HTTP/1.1 200") != 0) {
+            ++stats.errors;
+        }
+        bool closed = false;
+        while (body_received < content_length) {
+            ssize_t n = recv(fd, buffer.data(), std::min(buffer.size(), content_length - body_received), 0);
+            if (n <= 0) {
+                closed = true;
+                break;
+            }
+            body_received += static_cast<size_t>(n);
+        }
+        if (closed) {
+            ++stats.errors;
+            break;
+        }
+
+        uint64_t end_ns = pipelineNowNanoseconds();
+        double latency_us = (end_ns - start_ns) / 1000.0;
+        stats.latency_us.add(latency_us);
+        stats.first_byte_us.add((first_byte_ns - start_ns) / 1000.0);
+        stats.max_us = std::max(stats.max_us, latency_us);
+        ++stats.requests;
+        stats.bytes += content_length;
+    }
+    close(fd);
+}
+
+}
+
+StaticFileBenchmark::StaticFileBenchmark()
+    : StaticFileBenchmark(FileServeBenchmarkConfig())
+{
+}
+
+StaticFileBenchmark::StaticFileBenchmark(const FileServeBenchmarkConfig& config)
+    : config(config)
+{
+}
+
+BenchmarkResult StaticFileBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    std::string root = config.directory + "/fileserve_" + std::to_string(getpid());
+    size_t file_count = 0;
+
+    try {
+        if (config.size_distribution != "small" && config.size_distribution != "large" && config.size_distribution != "pareto") {
+            throw std::runtime_error("Unknown file size distribution: " + config.size_distribution);
+        }
+        uint64_t mem_total = readMemTotalBytes();
+        uint64_t corpus_bytes = config.ram_factor > 0.0 && mem_total > 0
+            ? static_cast<uint64_t>(config.ram_factor * mem_total)
+            : config.corpus_mb * 1024ULL * 1024ULL;
+        corpus_bytes = std::max<uint64_t>(corpus_bytes, MAX_FILE_BYTES);
+
+        if (mkdir(root.c_str(), 0755) != 0) {
+            throw std::runtime_error("Failed to create corpus directory " + root);
+        }
+
+        // Build the corpus, then evict it so serving starts from a cold page cache
+        if (verbose) {
+            std::cout << "  Writing " << corpus_bytes / (1024 * 1024) << " MB corpus (" << config.size_distribution << " sizes)...\n";
+        }
+        std::mt19937_64 gen(0xF11E5EEDULL);
+        std::vector<char> fill(FILL_CHUNK);
+        for (size_t i = 0; i < fill.size(); ++i) {
+            fill[i] = static_cast<char>(gen());
+        }
+        uint64_t written_bytes = 0;
+        while (written_bytes < corpus_bytes) {
+            size_t size = sampleFileSize(config.size_distribution, gen);
+            std::string path = root + "/" + std::to_string(file_count);
+            int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to create corpus file " + path);
+            }
+            ++file_count;
+            for (size_t done = 0; done < size;) {
+                size_t chunk = std::min(fill.size(), size - done);
+                if (write(fd, fill.data(), chunk) != static_cast<ssize_t>(chunk)) {
+                    close(fd);
+                    throw std::runtime_error("Failed to write corpus file " + path);
+                }
+                done += chunk;
+            }
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+            written_bytes += size;
+        }
+
+        // Zipf popularity over files; file order is independent of size
+        std::vector<double> popularity_cdf(file_count);
+        double total_weight = 0.0;
+        for (size_t i = 0; i < file_count; ++i) {
+            total_weight += 1.0 / std::pow(static_cast<double>(i + 1), config.zipf_exponent);
+            popularity_cdf[i] = total_weight;
+        }
+        for (double& value : popularity_cdf) {
+            value /= total_weight;
+        }
+
+        int workers = config.workers > 0 ? config.workers : Cgroup::effectiveCpuCount();
+        int clients = std::max(1, config.clients);
+        FileServer server(root);
+        server.start(config.port, workers);
+
+        if (verbose) {
+            std::cout << "  Serving " << file_count << " files with " << workers << " workers to " << clients
+                      << " keep-alive clients...\n";
+        }
+
+        std::vector<ClientStats> stats(clients);
+        std::vector<std::thread> threads;
+        VmstatCounters vmstat_before = VmstatCounters::capture();
+        uint64_t start_ns = pipelineNowNanoseconds();
+        uint64_t deadline_ns = start_ns + static_cast<uint64_t>(std::max(1, duration_seconds)) * 1000000000ULL;
+        for (int i = 0; i < clients; ++i) {
+            threads.emplace_back(clientLoop, config.port, std::cref(popularity_cdf), 0xC11E47ULL + i, deadline_ns, std::ref(stats[i]));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double elapsed = (pipelineNowNanoseconds() - start_ns) / NANOSECONDS_PER_SECOND;
+        VmstatCounters vmstat_after = VmstatCounters::capture();
+        server.stop();
+
+        LatencyStats latency;
+        LatencyStats first_byte;
+        uint64_t requests = 0;
+        uint64_t bytes = 0;
+        uint64_t errors = 0;
+        double max_us = 0.0;
+        for (const auto& client : stats) {
+            for (double sample : client.latency_us.samples) {
+                latency.addSample(sample);
+            }
+            for (double sample : client.first_byte_us.samples) {
+                first_byte.addSample(sample);
+            }
+            requests += client.requests;
+            bytes += client.bytes;
+            errors += client.errors;
+            max_us = std::max(max_us, client.max_us);
+        }
+        if (requests == 0) {
+            throw std::runtime_error("File server completed no requests");
+        }
+
+        // pgpgin counts KB read from block devices; whatever was served beyond
+        // that came from the page cache
+        VmstatCounters vm_events = vmstat_after.delta(vmstat_before);
+        uint64_t disk_read_bytes = vm_events.pgpgin * 1024ULL;
+        double hit_ratio = bytes > 0 ? 1.0 - std::min(1.0, static_cast<double>(disk_read_bytes) / bytes) : 0.0;
+        uint64_t refaults = vm_events.workingset_refault;
+        uint64_t steals = vm_events.pgsteal_kswapd + vm_events.pgsteal_direct;
+
+        double mb_served = bytes / (1024.0 * 1024.0);
+        result.throughput = requests / elapsed;
+        result.throughput_unit = "req/sec";
+        result.avg_latency = latency.getAverage();
+        result.min_latency = latency.getMin();
+        result.max_latency = max_us;
+        result.p50_latency = latency.getPercentile(50);
+        result.p90_latency = latency.getPercentile(90);
+        result.p99_latency = latency.getPercentile(99);
+        result.latency_unit = "us";
+
+        result.extra_metrics["work_ops"] = static_cast<double>(requests);
+        result.extra_metrics["work_bytes"] = static_cast<double>(bytes);
+        result.extra_metrics["fileserve_mbps"] = mb_served / elapsed;
+        result.extra_metrics["fileserve_p999_us"] = latency.getPercentile(99.9);
+        result.extra_metrics["fileserve_ttfb_p50_us"] = first_byte.getPercentile(50);
+        result.extra_metrics["fileserve_ttfb_p99_us"] = first_byte.getPercentile(99);
+        result.extra_metrics["fileserve_errors"] = static_cast<double>(errors);
+        result.extra_metrics["fileserve_files"] = static_cast<double>(file_count);
+        result.extra_metrics["fileserve_corpus_mb"] = written_bytes / (1024.0 * 1024.0);
+        result.extra_metrics["fileserve_corpus_ram_ratio"] = mem_total > 0 ? static_cast<double>(written_bytes) / mem_total : 0.0;
+        result.extra_metrics["fileserve_mean_file_kb"] = written_bytes / 1024.0 / file_count;
+        result.extra_metrics["fileserve_page_cache_hit_ratio"] = hit_ratio;
+        result.extra_metrics["fileserve_disk_read_mb"] = disk_read_bytes / (1024.0 * 1024.0);
+        result.extra_metrics["fileserve_workingset_refaults"] = static_cast<double>(refaults);
+        result.extra_metrics["fileserve_pages_reclaimed"] = static_cast<double>(steals);
+        result.extra_metrics["fileserve_workers"] = workers;
+        result.extra_metrics["fileserve_clients"] = clients;
+        result.extra_info["fileserve.size_distribution"] = config.size_distribution;
+        result.extra_info["fileserve.transfer"] = "sendfile";
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    for (size_t i = 0; i < file_count; ++i) {
+        unlink((root + "/" + std::to_string(i)).c_str());
+    }
+    rmdir(root.c_str());
+    return result;
+}
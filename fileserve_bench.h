@@ -0,0 +1,36 @@
+#ifndef FILESERVE_BENCH_H
+#define FILESERVE_BENCH_H
+
+#include "benchmark.h"
+#include "utils.h"
+#include <string>
+#include <vector>
+
+struct FileServeBenchmarkConfig {
+    int port { 9500 };
+    int workers { 0 }; // 0 = one per available core
+    int clients { 32 }; // keep-alive connections, one client thread each
+    size_t corpus_mb { 512 };
+    double ram_factor { 0.0 }; // > 0 sizes the corpus as a multiple of MemTotal instead
+    std::string size_distribution { "pareto" }; // small, large or pareto
+    double zipf_exponent { 0.99 };
+    std::string directory { "/tmp" };
+};
+
+// CDN-edge style static file serving: an embedded HTTP/1.1 server with one
+// epoll loop per worker serves a corpus of files with sendfile to keep-alive
+// clients requesting Zipf-popular files. The corpus starts evicted from the
+// page cache, and /proc/vmstat deltas show how much was served from memory.
+class StaticFileBenchmark : public Benchmark {
+private:
+    FileServeBenchmarkConfig config;
+
+public:
+    StaticFileBenchmark();
+    explicit StaticFileBenchmark(const FileServeBenchmarkConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "Static File Server"; }
+};
+
+#endif
@@ -0,0 +1,661 @@
+#include "ingest.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t IO_ALIGNMENT = 4096;
+constexpr int UDP_BATCH = 64;
+constexpr int UDP_MAX_BACKOFF_US = 1000;
+constexpr int RECEIVER_POLL_MS = 1;
+constexpr int UDP_DRAIN_IDLE_MS = 20;
+constexpr size_t SOCKET_BUFFER_BYTES = 4 * 1024 * 1024;
+constexpr auto RING_SAMPLE_INTERVAL = std::chrono::milliseconds(10);
+constexpr auto WRITER_IDLE_SLEEP = std::chrono::microseconds(50);
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+sockaddr_in loopbackAddress(int port)
+{
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    return addr;
+}
+
+void closeAll(std::vector<int>& fds)
+{
+    for (int& fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+}
+
+// Waits until the next batch is due when an offered rate is configured
+class RatePacer {
+private:
+    double interval_ns;
+    uint64_t next_ns;
+
+public:
+    explicit RatePacer(double records_per_second)
+        : interval_ns(records_per_second > 0.0 ? NANOSECONDS_PER_SECOND / records_per_second : 0.0)
+        , next_ns(pipelineNowNanoseconds())
+    {
+    }
+
+    void pace(size_t records)
+    {
+        if (interval_ns <= 0.0) {
+            return;
+        }
+        next_ns += static_cast<uint64_t>(interval_ns * records);
+        uint64_t now = pipelineNowNanoseconds();
+        if (next_ns > now) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(next_ns - now));
+        }
+    }
+};
+
+}
+
+struct IngestEngine::RingBuffer {
+    char* data { nullptr };
+    size_t used { 0 };
+    uint64_t opened_ns { 0 };
+    std::vector<uint64_t> receive_ns; // one entry per complete record
+
+    ~RingBuffer() { free(data); }
+};
+
+IngestEngine::IngestEngine(const IngestConfig& config)
+    : config(config)
+{
+    if (this->config.record_size < sizeof(uint64_t) || this->config.record_size > this->config.buffer_size) {
+        throw std::invalid_argument("Ingest record size must fit in a ring buffer");
+    }
+    this->config.buffer_size = alignUp(this->config.buffer_size, IO_ALIGNMENT);
+    this->config.max_file_size = alignUp(std::max(this->config.max_file_size,
+                                             this->config.buffer_size * this->config.max_write_buffers),
+        IO_ALIGNMENT);
+    this->config.receivers = std::max(1, this->config.receivers);
+    this->config.senders = std::max(1, this->config.senders);
+    this->config.ring_buffers = std::max<size_t>(static_cast<size_t>(this->config.receivers) + 2,
+        this->config.ring_buffers);
+    this->config.max_write_buffers = std::max<size_t>(1, std::min(this->config.max_write_buffers, static_cast<size_t>(IOV_MAX)));
+    if (this->config.output_path.empty()) {
+        this->config.output_path = "/tmp/ingest_" + std::to_string(getpid()) + ".dat";
+    }
+}
+
+const char* IngestEngine::transportName(IngestTransport transport)
+{
+    return transport == IngestTransport::TCP ? "tcp" : "udp";
+}
+
+IngestRunStats IngestEngine::run(int duration_seconds)
+{
+    const bool is_tcp = config.transport == IngestTransport::TCP;
+    const size_t record_size = config.record_size;
+    const size_t records_per_buffer = config.buffer_size / record_size;
+
+    std::vector<std::unique_ptr<RingBuffer>> buffers(config.ring_buffers);
+    MpmcQueue<RingBuffer*> free_buffers(config.ring_buffers);
+    MpmcQueue<RingBuffer*> full_buffers(config.ring_buffers);
+    for (auto& buffer : buffers) {
+        buffer.reset(new RingBuffer());
+        if (posix_memalign(reinterpret_cast<void**>(&buffer->data), IO_ALIGNMENT, config.buffer_size) != 0) {
+            throw std::runtime_error("Failed to allocate aligned ingest buffer");
+        }
+        memset(buffer->data, 0, config.buffer_size);
+        buffer->receive_ns.reserve(records_per_buffer);
+        free_buffers.tryPush(buffer.get());
+    }
+
+    // Prefer O_DIRECT so the writer measures the device rather than the page cache
+    bool direct_io = false;
+    int out_fd = open(config.output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    if (out_fd >= 0) {
+        if (pwrite(out_fd, buffers[0]->data, IO_ALIGNMENT, 0) == static_cast<ssize_t>(IO_ALIGNMENT)) {
+            direct_io = true;
+        } else {
+            close(out_fd);
+            out_fd = -1;
+        }
+    }
+    if (out_fd < 0) {
+        out_fd = open(config.output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (out_fd < 0) {
+        throw std::runtime_error("Failed to open ingest output file: " + config.output_path);
+    }
+
+    // Bind every receiver before any sender starts
+    std::vector<int> receiver_fds(config.receivers, -1);
+    for (int r = 0; r < config.receivers; ++r) {
+        int fd = socket(AF_INET, is_tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+        if (fd < 0) {
+            closeAll(receiver_fds);
+            close(out_fd);
+            unlink(config.output_path.c_str());
+            throw std::runtime_error("Failed to create ingest receiver socket");
+        }
+        receiver_fds[r] = fd;
+        int opt = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        int rcvbuf = static_cast<int>(SOCKET_BUFFER_BYTES);
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        sockaddr_in addr = loopbackAddress(config.port + r);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || (is_tcp && listen(fd, config.senders) < 0)) {
+            closeAll(receiver_fds);
+            close(out_fd);
+            unlink(config.output_path.c_str());
+            throw std::runtime_error("Failed to bind ingest receiver to port " + std::to_string(config.port + r));
+        }
+    }
+
+    std::atomic<bool> senders_stop(false);
+    std::atomic<bool> senders_done(false);
+    std::atomic<int> receivers_running(config.receivers);
+    std::atomic<uint64_t> records_sent(0);
+    std::atomic<uint64_t> records_received(0);
+    std::atomic<uint64_t> buffer_drops(0);
+    std::atomic<uint64_t> send_backoffs(0);
+
+    auto acquireBuffer = [&]() -> RingBuffer* {
+        RingBuffer* buffer = nullptr;
+        if (!free_buffers.tryPop(buffer)) {
+            return nullptr;
+        }
+        buffer->used = 0;
+        buffer->receive_ns.clear();
+        buffer->opened_ns = pipelineNowNanoseconds();
+        return buffer;
+    };
+
+    auto sealBuffer = [&](RingBuffer*& buffer) {
+        if (!buffer) {
+            return;
+        }
+        if (buffer->receive_ns.empty()) {
+            free_buffers.tryPush(buffer);
+        } else {
+            full_buffers.tryPush(buffer);
+        }
+        buffer = nullptr;
+    };
+
+    auto sealIfStale = [&](RingBuffer*& buffer, uint64_t now_ns) {
+        uint64_t seal_ns = static_cast<uint64_t>(config.seal_timeout_ms) * 1000000ULL;
+        if (buffer && !buffer->receive_ns.empty() && now_ns - buffer->opened_ns >= seal_ns) {
+            sealBuffer(buffer);
+        }
+    };
+
+    // UDP receiver: recvmmsg lands datagrams directly in ring buffer slots
+    auto udpReceiver = [&](int index) {
+        int fd = receiver_fds[index];
+        RingBuffer* current = nullptr;
+        std::vector<char> scratch(record_size * UDP_BATCH);
+        mmsghdr messages[UDP_BATCH];
+        iovec iovs[UDP_BATCH];
+        uint64_t idle_since = pipelineNowNanoseconds();
+
+        while (true) {
+            if (!current) {
+                current = acquireBuffer();
+            }
+
+            size_t slots = current ? std::min<size_t>(UDP_BATCH, records_per_buffer - current->used / record_size)
+                                   : static_cast<size_t>(UDP_BATCH);
+            memset(messages, 0, sizeof(messages));
+            for (size_t i = 0; i < slots; ++i) {
+                iovs[i].iov_base = current ? current->data + current->used + i * record_size : scratch.data() + i * record_size;
+                iovs[i].iov_len = record_size;
+                messages[i].msg_hdr.msg_iov = &iovs[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            int received = recvmmsg(fd, messages, static_cast<unsigned int>(slots), MSG_DONTWAIT, nullptr);
+            uint64_t now_ns = pipelineNowNanoseconds();
+
+            if (received > 0) {
+                idle_since = now_ns;
+                if (current) {
+                    for (int i = 0; i < received; ++i) {
+                        current->receive_ns.push_back(now_ns);
+                    }
+                    current->used += static_cast<size_t>(received) * record_size;
+                    records_received.fetch_add(received, std::memory_order_relaxed);
+                    if (current->used + record_size > config.buffer_size) {
+                        sealBuffer(current);
+                    }
+                } else {
+                    buffer_drops.fetch_add(received, std::memory_order_relaxed);
+                }
+                continue;
+            }
+
+            sealIfStale(current, now_ns);
+            if (senders_done.load(std::memory_order_acquire) &&
+                now_ns - idle_since >= static_cast<uint64_t>(UDP_DRAIN_IDLE_MS) * 1000000ULL) {
+                break;
+            }
+            pollfd pfd { fd, POLLIN, 0 };
+            poll(&pfd, 1, RECEIVER_POLL_MS);
+        }
+
+        sealBuffer(current);
+        receivers_running.fetch_sub(1, std::memory_order_release);
+    };
+
+    // TCP receiver: reads the stream into ring buffers, keeping record boundaries
+    auto tcpReceiver = [&](int index) {
+        int listen_fd = receiver_fds[index];
+        int fd = -1;
+        while (fd < 0 && !senders_done.load(std::memory_order_acquire)) {
+            pollfd pfd { listen_fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 10) > 0) {
+                fd = accept(listen_fd, nullptr, nullptr);
+            }
+        }
+
+        RingBuffer* current = nullptr;
+        std::vector<char> scratch(config.buffer_size);
+        uint64_t stream_offset = 0;
+        const uint64_t seal_ns = static_cast<uint64_t>(config.seal_timeout_ms) * 1000000ULL;
+
+        // Hand off complete records and carry a trailing partial record into the next buffer
+        auto rotate = [&]() {
+            if (current->receive_ns.empty()) {
+                return;
+            }
+            size_t complete_bytes = current->receive_ns.size() * record_size;
+            size_t tail = current->used - complete_bytes;
+            RingBuffer* next = acquireBuffer();
+            if (next && tail > 0) {
+                memcpy(next->data, current->data + complete_bytes, tail);
+                next->used = tail;
+            }
+            current->used = complete_bytes;
+            sealBuffer(current);
+            current = next;
+        };
+
+        while (fd >= 0) {
+            if (!current) {
+                current = acquireBuffer();
+            }
+
+            // A fresh buffer must start on a record boundary; finish discarding a dropped record first
+            if (current && current->used == 0 && stream_offset % record_size != 0) {
+                size_t skip = record_size - stream_offset % record_size;
+                ssize_t n = recv(fd, scratch.data(), skip, 0);
+                if (n <= 0) {
+                    break;
+                }
+                stream_offset += static_cast<uint64_t>(n);
+                if (static_cast<size_t>(n) == skip) {
+                    buffer_drops.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+
+            pollfd pfd { fd, POLLIN, 0 };
+            if (poll(&pfd, 1, RECEIVER_POLL_MS) <= 0) {
+                if (current && pipelineNowNanoseconds() - current->opened_ns >= seal_ns) {
+                    rotate();
+                }
+                continue;
+            }
+
+            char* target = current ? current->data + current->used : scratch.data();
+            size_t capacity = current ? config.buffer_size - current->used : scratch.size();
+            ssize_t n = recv(fd, target, capacity, MSG_DONTWAIT);
+            if (n == 0) {
+                break;
+            }
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            uint64_t now_ns = pipelineNowNanoseconds();
+            uint64_t completed = (stream_offset + n) / record_size - stream_offset / record_size;
+            stream_offset += static_cast<uint64_t>(n);
+
+            if (!current) {
+                buffer_drops.fetch_add(completed, std::memory_order_relaxed);
+                continue;
+            }
+
+            current->used += static_cast<size_t>(n);
+            for (uint64_t i = 0; i < completed; ++i) {
+                current->receive_ns.push_back(now_ns);
+            }
+            records_received.fetch_add(completed, std::memory_order_relaxed);
+
+            if (current->used + record_size > config.buffer_size || now_ns - current->opened_ns >= seal_ns) {
+                rotate();
+            }
+        }
+
+        if (current) {
+            // Only complete records are handed to the writer
+            current->used = current->receive_ns.size() * record_size;
+        }
+        sealBuffer(current);
+        if (fd >= 0) {
+            close(fd);
+        }
+        receivers_running.fetch_sub(1, std::memory_order_release);
+    };
+
+    auto sender = [&](int index) {
+        sockaddr_in addr = loopbackAddress(config.port + index % config.receivers);
+        int fd = socket(AF_INET, is_tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+        if (fd < 0) {
+            return;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            return;
+        }
+        if (is_tcp) {
+            int opt = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+        }
+
+        std::vector<char> batch(record_size * UDP_BATCH, 'L');
+        mmsghdr messages[UDP_BATCH];
+        iovec iovs[UDP_BATCH];
+        memset(messages, 0, sizeof(messages));
+        for (int i = 0; i < UDP_BATCH; ++i) {
+            iovs[i].iov_base = batch.data() + i * record_size;
+            iovs[i].iov_len = record_size;
+            messages[i].msg_hdr.msg_iov = &iovs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        RatePacer pacer(config.offered_records_sec / config.senders);
+        uint64_t sequence = static_cast<uint64_t>(index) << 48;
+        int backoff_us = 0;
+
+        while (!senders_stop.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < UDP_BATCH; ++i) {
+                memcpy(batch.data() + i * record_size, &sequence, sizeof(sequence));
+                ++sequence;
+            }
+
+            uint64_t sent = 0;
+            if (is_tcp) {
+                size_t offset = 0;
+                while (offset < batch.size()) {
+                    ssize_t n = send(fd, batch.data() + offset, batch.size() - offset, MSG_NOSIGNAL);
+                    if (n <= 0) {
+                        break;
+                    }
+                    offset += static_cast<size_t>(n);
+                }
+                sent = offset / record_size;
+                if (offset < batch.size()) {
+                    records_sent.fetch_add(sent, std::memory_order_relaxed);
+                    break;
+                }
+            } else {
+                int n = sendmmsg(fd, messages, UDP_BATCH, 0);
+                if (n < 0) {
+                    if (errno == ENOBUFS || errno == EAGAIN) {
+                        // Wait for socket space; ENOBUFS (device queue full) usually
+                        // still polls writable, so back off up to a millisecond
+                        send_backoffs.fetch_add(1, std::memory_order_relaxed);
+                        pollfd pfd { fd, POLLOUT, 0 };
+                        poll(&pfd, 1, 1);
+                        backoff_us = std::min(UDP_MAX_BACKOFF_US, std::max(1, backoff_us * 2));
+                        std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+                        continue;
+                    }
+                    break;
+                }
+                backoff_us = 0;
+                sent = static_cast<uint64_t>(n);
+            }
+
+            records_sent.fetch_add(sent, std::memory_order_relaxed);
+            pacer.pace(static_cast<size_t>(sent));
+        }
+
+        close(fd);
+    };
+
+    uint64_t writes = 0;
+    uint64_t syncs = 0;
+    uint64_t bytes_written = 0;
+    uint64_t records_durable = 0;
+    uint64_t bytes_durable = 0;
+    double total_sync_ms = 0.0;
+    double max_sync_ms = 0.0;
+    SampleReservoir durable_latency_us;
+
+    // Single writer: coalesce sealed buffers into one pwritev, fdatasync on an interval
+    auto writer = [&]() {
+        std::vector<RingBuffer*> batch;
+        std::vector<iovec> iovs(config.max_write_buffers);
+        std::vector<uint64_t> pending_receive_ns;
+        uint64_t pending_bytes = 0;
+        uint64_t file_offset = 0;
+        uint64_t last_sync_ns = pipelineNowNanoseconds();
+        const uint64_t sync_interval_ns = static_cast<uint64_t>(config.sync_interval_ms) * 1000000ULL;
+
+        auto syncPending = [&]() {
+            if (pending_receive_ns.empty()) {
+                return;
+            }
+            uint64_t sync_start = pipelineNowNanoseconds();
+            fdatasync(out_fd);
+            uint64_t sync_end = pipelineNowNanoseconds();
+            double sync_ms = (sync_end - sync_start) / 1e6;
+            total_sync_ms += sync_ms;
+            max_sync_ms = std::max(max_sync_ms, sync_ms);
+            ++syncs;
+            for (uint64_t receive_ns : pending_receive_ns) {
+                durable_latency_us.add((sync_end - receive_ns) / 1000.0);
+            }
+            records_durable += pending_receive_ns.size();
+            bytes_durable += pending_bytes;
+            pending_receive_ns.clear();
+            pending_bytes = 0;
+            last_sync_ns = sync_end;
+        };
+
+        while (true) {
+            batch.clear();
+            RingBuffer* buffer = nullptr;
+            while (batch.size() < config.max_write_buffers && full_buffers.tryPop(buffer)) {
+                batch.push_back(buffer);
+            }
+
+            if (batch.empty()) {
+                if (receivers_running.load(std::memory_order_acquire) == 0 && full_buffers.size() == 0) {
+                    break;
+                }
+                if (pipelineNowNanoseconds() - last_sync_ns >= sync_interval_ns) {
+                    syncPending();
+                }
+                std::this_thread::sleep_for(WRITER_IDLE_SLEEP);
+                continue;
+            }
+
+            size_t write_bytes = 0;
+            for (size_t i = 0; i < batch.size(); ++i) {
+                // Pad the tail so every write stays aligned for O_DIRECT
+                size_t padded = alignUp(batch[i]->used, IO_ALIGNMENT);
+                memset(batch[i]->data + batch[i]->used, 0, padded - batch[i]->used);
+                iovs[i].iov_base = batch[i]->data;
+                iovs[i].iov_len = padded;
+                write_bytes += padded;
+            }
+
+            if (file_offset + write_bytes > config.max_file_size) {
+                file_offset = 0;
+            }
+
+            size_t done = 0;
+            size_t iov_index = 0;
+            while (done < write_bytes && iov_index < batch.size()) {
+                ssize_t n = pwritev(out_fd, iovs.data() + iov_index, static_cast<int>(batch.size() - iov_index),
+                    static_cast<off_t>(file_offset + done));
+                if (n <= 0) {
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    break;
+                }
+                done += static_cast<size_t>(n);
+                size_t consumed = static_cast<size_t>(n);
+                while (iov_index < batch.size() && consumed >= iovs[iov_index].iov_len) {
+                    consumed -= iovs[iov_index].iov_len;
+                    ++iov_index;
+                }
+                if (iov_index < batch.size() && consumed > 0) {
+                    iovs[iov_index].iov_base = static_cast<char*>(iovs[iov_index].iov_base) + consumed;
+                    iovs[iov_index].iov_len -= consumed;
+                }
+            }
+            file_offset += write_bytes;
+            bytes_written += done;
+            ++writes;
+
+            for (RingBuffer* written : batch) {
+                pending_receive_ns.insert(pending_receive_ns.end(), written->receive_ns.begin(), written->receive_ns.end());
+                pending_bytes += written->receive_ns.size() * record_size;
+                free_buffers.tryPush(written);
+            }
+
+            if (pipelineNowNanoseconds() - last_sync_ns >= sync_interval_ns) {
+                syncPending();
+            }
+        }
+
+        syncPending();
+    };
+
+    Timer run_timer;
+    run_timer.start();
+
+    std::vector<std::thread> receiver_threads;
+    for (int r = 0; r < config.receivers; ++r) {
+        if (is_tcp) {
+            receiver_threads.emplace_back(tcpReceiver, r);
+        } else {
+            receiver_threads.emplace_back(udpReceiver, r);
+        }
+    }
+    std::thread writer_thread(writer);
+
+    Timer send_timer;
+    send_timer.start();
+    std::vector<std::thread> sender_threads;
+    for (int s = 0; s < config.senders; ++s) {
+        sender_threads.emplace_back(sender, s);
+    }
+
+    double ring_occupancy_sum = 0.0;
+    uint64_t ring_samples = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(duration_seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(RING_SAMPLE_INTERVAL);
+        ring_occupancy_sum += static_cast<double>(config.ring_buffers - std::min(config.ring_buffers, free_buffers.size()));
+        ++ring_samples;
+    }
+
+    senders_stop.store(true);
+    for (auto& t : sender_threads) {
+        t.join();
+    }
+    double send_seconds = send_timer.elapsedSeconds();
+    senders_done.store(true, std::memory_order_release);
+
+    for (auto& t : receiver_threads) {
+        t.join();
+    }
+    writer_thread.join();
+
+    double elapsed_seconds = run_timer.elapsedSeconds();
+
+    closeAll(receiver_fds);
+    close(out_fd);
+    unlink(config.output_path.c_str());
+
+    IngestRunStats stats;
+    stats.elapsed_seconds = elapsed_seconds;
+    stats.direct_io = direct_io;
+    stats.records_sent = records_sent.load();
+    stats.records_received = records_received.load();
+    stats.buffer_drops = buffer_drops.load();
+    stats.send_backoffs = send_backoffs.load();
+    stats.records_durable = records_durable;
+    stats.bytes_durable = bytes_durable;
+    stats.writes = writes;
+    stats.syncs = syncs;
+
+    uint64_t accounted = stats.records_received + stats.buffer_drops;
+    stats.network_drops = stats.records_sent > accounted ? stats.records_sent - accounted : 0;
+    if (stats.records_sent > 0) {
+        stats.drop_percent = (stats.buffer_drops + stats.network_drops) * 100.0 / stats.records_sent;
+    }
+    if (send_seconds > 0.0) {
+        stats.offered_records_sec = stats.records_sent / send_seconds;
+    }
+    if (elapsed_seconds > 0.0) {
+        stats.ingest_mbps = bytes_durable / (1024.0 * 1024.0) / elapsed_seconds;
+        stats.durable_records_sec = records_durable / elapsed_seconds;
+    }
+    if (writes > 0) {
+        stats.avg_write_kb = bytes_written / 1024.0 / writes;
+    }
+    if (syncs > 0) {
+        stats.avg_sync_ms = total_sync_ms / syncs;
+    }
+    stats.max_sync_ms = max_sync_ms;
+    if (ring_samples > 0) {
+        stats.avg_ring_occupancy = ring_occupancy_sum / ring_samples;
+    }
+
+    LatencyStats latency;
+    for (double sample : durable_latency_us.samples) {
+        latency.addSample(sample);
+    }
+    stats.durable_avg_us = latency.getAverage();
+    stats.durable_p50_us = latency.getPercentile(50);
+    stats.durable_p90_us = latency.getPercentile(90);
+    stats.durable_p99_us = latency.getPercentile(99);
+    stats.durable_p999_us = latency.getPercentile(99.9);
+    stats.durable_max_us = latency.getMax();
+    stats.durable_samples_us = durable_latency_us.samples;
+
+    return stats;
+}
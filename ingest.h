@@ -0,0 +1,77 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+#include "pipeline.h"
+#include "utils.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class IngestTransport {
+    UDP,
+    TCP
+};
+
+struct IngestConfig {
+    IngestTransport transport { IngestTransport::UDP };
+    int port { 9090 };
+    int receivers { 1 };
+    int senders { 1 };
+    size_t record_size { 1024 };
+    size_t buffer_size { 1024 * 1024 }; // one ring slot, written as a unit
+    size_t ring_buffers { 32 };
+    size_t max_write_buffers { 8 }; // buffers coalesced into one pwritev
+    int sync_interval_ms { 20 };
+    size_t max_file_size { 256ULL * 1024 * 1024 }; // file offset wraps like a rotated log
+    double offered_records_sec { 0.0 }; // 0 = senders run unthrottled
+    int seal_timeout_ms { 2 }; // partially filled buffers are handed off after this long
+    std::string output_path;
+};
+
+struct IngestRunStats {
+    double elapsed_seconds { 0.0 };
+    uint64_t records_sent { 0 };
+    uint64_t records_received { 0 };
+    uint64_t records_durable { 0 };
+    uint64_t bytes_durable { 0 };
+    uint64_t buffer_drops { 0 }; // received but no free ring buffer
+    uint64_t network_drops { 0 }; // sent but never received
+    uint64_t writes { 0 };
+    uint64_t syncs { 0 };
+    double offered_records_sec { 0.0 };
+    double ingest_mbps { 0.0 };
+    double durable_records_sec { 0.0 };
+    double drop_percent { 0.0 };
+    double avg_write_kb { 0.0 };
+    double avg_sync_ms { 0.0 };
+    double max_sync_ms { 0.0 };
+    double avg_ring_occupancy { 0.0 };
+    double durable_avg_us { 0.0 };
+    double durable_p50_us { 0.0 };
+    double durable_p90_us { 0.0 };
+    double durable_p99_us { 0.0 };
+    double durable_p999_us { 0.0 };
+    double durable_max_us { 0.0 };
+    std::vector<double> durable_samples_us;
+    uint64_t send_backoffs { 0 }; // UDP sends that found no socket or device buffer space
+    bool direct_io { false };
+};
+
+// Network-to-disk ingest path shaped like a log collector: receivers fill a ring of
+// aligned buffers straight from the socket, and a single writer thread coalesces
+// full buffers into large aligned writes with periodic fdatasync.
+class IngestEngine {
+private:
+    struct RingBuffer;
+
+    IngestConfig config;
+
+public:
+    explicit IngestEngine(const IngestConfig& config);
+
+    IngestRunStats run(int duration_seconds);
+
+    static const char* transportName(IngestTransport transport);
+};
+
+#endif
@@ -0,0 +1,254 @@
+#include "instrumentation.h"
+#include <algorithm>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+namespace {
+
+double timevalToSeconds(const struct timeval& tv)
+{
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / MICROSECONDS_PER_SECOND;
+}
+
+double deltaOrZero(double end, double start)
+{
+    return end > start ? end - start : 0.0;
+}
+
+}
+
+CpuUsageSnapshot CpuUsageSnapshot::capture()
+{
+    CpuUsageSnapshot snapshot;
+    struct rusage self_usage {};
+    struct rusage child_usage {};
+
+    if (getrusage(RUSAGE_SELF, &self_usage) != 0) {
+        return snapshot;
+    }
+
+    snapshot.valid = true;
+    snapshot.user_seconds = timevalToSeconds(self_usage.ru_utime);
+    snapshot.system_seconds = timevalToSeconds(self_usage.ru_stime);
+    snapshot.voluntary_context_switches = static_cast<uint64_t>(self_usage.ru_nvcsw);
+    snapshot.involuntary_context_switches = static_cast<uint64_t>(self_usage.ru_nivcsw);
+    snapshot.minor_faults = static_cast<uint64_t>(self_usage.ru_minflt);
+    snapshot.major_faults = static_cast<uint64_t>(self_usage.ru_majflt);
+
+    // Forked helpers (IPC consumer, snapshot writers) are accounted once reaped
+    if (getrusage(RUSAGE_CHILDREN, &child_usage) == 0) {
+        snapshot.children_user_seconds = timevalToSeconds(child_usage.ru_utime);
+        snapshot.children_system_seconds = timevalToSeconds(child_usage.ru_stime);
+    }
+
+    return snapshot;
+}
+
+BenchmarkInstrumentation::BenchmarkInstrumentation(bool collect_perf_counters)
+    : collect_perf_counters(collect_perf_counters)
+{
+}
+
+void BenchmarkInstrumentation::start()
+{
+    perf_started = collect_perf_counters && perf_counters.start();
+    cpu_start = CpuUsageSnapshot::capture();
+    cgroup_start = Cgroup::readCpuStat();
+    irq_start = IrqCounters::capture();
+    vmstat_start = VmstatCounters::capture();
+    sched_tracker.start();
+    wall_timer.start();
+}
+
+void BenchmarkInstrumentation::finish(BenchmarkResult& result)
+{
+    double wall_seconds = wall_timer.elapsedSeconds();
+    sched_tracker.stop();
+    CpuUsageSnapshot cpu_end = CpuUsageSnapshot::capture();
+    CgroupCpuStat cgroup_end = Cgroup::readCpuStat();
+    IrqCounters irq_end = IrqCounters::capture();
+    VmstatCounters vmstat_end = VmstatCounters::capture();
+    PerfCounterSample perf_sample = perf_counters.stop();
+
+    applyPerfCounters(result, perf_sample);
+    sched_tracker.apply(result);
+    applyCgroupThrottling(result, cgroup_end, wall_seconds);
+    applyIrqDistribution(result, irq_start, irq_end, sched_tracker.pinnedCpus());
+    applyVmstatDelta(result, vmstat_start, vmstat_end);
+
+    if (cpu_start.valid && cpu_end.valid) {
+        CpuEfficiency efficiency = computeEfficiency(result, cpu_start, cpu_end, wall_seconds, perf_sample);
+        applyCpuEfficiency(result, efficiency);
+    }
+}
+
+void BenchmarkInstrumentation::applyPerfCounters(BenchmarkResult& result, const PerfCounterSample& sample)
+{
+    if (!collect_perf_counters) {
+        result.extra_info["perf.counters"] = "disabled";
+        return;
+    }
+
+    if (sample.valid) {
+        result.extra_metrics["perf_cpu_cycles"] = static_cast<double>(sample.cycles);
+        result.extra_metrics["perf_cpu_instructions"] = static_cast<double>(sample.instructions);
+        result.extra_metrics["perf_l3_cache_misses"] = static_cast<double>(sample.cache_misses);
+        result.extra_metrics["perf_branches"] = static_cast<double>(sample.branches);
+        result.extra_metrics["perf_branch_misses"] = static_cast<double>(sample.branch_misses);
+        if (sample.instructions > 0) {
+            result.extra_metrics["perf_cpi"] = static_cast<double>(sample.cycles) /
+                static_cast<double>(sample.instructions);
+        }
+        result.extra_info["perf.counters"] = "perf_event_open";
+    } else {
+        result.extra_info["perf.counters"] = perf_started ? "unavailable" : "insufficient_permissions";
+    }
+}
+
+void BenchmarkInstrumentation::applyCpuEfficiency(BenchmarkResult& result, const CpuEfficiency& efficiency)
+{
+    result.extra_metrics["cpu_wall_seconds"] = efficiency.wall_seconds;
+    result.extra_metrics["cpu_user_seconds"] = efficiency.user_seconds;
+    result.extra_metrics["cpu_system_seconds"] = efficiency.system_seconds;
+    result.extra_metrics["cpu_children_seconds"] = efficiency.children_seconds;
+    result.extra_metrics["cpu_total_seconds"] = efficiency.cpu_seconds;
+    result.extra_metrics["cpu_cores_used"] = efficiency.cores_used;
+
+    if (efficiency.cpu_us_per_op > 0.0) {
+        result.extra_metrics["cpu_us_per_op"] = efficiency.cpu_us_per_op;
+    }
+    if (efficiency.work_bytes > 0.0) {
+        result.extra_metrics["cpu_us_per_mb"] = efficiency.cpu_seconds * MICROSECONDS_PER_SECOND /
+            (efficiency.work_bytes / (1024.0 * 1024.0));
+    }
+    if (efficiency.cycles_per_op > 0.0) {
+        result.extra_metrics["cycles_per_op"] = efficiency.cycles_per_op;
+    }
+    if (efficiency.cycles_per_byte > 0.0) {
+        result.extra_metrics["cycles_per_byte"] = efficiency.cycles_per_byte;
+    }
+
+    result.extra_info["cpu.work_source"] = efficiency.work_source;
+    result.extra_info["cpu.cycles_source"] = efficiency.cycles_source;
+}
+
+// CFS quota throttling silently caps throughput, so every result records it
+void BenchmarkInstrumentation::applyCgroupThrottling(BenchmarkResult& result, const CgroupCpuStat& end, double wall_seconds)
+{
+    CgroupLimits limits = Cgroup::readLimits();
+    if (!limits.available) {
+        result.extra_info["cgroup.version"] = "none (no cgroup v2)";
+        return;
+    }
+    result.extra_info["cgroup.version"] = "v2";
+    result.extra_info["cgroup.cpu_limit"] = limits.describeCpuLimit();
+    result.extra_info["cgroup.memory_limit"] = limits.describeMemoryLimit();
+    result.extra_metrics["cgroup_effective_cpus"] = Cgroup::effectiveCpuCount();
+
+    if (!cgroup_start.valid || !end.valid) {
+        return;
+    }
+    uint64_t periods = end.nr_periods - std::min(end.nr_periods, cgroup_start.nr_periods);
+    uint64_t throttled = end.nr_throttled - std::min(end.nr_throttled, cgroup_start.nr_throttled);
+    uint64_t throttled_usec = end.throttled_usec - std::min(end.throttled_usec, cgroup_start.throttled_usec);
+    uint64_t usage_usec = end.usage_usec - std::min(end.usage_usec, cgroup_start.usage_usec);
+
+    result.extra_metrics["cgroup_cpu_usage_seconds"] = usage_usec / MICROSECONDS_PER_SECOND;
+    result.extra_metrics["cgroup_nr_periods"] = static_cast<double>(periods);
+    result.extra_metrics["cgroup_nr_throttled"] = static_cast<double>(throttled);
+    result.extra_metrics["cgroup_throttled_ms"] = throttled_usec / 1000.0;
+    result.extra_metrics["cgroup_throttled_period_percent"] = periods > 0 ? throttled * 100.0 / periods : 0.0;
+    if (wall_seconds > 0.0) {
+        result.extra_metrics["cgroup_throttled_wall_percent"] = std::min(100.0,
+            throttled_usec / (wall_seconds * MICROSECONDS_PER_SECOND) * 100.0);
+    }
+}
+
+CpuEfficiency BenchmarkInstrumentation::computeEfficiency(const BenchmarkResult& result,
+    const CpuUsageSnapshot& start,
+    const CpuUsageSnapshot& end,
+    double wall_seconds,
+    const PerfCounterSample& perf_sample)
+{
+    CpuEfficiency efficiency;
+    efficiency.wall_seconds = wall_seconds;
+    efficiency.user_seconds = deltaOrZero(end.user_seconds, start.user_seconds);
+    efficiency.system_seconds = deltaOrZero(end.system_seconds, start.system_seconds);
+    efficiency.children_seconds = deltaOrZero(end.children_user_seconds + end.children_system_seconds,
+        start.children_user_seconds + start.children_system_seconds);
+    efficiency.cpu_seconds = efficiency.user_seconds + efficiency.system_seconds + efficiency.children_seconds;
+    if (wall_seconds > 0.0) {
+        efficiency.cores_used = efficiency.cpu_seconds / wall_seconds;
+    }
+
+    // Per-op and per-byte figures need the exact work a benchmark did; a
+    // throughput figure averaged over warmup, iterations and setup is no
+    // substitute, so modules that do not report work get none
+    auto ops_it = result.extra_metrics.find("work_ops");
+    auto bytes_it = result.extra_metrics.find("work_bytes");
+    if (ops_it != result.extra_metrics.end() || bytes_it != result.extra_metrics.end()) {
+        efficiency.work_ops = ops_it != result.extra_metrics.end() ? ops_it->second : 0.0;
+        efficiency.work_bytes = bytes_it != result.extra_metrics.end() ? bytes_it->second : 0.0;
+        efficiency.work_source = "reported";
+    } else {
+        efficiency.work_source = "unreported";
+    }
+
+    if (efficiency.work_ops > 0.0) {
+        efficiency.cpu_us_per_op = efficiency.cpu_seconds * MICROSECONDS_PER_SECOND / efficiency.work_ops;
+    }
+
+    if (perf_sample.valid && perf_sample.cycles > 0) {
+        efficiency.cycles = static_cast<double>(perf_sample.cycles);
+        efficiency.cycles_source = "perf_event_open";
+    } else {
+        double frequency_hz = getNominalCpuFrequencyHz();
+        if (frequency_hz > 0.0) {
+            efficiency.cycles = efficiency.cpu_seconds * frequency_hz;
+            efficiency.cycles_source = "estimated_from_cpu_time";
+        } else {
+            efficiency.cycles_source = "unavailable";
+        }
+    }
+
+    if (efficiency.cycles > 0.0) {
+        if (efficiency.work_ops > 0.0) {
+            efficiency.cycles_per_op = efficiency.cycles / efficiency.work_ops;
+        }
+        if (efficiency.work_bytes > 0.0) {
+            efficiency.cycles_per_byte = efficiency.cycles / efficiency.work_bytes;
+        }
+    }
+
+    return efficiency;
+}
+
+double BenchmarkInstrumentation::getNominalCpuFrequencyHz()
+{
+#ifdef __linux__
+    std::ifstream max_freq_file("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+    if (max_freq_file.is_open()) {
+        double khz = 0.0;
+        if (max_freq_file >> khz && khz > 0.0) {
+            return khz * 1000.0;
+        }
+    }
+
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.find("cpu MHz") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                try {
+                    return std::stod(line.substr(colon + 1)) * 1e6;
+                } catch (const std::exception&) {
+                    return 0.0;
+                }
+            }
+        }
+    }
+#endif
+    return 0.0;
+}
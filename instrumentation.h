@@ -0,0 +1,78 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include "benchmark.h"
+#include "cgroup.h"
+#include "irq_stats.h"
+#include "thread_sched.h"
+#include "vmstat.h"
+#include "utils.h"
+#include <cstdint>
+#include <string>
+
+// Process CPU consumption captured with getrusage (self and reaped children)
+struct CpuUsageSnapshot {
+    bool valid { false };
+    double user_seconds { 0.0 };
+    double system_seconds { 0.0 };
+    double children_user_seconds { 0.0 };
+    double children_system_seconds { 0.0 };
+    uint64_t voluntary_context_switches { 0 };
+    uint64_t involuntary_context_switches { 0 };
+    uint64_t minor_faults { 0 };
+    uint64_t major_faults { 0 };
+
+    static CpuUsageSnapshot capture();
+    double totalSeconds() const { return user_seconds + system_seconds + children_user_seconds + children_system_seconds; }
+};
+
+struct CpuEfficiency {
+    double wall_seconds { 0.0 };
+    double user_seconds { 0.0 };
+    double system_seconds { 0.0 };
+    double children_seconds { 0.0 };
+    double cpu_seconds { 0.0 };
+    double cores_used { 0.0 };
+    double work_ops { 0.0 };
+    double work_bytes { 0.0 };
+    double cpu_us_per_op { 0.0 };
+    double cycles { 0.0 };
+    double cycles_per_op { 0.0 };
+    double cycles_per_byte { 0.0 };
+    std::string work_source;
+    std::string cycles_source;
+};
+
+// Wraps a single benchmark run and attaches perf counter and CPU efficiency
+// metrics to its result. Used by both the standard and the contextual runner.
+class BenchmarkInstrumentation {
+private:
+    bool collect_perf_counters;
+    bool perf_started { false };
+    PerfCounterSet perf_counters;
+    CpuUsageSnapshot cpu_start;
+    CgroupCpuStat cgroup_start;
+    IrqCounters irq_start;
+    VmstatCounters vmstat_start;
+    ThreadSchedTracker sched_tracker;
+    Timer wall_timer;
+
+    void applyPerfCounters(BenchmarkResult& result, const PerfCounterSample& sample);
+    void applyCpuEfficiency(BenchmarkResult& result, const CpuEfficiency& efficiency);
+    void applyCgroupThrottling(BenchmarkResult& result, const CgroupCpuStat& end, double wall_seconds);
+
+public:
+    explicit BenchmarkInstrumentation(bool collect_perf_counters);
+
+    void start();
+    void finish(BenchmarkResult& result);
+
+    static CpuEfficiency computeEfficiency(const BenchmarkResult& result,
+        const CpuUsageSnapshot& start,
+        const CpuUsageSnapshot& end,
+        double wall_seconds,
+        const PerfCounterSample& perf_sample);
+    static double getNominalCpuFrequencyHz();
+};
+
+#endif
@@ -1,276 +1,221 @@
 #include "integrated_bench.h"
-#include <arpa/inet.h>
+#include "cgroup.h"
 #include <cstring>
 #include <fcntl.h>
-#include <fstream>
 #include <iostream>
-#include <netinet/in.h>
+#include <numeric>
 #include <random>
-#include <sys/socket.h>
 #include <unistd.h>
 
-IntegratedBenchmark::WorkflowMetrics IntegratedBenchmark::runNetworkToMemoryWorkflow(int duration_seconds)
-{
-    WorkflowMetrics metrics {};
-
-    const int PORT = 9090;
-    const size_t BUFFER_SIZE = 1024 * 1024; // 1MB
-
-    std::atomic<uint64_t> total_operations(0);
-    std::atomic<bool> should_stop(false);
-    Timer overall_timer;
-    overall_timer.start();
-
-    std::vector<char> memory_buffer(BUFFER_SIZE);
-    std::mutex buffer_mutex;
-
-    std::thread server_thread([&]() {
-        int server_fd = socket(AF_INET, SOCK_DGRAM, 0);
-        if (server_fd < 0)
-            return;
-
-        int flags = fcntl(server_fd, F_GETFL, 0);
-        fcntl(server_fd, F_SETFL, flags | O_NONBLOCK);
-
-        struct sockaddr_in addr;
-        memset(&addr, 0, sizeof(addr));
-        addr.sin_family = AF_INET;
-        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-        addr.sin_port = htons(PORT);
-
-        if (bind(server_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-            close(server_fd);
-            return;
-        }
-
-        char recv_buffer[1024];
-        struct sockaddr_in client_addr;
-        socklen_t client_len;
-
-        while (!should_stop.load()) {
-            client_len = sizeof(client_addr);
-            ssize_t bytes = recvfrom(server_fd, recv_buffer, sizeof(recv_buffer), 0,
-                (struct sockaddr*)&client_addr, &client_len);
-
-            if (bytes > 0) {
-                std::lock_guard<std::mutex> lock(buffer_mutex);
-                size_t offset = (total_operations.load() * bytes) % BUFFER_SIZE;
-                if (offset + bytes <= BUFFER_SIZE) {
-                    memcpy(memory_buffer.data() + offset, recv_buffer, bytes);
-                }
-                total_operations.fetch_add(1);
-            }
-
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
-        }
-
-        close(server_fd);
-    });
-
-    std::thread client_thread([&]() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-        int client_fd = socket(AF_INET, SOCK_DGRAM, 0);
-        if (client_fd < 0)
-            return;
-
-        struct sockaddr_in server_addr;
-        memset(&server_addr, 0, sizeof(server_addr));
-        server_addr.sin_family = AF_INET;
-        server_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-        server_addr.sin_port = htons(PORT);
-
-        std::vector<char> message(1024, 'I');
-        auto start = std::chrono::steady_clock::now();
-        auto end = start + std::chrono::seconds(duration_seconds);
+namespace {
 
-        while (std::chrono::steady_clock::now() < end && !should_stop.load()) {
-            sendto(client_fd, message.data(), message.size(), 0,
-                (struct sockaddr*)&server_addr, sizeof(server_addr));
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+IngestConfig makeIngestConfig(IngestTransport transport)
+{
+    IngestConfig config;
+    config.transport = transport;
+    config.port = transport == IngestTransport::TCP ? 9190 : 9090;
+    int cores = Cgroup::effectiveCpuCount();
+    config.receivers = std::max(1, std::min(4, cores / 4));
+    config.senders = config.receivers;
+    return config;
+}
 
-        close(client_fd);
-    });
+// UDP network-to-disk ingest at a fixed offered record rate; a record completes
+// once it is durable, so drops and writer backlog both count against the rate.
+class IngestRateWorkload : public RateControlledWorkload {
+public:
+    std::string getName() const override { return "Integrated UDP Ingest"; }
+    std::string getRateUnit() const override { return "records/s"; }
+
+    LoadStepResult runAtRate(double rate, int duration_seconds) override
+    {
+        IngestConfig config = makeIngestConfig(IngestTransport::UDP);
+        config.offered_records_sec = std::max(0.0, rate);
+
+        IngestEngine engine(config);
+        IngestRunStats stats = engine.run(duration_seconds);
+
+        LoadStepResult step;
+        step.offered_rate = rate > 0.0 ? rate : stats.offered_records_sec;
+        step.achieved_rate = stats.durable_records_sec;
+        step.sent = stats.records_sent;
+        step.completed = stats.records_durable;
+        step.avg_us = stats.durable_avg_us;
+        step.p50_us = stats.durable_p50_us;
+        step.p90_us = stats.durable_p90_us;
+        step.p99_us = stats.durable_p99_us;
+        step.p999_us = stats.durable_p999_us;
+        step.max_us = stats.durable_max_us;
+        return step;
+    }
+};
 
-    std::this_thread::sleep_for(std::chrono::seconds(duration_seconds));
-    should_stop.store(true);
+}
 
-    server_thread.join();
-    client_thread.join();
+IntegratedBenchmark::WorkflowMetrics IntegratedBenchmark::runNetworkIngestWorkflow(int duration_seconds,
+    IngestTransport transport,
+    IngestRunStats& ingest_stats)
+{
+    WorkflowMetrics metrics {};
 
-    double elapsed_nanoseconds = overall_timer.elapsedNanoseconds();
-    double elapsed = elapsed_nanoseconds / NANOSECONDS_PER_SECOND;
-    uint64_t ops = total_operations.load();
+    IngestEngine engine(makeIngestConfig(transport));
+    ingest_stats = engine.run(duration_seconds);
 
-    metrics.throughput_ops_sec = ops / elapsed;
-    metrics.end_to_end_latency_ms = elapsed * 1000.0 / ops;
-    metrics.memory_bandwidth_mbps = (ops * 1024) / (1024.0 * 1024.0) / elapsed;
+    metrics.throughput_ops_sec = ingest_stats.durable_records_sec;
+    metrics.end_to_end_latency_ms = ingest_stats.durable_avg_us / 1000.0;
+    metrics.memory_bandwidth_mbps = ingest_stats.ingest_mbps;
+    metrics.disk_write_mbps = ingest_stats.ingest_mbps;
 
     return metrics;
 }
 
-IntegratedBenchmark::WorkflowMetrics IntegratedBenchmark::runMemoryToDiskWorkflow(int duration_seconds)
+IntegratedBenchmark::WorkflowMetrics IntegratedBenchmark::runFullPipeline(int duration_seconds, PipelineRunStats& pipeline_stats)
 {
     WorkflowMetrics metrics {};
 
-    std::string temp_file = "/tmp/integrated_test_" + std::to_string(getpid()) + ".dat";
-    const size_t BUFFER_SIZE = 2 * 1024 * 1024; // 2MB
+    const size_t RECORD_SIZE = 1024; // 1KB records
+    const size_t HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+    const size_t QUEUE_CAPACITY = 1024;
+    const size_t BATCH_SIZE = 32;
+    const size_t FLUSH_THRESHOLD = 64 * 1024; // 64KB writes
 
-    std::atomic<uint64_t> bytes_written(0);
-    std::atomic<bool> should_stop(false);
-    Timer overall_timer;
-    overall_timer.start();
+    int cores = Cgroup::effectiveCpuCount();
+    int compute_threads = std::max(1, cores - 3);
 
-    std::vector<char> memory_buffer(BUFFER_SIZE);
-    std::mutex buffer_mutex;
+    std::string temp_file = "/tmp/pipeline_out_" + std::to_string(getpid()) + ".dat";
+    int out_fd = open(temp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (out_fd < 0) {
+        throw std::runtime_error("Failed to open pipeline output file");
+    }
 
-    std::thread generator_thread([&]() {
-        std::mt19937 gen(42);
-        std::vector<char> data(4096);
+    // Source bytes standing in for data arriving from the network
+    std::vector<char> wire_data(RECORD_SIZE * 64);
+    std::mt19937 gen(42);
+    for (auto& c : wire_data) {
+        c = static_cast<char>(gen() % 256);
+    }
 
-        for (auto& c : data) {
-            c = static_cast<char>(gen() % 256);
+    uint64_t recv_state = 0x2545F4914F6CDD1DULL;
+    size_t wire_offset = 0;
+    std::vector<double> compute_sinks(compute_threads, 0.0);
+    std::vector<char> persist_buffer;
+    persist_buffer.reserve(FLUSH_THRESHOLD + RECORD_SIZE);
+    uint64_t bytes_persisted = 0;
+
+    PipelineEngine engine(QUEUE_CAPACITY, RECORD_SIZE);
+
+    PipelineStageConfig recv_stage;
+    recv_stage.name = "recv";
+    recv_stage.batch_size = BATCH_SIZE;
+    recv_stage.process = [&](PipelineItem& item, int) {
+        recv_state ^= recv_state << 13;
+        recv_state ^= recv_state >> 7;
+        recv_state ^= recv_state << 17;
+        uint32_t length = static_cast<uint32_t>(RECORD_SIZE - HEADER_SIZE);
+
+        memcpy(item.payload.data() + HEADER_SIZE, wire_data.data() + wire_offset, length);
+        memcpy(item.payload.data(), &recv_state, sizeof(recv_state));
+        memcpy(item.payload.data() + sizeof(recv_state), &length, sizeof(length));
+        wire_offset = (wire_offset + RECORD_SIZE) % (wire_data.size() - RECORD_SIZE);
+    };
+    engine.addStage(recv_stage);
+
+    PipelineStageConfig parse_stage;
+    parse_stage.name = "parse";
+    parse_stage.batch_size = BATCH_SIZE;
+    parse_stage.process = [&](PipelineItem& item, int) {
+        memcpy(&item.key, item.payload.data(), sizeof(item.key));
+        memcpy(&item.length, item.payload.data() + sizeof(item.key), sizeof(item.length));
+        if (item.length > RECORD_SIZE - HEADER_SIZE) {
+            item.length = 0;
         }
 
-        size_t offset = 0;
-        while (!should_stop.load()) {
-            {
-                std::lock_guard<std::mutex> lock(buffer_mutex);
-                if (offset + data.size() <= BUFFER_SIZE) {
-                    memcpy(memory_buffer.data() + offset, data.data(), data.size());
-                    offset += data.size();
-                } else {
-                    offset = 0;
-                    memcpy(memory_buffer.data(), data.data(), data.size());
-                    offset = data.size();
-                }
-            }
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        // FNV-1a checksum over the record body
+        uint32_t hash = 2166136261u;
+        const unsigned char* body = reinterpret_cast<const unsigned char*>(item.payload.data() + HEADER_SIZE);
+        for (uint32_t i = 0; i < item.length; ++i) {
+            hash ^= body[i];
+            hash *= 16777619u;
         }
-    });
-
-    std::thread writer_thread([&]() {
-        std::ofstream file(temp_file, std::ios::binary | std::ios::app);
-        std::vector<char> read_buffer(4096);
-
-        while (!should_stop.load()) {
-            {
-                std::lock_guard<std::mutex> lock(buffer_mutex);
-                memcpy(read_buffer.data(), memory_buffer.data(), read_buffer.size());
-            }
-
-            if (file) {
-                file.write(read_buffer.data(), read_buffer.size());
-                file.flush();
-                bytes_written.fetch_add(read_buffer.size());
-            }
-
-            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        item.checksum = hash;
+    };
+    engine.addStage(parse_stage);
+
+    PipelineStageConfig compute_stage;
+    compute_stage.name = "compute";
+    compute_stage.threads = compute_threads;
+    compute_stage.batch_size = BATCH_SIZE;
+    compute_stage.process = [&](PipelineItem& item, int worker) {
+        double result = 0.0;
+        const char* body = item.payload.data() + HEADER_SIZE;
+        for (uint32_t i = 0; i + sizeof(uint32_t) <= item.length; i += 8 * sizeof(uint32_t)) {
+            uint32_t word;
+            memcpy(&word, body + i, sizeof(word));
+            double value = word * 1e-9;
+            result += std::sin(value) * std::cos(value * 0.5);
         }
-
-        file.close();
-    });
-
-    std::this_thread::sleep_for(std::chrono::seconds(duration_seconds));
-    should_stop.store(true);
-
-    generator_thread.join();
-    writer_thread.join();
-
-    double elapsed_nanoseconds = overall_timer.elapsedNanoseconds();
-    double elapsed = elapsed_nanoseconds / NANOSECONDS_PER_SECOND;
-    uint64_t total_bytes = bytes_written.load();
-
-    metrics.throughput_ops_sec = (total_bytes / 4096.0) / elapsed;
-    metrics.memory_bandwidth_mbps = (total_bytes / (1024.0 * 1024.0)) / elapsed;
-    metrics.end_to_end_latency_ms = elapsed * 1000.0 / (total_bytes / 4096.0);
-
-    unlink(temp_file.c_str());
-
-    return metrics;
-}
-
-IntegratedBenchmark::WorkflowMetrics IntegratedBenchmark::runFullPipeline(int duration_seconds)
-{
-    WorkflowMetrics metrics {};
-
-    std::atomic<uint64_t> total_operations(0);
-    std::atomic<bool> should_stop(false);
-    Timer overall_timer;
-    overall_timer.start();
-
-    const size_t BUFFER_SIZE = 1024 * 1024; // 1MB
-    std::vector<char> memory_buffer(BUFFER_SIZE);
-    std::mutex buffer_mutex;
-
-    std::thread input_thread([&]() {
-        std::mt19937 gen(42);
-        while (!should_stop.load()) {
-            std::lock_guard<std::mutex> lock(buffer_mutex);
-            for (size_t i = 0; i < BUFFER_SIZE / 4; i += 4) {
-                uint32_t value = gen();
-                memcpy(memory_buffer.data() + i, &value, sizeof(value));
-            }
-            total_operations.fetch_add(1);
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        item.value = result;
+        compute_sinks[worker] += result;
+    };
+    engine.addStage(compute_stage);
+
+    PipelineStageConfig persist_stage;
+    persist_stage.name = "persist";
+    persist_stage.batch_size = BATCH_SIZE;
+    persist_stage.process = [&](PipelineItem& item, int) {
+        const char* record = item.payload.data();
+        persist_buffer.insert(persist_buffer.end(), record, record + HEADER_SIZE + item.length);
+        const char* summary = reinterpret_cast<const char*>(&item.value);
+        persist_buffer.insert(persist_buffer.end(), summary, summary + sizeof(item.value));
+    };
+    auto flush_persist_buffer = [&]() {
+        ssize_t written = write(out_fd, persist_buffer.data(), persist_buffer.size());
+        if (written > 0) {
+            bytes_persisted += static_cast<uint64_t>(written);
         }
-    });
-
-    std::thread cpu_thread([&]() {
-        while (!should_stop.load()) {
-            double result = 0.0;
-            {
-                std::lock_guard<std::mutex> lock(buffer_mutex);
-                for (size_t i = 0; i < BUFFER_SIZE / sizeof(double); i += sizeof(double)) {
-                    double value;
-                    memcpy(&value, memory_buffer.data() + i, sizeof(value));
-                    result += std::sin(value) * std::cos(value * 0.5);
-                }
-            }
-
-            if (result == 0.0) {
-                volatile double dummy = result;
-                (void)dummy;
-            }
-
-            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        persist_buffer.clear();
+    };
+    persist_stage.batch_end = [&](int) {
+        if (persist_buffer.size() >= FLUSH_THRESHOLD) {
+            flush_persist_buffer();
         }
-    });
-
-    std::thread output_thread([&]() {
-        std::string temp_file = "/tmp/pipeline_out_" + std::to_string(getpid()) + ".dat";
-        std::ofstream file(temp_file, std::ios::binary);
-
-        while (!should_stop.load()) {
-            {
-                std::lock_guard<std::mutex> lock(buffer_mutex);
-                if (file) {
-                    file.write(memory_buffer.data(), 1024);
-                }
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    };
+    // The tail below the flush threshold is written before the run's clock stops
+    persist_stage.stage_end = [&](int) {
+        if (!persist_buffer.empty()) {
+            flush_persist_buffer();
         }
+    };
+    engine.addStage(persist_stage);
 
-        file.close();
+    try {
+        pipeline_stats = engine.run(duration_seconds);
+    } catch (...) {
+        close(out_fd);
         unlink(temp_file.c_str());
-    });
-
-    std::this_thread::sleep_for(std::chrono::seconds(duration_seconds));
-    should_stop.store(true);
+        throw;
+    }
 
-    input_thread.join();
-    cpu_thread.join();
-    output_thread.join();
+    close(out_fd);
+    unlink(temp_file.c_str());
 
-    double elapsed_nanoseconds = overall_timer.elapsedNanoseconds();
-    double elapsed = elapsed_nanoseconds / NANOSECONDS_PER_SECOND;
-    uint64_t ops = total_operations.load();
+    double checksum = std::accumulate(compute_sinks.begin(), compute_sinks.end(), 0.0);
+    if (checksum == 0.0) {
+        volatile double dummy = checksum;
+        (void)dummy;
+    }
 
-    metrics.throughput_ops_sec = ops / elapsed;
-    metrics.end_to_end_latency_ms = elapsed * 1000.0 / ops;
-    metrics.cpu_utilization_percent = 75.0; // Estimated
-    metrics.memory_bandwidth_mbps = (ops * BUFFER_SIZE) / (1024.0 * 1024.0) / elapsed;
+    metrics.throughput_ops_sec = pipeline_stats.throughput_items_sec;
+    metrics.end_to_end_latency_ms = pipeline_stats.e2e_avg_us / 1000.0;
+    metrics.cpu_utilization_percent = pipeline_stats.busy_utilization_percent;
+    if (pipeline_stats.elapsed_seconds > 0.0) {
+        metrics.memory_bandwidth_mbps = (pipeline_stats.items_completed * RECORD_SIZE) / (1024.0 * 1024.0) /
+            pipeline_stats.elapsed_seconds;
+    }
+    if (pipeline_stats.elapsed_seconds > 0.0) {
+        metrics.disk_write_mbps = (bytes_persisted / (1024.0 * 1024.0)) / pipeline_stats.elapsed_seconds;
+    }
+    metrics.bytes_persisted = bytes_persisted;
 
     return metrics;
 }
@@ -282,47 +227,102 @@ BenchmarkResult IntegratedBenchmark::run(int duration_seconds, int iterations, b
 
     try {
         if (verbose) {
-            std::cout << "  Running Network->Memory workflow...\n";
+            std::cout << "  Running UDP ingest->disk workflow...\n";
         }
 
-        WorkflowMetrics net_mem = runNetworkToMemoryWorkflow(duration_seconds / 3);
+        IngestRunStats udp_stats;
+        WorkflowMetrics udp_ingest = runNetworkIngestWorkflow(duration_seconds / 3, IngestTransport::UDP, udp_stats);
 
         if (verbose) {
-            std::cout << "  Running Memory->Disk workflow...\n";
+            std::cout << "  Running TCP ingest->disk workflow...\n";
         }
 
-        WorkflowMetrics mem_disk = runMemoryToDiskWorkflow(duration_seconds / 3);
+        IngestRunStats tcp_stats;
+        WorkflowMetrics tcp_ingest = runNetworkIngestWorkflow(duration_seconds / 3, IngestTransport::TCP, tcp_stats);
 
         if (verbose) {
             std::cout << "  Running full pipeline...\n";
         }
 
-        WorkflowMetrics full_pipeline = runFullPipeline(duration_seconds / 3);
+        PipelineRunStats pipeline_stats;
+        WorkflowMetrics full_pipeline = runFullPipeline(duration_seconds / 3, pipeline_stats);
 
-        result.throughput = (net_mem.throughput_ops_sec + mem_disk.throughput_ops_sec + full_pipeline.throughput_ops_sec) / 3.0;
+        result.throughput = (udp_ingest.throughput_ops_sec + tcp_ingest.throughput_ops_sec + full_pipeline.throughput_ops_sec) / 3.0;
         result.throughput_unit = "ops/sec";
 
-        result.avg_latency = (net_mem.end_to_end_latency_ms + mem_disk.end_to_end_latency_ms + full_pipeline.end_to_end_latency_ms) / 3.0;
-        result.min_latency = std::min({ net_mem.end_to_end_latency_ms,
-            mem_disk.end_to_end_latency_ms,
-            full_pipeline.end_to_end_latency_ms });
-        result.max_latency = std::max({ net_mem.end_to_end_latency_ms,
-            mem_disk.end_to_end_latency_ms,
-            full_pipeline.end_to_end_latency_ms });
-        result.p50_latency = result.avg_latency;
-        result.p90_latency = result.max_latency * 0.9;
-        result.p99_latency = result.max_latency * 0.99;
+        // Percentiles over the open-loop ingest runs' receive->durable samples only; the
+        // closed-loop pipeline's latency tracks its pool size and is reported separately
+        LatencyStats latency_ms;
+        for (const std::vector<double>* samples : { &udp_stats.durable_samples_us, &tcp_stats.durable_samples_us }) {
+            for (double sample : *samples) {
+                latency_ms.addSample(sample / 1000.0);
+            }
+        }
+        result.avg_latency = latency_ms.getAverage();
+        result.min_latency = latency_ms.getMin();
+        result.max_latency = latency_ms.getMax();
+        result.p50_latency = latency_ms.getPercentile(50);
+        result.p90_latency = latency_ms.getPercentile(90);
+        result.p99_latency = latency_ms.getPercentile(99);
         result.latency_unit = "ms";
 
-        result.extra_metrics["network_memory_throughput_ops_sec"] = net_mem.throughput_ops_sec;
-        result.extra_metrics["network_memory_latency_ms"] = net_mem.end_to_end_latency_ms;
-        result.extra_metrics["memory_disk_throughput_ops_sec"] = mem_disk.throughput_ops_sec;
-        result.extra_metrics["memory_disk_latency_ms"] = mem_disk.end_to_end_latency_ms;
-        result.extra_metrics["memory_disk_bandwidth_mbps"] = mem_disk.memory_bandwidth_mbps;
+        for (const IngestRunStats* ingest : { &udp_stats, &tcp_stats }) {
+            std::string prefix = std::string("ingest_") + (ingest == &udp_stats ? "udp" : "tcp") + "_";
+            result.extra_metrics[prefix + "mbps"] = ingest->ingest_mbps;
+            result.extra_metrics[prefix + "durable_records_sec"] = ingest->durable_records_sec;
+            result.extra_metrics[prefix + "offered_records_sec"] = ingest->offered_records_sec;
+            result.extra_metrics[prefix + "durable_p50_us"] = ingest->durable_p50_us;
+            result.extra_metrics[prefix + "durable_p90_us"] = ingest->durable_p90_us;
+            result.extra_metrics[prefix + "durable_p99_us"] = ingest->durable_p99_us;
+            result.extra_metrics[prefix + "durable_p999_us"] = ingest->durable_p999_us;
+            result.extra_metrics[prefix + "durable_max_us"] = ingest->durable_max_us;
+            result.extra_metrics[prefix + "buffer_drops"] = static_cast<double>(ingest->buffer_drops);
+            result.extra_metrics[prefix + "network_drops"] = static_cast<double>(ingest->network_drops);
+            result.extra_metrics[prefix + "drop_percent"] = ingest->drop_percent;
+            result.extra_metrics[prefix + "avg_write_kb"] = ingest->avg_write_kb;
+            result.extra_metrics[prefix + "avg_fdatasync_ms"] = ingest->avg_sync_ms;
+            result.extra_metrics[prefix + "max_fdatasync_ms"] = ingest->max_sync_ms;
+            result.extra_metrics[prefix + "avg_ring_occupancy"] = ingest->avg_ring_occupancy;
+        }
+        result.extra_metrics["ingest_udp_send_backoffs"] = static_cast<double>(udp_stats.send_backoffs);
+        result.extra_info["ingest.direct_io"] = udp_stats.direct_io ? "true" : "false";
+
         result.extra_metrics["full_pipeline_throughput_ops_sec"] = full_pipeline.throughput_ops_sec;
         result.extra_metrics["full_pipeline_latency_ms"] = full_pipeline.end_to_end_latency_ms;
         result.extra_metrics["full_pipeline_cpu_util_percent"] = full_pipeline.cpu_utilization_percent;
         result.extra_metrics["full_pipeline_memory_bw_mbps"] = full_pipeline.memory_bandwidth_mbps;
+        result.extra_metrics["full_pipeline_disk_write_mbps"] = full_pipeline.disk_write_mbps;
+        result.extra_metrics["full_pipeline_e2e_p50_us"] = pipeline_stats.e2e_p50_us;
+        result.extra_metrics["full_pipeline_e2e_p90_us"] = pipeline_stats.e2e_p90_us;
+        result.extra_metrics["full_pipeline_e2e_p99_us"] = pipeline_stats.e2e_p99_us;
+        result.extra_metrics["full_pipeline_e2e_max_us"] = pipeline_stats.e2e_max_us;
+        result.extra_metrics["full_pipeline_pool_items"] = static_cast<double>(pipeline_stats.pool_items);
+
+        for (const auto& stage : pipeline_stats.stages) {
+            std::string prefix = "pipeline_stage_" + stage.name + "_";
+            result.extra_metrics[prefix + "threads"] = stage.threads;
+            result.extra_metrics[prefix + "service_us"] = stage.avg_service_us;
+            result.extra_metrics[prefix + "service_p99_us"] = stage.p99_service_us;
+            result.extra_metrics[prefix + "utilization_percent"] = stage.utilization_percent;
+            result.extra_metrics[prefix + "avg_batch"] = stage.avg_batch_size;
+        }
+        for (const auto& queue : pipeline_stats.queues) {
+            std::string prefix = "pipeline_queue_" + queue.name + "_";
+            result.extra_metrics[prefix + "avg_occupancy"] = queue.avg_occupancy;
+            result.extra_metrics[prefix + "max_occupancy"] = static_cast<double>(queue.max_occupancy);
+            result.extra_metrics[prefix + "full_percent"] = queue.full_percent;
+        }
+        result.extra_info["pipeline.bottleneck_stage"] = pipeline_stats.bottleneck_stage;
+
+        // Records made durable by the ingest runs plus records the pipeline carried to disk
+        result.extra_metrics["work_ops"] = static_cast<double>(udp_stats.records_durable + tcp_stats.records_durable +
+            pipeline_stats.items_completed);
+        result.extra_metrics["work_bytes"] = static_cast<double>(udp_stats.bytes_durable + tcp_stats.bytes_durable +
+            full_pipeline.bytes_persisted);
+
+        if (verbose) {
+            std::cout << "  Pipeline bottleneck stage: " << pipeline_stats.bottleneck_stage << "\n";
+        }
 
         result.status = "success";
 
@@ -332,4 +332,8 @@ BenchmarkResult IntegratedBenchmark::run(int duration_seconds, int iterations, b
     }
 
     return result;
-}
\ No newline at end of file
+}
+std::unique_ptr<RateControlledWorkload> IntegratedBenchmark::createRateControlledWorkload()
+{
+    return std::make_unique<IngestRateWorkload>();
+}
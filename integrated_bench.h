@@ -2,9 +2,10 @@
 #define INTEGRATED_BENCH_H
 
 #include "benchmark.h"
+#include "ingest.h"
+#include "pipeline.h"
 #include "utils.h"
 #include <atomic>
-#include <mutex>
 #include <thread>
 
 class IntegratedBenchmark : public Benchmark {
@@ -14,15 +15,17 @@ private:
         double throughput_ops_sec;
         double cpu_utilization_percent;
         double memory_bandwidth_mbps;
+        double disk_write_mbps;
+        uint64_t bytes_persisted;
     };
 
-    WorkflowMetrics runNetworkToMemoryWorkflow(int duration_seconds);
-    WorkflowMetrics runMemoryToDiskWorkflow(int duration_seconds);
-    WorkflowMetrics runFullPipeline(int duration_seconds);
+    WorkflowMetrics runNetworkIngestWorkflow(int duration_seconds, IngestTransport transport, IngestRunStats& ingest_stats);
+    WorkflowMetrics runFullPipeline(int duration_seconds, PipelineRunStats& pipeline_stats);
 
 public:
     BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
     std::string getName() const override { return "Integrated System"; }
+    std::unique_ptr<RateControlledWorkload> createRateControlledWorkload() override;
 };
 
 #endif
\ No newline at end of file
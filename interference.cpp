@@ -0,0 +1,281 @@
+#include "interference.h"
+#include "cpu_topology.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+
+namespace {
+
+double nowSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool pinCurrentThread(const std::vector<int>& cpus)
+{
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &cpuset);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+std::string formatCpuList(const std::vector<int>& cpus)
+{
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        out << (i ? "," : "") << cpus[i];
+    }
+    return out.str();
+}
+
+// Two equal halves of whole physical cores, so SMT siblings never straddle the
+// partitions; the CPUs of a lone core are split, and a single CPU is shared.
+// Returns how the partitions relate.
+std::string splitPartitions(const std::vector<int>& allowed, std::vector<int>& partition_a, std::vector<int>& partition_b)
+{
+    const CpuTopology& topology = CpuTopology::host();
+    std::map<std::tuple<int, int, int>, std::vector<int>> cores;
+    for (int id : allowed) {
+        auto key = std::make_tuple(-1, -1, id);
+        for (const auto& cpu : topology.cpus) {
+            if (cpu.id == id) {
+                key = std::make_tuple(cpu.package, cpu.die, cpu.core);
+                break;
+            }
+        }
+        cores[key].push_back(id);
+    }
+
+    partition_a.clear();
+    partition_b.clear();
+    if (cores.size() >= 2) {
+        size_t half = cores.size() / 2;
+        size_t index = 0;
+        for (const auto& core : cores) {
+            if (index < half) {
+                partition_a.insert(partition_a.end(), core.second.begin(), core.second.end());
+            } else if (index < 2 * half) {
+                partition_b.insert(partition_b.end(), core.second.begin(), core.second.end());
+            }
+            ++index;
+        }
+        return "disjoint cores";
+    }
+    size_t half = allowed.size() / 2;
+    if (half > 0) {
+        partition_a.assign(allowed.begin(), allowed.begin() + half);
+        partition_b.assign(allowed.begin() + half, allowed.begin() + 2 * half);
+        return "disjoint SMT siblings (single core)";
+    }
+    partition_a = allowed;
+    partition_b = allowed;
+    return "shared (single CPU)";
+}
+
+}
+
+InterferenceMatrixBenchmark::InterferenceMatrixBenchmark(const std::vector<std::string>& modules, BenchmarkFactory factory)
+    : modules(modules)
+    , factory(std::move(factory))
+{
+}
+
+// Threads and processes a benchmark starts inherit the runner thread's affinity
+InterferenceMatrixBenchmark::ModuleRun InterferenceMatrixBenchmark::runPinned(const std::string& module,
+    const std::vector<int>& cpus, int duration_seconds, int iterations, double epoch_seconds)
+{
+    ModuleRun run;
+    std::cout.flush(); // modules may fork, which would duplicate buffered output
+    std::thread runner([&]() {
+        pinCurrentThread(cpus);
+        run.start_seconds = nowSeconds() - epoch_seconds;
+        try {
+            std::unique_ptr<Benchmark> benchmark = factory(module);
+            if (!benchmark) {
+                throw std::runtime_error("Unknown module: " + module);
+            }
+            run.result = benchmark->run(duration_seconds, iterations, false);
+        } catch (const std::exception& e) {
+            run.result.name = module;
+            run.result.status = "error";
+            run.result.error_message = e.what();
+        }
+        run.end_seconds = nowSeconds() - epoch_seconds;
+    });
+    runner.join();
+    return run;
+}
+
+BenchmarkResult InterferenceMatrixBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    BenchmarkResult result;
+    result.name = getName();
+
+    try {
+        if (modules.size() < 2) {
+            throw std::runtime_error("Interference mode needs at least two modules");
+        }
+
+        std::vector<int> allowed = CPUAffinity::getCurrentAffinity();
+        if (allowed.empty()) {
+            allowed.push_back(0);
+        }
+        std::vector<int> partition_a;
+        std::vector<int> partition_b;
+        std::string partitions = splitPartitions(allowed, partition_a, partition_b);
+        bool disjoint = partition_a != partition_b;
+
+        // In pair (i, j) module i runs on partition a and module j on partition b,
+        // so each module's baseline is taken alone on the partition(s) it uses
+        size_t n = modules.size();
+        double epoch = nowSeconds();
+        std::vector<BenchmarkResult> solo_a(n);
+        std::vector<BenchmarkResult> solo_b(n);
+        for (size_t i = 0; i < n; ++i) {
+            if (i + 1 < n || !disjoint) {
+                if (verbose) {
+                    std::cout << "  Solo: " << modules[i] << " on CPUs " << formatCpuList(partition_a) << "\n";
+                }
+                solo_a[i] = runPinned(modules[i], partition_a, duration_seconds, iterations, epoch).result;
+            }
+            if (i > 0 && disjoint) {
+                if (verbose) {
+                    std::cout << "  Solo: " << modules[i] << " on CPUs " << formatCpuList(partition_b) << "\n";
+                }
+                solo_b[i] = runPinned(modules[i], partition_b, duration_seconds, iterations, epoch).result;
+            }
+        }
+        if (!disjoint) {
+            solo_b = solo_a;
+        }
+
+        // slowdown[victim][neighbor] = solo throughput / throughput next to the neighbor
+        std::vector<std::vector<double>> slowdown(n, std::vector<double>(n, 0.0));
+        std::vector<std::vector<double>> p99_inflation(n, std::vector<double>(n, 0.0));
+        double worst = 0.0;
+        std::string worst_pair;
+        double slowdown_sum = 0.0;
+        int slowdown_count = 0;
+
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                if (verbose) {
+                    std::cout << "  Pair: " << modules[i] << " (CPUs " << formatCpuList(partition_a) << ") + "
+                              << modules[j] << " (CPUs " << formatCpuList(partition_b) << ")\n";
+                }
+                ModuleRun first;
+                ModuleRun second;
+                std::thread other([&]() { second = runPinned(modules[j], partition_b, duration_seconds, iterations, epoch); });
+                first = runPinned(modules[i], partition_a, duration_seconds, iterations, epoch);
+                other.join();
+
+                // Share of the longer run during which both were active
+                double overlap = std::min(first.end_seconds, second.end_seconds) - std::max(first.start_seconds, second.start_seconds);
+                double longest = std::max(first.end_seconds - first.start_seconds, second.end_seconds - second.start_seconds);
+                std::string pair_key = "interference_" + modules[i] + "_" + modules[j] + "_overlap";
+                result.extra_metrics[pair_key] = longest > 0.0 ? std::max(0.0, overlap) / longest : 0.0;
+
+                const std::pair<size_t, const ModuleRun*> victims[] = { { i, &first }, { j, &second } };
+                for (const auto& victim : victims) {
+                    size_t v = victim.first;
+                    size_t neighbor = v == i ? j : i;
+                    const BenchmarkResult& paired = victim.second->result;
+                    const BenchmarkResult& solo = v == i ? solo_a[v] : solo_b[v];
+                    if (paired.status != "success") {
+                        result.extra_info["interference." + modules[v] + "_next_to_" + modules[neighbor] + ".error"] = paired.error_message;
+                    }
+                    if (paired.status != "success" || solo.status != "success" || paired.throughput <= 0.0) {
+                        continue;
+                    }
+                    slowdown[v][neighbor] = solo.throughput / paired.throughput;
+                    p99_inflation[v][neighbor] = solo.p99_latency > 0.0 ? paired.p99_latency / solo.p99_latency : 0.0;
+                    std::string prefix = "interference_" + modules[v] + "_next_to_" + modules[neighbor] + "_";
+                    result.extra_metrics[prefix + "slowdown"] = slowdown[v][neighbor];
+                    result.extra_metrics[prefix + "p99_inflation"] = p99_inflation[v][neighbor];
+                    slowdown_sum += slowdown[v][neighbor];
+                    ++slowdown_count;
+                    if (slowdown[v][neighbor] > worst) {
+                        worst = slowdown[v][neighbor];
+                        worst_pair = modules[v] + " next to " + modules[neighbor];
+                    }
+                }
+            }
+        }
+
+        // Rows are the measured module, columns the neighbor it shared the host with
+        std::cout << "  Interference matrix (throughput slowdown vs solo, row next to column):\n";
+        std::cout << "  " << std::setw(12) << "";
+        for (const auto& module : modules) {
+            std::cout << std::setw(12) << module;
+        }
+        std::cout << "\n";
+        for (size_t v = 0; v < n; ++v) {
+            std::cout << "  " << std::setw(12) << modules[v];
+            for (size_t neighbor = 0; neighbor < n; ++neighbor) {
+                if (v == neighbor || slowdown[v][neighbor] <= 0.0) {
+                    std::cout << std::setw(12) << "-";
+                } else {
+                    std::ostringstream cell;
+                    cell << std::fixed << std::setprecision(2) << slowdown[v][neighbor] << "x";
+                    std::cout << std::setw(12) << cell.str();
+                }
+            }
+            std::cout << "\n";
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const std::pair<const char*, const BenchmarkResult*> baselines[] = { { "a", &solo_a[i] }, { "b", &solo_b[i] } };
+            for (const auto& baseline : baselines) {
+                const BenchmarkResult& solo = *baseline.second;
+                if (solo.status.empty() || (!disjoint && baseline.second == &solo_b[i])) {
+                    continue;
+                }
+                std::string partition = baseline.first;
+                result.extra_metrics["interference_" + modules[i] + "_solo_" + partition + "_throughput"] = solo.throughput;
+                if (solo.status != "success") {
+                    result.extra_info["interference." + modules[i] + ".solo_" + partition + "_error"] = solo.error_message;
+                }
+            }
+        }
+
+        result.throughput = slowdown_count > 0 ? slowdown_sum / slowdown_count : 0.0;
+        result.throughput_unit = "x mean slowdown";
+        result.avg_latency = 0.0;
+        result.min_latency = 0.0;
+        result.max_latency = 0.0;
+        result.p50_latency = 0.0;
+        result.p90_latency = 0.0;
+        result.p99_latency = 0.0;
+        result.latency_unit = "ms";
+        result.extra_metrics["interference_max_slowdown"] = worst;
+        result.extra_metrics["interference_pairs"] = static_cast<double>(n * (n - 1) / 2);
+        result.extra_info["interference.worst_pair"] = worst_pair.empty() ? "none" : worst_pair;
+        result.extra_info["interference.partition_a"] = formatCpuList(partition_a);
+        result.extra_info["interference.partition_b"] = formatCpuList(partition_b);
+        result.extra_info["interference.partitions"] = partitions;
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    return result;
+}
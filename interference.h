@@ -0,0 +1,38 @@
+#ifndef INTERFERENCE_H
+#define INTERFERENCE_H
+
+#include "benchmark.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Builds a fresh benchmark for a module name, or nullptr if it is unknown
+using BenchmarkFactory = std::function<std::unique_ptr<Benchmark>(const std::string&)>;
+
+// Noisy-neighbor mode: splits the allowed CPUs into two halves of whole cores,
+// runs every module alone on each half it will use, then every pair of modules
+// concurrently with one module per half, and reports each module's slowdown
+// next to each neighbor (against its solo run on the same half) as an NxN matrix.
+class InterferenceMatrixBenchmark : public Benchmark {
+private:
+    struct ModuleRun {
+        BenchmarkResult result;
+        double start_seconds { 0.0 };
+        double end_seconds { 0.0 };
+    };
+
+    std::vector<std::string> modules;
+    BenchmarkFactory factory;
+
+    ModuleRun runPinned(const std::string& module, const std::vector<int>& cpus, int duration_seconds,
+        int iterations, double epoch_seconds);
+
+public:
+    InterferenceMatrixBenchmark(const std::vector<std::string>& modules, BenchmarkFactory factory);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "Interference Matrix"; }
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "interference_policy.h"
+#include "system_monitor.h"
+#include <iomanip>
+#include <sstream>
+
+std::string InterferencePolicy::describe() const
+{
+    std::ostringstream text;
+    text << "psi>" << psi_stall_percent << "% (foreign_cpu>=" << foreign_cpu_percent / 2.0 << "%) foreign_cpu>"
+         << foreign_cpu_percent << "%";
+    if (thermal_throttle) {
+        text << " thermal_throttle";
+    }
+    text << ", " << max_reruns << (max_reruns == 1 ? " rerun" : " reruns");
+    return text.str();
+}
+
+void InterferenceWatch::reset(const InterferencePolicy& new_policy)
+{
+    policy = new_policy;
+    windows.clear();
+    checked = 0;
+    disturbed = 0;
+    previous_timestamp = 0.0;
+    previous_disturbed = false;
+}
+
+std::string InterferenceWatch::trigger(const ResourceMetrics& sample) const
+{
+    std::ostringstream reason;
+    reason << std::fixed << std::setprecision(0);
+
+    double foreign_cpu = sample.avg_cpu_usage_percent - sample.process_cpu_percent;
+
+    // Stall is also caused by the benchmark itself (fsync raises io PSI, extra
+    // threads raise cpu PSI), so the benchmark's own cgroup is ignored and
+    // system-wide stall only counts while something else is clearly running;
+    // kernel writeback on the benchmark's behalf shows up as a few percent
+    if (sample.psi_available && foreign_cpu >= policy.foreign_cpu_percent / 2.0) {
+        const char* names[] = { "cpu", "memory", "io" };
+        const PressureStall* system[] = { &sample.cpu_psi, &sample.memory_psi, &sample.io_psi };
+        for (size_t i = 0; i < 3; ++i) {
+            if (system[i]->some_stall_percent > policy.psi_stall_percent) {
+                reason << names[i] << " PSI " << system[i]->some_stall_percent << "% with foreign CPU " << foreign_cpu << "%";
+                return reason.str();
+            }
+        }
+    }
+
+    if (foreign_cpu > policy.foreign_cpu_percent) {
+        reason << "foreign CPU " << foreign_cpu << "%";
+        return reason.str();
+    }
+
+    if (policy.thermal_throttle && sample.thermal_throttle_events > 0) {
+        reason << "thermal throttle (" << sample.thermal_throttle_events << " events)";
+        return reason.str();
+    }
+    return "";
+}
+
+void InterferenceWatch::observe(const ResourceMetrics& sample)
+{
+    double start = previous_timestamp;
+    previous_timestamp = sample.sample_timestamp_seconds;
+    ++checked;
+
+    std::string reason = trigger(sample);
+    if (reason.empty()) {
+        previous_disturbed = false;
+        return;
+    }
+
+    ++disturbed;
+    if (previous_disturbed && !windows.empty()) {
+        windows.back().end_seconds = sample.sample_timestamp_seconds;
+        ++windows.back().samples;
+    } else {
+        DisturbedWindow window;
+        window.start_seconds = start;
+        window.end_seconds = sample.sample_timestamp_seconds;
+        window.samples = 1;
+        window.reason = reason;
+        windows.push_back(window);
+    }
+    previous_disturbed = true;
+}
+
+double InterferenceWatch::disturbedSeconds() const
+{
+    double seconds = 0.0;
+    for (const auto& window : windows) {
+        seconds += window.end_seconds - window.start_seconds;
+    }
+    return seconds;
+}
+
+std::string InterferenceWatch::summary() const
+{
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < windows.size(); ++i) {
+        if (i) {
+            text << "; ";
+        }
+        text << windows[i].start_seconds << "-" << windows[i].end_seconds << "s " << windows[i].reason;
+    }
+    return text.str();
+}
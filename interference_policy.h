@@ -0,0 +1,57 @@
+#ifndef INTERFERENCE_POLICY_H
+#define INTERFERENCE_POLICY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct ResourceMetrics;
+
+// Per-sample limits that mark a monitor interval as disturbed, and how many
+// times a disturbed benchmark run is repeated before its result is kept anyway
+struct InterferencePolicy {
+    double psi_stall_percent { 25.0 };   // system-wide cpu, memory or io "some" stall, counted
+                                         // only while foreign CPU is at least half its limit
+    double foreign_cpu_percent { 25.0 }; // CPU used outside this process tree, percent of all cores
+    bool thermal_throttle { true };      // thermal_throttle counters advanced
+    int max_reruns { 0 };
+
+    std::string describe() const;
+};
+
+// Consecutive disturbed samples merged into one span of monitor time
+struct DisturbedWindow {
+    double start_seconds { 0.0 };
+    double end_seconds { 0.0 };
+    size_t samples { 0 };
+    std::string reason; // first trigger seen in the window
+};
+
+// Checks monitor samples against a policy as they are recorded
+class InterferenceWatch {
+private:
+    InterferencePolicy policy;
+    std::vector<DisturbedWindow> windows;
+    size_t checked { 0 };
+    size_t disturbed { 0 };
+    double previous_timestamp { 0.0 };
+    bool previous_disturbed { false };
+
+    std::string trigger(const ResourceMetrics& sample) const;
+
+public:
+    void reset(const InterferencePolicy& new_policy);
+    void observe(const ResourceMetrics& sample);
+
+    const InterferencePolicy& getPolicy() const { return policy; }
+    const std::vector<DisturbedWindow>& getWindows() const { return windows; }
+    size_t samplesChecked() const { return checked; }
+    size_t disturbedSamples() const { return disturbed; }
+    double disturbedSeconds() const;
+    bool isDisturbed() const { return disturbed > 0; }
+
+    // "0.5-1.0s cpu PSI 31%; 4.2-4.5s foreign CPU 48%"
+    std::string summary() const;
+};
+
+#endif
@@ -1,12 +1,205 @@
 #include "ipc_bench.h"
+#include "load_curve.h"
+#include "pipeline.h"
 #include <chrono>
 #include <cstring>
 #include <errno.h>
 #include <iostream>
+#include <new>
 #include <random>
 #include <sys/wait.h>
 #include <unistd.h>
 
+namespace {
+
+constexpr size_t RR_RING_SLOTS = 4096;
+constexpr size_t RR_MESSAGE_SIZE = 64;
+constexpr uint64_t RR_CLOSED_LOOP_WINDOW = 1;
+constexpr int RR_DRAIN_TIMEOUT_MS = 1000;
+
+struct RingMessage {
+    uint64_t intended_ns;
+    uint64_t step;
+    char payload[RR_MESSAGE_SIZE - 2 * sizeof(uint64_t)];
+};
+
+// Single-producer/single-consumer ring placed in shared memory; the atomics
+// are lock-free so they synchronize across the process boundary
+struct SharedRing {
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+    alignas(64) RingMessage slots[RR_RING_SLOTS];
+
+    bool tryPush(const RingMessage& message)
+    {
+        uint64_t current = head.load(std::memory_order_relaxed);
+        if (current - tail.load(std::memory_order_acquire) >= RR_RING_SLOTS) {
+            return false;
+        }
+        slots[current % RR_RING_SLOTS] = message;
+        head.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(RingMessage& message)
+    {
+        uint64_t current = tail.load(std::memory_order_relaxed);
+        if (current == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        message = slots[current % RR_RING_SLOTS];
+        tail.store(current + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+struct SharedChannel {
+    std::atomic<bool> should_stop;
+    SharedRing requests;
+    SharedRing responses;
+};
+
+// Request/response between two processes over shared-memory rings: a forked
+// server copies each request into a response, timed from its scheduled send time.
+class IPCRequestResponseWorkload : public RateControlledWorkload {
+private:
+    SharedChannel* channel { nullptr };
+    pid_t server_pid { -1 };
+    uint64_t step_id { 0 };
+
+    static void serve(SharedChannel* channel)
+    {
+        RingMessage message;
+        while (!channel->should_stop.load(std::memory_order_relaxed)) {
+            if (!channel->requests.tryPop(message)) {
+                sched_yield();
+                continue;
+            }
+            while (!channel->responses.tryPush(message)) {
+                if (channel->should_stop.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                sched_yield();
+            }
+        }
+    }
+
+public:
+    std::string getName() const override { return "IPC Shared Memory RR"; }
+    std::string getRateUnit() const override { return "msg/s"; }
+
+    void setUp() override
+    {
+        void* mapping = mmap(nullptr, sizeof(SharedChannel), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Failed to map IPC request/response channel");
+        }
+        channel = new (mapping) SharedChannel();
+        channel->should_stop.store(false);
+        channel->requests.head.store(0);
+        channel->requests.tail.store(0);
+        channel->responses.head.store(0);
+        channel->responses.tail.store(0);
+
+        server_pid = fork();
+        if (server_pid == -1) {
+            munmap(channel, sizeof(SharedChannel));
+            channel = nullptr;
+            throw std::runtime_error("Failed to fork IPC server process");
+        }
+        if (server_pid == 0) {
+            serve(channel);
+            _exit(0);
+        }
+    }
+
+    void tearDown() override
+    {
+        if (server_pid > 0) {
+            channel->should_stop.store(true);
+            int status;
+            waitpid(server_pid, &status, 0);
+            server_pid = -1;
+        }
+        if (channel) {
+            munmap(channel, sizeof(SharedChannel));
+            channel = nullptr;
+        }
+    }
+
+    LoadStepResult runAtRate(double rate, int duration_seconds) override
+    {
+        uint64_t step = ++step_id;
+        std::atomic<uint64_t> sent(0);
+        std::atomic<uint64_t> completed(0);
+        std::atomic<bool> sender_done(false);
+        SampleReservoir latency_us;
+        uint64_t start_ns = pipelineNowNanoseconds();
+        uint64_t deadline_ns = start_ns + static_cast<uint64_t>(duration_seconds) * 1000000000ULL;
+        uint64_t send_end_ns = start_ns;
+
+        std::thread sender([&]() {
+            ArrivalSchedule schedule(rate, start_ns, step);
+            RingMessage message;
+            memset(&message, 'I', sizeof(message));
+            message.step = step;
+            while (true) {
+                uint64_t intended = pipelineNowNanoseconds();
+                if (rate > 0.0) {
+                    if (!schedule.waitNext(deadline_ns, intended)) {
+                        break;
+                    }
+                } else {
+                    if (intended >= deadline_ns) {
+                        break;
+                    }
+                    if (sent.load(std::memory_order_relaxed) - completed.load(std::memory_order_acquire) >= RR_CLOSED_LOOP_WINDOW) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+                message.intended_ns = intended;
+                while (!channel->requests.tryPush(message)) {
+                    std::this_thread::yield();
+                }
+                sent.fetch_add(1, std::memory_order_release);
+            }
+            send_end_ns = pipelineNowNanoseconds();
+            sender_done.store(true, std::memory_order_release);
+        });
+
+        RingMessage reply;
+        uint64_t drain_deadline = 0;
+        while (true) {
+            if (sender_done.load(std::memory_order_acquire)) {
+                if (completed.load() >= sent.load()) {
+                    break;
+                }
+                uint64_t now = pipelineNowNanoseconds();
+                if (drain_deadline == 0) {
+                    drain_deadline = now + static_cast<uint64_t>(RR_DRAIN_TIMEOUT_MS) * 1000000ULL;
+                } else if (now > drain_deadline) {
+                    break;
+                }
+            }
+            if (!channel->responses.tryPop(reply)) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint64_t now = pipelineNowNanoseconds();
+            if (reply.step == step) {
+                latency_us.add(now > reply.intended_ns ? (now - reply.intended_ns) / 1000.0 : 0.0);
+                completed.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        sender.join();
+        return summarizeLoadStep(rate, sent.load(), completed.load(), latency_us, (send_end_ns - start_ns) / NANOSECONDS_PER_SECOND);
+    }
+};
+
+}
+
 IPCBenchmark::SharedMemorySegment IPCBenchmark::createSharedMemory()
 {
     SharedMemorySegment segment;
@@ -86,8 +279,14 @@ void IPCBenchmark::destroySharedMemory(SharedMemorySegment& segment)
     segment.consumer_sem = nullptr;
 }
 
+IPCBenchmark::IPCBenchmark(const ThreadPlacement& placement)
+    : placement(placement)
+{
+}
+
 void IPCBenchmark::producer(SharedMemorySegment& segment, size_t message_size)
 {
+    cpu_map.pin(0);
     SharedControlBlock* control = static_cast<SharedControlBlock*>(segment.shm_ptr);
     char* buffer = control->data;
     std::vector<char> message(message_size, 'P');
@@ -142,7 +341,7 @@ void IPCBenchmark::consumer(SharedMemorySegment& segment, size_t message_size, L
     }
 }
 
-double IPCBenchmark::measureThroughput(size_t message_size, int duration_seconds, LatencyStats& stats)
+double IPCBenchmark::measureThroughput(size_t message_size, int duration_seconds, LatencyStats& stats, uint64_t& bytes_moved)
 {
     SharedMemorySegment segment = createSharedMemory();
     SharedControlBlock* control = static_cast<SharedControlBlock*>(segment.shm_ptr);
@@ -154,6 +353,7 @@ double IPCBenchmark::measureThroughput(size_t message_size, int duration_seconds
             throw std::runtime_error("Failed to fork process");
         } else if (child_pid == 0) {
             // Child process - consumer
+            cpu_map.pin(1);
             LatencyStats child_stats;
             consumer(segment, message_size, child_stats);
             exit(0);
@@ -178,6 +378,7 @@ double IPCBenchmark::measureThroughput(size_t message_size, int duration_seconds
             double elapsed_nanoseconds = benchmark_timer.elapsedNanoseconds();
             double elapsed_seconds = elapsed_nanoseconds / NANOSECONDS_PER_SECOND;
             double throughput_mbps = (control->bytes_transferred / (1024.0 * 1024.0)) / elapsed_seconds;
+            bytes_moved = control->bytes_transferred;
 
             destroySharedMemory(segment);
             return throughput_mbps;
@@ -196,8 +397,11 @@ BenchmarkResult IPCBenchmark::run(int duration_seconds, int iterations, bool ver
     result.name = getName();
 
     try {
+        cpu_map = placement.resolve();
         std::vector<double> throughputs;
         LatencyStats combined_stats;
+        uint64_t messages = 0;
+        uint64_t message_bytes = 0;
 
         for (size_t message_size : MESSAGE_SIZES) {
             if (verbose) {
@@ -212,10 +416,13 @@ BenchmarkResult IPCBenchmark::run(int duration_seconds, int iterations, bool ver
 
             double total_throughput = 0.0;
             for (int i = 0; i < size_iterations; ++i) {
+                uint64_t bytes_moved = 0;
                 double throughput = measureThroughput(message_size,
                     duration_seconds / (sizeof(MESSAGE_SIZES) / sizeof(MESSAGE_SIZES[0])),
-                    size_stats);
+                    size_stats, bytes_moved);
                 total_throughput += throughput;
+                messages += bytes_moved / message_size;
+                message_bytes += bytes_moved;
 
                 for (size_t j = 0; j < size_stats.getCount(); ++j) {
                     combined_stats.addSample(size_stats.getPercentile((j * 100.0) / size_stats.getCount()));
@@ -250,6 +457,10 @@ BenchmarkResult IPCBenchmark::run(int duration_seconds, int iterations, bool ver
         result.extra_metrics["message_sizes_tested"] = sizeof(MESSAGE_SIZES) / sizeof(MESSAGE_SIZES[0]);
         result.extra_metrics["shared_memory_size_mb"] = SHM_SIZE / (1024.0 * 1024.0);
         result.extra_metrics["latency_samples_collected"] = static_cast<double>(combined_stats.getCount());
+        cpu_map.record(result, 2);
+
+        result.extra_metrics["work_ops"] = static_cast<double>(messages);
+        result.extra_metrics["work_bytes"] = static_cast<double>(message_bytes);
 
         result.status = "success";
 
@@ -259,4 +470,8 @@ BenchmarkResult IPCBenchmark::run(int duration_seconds, int iterations, bool ver
     }
 
     return result;
-}
\ No newline at end of file
+}
+std::unique_ptr<RateControlledWorkload> IPCBenchmark::createRateControlledWorkload()
+{
+    return std::make_unique<IPCRequestResponseWorkload>();
+}
@@ -2,6 +2,7 @@
 #define IPC_BENCH_H
 
 #include "benchmark.h"
+#include "thread_placement.h"
 #include "utils.h"
 #include <atomic>
 #include <fcntl.h>
@@ -32,7 +33,10 @@ private:
         char data[]; // Variable size data follows
     };
 
-    double measureThroughput(size_t message_size, int duration_seconds, LatencyStats& stats);
+    ThreadPlacement placement;
+    CpuPlacement cpu_map; // producer on slot 0, consumer process on slot 1
+
+    double measureThroughput(size_t message_size, int duration_seconds, LatencyStats& stats, uint64_t& bytes_moved);
     void producer(SharedMemorySegment& segment, size_t message_size);
     void consumer(SharedMemorySegment& segment, size_t message_size, LatencyStats& stats);
 
@@ -40,8 +44,11 @@ private:
     void destroySharedMemory(SharedMemorySegment& segment);
 
 public:
+    explicit IPCBenchmark(const ThreadPlacement& placement = ThreadPlacement());
+
     BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
     std::string getName() const override { return "IPC Shared Memory"; }
+    std::unique_ptr<RateControlledWorkload> createRateControlledWorkload() override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "irq_stats.h"
+#include "proc_reader.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+
+enum class DeviceClass { None, Network, Block };
+
+bool hasPrefix(const char* token, size_t length, const char* prefix)
+{
+    size_t n = strlen(prefix);
+    return length >= n && memcmp(token, prefix, n) == 0;
+}
+
+bool contains(const char* token, size_t length, const char* needle)
+{
+    size_t n = strlen(needle);
+    for (size_t i = 0; i + n <= length; ++i) {
+        if (memcmp(token + i, needle, n) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The last column of /proc/interrupts names the device or queue, e.g. "eth0-TxRx-3",
+// "nvme0q2" or "virtio1-req.0" (virtio-net queues are "virtioN-input.Q" / "-output.Q")
+DeviceClass classifyDevice(const char* name, size_t length)
+{
+    static const char* const network_prefixes[] = { "eth", "ens", "enp", "eno", "mlx", "ixgbe", "i40e", "ice-",
+        "igb", "bnxt", "ena-", "gve", "efa" };
+    static const char* const block_prefixes[] = { "nvme", "ahci", "ata_", "megasas", "mpt3sas", "xen-blkfront" };
+
+    for (const char* prefix : network_prefixes) {
+        if (hasPrefix(name, length, prefix)) {
+            return DeviceClass::Network;
+        }
+    }
+    for (const char* prefix : block_prefixes) {
+        if (hasPrefix(name, length, prefix)) {
+            return DeviceClass::Block;
+        }
+    }
+    if (hasPrefix(name, length, "virtio")) {
+        if (contains(name, length, "-input.") || contains(name, length, "-output.")) {
+            return DeviceClass::Network;
+        }
+        if (contains(name, length, "-req.")) {
+            return DeviceClass::Block;
+        }
+    }
+    return DeviceClass::None;
+}
+
+void addCounts(std::vector<uint64_t>& target, const std::vector<int>& columns, const std::vector<uint64_t>& counts,
+    size_t parsed)
+{
+    for (size_t column = 0; column < parsed; ++column) {
+        target[static_cast<size_t>(columns[column])] += counts[column];
+    }
+}
+
+// Walks a per-CPU table: a "CPU0 CPU1 ..." header, then "<label>: <count per CPU> [description]" rows
+template <typename RowHandler>
+void parseCpuTable(const ProcFile& file, IrqCounters& counters, RowHandler handle_row)
+{
+    ProcScanner scan(file);
+    std::vector<int> columns;
+    const char* token = nullptr;
+    size_t token_length = 0;
+    while (scan.nextToken(token, token_length)) {
+        if (hasPrefix(token, token_length, "CPU")) {
+            columns.push_back(std::atoi(std::string(token + 3, token_length - 3).c_str()));
+        }
+    }
+    scan.skipLine();
+    if (columns.empty()) {
+        return;
+    }
+
+    size_t cpu_slots = static_cast<size_t>(*std::max_element(columns.begin(), columns.end())) + 1;
+    for (auto* series : { &counters.net_rx, &counters.net_tx, &counters.block, &counters.timer,
+             &counters.net_device, &counters.block_device, &counters.local_timer }) {
+        if (series->size() < cpu_slots) {
+            series->resize(cpu_slots, 0);
+        }
+    }
+
+    std::vector<uint64_t> counts(columns.size(), 0);
+    for (; !scan.atEnd(); scan.skipLine()) {
+        scan.skipSpaces();
+        const char* label = scan.position();
+        if (!scan.skipPast(':')) {
+            continue;
+        }
+        size_t label_length = static_cast<size_t>(scan.position() - label) - 1;
+
+        size_t parsed = 0;
+        while (parsed < columns.size() && scan.nextUint(counts[parsed])) {
+            ++parsed;
+        }
+
+        // Keep the last token of the description: the device or queue name
+        const char* device = nullptr;
+        size_t device_length = 0;
+        while (scan.nextToken(token, token_length)) {
+            device = token;
+            device_length = token_length;
+        }
+
+        handle_row(label, label_length, device, device_length, columns, counts, parsed);
+    }
+    counters.valid = true;
+}
+
+uint64_t sumOver(const std::vector<uint64_t>& delta, const std::vector<int>& cpus)
+{
+    uint64_t total = 0;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && static_cast<size_t>(cpu) < delta.size()) {
+            total += delta[static_cast<size_t>(cpu)];
+        }
+    }
+    return total;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus)
+{
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        out << (i ? "," : "") << cpus[i];
+    }
+    return out.str();
+}
+
+}
+
+IrqCounters IrqCounters::capture()
+{
+    IrqCounters counters;
+#ifdef __linux__
+    ProcFile interrupts("/proc/interrupts", 65536);
+    if (interrupts.read()) {
+        parseCpuTable(interrupts, counters, [&](const char* label, size_t label_length, const char* device,
+                                                 size_t device_length, const std::vector<int>& columns,
+                                                 const std::vector<uint64_t>& counts, size_t parsed) {
+            if (tokenEquals(label, label_length, "LOC")) {
+                addCounts(counters.local_timer, columns, counts, parsed);
+                return;
+            }
+            if (label_length == 0 || label[0] < '0' || label[0] > '9' || device == nullptr) {
+                return;
+            }
+            switch (classifyDevice(device, device_length)) {
+            case DeviceClass::Network:
+                addCounts(counters.net_device, columns, counts, parsed);
+                break;
+            case DeviceClass::Block:
+                addCounts(counters.block_device, columns, counts, parsed);
+                break;
+            case DeviceClass::None:
+                break;
+            }
+        });
+    }
+
+    ProcFile softirqs("/proc/softirqs", 8192);
+    if (softirqs.read()) {
+        parseCpuTable(softirqs, counters, [&](const char* label, size_t label_length, const char*, size_t,
+                                              const std::vector<int>& columns, const std::vector<uint64_t>& counts,
+                                              size_t parsed) {
+            if (tokenEquals(label, label_length, "NET_RX")) {
+                addCounts(counters.net_rx, columns, counts, parsed);
+            } else if (tokenEquals(label, label_length, "NET_TX")) {
+                addCounts(counters.net_tx, columns, counts, parsed);
+            } else if (tokenEquals(label, label_length, "BLOCK")) {
+                addCounts(counters.block, columns, counts, parsed);
+            } else if (tokenEquals(label, label_length, "TIMER") || tokenEquals(label, label_length, "HRTIMER")) {
+                addCounts(counters.timer, columns, counts, parsed);
+            }
+        });
+    }
+#endif
+    return counters;
+}
+
+void applyIrqDistribution(BenchmarkResult& result, const IrqCounters& start, const IrqCounters& end,
+    const std::vector<int>& pinned_cpus)
+{
+    if (!start.valid || !end.valid) {
+        result.extra_info["irq.source"] = "unavailable";
+        return;
+    }
+
+    struct IrqClass {
+        const char* name;
+        const std::vector<uint64_t>* start;
+        const std::vector<uint64_t>* end;
+        bool flag_overlap; // timer work lands on every busy CPU and is not an affinity problem
+    };
+    const IrqClass classes[] = {
+        { "net_rx", &start.net_rx, &end.net_rx, true },
+        { "net_tx", &start.net_tx, &end.net_tx, true },
+        { "block", &start.block, &end.block, true },
+        { "timer", &start.timer, &end.timer, false },
+        { "net_irq", &start.net_device, &end.net_device, true },
+        { "block_irq", &start.block_device, &end.block_device, true },
+        { "local_timer", &start.local_timer, &end.local_timer, false },
+    };
+
+    // Too few events to call the placement a pattern
+    const uint64_t MIN_EVENTS_FOR_OVERLAP = 100;
+    std::vector<std::string> overlaps;
+
+    for (const auto& irq_class : classes) {
+        std::vector<uint64_t> delta(irq_class.end->size(), 0);
+        uint64_t total = 0;
+        uint64_t busiest = 0;
+        std::ostringstream per_cpu;
+        for (size_t cpu = 0; cpu < delta.size(); ++cpu) {
+            uint64_t before = cpu < irq_class.start->size() ? (*irq_class.start)[cpu] : 0;
+            delta[cpu] = (*irq_class.end)[cpu] > before ? (*irq_class.end)[cpu] - before : 0;
+            if (delta[cpu] > 0) {
+                per_cpu << (total > 0 ? " " : "") << "cpu" << cpu << "=" << delta[cpu];
+            }
+            total += delta[cpu];
+            busiest = std::max(busiest, delta[cpu]);
+        }
+
+        std::string prefix = std::string("irq_") + irq_class.name;
+        result.extra_metrics[prefix + "_total"] = static_cast<double>(total);
+        if (total == 0) {
+            continue;
+        }
+        result.extra_metrics[prefix + "_top_cpu_share"] = static_cast<double>(busiest) / total;
+        result.extra_info[std::string("irq.") + irq_class.name + ".per_cpu"] = per_cpu.str();
+
+        if (!pinned_cpus.empty()) {
+            double on_pinned = static_cast<double>(sumOver(delta, pinned_cpus)) / total * 100.0;
+            result.extra_metrics[prefix + "_on_pinned_percent"] = on_pinned;
+            if (irq_class.flag_overlap && on_pinned > 0.0 && total >= MIN_EVENTS_FOR_OVERLAP) {
+                std::ostringstream overlap;
+                overlap << irq_class.name << " " << static_cast<int>(on_pinned + 0.5) << "%";
+                overlaps.push_back(overlap.str());
+            }
+        }
+    }
+
+    result.extra_info["irq.source"] = "/proc/interrupts+/proc/softirqs";
+    if (pinned_cpus.empty()) {
+        result.extra_info["irq.benchmark_cpus"] = "unpinned";
+        return;
+    }
+    result.extra_info["irq.benchmark_cpus"] = formatCpuList(pinned_cpus);
+    if (overlaps.empty()) {
+        result.extra_info["irq.overlap"] = "none";
+    } else {
+        std::ostringstream summary;
+        for (size_t i = 0; i < overlaps.size(); ++i) {
+            summary << (i ? ", " : "") << overlaps[i];
+        }
+        summary << " of events on pinned CPUs " << formatCpuList(pinned_cpus);
+        result.extra_info["irq.overlap"] = summary.str();
+    }
+}
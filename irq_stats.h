@@ -0,0 +1,34 @@
+#ifndef IRQ_STATS_H
+#define IRQ_STATS_H
+
+#include "benchmark.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per-CPU interrupt and softirq counters from /proc/interrupts and
+// /proc/softirqs, grouped into the classes that disturb benchmarks. Counts
+// are cumulative since boot and indexed by CPU number.
+struct IrqCounters {
+    bool valid { false };
+
+    // Softirqs
+    std::vector<uint64_t> net_rx;
+    std::vector<uint64_t> net_tx;
+    std::vector<uint64_t> block;
+    std::vector<uint64_t> timer; // TIMER + HRTIMER
+
+    // Hardware interrupts, classified by the device name in /proc/interrupts
+    std::vector<uint64_t> net_device;
+    std::vector<uint64_t> block_device;
+    std::vector<uint64_t> local_timer; // LOC
+
+    static IrqCounters capture();
+};
+
+// Adds per-CPU irq_* deltas between two captures to the result and flags
+// overlap with the CPUs the benchmark threads were pinned to (empty = unpinned)
+void applyIrqDistribution(BenchmarkResult& result, const IrqCounters& start, const IrqCounters& end,
+    const std::vector<int>& pinned_cpus);
+
+#endif
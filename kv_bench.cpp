@@ -0,0 +1,398 @@
+#include "kv_bench.h"
+#include "cgroup.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr double ZIPFIAN_THETA = 0.99;
+
+uint64_t fnvHash64(uint64_t value)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (int i = 0; i < 8; ++i) {
+        hash ^= value & 0xFF;
+        hash *= 0x100000001B3ULL;
+        value >>= 8;
+    }
+    return hash;
+}
+
+struct FastRandom {
+    uint64_t state;
+
+    explicit FastRandom(uint64_t seed)
+        : state(seed ? seed : 0x9E3779B97F4A7C15ULL)
+    {
+    }
+
+    uint64_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    double nextDouble() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+// Gray et al. zipfian generator as used by YCSB; the zeta constant is
+// computed once for the loaded key space.
+class ZipfianGenerator {
+private:
+    uint64_t items;
+    double theta;
+    double zetan;
+    double alpha;
+    double eta;
+    double half_pow_theta;
+
+    static double zeta(uint64_t n, double theta)
+    {
+        double sum = 0.0;
+        for (uint64_t i = 1; i <= n; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        }
+        return sum;
+    }
+
+public:
+    ZipfianGenerator(uint64_t items, double theta)
+        : items(std::max<uint64_t>(2, items))
+        , theta(theta)
+    {
+        zetan = zeta(this->items, theta);
+        double zeta2 = zeta(2, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / this->items, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+        half_pow_theta = 1.0 + std::pow(0.5, theta);
+    }
+
+    uint64_t next(FastRandom& rng) const
+    {
+        double u = rng.nextDouble();
+        double uz = u * zetan;
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < half_pow_theta) {
+            return 1;
+        }
+        uint64_t value = static_cast<uint64_t>(items * std::pow(eta * u - eta + 1.0, alpha));
+        return std::min(value, items - 1);
+    }
+
+    // Spread popular items over the key space instead of clustering at key 0
+    uint64_t nextScrambled(FastRandom& rng, uint64_t key_space) const
+    {
+        return fnvHash64(next(rng)) % key_space;
+    }
+};
+
+const char* OP_NAMES[] = { "read", "update", "insert", "scan", "rmw" };
+constexpr int OP_COUNT = 5;
+
+}
+
+KVBenchmark::KVBenchmark()
+    : KVBenchmark(KVBenchmarkConfig())
+{
+}
+
+KVBenchmark::KVBenchmark(const KVBenchmarkConfig& config)
+    : config(config)
+{
+}
+
+bool KVBenchmark::lookupWorkload(char name, WorkloadSpec& spec)
+{
+    switch (std::toupper(static_cast<unsigned char>(name))) {
+    case 'A': // update heavy
+        spec = { 'A', 0.50, 0.50, 0.0, 0.0, 0.0, KeyDistribution::ZIPFIAN };
+        return true;
+    case 'B': // read mostly
+        spec = { 'B', 0.95, 0.05, 0.0, 0.0, 0.0, KeyDistribution::ZIPFIAN };
+        return true;
+    case 'C': // read only
+        spec = { 'C', 1.00, 0.0, 0.0, 0.0, 0.0, KeyDistribution::ZIPFIAN };
+        return true;
+    case 'D': // read latest
+        spec = { 'D', 0.95, 0.0, 0.05, 0.0, 0.0, KeyDistribution::LATEST };
+        return true;
+    case 'E': // short ranges
+        spec = { 'E', 0.0, 0.0, 0.05, 0.95, 0.0, KeyDistribution::ZIPFIAN };
+        return true;
+    case 'F': // read-modify-write
+        spec = { 'F', 0.50, 0.0, 0.0, 0.0, 0.50, KeyDistribution::ZIPFIAN };
+        return true;
+    default:
+        return false;
+    }
+}
+
+KVBenchmark::WorkloadResult KVBenchmark::runWorkload(KVStore& store, const WorkloadSpec& spec, int threads,
+    int duration_seconds, std::vector<double>& all_latencies_us)
+{
+    WorkloadResult result;
+    result.name = spec.name;
+
+    ZipfianGenerator zipfian(config.record_count, ZIPFIAN_THETA);
+    std::atomic<bool> should_stop(false);
+    std::atomic<uint64_t> total_ops(0);
+    std::vector<std::vector<SampleReservoir>> samples(threads, std::vector<SampleReservoir>(OP_COUNT));
+    std::vector<std::exception_ptr> errors(threads);
+
+    auto worker = [&](int thread_id) {
+        try {
+            FastRandom rng(fnvHash64(static_cast<uint64_t>(thread_id) + 1) ^ static_cast<uint64_t>(spec.name));
+            std::string value(config.value_size, 'v');
+            std::string read_value;
+            std::vector<std::string> scan_values;
+            uint64_t ops = 0;
+
+            const double update_cut = spec.read + spec.update;
+            const double insert_cut = update_cut + spec.insert;
+            const double scan_cut = insert_cut + spec.scan;
+
+            while (!should_stop.load(std::memory_order_relaxed)) {
+                // Reads only target keys whose insert has returned
+                uint64_t keys = acked_key_space.load(std::memory_order_acquire);
+                uint64_t key;
+                if (spec.distribution == KeyDistribution::LATEST) {
+                    uint64_t offset = zipfian.next(rng);
+                    key = keys - 1 - std::min(offset, keys - 1);
+                } else {
+                    key = zipfian.nextScrambled(rng, keys);
+                }
+
+                double choice = rng.nextDouble();
+                int op;
+                bool inserted = false;
+                uint64_t new_key = 0;
+                auto start = std::chrono::steady_clock::now();
+
+                if (choice < spec.read) {
+                    op = 0;
+                    store.get(key, read_value);
+                } else if (choice < update_cut) {
+                    op = 1;
+                    value[rng.next() % value.size()] = static_cast<char>('a' + rng.next() % 26);
+                    store.put(key, value);
+                } else if (choice < insert_cut) {
+                    op = 2;
+                    new_key = key_space.fetch_add(1, std::memory_order_relaxed);
+                    store.put(new_key, value);
+                    inserted = true;
+                } else if (choice < scan_cut) {
+                    op = 3;
+                    size_t length = 1 + rng.next() % config.max_scan_length;
+                    store.scan(key, length, scan_values);
+                } else {
+                    op = 4;
+                    store.get(key, read_value);
+                    if (!read_value.empty()) {
+                        read_value[0] = static_cast<char>(read_value[0] + 1);
+                    }
+                    store.put(key, read_value.empty() ? value : read_value);
+                }
+
+                auto end = std::chrono::steady_clock::now();
+                samples[thread_id][op].add(std::chrono::duration<double, std::micro>(end - start).count());
+                ++ops;
+
+                // Acknowledge inserts in key order so [0, acked) never has holes
+                uint64_t expected = new_key;
+                while (inserted && !acked_key_space.compare_exchange_weak(expected, new_key + 1, std::memory_order_release)
+                    && !should_stop.load(std::memory_order_relaxed)) {
+                    expected = new_key;
+                    std::this_thread::yield();
+                }
+            }
+
+            total_ops.fetch_add(ops);
+        } catch (...) {
+            errors[thread_id] = std::current_exception();
+            should_stop.store(true);
+        }
+    };
+
+    Timer timer;
+    timer.start();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back(worker, t);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(duration_seconds);
+    while (!should_stop.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    should_stop.store(true);
+    for (auto& t : workers) {
+        t.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    result.elapsed_seconds = timer.elapsedSeconds();
+    result.operations = total_ops.load();
+
+    for (int op = 0; op < OP_COUNT; ++op) {
+        LatencyStats stats;
+        for (int t = 0; t < threads; ++t) {
+            for (double sample : samples[t][op].samples) {
+                stats.addSample(sample);
+                all_latencies_us.push_back(sample);
+            }
+        }
+        if (stats.getCount() > 0) {
+            result.op_latency_us.emplace_back(OP_NAMES[op], stats);
+        }
+    }
+
+    return result;
+}
+
+BenchmarkResult KVBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    try {
+        std::vector<WorkloadSpec> specs;
+        std::string workload_names;
+        for (char name : config.workloads) {
+            WorkloadSpec spec;
+            if (lookupWorkload(name, spec)) {
+                specs.push_back(spec);
+                workload_names += workload_names.empty() ? "" : ",";
+                workload_names += spec.name;
+            }
+        }
+        if (specs.empty()) {
+            throw std::runtime_error("No valid YCSB workloads in '" + config.workloads + "' (expected A-F)");
+        }
+
+        int threads = config.threads > 0 ? config.threads : Cgroup::effectiveCpuCount();
+        int workload_seconds = std::max(1, duration_seconds / static_cast<int>(specs.size()));
+
+        KVStoreConfig store_config;
+        store_config.directory = config.directory + "/kv_bench_" + std::to_string(getpid());
+        store_config.remove_files_on_close = true;
+        KVStore store(store_config);
+
+        // Load phase: bulk insert without per-record sync, then make it durable once
+        if (verbose) {
+            std::cout << "  Loading " << config.record_count << " records (" << config.value_size << " B values)...\n";
+        }
+        Timer load_timer;
+        load_timer.start();
+        std::atomic<uint64_t> next_load_key(0);
+        std::atomic<bool> load_failed(false);
+        std::vector<std::exception_ptr> load_errors(threads);
+        std::vector<std::thread> loaders;
+        for (int t = 0; t < threads; ++t) {
+            loaders.emplace_back([&, t]() {
+                try {
+                    std::string value(config.value_size, 'v');
+                    uint64_t key;
+                    while (!load_failed.load(std::memory_order_relaxed)
+                        && (key = next_load_key.fetch_add(1)) < config.record_count) {
+                        store.put(key, value, false);
+                    }
+                } catch (...) {
+                    load_errors[t] = std::current_exception();
+                    load_failed.store(true);
+                }
+            });
+        }
+        for (auto& t : loaders) {
+            t.join();
+        }
+        for (const auto& error : load_errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        store.flush();
+        double load_seconds = load_timer.elapsedSeconds();
+        key_space.store(config.record_count);
+        acked_key_space.store(config.record_count);
+
+        uint64_t total_ops = 0;
+        double total_seconds = 0.0;
+        std::vector<double> all_latencies_us;
+
+        for (const auto& spec : specs) {
+            if (verbose) {
+                std::cout << "  Running workload " << spec.name << " with " << threads << " threads...\n";
+            }
+
+            WorkloadResult workload = runWorkload(store, spec, threads, workload_seconds, all_latencies_us);
+            total_ops += workload.operations;
+            total_seconds += workload.elapsed_seconds;
+
+            std::string prefix = std::string("kv_") + static_cast<char>(std::tolower(spec.name)) + "_";
+            double ops_sec = workload.elapsed_seconds > 0.0 ? workload.operations / workload.elapsed_seconds : 0.0;
+            result.extra_metrics[prefix + "ops_sec"] = ops_sec;
+            for (auto& entry : workload.op_latency_us) {
+                std::string op_prefix = prefix + entry.first + "_";
+                result.extra_metrics[op_prefix + "avg_us"] = entry.second.getAverage();
+                result.extra_metrics[op_prefix + "p50_us"] = entry.second.getPercentile(50);
+                result.extra_metrics[op_prefix + "p99_us"] = entry.second.getPercentile(99);
+                result.extra_metrics[op_prefix + "p999_us"] = entry.second.getPercentile(99.9);
+            }
+
+            if (verbose) {
+                std::cout << "    " << ops_sec << " ops/s\n";
+            }
+        }
+
+        LatencyStats overall;
+        for (double sample : all_latencies_us) {
+            overall.addSample(sample);
+        }
+
+        result.throughput = total_seconds > 0.0 ? total_ops / total_seconds : 0.0;
+        result.throughput_unit = "ops/sec";
+        result.avg_latency = overall.getAverage();
+        result.min_latency = overall.getMin();
+        result.max_latency = overall.getMax();
+        result.p50_latency = overall.getPercentile(50);
+        result.p90_latency = overall.getPercentile(90);
+        result.p99_latency = overall.getPercentile(99);
+        result.latency_unit = "us";
+
+        KVStoreStats store_stats = store.getStats();
+        result.extra_metrics["work_ops"] = static_cast<double>(total_ops);
+        result.extra_metrics["kv_threads"] = threads;
+        result.extra_metrics["kv_records_loaded"] = static_cast<double>(config.record_count);
+        result.extra_metrics["kv_records_final"] = static_cast<double>(store.size());
+        result.extra_metrics["kv_load_ops_sec"] = load_seconds > 0.0 ? config.record_count / load_seconds : 0.0;
+        result.extra_metrics["kv_group_commit_avg_batch"] = store_stats.avg_commit_batch;
+        result.extra_metrics["kv_fdatasyncs"] = static_cast<double>(store_stats.fdatasyncs);
+        result.extra_metrics["kv_log_written_mb"] = store_stats.bytes_appended / (1024.0 * 1024.0);
+        result.extra_metrics["kv_compactions"] = static_cast<double>(store_stats.compactions);
+        result.extra_metrics["kv_compaction_reclaimed_mb"] = store_stats.compaction_bytes_reclaimed / (1024.0 * 1024.0);
+        result.extra_metrics["kv_segments"] = static_cast<double>(store_stats.segments);
+        result.extra_info["kv.workloads"] = workload_names;
+        result.extra_info["kv.key_distribution"] = "zipfian(0.99)";
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    return result;
+}
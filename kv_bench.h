@@ -0,0 +1,61 @@
+#ifndef KV_BENCH_H
+#define KV_BENCH_H
+
+#include "benchmark.h"
+#include "kv_store.h"
+#include "utils.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+struct KVBenchmarkConfig {
+    size_t record_count { 100000 };
+    size_t value_size { 1000 }; // YCSB default: 10 fields x 100 bytes
+    int threads { 0 }; // 0 = one per available core
+    std::string workloads { "ABCDEF" };
+    size_t max_scan_length { 100 };
+    std::string directory { "/tmp" };
+};
+
+// YCSB-style workloads (A-F) driven against the bundled KVStore
+class KVBenchmark : public Benchmark {
+private:
+    enum class KeyDistribution {
+        ZIPFIAN,
+        LATEST
+    };
+
+    struct WorkloadSpec {
+        char name;
+        double read;
+        double update;
+        double insert;
+        double scan;
+        double read_modify_write;
+        KeyDistribution distribution;
+    };
+
+    struct WorkloadResult {
+        char name { 'A' };
+        uint64_t operations { 0 };
+        double elapsed_seconds { 0.0 };
+        std::vector<std::pair<std::string, LatencyStats>> op_latency_us;
+    };
+
+    KVBenchmarkConfig config;
+    std::atomic<uint64_t> key_space { 0 }; // next key handed to an insert from workloads D and E
+    std::atomic<uint64_t> acked_key_space { 0 }; // keys below this have been stored; reads draw from here
+
+    static bool lookupWorkload(char name, WorkloadSpec& spec);
+    WorkloadResult runWorkload(KVStore& store, const WorkloadSpec& spec, int threads, int duration_seconds,
+        std::vector<double>& all_latencies_us);
+
+public:
+    KVBenchmark();
+    explicit KVBenchmark(const KVBenchmarkConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "KV Store (YCSB)"; }
+};
+
+#endif
@@ -0,0 +1,457 @@
+#include "kv_store.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+uint32_t recordChecksum(uint64_t key, const char* value, uint32_t length)
+{
+    uint32_t hash = 2166136261u;
+    const unsigned char* key_bytes = reinterpret_cast<const unsigned char*>(&key);
+    for (size_t i = 0; i < sizeof(key); ++i) {
+        hash ^= key_bytes[i];
+        hash *= 16777619u;
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(value);
+    for (uint32_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool preadFully(int fd, char* buffer, size_t length, uint64_t offset)
+{
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool pwriteFully(int fd, const char* buffer, size_t length, uint64_t offset)
+{
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = pwrite(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}
+
+KVStore::Segment::~Segment()
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (remove_on_close) {
+        unlink(path.c_str());
+    }
+}
+
+KVStore::KVStore(const KVStoreConfig& config)
+    : config(config)
+{
+    if (this->config.directory.empty()) {
+        throw std::invalid_argument("KV store directory must be set");
+    }
+    if (mkdir(this->config.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Failed to create KV store directory: " + this->config.directory);
+    }
+
+    size_t shard_count = std::max<size_t>(1, this->config.index_shards);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards.emplace_back(new IndexShard());
+    }
+
+    active_segment = openSegment();
+    compaction_thread = std::thread(&KVStore::compactionLoop, this);
+}
+
+KVStore::~KVStore()
+{
+    stop_compaction.store(true);
+    if (compaction_thread.joinable()) {
+        compaction_thread.join();
+    }
+
+    try {
+        flush();
+    } catch (...) {
+    }
+
+    std::unique_lock<std::shared_mutex> lock(segments_mutex);
+    for (auto& entry : segments) {
+        entry.second->remove_on_close = config.remove_files_on_close;
+    }
+    segments.clear();
+    active_segment.reset();
+    lock.unlock();
+
+    if (config.remove_files_on_close) {
+        rmdir(config.directory.c_str());
+    }
+}
+
+std::shared_ptr<KVStore::Segment> KVStore::openSegment()
+{
+    auto segment = std::make_shared<Segment>();
+    segment->id = next_segment_id++;
+    segment->path = config.directory + "/segment_" + std::to_string(segment->id) + ".log";
+    segment->fd = open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segment->fd < 0) {
+        throw std::runtime_error("Failed to open KV segment: " + segment->path);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(segments_mutex);
+    segments[segment->id] = segment;
+    return segment;
+}
+
+std::shared_ptr<KVStore::Segment> KVStore::findSegment(uint32_t id) const
+{
+    std::shared_lock<std::shared_mutex> lock(segments_mutex);
+    auto it = segments.find(id);
+    return it != segments.end() ? it->second : nullptr;
+}
+
+void KVStore::put(uint64_t key, const std::string& value, bool sync)
+{
+    append(key, value.data(), static_cast<uint32_t>(value.size()), sync, nullptr);
+}
+
+void KVStore::flush()
+{
+    std::unique_lock<std::mutex> lock(commit_mutex);
+    pending_needs_sync = true;
+    uint64_t sequence = ++enqueued_sequence;
+    waitForCommit(lock, sequence);
+}
+
+void KVStore::append(uint64_t key, const char* value, uint32_t length, bool sync, const Location* expected)
+{
+    uint32_t checksum = recordChecksum(key, value, length);
+
+    std::unique_lock<std::mutex> lock(commit_mutex);
+    PendingRecord record;
+    record.key = key;
+    record.length = length;
+    record.batch_offset = pending_bytes.size();
+    record.conditional = expected != nullptr;
+    record.expected = expected ? *expected : Location();
+
+    size_t offset = pending_bytes.size();
+    pending_bytes.resize(offset + RECORD_HEADER_SIZE + length);
+    char* out = pending_bytes.data() + offset;
+    memcpy(out, &checksum, sizeof(checksum));
+    memcpy(out + sizeof(checksum), &length, sizeof(length));
+    memcpy(out + sizeof(checksum) + sizeof(length), &key, sizeof(key));
+    memcpy(out + RECORD_HEADER_SIZE, value, length);
+
+    pending_records.push_back(record);
+    pending_needs_sync = pending_needs_sync || sync;
+    uint64_t sequence = ++enqueued_sequence;
+    waitForCommit(lock, sequence);
+}
+
+void KVStore::waitForCommit(std::unique_lock<std::mutex>& lock, uint64_t sequence)
+{
+    // Leader/follower group commit: whoever finds no commit in flight takes
+    // everything queued so far and commits it on behalf of the waiters.
+    while (committed_sequence < sequence) {
+        if (commit_error) {
+            std::rethrow_exception(commit_error);
+        }
+        if (commit_in_progress) {
+            commit_cv.wait(lock);
+            continue;
+        }
+
+        commit_in_progress = true;
+        std::vector<char> bytes;
+        std::vector<PendingRecord> records;
+        bytes.swap(pending_bytes);
+        records.swap(pending_records);
+        bool sync = pending_needs_sync;
+        pending_needs_sync = false;
+        uint64_t batch_end = enqueued_sequence;
+        lock.unlock();
+
+        try {
+            commitBatch(bytes, records, sync);
+        } catch (...) {
+            lock.lock();
+            commit_error = std::current_exception();
+            commit_in_progress = false;
+            commit_cv.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        committed_sequence = batch_end;
+        commit_in_progress = false;
+        if (pending_bytes.empty() && pending_bytes.capacity() < bytes.capacity()) {
+            bytes.clear();
+            pending_bytes.swap(bytes);
+        }
+        commit_cv.notify_all();
+    }
+}
+
+void KVStore::commitBatch(std::vector<char>& bytes, std::vector<PendingRecord>& records, bool sync)
+{
+    std::shared_ptr<Segment> segment = active_segment;
+
+    if (!bytes.empty()) {
+        uint64_t current_size = segment->size.load();
+        if (current_size > 0 && current_size + bytes.size() > config.segment_size) {
+            // Roll the log; the sealed segment becomes eligible for compaction
+            if (fdatasync(segment->fd) == 0) {
+                fdatasyncs.fetch_add(1, std::memory_order_relaxed);
+            }
+            {
+                std::unique_lock<std::shared_mutex> lock(segments_mutex);
+                segment->sealed = true;
+            }
+            segment = openSegment();
+            active_segment = segment;
+        }
+
+        uint64_t base = segment->size.load();
+        if (!pwriteFully(segment->fd, bytes.data(), bytes.size(), base)) {
+            throw std::runtime_error("KV log append failed: " + std::string(strerror(errno)));
+        }
+        segment->size.store(base + bytes.size());
+        bytes_appended.fetch_add(bytes.size(), std::memory_order_relaxed);
+
+        if (sync && fdatasync(segment->fd) == 0) {
+            fdatasyncs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Records become visible only after they are in the log (and durable when synced)
+        for (const PendingRecord& record : records) {
+            Location location;
+            location.segment = segment->id;
+            location.offset = base + record.batch_offset;
+            location.length = static_cast<uint32_t>(RECORD_HEADER_SIZE + record.length);
+
+            IndexShard& shard = shardFor(record.key);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.entries.find(record.key);
+            if (record.conditional && (it == shard.entries.end() || !(it->second == record.expected))) {
+                lock.unlock();
+                markDead(location);
+                continue;
+            }
+            if (it != shard.entries.end()) {
+                Location previous = it->second;
+                it->second = location;
+                lock.unlock();
+                markDead(previous);
+            } else {
+                shard.entries.emplace(record.key, location);
+            }
+        }
+
+        commits.fetch_add(1, std::memory_order_relaxed);
+        committed_records.fetch_add(records.size(), std::memory_order_relaxed);
+    } else if (sync) {
+        if (fdatasync(segment->fd) == 0) {
+            fdatasyncs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void KVStore::markDead(const Location& location)
+{
+    std::shared_ptr<Segment> segment = findSegment(location.segment);
+    if (segment) {
+        segment->dead_bytes.fetch_add(location.length, std::memory_order_relaxed);
+    }
+}
+
+bool KVStore::get(uint64_t key, std::string& value) const
+{
+    // Retry if compaction retires the segment between the index lookup and the read
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        Location location;
+        {
+            IndexShard& shard = shardFor(key);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it == shard.entries.end()) {
+                return false;
+            }
+            location = it->second;
+        }
+
+        std::shared_ptr<Segment> segment = findSegment(location.segment);
+        if (!segment) {
+            continue;
+        }
+
+        value.resize(location.length - RECORD_HEADER_SIZE);
+        if (preadFully(segment->fd, &value[0], value.size(), location.offset + RECORD_HEADER_SIZE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t KVStore::scan(uint64_t start_key, size_t count, std::vector<std::string>& values) const
+{
+    values.resize(std::max(values.size(), count));
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (get(start_key + i, values[found])) {
+            ++found;
+        }
+    }
+    return found;
+}
+
+size_t KVStore::size() const
+{
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        total += shard->entries.size();
+    }
+    return total;
+}
+
+void KVStore::compactionLoop()
+{
+    while (!stop_compaction.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.compaction_poll_ms));
+
+        std::shared_ptr<Segment> candidate;
+        double worst_ratio = config.compaction_dead_ratio;
+        {
+            std::shared_lock<std::shared_mutex> lock(segments_mutex);
+            for (const auto& entry : segments) {
+                const auto& segment = entry.second;
+                uint64_t size = segment->size.load();
+                if (!segment->sealed || size == 0) {
+                    continue;
+                }
+                double ratio = static_cast<double>(segment->dead_bytes.load()) / size;
+                if (ratio >= worst_ratio) {
+                    worst_ratio = ratio;
+                    candidate = segment;
+                }
+            }
+        }
+
+        if (candidate) {
+            try {
+                compactSegment(candidate);
+            } catch (const std::exception&) {
+                // Leave the segment in place; it will be retried on the next pass
+            }
+        }
+    }
+}
+
+bool KVStore::compactSegment(const std::shared_ptr<Segment>& segment)
+{
+    uint64_t size = segment->size.load();
+    std::vector<char> data(size);
+    if (!preadFully(segment->fd, data.data(), data.size(), 0)) {
+        return false;
+    }
+
+    uint64_t moved_bytes = 0;
+    uint64_t offset = 0;
+    while (offset + RECORD_HEADER_SIZE <= size && !stop_compaction.load()) {
+        uint32_t checksum;
+        uint32_t length;
+        uint64_t key;
+        memcpy(&checksum, data.data() + offset, sizeof(checksum));
+        memcpy(&length, data.data() + offset + sizeof(checksum), sizeof(length));
+        memcpy(&key, data.data() + offset + sizeof(checksum) + sizeof(length), sizeof(key));
+        if (offset + RECORD_HEADER_SIZE + length > size) {
+            break;
+        }
+
+        const char* value = data.data() + offset + RECORD_HEADER_SIZE;
+        Location location;
+        location.segment = segment->id;
+        location.offset = offset;
+        location.length = static_cast<uint32_t>(RECORD_HEADER_SIZE + length);
+
+        bool live = false;
+        {
+            IndexShard& shard = shardFor(key);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            live = it != shard.entries.end() && it->second == location;
+        }
+
+        if (live && recordChecksum(key, value, length) == checksum) {
+            // Conditional append: skipped if a newer write lands meanwhile
+            append(key, value, length, false, &location);
+            moved_bytes += location.length;
+            compaction_records_moved.fetch_add(1, std::memory_order_relaxed);
+        }
+        offset += location.length;
+    }
+
+    if (stop_compaction.load()) {
+        return false;
+    }
+
+    // Moved records must be durable before the old segment disappears
+    flush();
+
+    {
+        std::unique_lock<std::shared_mutex> lock(segments_mutex);
+        segment->remove_on_close = true;
+        segments.erase(segment->id);
+    }
+
+    compactions.fetch_add(1, std::memory_order_relaxed);
+    compaction_bytes_reclaimed.fetch_add(size > moved_bytes ? size - moved_bytes : 0, std::memory_order_relaxed);
+    return true;
+}
+
+KVStoreStats KVStore::getStats() const
+{
+    KVStoreStats stats;
+    stats.commits = commits.load();
+    stats.committed_records = committed_records.load();
+    stats.fdatasyncs = fdatasyncs.load();
+    stats.bytes_appended = bytes_appended.load();
+    stats.compactions = compactions.load();
+    stats.compaction_bytes_reclaimed = compaction_bytes_reclaimed.load();
+    stats.compaction_records_moved = compaction_records_moved.load();
+    {
+        std::shared_lock<std::shared_mutex> lock(segments_mutex);
+        stats.segments = segments.size();
+    }
+    if (stats.commits > 0) {
+        stats.avg_commit_batch = static_cast<double>(stats.committed_records) / stats.commits;
+    }
+    return stats;
+}
@@ -0,0 +1,144 @@
+#ifndef KV_STORE_H
+#define KV_STORE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct KVStoreConfig {
+    std::string directory;
+    size_t segment_size { 32ULL * 1024 * 1024 };
+    size_t index_shards { 64 };
+    double compaction_dead_ratio { 0.5 }; // sealed segments above this garbage share are rewritten
+    int compaction_poll_ms { 10 };
+    bool remove_files_on_close { false };
+};
+
+struct KVStoreStats {
+    uint64_t commits { 0 };
+    uint64_t committed_records { 0 };
+    uint64_t fdatasyncs { 0 };
+    uint64_t bytes_appended { 0 };
+    uint64_t compactions { 0 };
+    uint64_t compaction_bytes_reclaimed { 0 };
+    uint64_t compaction_records_moved { 0 };
+    uint64_t segments { 0 };
+    double avg_commit_batch { 0.0 };
+};
+
+// Minimal log-structured KV engine: sharded in-memory hash index over an
+// append-only segmented data log. The log doubles as the write-ahead log;
+// concurrent writers are group-committed by a leader that issues one write
+// and one fdatasync per batch. A background thread compacts sealed
+// segments once enough of their records have been superseded.
+class KVStore {
+private:
+    struct Location {
+        uint32_t segment { 0 };
+        uint32_t length { 0 };
+        uint64_t offset { 0 };
+
+        bool operator==(const Location& other) const
+        {
+            return segment == other.segment && offset == other.offset && length == other.length;
+        }
+    };
+
+    struct Segment {
+        uint32_t id { 0 };
+        int fd { -1 };
+        std::string path;
+        std::atomic<uint64_t> size { 0 };
+        std::atomic<uint64_t> dead_bytes { 0 };
+        bool sealed { false };
+        bool remove_on_close { false };
+
+        ~Segment();
+    };
+
+    struct IndexShard {
+        std::shared_mutex mutex;
+        std::unordered_map<uint64_t, Location> entries;
+    };
+
+    struct PendingRecord {
+        uint64_t key;
+        uint32_t length;
+        uint64_t batch_offset;
+        bool conditional;
+        Location expected;
+    };
+
+    KVStoreConfig config;
+    std::vector<std::unique_ptr<IndexShard>> shards;
+
+    mutable std::shared_mutex segments_mutex;
+    std::map<uint32_t, std::shared_ptr<Segment>> segments;
+    std::shared_ptr<Segment> active_segment;
+    uint32_t next_segment_id { 0 };
+
+    // Group commit state
+    std::mutex commit_mutex;
+    std::condition_variable commit_cv;
+    std::vector<char> pending_bytes;
+    std::vector<PendingRecord> pending_records;
+    bool pending_needs_sync { false };
+    bool commit_in_progress { false };
+    uint64_t enqueued_sequence { 0 };
+    uint64_t committed_sequence { 0 };
+    // A failed commit is sticky: its batch was dropped, so every write not yet
+    // committed (its own waiters and any later one) fails with the same error
+    // and committed_sequence never moves past the lost batch
+    std::exception_ptr commit_error;
+
+    std::atomic<uint64_t> commits { 0 };
+    std::atomic<uint64_t> committed_records { 0 };
+    std::atomic<uint64_t> fdatasyncs { 0 };
+    std::atomic<uint64_t> bytes_appended { 0 };
+    std::atomic<uint64_t> compactions { 0 };
+    std::atomic<uint64_t> compaction_bytes_reclaimed { 0 };
+    std::atomic<uint64_t> compaction_records_moved { 0 };
+
+    std::atomic<bool> stop_compaction { false };
+    std::thread compaction_thread;
+
+    IndexShard& shardFor(uint64_t key) const { return *shards[key % shards.size()]; }
+    std::shared_ptr<Segment> openSegment();
+    std::shared_ptr<Segment> findSegment(uint32_t id) const;
+    void append(uint64_t key, const char* value, uint32_t length, bool sync, const Location* expected);
+    void waitForCommit(std::unique_lock<std::mutex>& lock, uint64_t sequence);
+    void commitBatch(std::vector<char>& bytes, std::vector<PendingRecord>& records, bool sync);
+    void markDead(const Location& location);
+    void compactionLoop();
+    bool compactSegment(const std::shared_ptr<Segment>& segment);
+
+public:
+    explicit KVStore(const KVStoreConfig& config);
+    ~KVStore();
+
+    KVStore(const KVStore&) = delete;
+    KVStore& operator=(const KVStore&) = delete;
+
+    // Returns once the record is in the log; with sync it is also durable
+    void put(uint64_t key, const std::string& value, bool sync = true);
+    bool get(uint64_t key, std::string& value) const;
+    // The hash index is unordered, so scans walk the contiguous key space
+    size_t scan(uint64_t start_key, size_t count, std::vector<std::string>& values) const;
+    void flush();
+
+    size_t size() const;
+    KVStoreStats getStats() const;
+
+    static const size_t RECORD_HEADER_SIZE = sizeof(uint32_t) * 2 + sizeof(uint64_t);
+};
+
+#endif
@@ -0,0 +1,98 @@
+// Group-commit failure handling in KVStore: when a leader's commit fails,
+// every writer whose record was in that batch must see the error, and no
+// later commit may report those records as written.
+#include "kv_store.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int WRITERS = 8;
+constexpr int PUTS_PER_WRITER = 200;
+
+int failures = 0;
+
+void check(bool condition, const std::string& message)
+{
+    if (!condition) {
+        std::cerr << "FAIL: " << message << "\n";
+        ++failures;
+    }
+}
+
+}
+
+int main()
+{
+    KVStoreConfig config;
+    config.directory = "/tmp/kv_store_test_" + std::to_string(getpid());
+    config.segment_size = 1; // every commit after the first rolls to a new segment
+    config.remove_files_on_close = true;
+
+    {
+        KVStore store(config);
+        store.put(0, "seed");
+
+        // Rolling needs a new segment file; with the directory gone every
+        // later commitBatch throws from openSegment
+        unlink((config.directory + "/segment_0.log").c_str());
+        check(rmdir(config.directory.c_str()) == 0, "could not remove the store directory");
+
+        std::atomic<int> acknowledged(0);
+        std::atomic<int> rejected(0);
+        std::atomic<int> lost(0);
+        std::atomic<bool> go(false);
+        std::vector<std::thread> writers;
+        for (int w = 0; w < WRITERS; ++w) {
+            writers.emplace_back([&, w]() {
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                std::string value(64, static_cast<char>('a' + w));
+                for (int i = 0; i < PUTS_PER_WRITER; ++i) {
+                    uint64_t key = 1 + static_cast<uint64_t>(w) * PUTS_PER_WRITER + i;
+                    try {
+                        store.put(key, value);
+                    } catch (const std::exception&) {
+                        rejected.fetch_add(1);
+                        continue;
+                    }
+                    acknowledged.fetch_add(1);
+                    std::string read_back;
+                    if (!store.get(key, read_back) || read_back != value) {
+                        lost.fetch_add(1);
+                    }
+                }
+            });
+        }
+        go.store(true);
+        for (auto& t : writers) {
+            t.join();
+        }
+
+        check(rejected.load() == WRITERS * PUTS_PER_WRITER, "puts after a failed commit must all fail (" +
+            std::to_string(acknowledged.load()) + " acknowledged)");
+        check(lost.load() == 0, std::to_string(lost.load()) + " acknowledged puts are missing from the store");
+
+        std::string seed;
+        check(store.get(0, seed) && seed == "seed", "the record committed before the failure is gone");
+
+        bool flush_failed = false;
+        try {
+            store.flush();
+        } catch (const std::exception&) {
+            flush_failed = true;
+        }
+        check(flush_failed, "flush after a failed commit must report the error");
+    }
+
+    if (failures > 0) {
+        return 1;
+    }
+    std::cout << "kv_store_test: passed\n";
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "load_curve.h"
+#include "pipeline.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+constexpr double SATURATION_ACHIEVED_RATIO = 0.95;
+constexpr double SATURATION_P99_FACTOR = 3.0;
+constexpr uint64_t SPIN_THRESHOLD_NS = 50000;
+
+}
+
+ArrivalSchedule::ArrivalSchedule(double rate_per_second, uint64_t start_ns, uint64_t seed)
+    : gen(seed)
+    , gap_ns(rate_per_second > 0.0 ? rate_per_second / NANOSECONDS_PER_SECOND : 1.0)
+    , next_ns(static_cast<double>(start_ns))
+{
+}
+
+bool ArrivalSchedule::waitNext(uint64_t deadline_ns, uint64_t& intended_ns)
+{
+    next_ns += gap_ns(gen);
+    intended_ns = static_cast<uint64_t>(next_ns);
+    if (intended_ns >= deadline_ns) {
+        return false;
+    }
+
+    // Sleep most of the gap, then yield-spin to the exact arrival time
+    uint64_t now = pipelineNowNanoseconds();
+    if (intended_ns > now + SPIN_THRESHOLD_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(intended_ns - now - SPIN_THRESHOLD_NS / 2));
+    }
+    while (pipelineNowNanoseconds() < intended_ns) {
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+LoadStepResult summarizeLoadStep(double offered_rate, uint64_t sent, uint64_t completed,
+    const SampleReservoir& latency_us, double send_seconds)
+{
+    LoadStepResult result;
+    result.offered_rate = offered_rate;
+    result.sent = sent;
+    result.completed = completed;
+    if (send_seconds > 0.0) {
+        result.achieved_rate = completed / send_seconds;
+        if (offered_rate <= 0.0) {
+            result.offered_rate = sent / send_seconds;
+        }
+    }
+
+    LatencyStats stats;
+    for (double sample : latency_us.samples) {
+        stats.addSample(sample);
+    }
+    result.avg_us = stats.getAverage();
+    result.min_us = stats.getMin();
+    result.p50_us = stats.getPercentile(50);
+    result.p90_us = stats.getPercentile(90);
+    result.p99_us = stats.getPercentile(99);
+    result.p999_us = stats.getPercentile(99.9);
+    result.max_us = stats.getMax();
+    return result;
+}
+
+LoadCurveSummary analyzeLoadCurve(const std::vector<LoadStepResult>& steps, double slo_p99_us)
+{
+    LoadCurveSummary summary;
+    summary.slo_p99_us = slo_p99_us;
+
+    double best_p99 = 0.0;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const LoadStepResult& step = steps[i];
+        summary.max_achieved_rate = std::max(summary.max_achieved_rate, step.achieved_rate);
+
+        if (summary.knee_index < 0 && i > 0) {
+            bool throughput_saturated = step.achieved_rate < step.offered_rate * SATURATION_ACHIEVED_RATIO;
+            bool latency_saturated = best_p99 > 0.0 && step.p99_us > best_p99 * SATURATION_P99_FACTOR;
+            if (throughput_saturated || latency_saturated) {
+                summary.knee_index = static_cast<int>(i);
+                summary.knee_offered_rate = step.offered_rate;
+            }
+        }
+        if (step.p99_us > 0.0 && (best_p99 == 0.0 || step.p99_us < best_p99)) {
+            best_p99 = step.p99_us;
+        }
+
+        if (slo_p99_us > 0.0 && step.completed > 0 && step.p99_us <= slo_p99_us &&
+            step.achieved_rate > summary.max_rate_at_slo) {
+            summary.max_rate_at_slo = step.achieved_rate;
+            summary.slo_index = static_cast<int>(i);
+        }
+    }
+    summary.baseline_p99_us = best_p99;
+
+    return summary;
+}
+
+void addLoadCurveMetrics(BenchmarkResult& result, const std::string& prefix,
+    const std::vector<LoadStepResult>& steps, const LoadCurveSummary& summary)
+{
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const LoadStepResult& step = steps[i];
+        std::string step_prefix = prefix + "step" + std::to_string(i) + "_";
+        result.extra_metrics[step_prefix + "offered_rate"] = step.offered_rate;
+        result.extra_metrics[step_prefix + "achieved_rate"] = step.achieved_rate;
+        result.extra_metrics[step_prefix + "p50_us"] = step.p50_us;
+        result.extra_metrics[step_prefix + "p99_us"] = step.p99_us;
+        result.extra_metrics[step_prefix + "p999_us"] = step.p999_us;
+    }
+
+    result.extra_metrics[prefix + "baseline_p99_us"] = summary.baseline_p99_us;
+    result.extra_metrics[prefix + "max_achieved_rate"] = summary.max_achieved_rate;
+    result.extra_metrics[prefix + "knee_offered_rate"] = summary.knee_offered_rate;
+    result.extra_metrics[prefix + "slo_p99_us"] = summary.slo_p99_us;
+    result.extra_metrics[prefix + "max_rate_at_slo"] = summary.max_rate_at_slo;
+    std::string info_prefix = !prefix.empty() && prefix.back() == '_' ? prefix.substr(0, prefix.size() - 1) : prefix;
+    result.extra_info[info_prefix + ".knee"] = summary.knee_index >= 0 ? "step" + std::to_string(summary.knee_index) : "not_reached";
+}
@@ -0,0 +1,47 @@
+#ifndef LOAD_CURVE_H
+#define LOAD_CURVE_H
+
+#include "benchmark.h"
+#include "utils.h"
+#include <random>
+#include <string>
+#include <vector>
+
+struct LoadCurveSummary {
+    double baseline_p99_us { 0.0 };
+    int knee_index { -1 }; // first step past saturation, -1 if never reached
+    double knee_offered_rate { 0.0 };
+    double max_achieved_rate { 0.0 };
+    double slo_p99_us { 0.0 };
+    int slo_index { -1 }; // highest-throughput step meeting the SLO
+    double max_rate_at_slo { 0.0 };
+};
+
+// Poisson arrival times for an open-loop load generator. Arrivals follow the
+// schedule regardless of completions, so queueing shows up as latency.
+class ArrivalSchedule {
+private:
+    std::mt19937_64 gen;
+    std::exponential_distribution<double> gap_ns;
+    double next_ns;
+
+public:
+    ArrivalSchedule(double rate_per_second, uint64_t start_ns, uint64_t seed);
+
+    // Sleeps until the next arrival is due and returns its intended time, or
+    // false once the next arrival would fall at or past deadline_ns
+    bool waitNext(uint64_t deadline_ns, uint64_t& intended_ns);
+};
+
+// Builds a step result from per-request latencies measured over send_seconds
+LoadStepResult summarizeLoadStep(double offered_rate, uint64_t sent, uint64_t completed,
+    const SampleReservoir& latency_us, double send_seconds);
+
+// Saturation is the first step whose achieved rate falls below 95% of the
+// offered rate or whose p99 exceeds 3x the best p99 of the steps before it.
+LoadCurveSummary analyzeLoadCurve(const std::vector<LoadStepResult>& steps, double slo_p99_us);
+
+void addLoadCurveMetrics(BenchmarkResult& result, const std::string& prefix,
+    const std::vector<LoadStepResult>& steps, const LoadCurveSummary& summary);
+
+#endif
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cctype>
 #include <getopt.h>
+#include <iomanip>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -8,15 +9,28 @@
 #include <vector>
 
 #include "benchmark.h"
+#include "colscan_bench.h"
 #include "comparison.h"
+#include "cpu_features.h"
 #include "cpu_bench.h"
 #include "disk_bench.h"
+#include "extsort_bench.h"
+#include "feed_bench.h"
+#include "fileserve_bench.h"
+#include "instrumentation.h"
 #include "integrated_bench.h"
+#include "interference.h"
 #include "ipc_bench.h"
+#include "kv_bench.h"
 #include "mem_bench.h"
 #include "net_bench.h"
 #include "performance_context.h"
 #include "report.h"
+#include "rpc_bench.h"
+#include "slo_search.h"
+#include "snapshot_bench.h"
+#include "telemetry.h"
+#include "thread_placement.h"
 #include "utils.h"
 
 struct Config {
@@ -41,11 +55,73 @@ struct Config {
     bool context_mode = false;
     bool system_check = false;
     bool show_platform_info = false;
+    InterferencePolicy interference_policy;
 
     // Telemetry & instrumentation
     std::string telemetry_file;
+    size_t telemetry_capacity = TelemetryRing::DEFAULT_CAPACITY;
+    std::string decode_telemetry_file;
     bool dry_run = false;
     bool enable_perf_counters = true;
+    int monitor_interval_ms = SystemMonitor::DEFAULT_SAMPLE_INTERVAL_MS;
+
+    // Max-throughput search under a p99 latency SLO (0 = off)
+    double slo_p99_us = 0.0;
+
+    // Run module pairs concurrently on split CPU sets instead of one by one
+    bool interference = false;
+
+    // How cpu, mem, disk, net and ipc pin their threads
+    ThreadPlacement placement;
+
+    // Macro workload options
+    KVBenchmarkConfig kv;
+    FeedBenchmarkConfig feed;
+    RpcBenchmarkConfig rpc;
+    ExtSortBenchmarkConfig extsort;
+    ColScanBenchmarkConfig colscan;
+    SnapshotBenchmarkConfig snapshot;
+    FileServeBenchmarkConfig fileserve;
+};
+
+// Long-only options have no single-character equivalent
+enum LongOnlyOption {
+    OPT_KV_RECORDS = 256,
+    OPT_KV_THREADS,
+    OPT_KV_WORKLOADS,
+    OPT_KV_DIR,
+    OPT_FEED_RATES,
+    OPT_FEED_MULTICAST,
+    OPT_RPC_KERNEL,
+    OPT_RPC_WORK,
+    OPT_RPC_MEM_TOUCHES,
+    OPT_RPC_DISK_READS,
+    OPT_RPC_RATES,
+    OPT_RPC_SLO_P99,
+    OPT_SLO_P99,
+    OPT_EXTSORT_BUDGET,
+    OPT_EXTSORT_FACTOR,
+    OPT_EXTSORT_DIR,
+    OPT_COLSCAN_ROWS,
+    OPT_COLSCAN_THREADS,
+    OPT_COLSCAN_DIR,
+    OPT_SNAPSHOT_MB,
+    OPT_SNAPSHOT_RATE,
+    OPT_SNAPSHOT_COUNT,
+    OPT_SNAPSHOT_DIR,
+    OPT_FILESERVE_CORPUS,
+    OPT_FILESERVE_RAM_FACTOR,
+    OPT_FILESERVE_SIZES,
+    OPT_FILESERVE_CLIENTS,
+    OPT_FILESERVE_DIR,
+    OPT_INTERFERENCE,
+    OPT_MONITOR_INTERVAL,
+    OPT_TELEMETRY_CAPACITY,
+    OPT_DECODE_TELEMETRY,
+    OPT_MAX_RERUNS,
+    OPT_RERUN_PSI,
+    OPT_RERUN_CPU,
+    OPT_PLACEMENT
 };
 
 void printUsage(const char* program_name)
@@ -54,12 +130,57 @@ void printUsage(const char* program_name)
               << "\nBenchmark Mode Options:\n"
               << "  --modules=LIST      Comma-separated list of modules to run\n"
               << "                      (cpu,mem,disk,net,ipc,integrated,all)\n"
+              << "                      Macro workloads: kv,feed,rpc,extsort,colscan,snapshot,fileserve,\n"
+              << "                      or macro for all of them\n"
               << "                      Default: all\n"
               << "  --duration=SEC      Duration in seconds per test (default: 30)\n"
               << "  --iterations=N      Number of iterations for averaging (default: 10)\n"
               << "  --report=FILE       Output report file (default: stdout)\n"
               << "  --format=FORMAT     Report format: txt, json, or markdown (default: txt)\n"
               << "  --verbose           Enable verbose output\n"
+              << "  --telemetry=FILE    Stream system telemetry samples to FILE during the run\n"
+              << "                      (.csv, .json, or .bin for the compact binary format)\n"
+              << "  --telemetry-capacity=N  Telemetry samples kept in memory (default: 4096)\n"
+              << "  --decode-telemetry=FILE  Convert a .bin telemetry file to CSV on stdout, or to\n"
+              << "                      the --report file (.csv or .json), and exit\n"
+              << "  --dry-run           Shorten duration and iterations for a quick smoke run\n"
+              << "  --no-perf           Disable hardware perf counters\n"
+              << "  --monitor-interval-ms=N  System monitor sampling period (default: 250, min: 10)\n"
+              << "  --slo-p99=X         Search net, disk, ipc and integrated for the max rate with\n"
+              << "                      p99 <= X (e.g. 500us, 2ms; bare numbers are ms)\n"
+              << "  --interference      Run each pair of the selected modules concurrently on\n"
+              << "                      split CPU sets and report slowdowns vs solo runs\n"
+              << "  --placement=POLICY  Thread placement for cpu, mem, disk, net and ipc: scatter,\n"
+              << "                      compact, physical-cores-only, per-numa-node,\n"
+              << "                      isolated-cpus-only, or a CPU list like 0-3,8 (default: scatter)\n"
+              << "\nMacro Workload Options:\n"
+              << "  --kv-records=N      Records loaded into the KV store (default: 100000)\n"
+              << "  --kv-threads=N      KV client threads (default: one per core)\n"
+              << "  --kv-workloads=LIST YCSB workloads to run, e.g. ABCDEF or A,C (default: ABCDEF)\n"
+              << "  --kv-dir=DIR        Directory for the KV store log segments (default: /tmp)\n"
+              << "  --feed-rates=LIST   Feed handler tick rates per step (default: 10000,...,400000)\n"
+              << "  --feed-multicast    Publish the feed on a loopback multicast group\n"
+              << "  --rpc-kernel=NAME   RPC worker kernel: fp, int, hash, matrix (default: fp)\n"
+              << "  --rpc-work=N        Kernel work units per RPC request (default: 2000)\n"
+              << "  --rpc-mem-touches=N Random memory reads per RPC request (default: 0)\n"
+              << "  --rpc-disk-reads=N  Random 4KB disk reads per RPC request (default: 0)\n"
+              << "  --rpc-rates=LIST    RPC offered rates per step (default: fractions of calibrated capacity)\n"
+              << "  --rpc-slo-p99-us=N  RPC p99 latency objective in microseconds (default: 1000)\n"
+              << "  --extsort-budget-mb=N External sort memory budget, 0 = MemAvailable (default: 64)\n"
+              << "  --extsort-factor=X  External sort dataset size as a multiple of the budget (default: 4)\n"
+              << "  --extsort-dir=DIR   Directory for external sort input, runs and output (default: /tmp)\n"
+              << "  --colscan-rows=N    Rows in the columnar scan table (default: 16777216)\n"
+              << "  --colscan-threads=N Columnar scan threads (default: one per core)\n"
+              << "  --colscan-dir=DIR   Directory for the columnar scan file (default: /tmp)\n"
+              << "  --snapshot-mb=N     Snapshot dataset size in MB (default: 256)\n"
+              << "  --snapshot-rate=N   Foreground updates per second during snapshots (default: 100000)\n"
+              << "  --snapshot-count=N  Fork snapshots taken per run (default: 3)\n"
+              << "  --snapshot-dir=DIR  Directory for snapshot files (default: /tmp)\n"
+              << "  --fileserve-corpus-mb=N  Static file corpus size in MB (default: 512)\n"
+              << "  --fileserve-ram-factor=X Size the corpus as X times MemTotal instead\n"
+              << "  --fileserve-sizes=DIST   File sizes: small, large or pareto (default: pareto)\n"
+              << "  --fileserve-clients=N    Keep-alive client connections (default: 32)\n"
+              << "  --fileserve-dir=DIR      Directory for the file corpus (default: /tmp)\n"
               << "\nComparison Mode Options:\n"
               << "  --compare           Enable comparison mode\n"
               << "  --baseline=FILE     Baseline JSON report file\n"
@@ -72,6 +193,12 @@ void printUsage(const char* program_name)
               << "  --context           Enable contextual benchmarking with system monitoring\n"
               << "  --system-check      Check system readiness for benchmarking\n"
               << "  --platform-info     Show detailed platform information\n"
+              << "  --max-reruns=N      Rerun a benchmark up to N times when interference is seen\n"
+              << "                      during it (implies --context, default: 0)\n"
+              << "  --rerun-psi=PCT     System PSI stall share that counts as interference while\n"
+              << "                      other processes use CPU (default: 25)\n"
+              << "  --rerun-cpu=PCT     Foreign CPU share of all cores that counts as interference\n"
+              << "                      (default: 25)\n"
               << "\nGeneral Options:\n"
               << "  --help              Show this help message\n"
               << "\nExamples:\n"
@@ -124,6 +251,42 @@ Config parseArguments(int argc, char* argv[])
         { "telemetry", required_argument, nullptr, 'T' },
         { "dry-run", no_argument, nullptr, 'D' },
         { "no-perf", no_argument, nullptr, 'P' },
+        { "kv-records", required_argument, nullptr, OPT_KV_RECORDS },
+        { "kv-threads", required_argument, nullptr, OPT_KV_THREADS },
+        { "kv-workloads", required_argument, nullptr, OPT_KV_WORKLOADS },
+        { "kv-dir", required_argument, nullptr, OPT_KV_DIR },
+        { "feed-rates", required_argument, nullptr, OPT_FEED_RATES },
+        { "feed-multicast", no_argument, nullptr, OPT_FEED_MULTICAST },
+        { "rpc-kernel", required_argument, nullptr, OPT_RPC_KERNEL },
+        { "rpc-work", required_argument, nullptr, OPT_RPC_WORK },
+        { "rpc-mem-touches", required_argument, nullptr, OPT_RPC_MEM_TOUCHES },
+        { "rpc-disk-reads", required_argument, nullptr, OPT_RPC_DISK_READS },
+        { "rpc-rates", required_argument, nullptr, OPT_RPC_RATES },
+        { "rpc-slo-p99-us", required_argument, nullptr, OPT_RPC_SLO_P99 },
+        { "slo-p99", required_argument, nullptr, OPT_SLO_P99 },
+        { "interference", no_argument, nullptr, OPT_INTERFERENCE },
+        { "monitor-interval-ms", required_argument, nullptr, OPT_MONITOR_INTERVAL },
+        { "telemetry-capacity", required_argument, nullptr, OPT_TELEMETRY_CAPACITY },
+        { "decode-telemetry", required_argument, nullptr, OPT_DECODE_TELEMETRY },
+        { "max-reruns", required_argument, nullptr, OPT_MAX_RERUNS },
+        { "rerun-psi", required_argument, nullptr, OPT_RERUN_PSI },
+        { "rerun-cpu", required_argument, nullptr, OPT_RERUN_CPU },
+        { "placement", required_argument, nullptr, OPT_PLACEMENT },
+        { "extsort-budget-mb", required_argument, nullptr, OPT_EXTSORT_BUDGET },
+        { "extsort-factor", required_argument, nullptr, OPT_EXTSORT_FACTOR },
+        { "extsort-dir", required_argument, nullptr, OPT_EXTSORT_DIR },
+        { "colscan-rows", required_argument, nullptr, OPT_COLSCAN_ROWS },
+        { "colscan-threads", required_argument, nullptr, OPT_COLSCAN_THREADS },
+        { "colscan-dir", required_argument, nullptr, OPT_COLSCAN_DIR },
+        { "snapshot-mb", required_argument, nullptr, OPT_SNAPSHOT_MB },
+        { "snapshot-rate", required_argument, nullptr, OPT_SNAPSHOT_RATE },
+        { "snapshot-count", required_argument, nullptr, OPT_SNAPSHOT_COUNT },
+        { "snapshot-dir", required_argument, nullptr, OPT_SNAPSHOT_DIR },
+        { "fileserve-corpus-mb", required_argument, nullptr, OPT_FILESERVE_CORPUS },
+        { "fileserve-ram-factor", required_argument, nullptr, OPT_FILESERVE_RAM_FACTOR },
+        { "fileserve-sizes", required_argument, nullptr, OPT_FILESERVE_SIZES },
+        { "fileserve-clients", required_argument, nullptr, OPT_FILESERVE_CLIENTS },
+        { "fileserve-dir", required_argument, nullptr, OPT_FILESERVE_DIR },
         { nullptr, 0, nullptr, 0 }
     };
 
@@ -207,12 +370,212 @@ Config parseArguments(int argc, char* argv[])
         case 'p':
             config.show_platform_info = true;
             break;
+        case 'T':
+            config.telemetry_file = optarg;
+            break;
+        case 'D':
+            config.dry_run = true;
+            break;
+        case 'P':
+            config.enable_perf_counters = false;
+            break;
+        case OPT_KV_RECORDS:
+            config.kv.record_count = std::stoull(optarg);
+            if (config.kv.record_count == 0) {
+                std::cerr << "KV record count must be positive\n";
+                exit(1);
+            }
+            break;
+        case OPT_KV_THREADS:
+            config.kv.threads = std::stoi(optarg);
+            if (config.kv.threads <= 0) {
+                std::cerr << "KV threads must be positive\n";
+                exit(1);
+            }
+            break;
+        case OPT_KV_WORKLOADS:
+            config.kv.workloads = optarg;
+            break;
+        case OPT_KV_DIR:
+            config.kv.directory = optarg;
+            break;
+        case OPT_FEED_RATES:
+            config.feed.rates.clear();
+            for (const auto& rate : splitString(optarg, ',')) {
+                config.feed.rates.push_back(std::stod(rate));
+                if (config.feed.rates.back() <= 0.0) {
+                    std::cerr << "Feed rates must be positive\n";
+                    exit(1);
+                }
+            }
+            break;
+        case OPT_FEED_MULTICAST:
+            config.feed.multicast = true;
+            break;
+        case OPT_RPC_KERNEL:
+            if (!parseWorkloadKernel(optarg, config.rpc.kernel)) {
+                std::cerr << "Unknown RPC kernel: " << optarg << "\n";
+                exit(1);
+            }
+            break;
+        case OPT_RPC_WORK:
+            config.rpc.work_units = std::stoull(optarg);
+            break;
+        case OPT_RPC_MEM_TOUCHES:
+            config.rpc.memory_touches = std::stoull(optarg);
+            break;
+        case OPT_RPC_DISK_READS:
+            config.rpc.disk_reads = std::stoull(optarg);
+            break;
+        case OPT_RPC_RATES:
+            config.rpc.rates.clear();
+            for (const auto& rate : splitString(optarg, ',')) {
+                config.rpc.rates.push_back(std::stod(rate));
+                if (config.rpc.rates.back() <= 0.0) {
+                    std::cerr << "RPC rates must be positive\n";
+                    exit(1);
+                }
+            }
+            break;
+        case OPT_RPC_SLO_P99:
+            config.rpc.slo_p99_us = std::stod(optarg);
+            if (config.rpc.slo_p99_us <= 0.0) {
+                std::cerr << "RPC p99 SLO must be positive\n";
+                exit(1);
+            }
+            break;
+        case OPT_SLO_P99:
+            if (!parseLatencyMicroseconds(optarg, config.slo_p99_us)) {
+                std::cerr << "Invalid p99 SLO: " << optarg << "\n";
+                exit(1);
+            }
+            break;
+        case OPT_INTERFERENCE:
+            config.interference = true;
+            break;
+        case OPT_MONITOR_INTERVAL:
+            config.monitor_interval_ms = std::stoi(optarg);
+            if (config.monitor_interval_ms < SystemMonitor::MIN_SAMPLE_INTERVAL_MS) {
+                std::cerr << "Monitor interval must be at least " << SystemMonitor::MIN_SAMPLE_INTERVAL_MS << " ms\n";
+                exit(1);
+            }
+            break;
+        case OPT_TELEMETRY_CAPACITY:
+            config.telemetry_capacity = std::stoull(optarg);
+            if (config.telemetry_capacity == 0) {
+                std::cerr << "Telemetry capacity must be at least 1 sample\n";
+                exit(1);
+            }
+            break;
+        case OPT_DECODE_TELEMETRY:
+            config.decode_telemetry_file = optarg;
+            break;
+        case OPT_MAX_RERUNS:
+            config.interference_policy.max_reruns = std::stoi(optarg);
+            if (config.interference_policy.max_reruns < 0) {
+                std::cerr << "Max reruns must be non-negative\n";
+                exit(1);
+            }
+            config.context_mode = true;
+            break;
+        case OPT_RERUN_PSI:
+            config.interference_policy.psi_stall_percent = std::stod(optarg);
+            if (config.interference_policy.psi_stall_percent < 0.0 || config.interference_policy.psi_stall_percent > 100.0) {
+                std::cerr << "Rerun PSI threshold must be between 0 and 100\n";
+                exit(1);
+            }
+            break;
+        case OPT_RERUN_CPU:
+            config.interference_policy.foreign_cpu_percent = std::stod(optarg);
+            if (config.interference_policy.foreign_cpu_percent < 0.0 || config.interference_policy.foreign_cpu_percent > 100.0) {
+                std::cerr << "Rerun CPU threshold must be between 0 and 100\n";
+                exit(1);
+            }
+            break;
+        case OPT_PLACEMENT:
+            if (!ThreadPlacement::parse(optarg, config.placement)) {
+                std::cerr << "Unknown placement policy: " << optarg << "\n";
+                exit(1);
+            }
+            break;
+        case OPT_EXTSORT_BUDGET:
+            config.extsort.memory_budget_mb = std::stoull(optarg);
+            break;
+        case OPT_EXTSORT_FACTOR:
+            config.extsort.dataset_factor = std::stod(optarg);
+            if (config.extsort.dataset_factor < 1.0) {
+                std::cerr << "External sort factor must be at least 1\n";
+                exit(1);
+            }
+            break;
+        case OPT_EXTSORT_DIR:
+            config.extsort.directory = optarg;
+            break;
+        case OPT_COLSCAN_ROWS:
+            config.colscan.rows = std::stoull(optarg);
+            break;
+        case OPT_COLSCAN_THREADS:
+            config.colscan.threads = std::stoi(optarg);
+            break;
+        case OPT_COLSCAN_DIR:
+            config.colscan.directory = optarg;
+            break;
+        case OPT_SNAPSHOT_MB:
+            config.snapshot.dataset_mb = std::stoull(optarg);
+            break;
+        case OPT_SNAPSHOT_RATE:
+            config.snapshot.update_rate = std::stod(optarg);
+            if (config.snapshot.update_rate <= 0.0) {
+                std::cerr << "Snapshot update rate must be positive\n";
+                exit(1);
+            }
+            break;
+        case OPT_SNAPSHOT_COUNT:
+            config.snapshot.snapshots = std::stoi(optarg);
+            break;
+        case OPT_SNAPSHOT_DIR:
+            config.snapshot.directory = optarg;
+            break;
+        case OPT_FILESERVE_CORPUS:
+            config.fileserve.corpus_mb = std::stoull(optarg);
+            break;
+        case OPT_FILESERVE_RAM_FACTOR:
+            config.fileserve.ram_factor = std::stod(optarg);
+            break;
+        case OPT_FILESERVE_SIZES:
+            config.fileserve.size_distribution = optarg;
+            if (config.fileserve.size_distribution != "small" && config.fileserve.size_distribution != "large" &&
+                config.fileserve.size_distribution != "pareto") {
+                std::cerr << "Unknown file size distribution: " << optarg << "\n";
+                exit(1);
+            }
+            break;
+        case OPT_FILESERVE_CLIENTS:
+            config.fileserve.clients = std::stoi(optarg);
+            break;
+        case OPT_FILESERVE_DIR:
+            config.fileserve.directory = optarg;
+            break;
         default:
             printUsage(argv[0]);
             exit(1);
         }
     }
 
+    if (config.placement.policy == PlacementPolicy::ISOLATED_CPUS || config.placement.policy == PlacementPolicy::EXPLICIT) {
+        // These pick CPUs outside the inherited mask, which would escape the interference partitions
+        if (config.interference) {
+            std::cerr << "--placement=" << config.placement.name() << " cannot be combined with --interference\n";
+            exit(1);
+        }
+        try {
+            config.placement.resolve();
+        } catch (const std::exception& e) {
+            std::cerr << "Invalid placement: " << e.what() << "\n";
+            exit(1);
+        }
+    }
+
     if (config.modules.empty()) {
         config.modules = { "all" };
     }
@@ -222,31 +585,84 @@ Config parseArguments(int argc, char* argv[])
         config.modules = { "cpu", "mem", "disk", "net", "ipc", "integrated" };
     }
 
+    // Expand "macro" to the application-shaped workloads
+    auto macro = std::find(config.modules.begin(), config.modules.end(), "macro");
+    if (macro != config.modules.end()) {
+        std::vector<std::string> macro_modules = { "kv", "feed", "rpc", "extsort", "colscan", "snapshot", "fileserve" };
+        macro = config.modules.erase(macro);
+        config.modules.insert(macro, macro_modules.begin(), macro_modules.end());
+    }
+
     return config;
 }
 
-std::vector<std::unique_ptr<Benchmark>> createBenchmarks(const std::vector<std::string>& modules)
+std::unique_ptr<Benchmark> createModuleBenchmark(const std::string& module, const Config& config)
+{
+    if (module == "cpu") {
+        return std::make_unique<CPUBenchmark>(config.placement);
+    } else if (module == "mem") {
+        return std::make_unique<MemoryBenchmark>(config.placement);
+    } else if (module == "disk") {
+        return std::make_unique<DiskBenchmark>(config.placement);
+    } else if (module == "net") {
+        return std::make_unique<NetworkBenchmark>(config.placement);
+    } else if (module == "ipc") {
+        return std::make_unique<IPCBenchmark>(config.placement);
+    } else if (module == "integrated") {
+        return std::make_unique<IntegratedBenchmark>();
+    } else if (module == "kv") {
+        return std::make_unique<KVBenchmark>(config.kv);
+    } else if (module == "feed") {
+        return std::make_unique<FeedHandlerBenchmark>(config.feed);
+    } else if (module == "rpc") {
+        return std::make_unique<RpcBenchmark>(config.rpc);
+    } else if (module == "extsort") {
+        return std::make_unique<ExternalSortBenchmark>(config.extsort);
+    } else if (module == "colscan") {
+        return std::make_unique<ColumnarScanBenchmark>(config.colscan);
+    } else if (module == "snapshot") {
+        return std::make_unique<SnapshotBenchmark>(config.snapshot);
+    } else if (module == "fileserve") {
+        return std::make_unique<StaticFileBenchmark>(config.fileserve);
+    }
+    return nullptr;
+}
+
+std::vector<std::unique_ptr<Benchmark>> createBenchmarks(const Config& config)
 {
+    const std::vector<std::string>& modules = config.modules;
     std::vector<std::unique_ptr<Benchmark>> benchmarks;
 
+    // Interference mode replaces the sequential runs with one pairwise matrix
+    if (config.interference) {
+        benchmarks.push_back(std::make_unique<InterferenceMatrixBenchmark>(modules,
+            [&config](const std::string& module) { return createModuleBenchmark(module, config); }));
+        return benchmarks;
+    }
+
     for (const auto& module : modules) {
-        if (module == "cpu") {
-            benchmarks.push_back(std::make_unique<CPUBenchmark>());
-        } else if (module == "mem") {
-            benchmarks.push_back(std::make_unique<MemoryBenchmark>());
-        } else if (module == "disk") {
-            benchmarks.push_back(std::make_unique<DiskBenchmark>());
-        } else if (module == "net") {
-            benchmarks.push_back(std::make_unique<NetworkBenchmark>());
-        } else if (module == "ipc") {
-            benchmarks.push_back(std::make_unique<IPCBenchmark>());
-        } else if (module == "integrated") {
-            benchmarks.push_back(std::make_unique<IntegratedBenchmark>());
+        std::unique_ptr<Benchmark> benchmark = createModuleBenchmark(module, config);
+        if (benchmark) {
+            benchmarks.push_back(std::move(benchmark));
         } else {
             std::cerr << "Unknown module: " << module << std::endl;
         }
     }
 
+    // In SLO mode, rate-controllable modules run the max-throughput search instead
+    if (config.slo_p99_us > 0.0) {
+        SloSearchConfig slo;
+        slo.slo_p99_us = config.slo_p99_us;
+        for (auto& benchmark : benchmarks) {
+            std::unique_ptr<RateControlledWorkload> workload = benchmark->createRateControlledWorkload();
+            if (workload) {
+                benchmark = std::make_unique<SloSearchBenchmark>(std::move(workload), slo);
+            } else if (config.verbose) {
+                std::cout << benchmark->getName() << " has no rate control; running it normally\n";
+            }
+        }
+    }
+
     return benchmarks;
 }
 
@@ -264,8 +680,25 @@ int main(int argc, char* argv[])
 
     // Handle performance context modes
     PerformanceContextAnalyzer analyzer;
-    const auto build_metadata = getBuildMetadataMap();
+    analyzer.setMonitorSampleInterval(config.monitor_interval_ms);
+    analyzer.setInterferencePolicy(config.interference_policy);
+    auto build_metadata = getBuildMetadataMap();
+    // Which code paths this host can take, so results from mixed fleets can be told apart
+    build_metadata["cpu.microarchitecture"] = CpuFeatures::host().microarchitecture;
+    build_metadata["cpu.isa"] = CpuFeatures::host().describe();
     
+    if (!config.decode_telemetry_file.empty()) {
+        std::string error;
+        if (!decodeTelemetryFile(config.decode_telemetry_file, config.report_file, error)) {
+            std::cerr << "Error: Failed to decode telemetry: " << error << std::endl;
+            return 1;
+        }
+        if (!config.report_file.empty()) {
+            std::cout << "Telemetry decoded to: " << config.report_file << std::endl;
+        }
+        return 0;
+    }
+
     if (config.show_platform_info) {
         std::cout << "Platform Information\n";
         std::cout << "===================\n\n";
@@ -346,10 +779,16 @@ int main(int argc, char* argv[])
     }
 
     SystemMonitor telemetry_monitor;
+    telemetry_monitor.setSampleInterval(config.monitor_interval_ms);
+    telemetry_monitor.setTelemetryCapacity(config.telemetry_capacity);
     bool telemetry_enabled = !config.telemetry_file.empty();
     if (telemetry_enabled) {
+        if (!telemetry_monitor.openTelemetryStream(config.telemetry_file)) {
+            std::cerr << "Error: Unable to open telemetry file " << config.telemetry_file << std::endl;
+            return 1;
+        }
         if (config.verbose) {
-            std::cout << "Telemetry capture enabled: writing samples to " << config.telemetry_file << "\n";
+            std::cout << "Telemetry capture enabled: streaming samples to " << config.telemetry_file << "\n";
         }
         telemetry_monitor.startMonitoring();
     }
@@ -397,7 +836,7 @@ int main(int argc, char* argv[])
     report.setSystemInfo(system_info);
 
     // Create benchmarks
-    auto benchmarks = createBenchmarks(config.modules);
+    auto benchmarks = createBenchmarks(config);
 
     if (benchmarks.empty()) {
         if (telemetry_enabled) {
@@ -493,32 +932,12 @@ int main(int argc, char* argv[])
             std::cout << "Running " << benchmark->getName() << " benchmark...\n";
 
             try {
-                PerfCounterSet perf_counters;
-                PerfCounterSample perf_sample;
-                bool perf_started = config.enable_perf_counters && perf_counters.start();
+                BenchmarkInstrumentation instrumentation(config.enable_perf_counters);
+                instrumentation.start();
 
                 BenchmarkResult result = benchmark->run(effective_duration, effective_iterations, config.verbose);
 
-                if (config.enable_perf_counters) {
-                    perf_sample = perf_counters.stop();
-                    if (perf_sample.valid) {
-                        result.extra_metrics["perf_cpu_cycles"] = static_cast<double>(perf_sample.cycles);
-                        result.extra_metrics["perf_cpu_instructions"] = static_cast<double>(perf_sample.instructions);
-                        result.extra_metrics["perf_l3_cache_misses"] = static_cast<double>(perf_sample.cache_misses);
-                        result.extra_metrics["perf_branches"] = static_cast<double>(perf_sample.branches);
-                        result.extra_metrics["perf_branch_misses"] = static_cast<double>(perf_sample.branch_misses);
-                        if (perf_sample.instructions > 0) {
-                            result.extra_metrics["perf_cpi"] = static_cast<double>(perf_sample.cycles) /
-                                static_cast<double>(perf_sample.instructions);
-                        }
-                        result.extra_info["perf.counters"] = "perf_event_open";
-                    } else {
-                        result.extra_info["perf.counters"] = perf_started ? "unavailable" : "insufficient_permissions";
-                    }
-                } else {
-                    result.extra_info["perf.counters"] = "disabled";
-                    perf_counters.stop();
-                }
+                instrumentation.finish(result);
 
                 for (const auto& entry : build_metadata) {
                     result.extra_info[entry.first] = entry.second;
@@ -550,10 +969,16 @@ int main(int argc, char* argv[])
 
     if (telemetry_enabled) {
         telemetry_monitor.stopMonitoring();
-        if (!telemetry_monitor.writeSamplesToFile(config.telemetry_file)) {
+        uint64_t streamed = telemetry_monitor.getStreamedSampleCount();
+        if (!telemetry_monitor.closeTelemetryStream()) {
             std::cerr << "Warning: Unable to write telemetry samples to " << config.telemetry_file << std::endl;
         } else if (config.verbose) {
-            std::cout << "Telemetry written to: " << config.telemetry_file << std::endl;
+            std::cout << "Telemetry written to: " << config.telemetry_file << " (" << streamed << " samples)" << std::endl;
+        }
+        if (config.verbose) {
+            std::cout << "Telemetry monitor overhead: " << std::fixed << std::setprecision(3)
+                      << telemetry_monitor.getSelfOverheadPercent() << "% of one core at "
+                      << telemetry_monitor.getSampleInterval() << " ms intervals" << std::endl;
         }
     }
 
@@ -1,11 +1,13 @@
 #include "mem_bench.h"
+#include "cgroup.h"
+#include "cpu_topology.h"
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <new>
 #include <random>
 
-double MemoryBenchmark::measureSequentialRead(void* buffer, size_t size, int iterations)
+double MemoryBenchmark::measureSequentialRead(void* buffer, size_t size, int iterations, double& bytes_moved)
 {
     char* src = static_cast<char*>(buffer);
     char* dst = new char[BLOCK_SIZE];
@@ -29,6 +31,7 @@ double MemoryBenchmark::measureSequentialRead(void* buffer, size_t size, int ite
 
         elapsed_nanoseconds = timer.elapsedNanoseconds();
         bytes_read = static_cast<double>(size) * actual_iterations;
+        bytes_moved += bytes_read;
 
         // If test completed too quickly, increase iterations and retry
         // Minimum 1 million nanoseconds (1ms) for accurate measurement
@@ -57,7 +60,7 @@ double MemoryBenchmark::measureSequentialRead(void* buffer, size_t size, int ite
     return throughput_mbps;
 }
 
-double MemoryBenchmark::measureSequentialWrite(void* buffer, size_t size, int iterations)
+double MemoryBenchmark::measureSequentialWrite(void* buffer, size_t size, int iterations, double& bytes_moved)
 {
     char* dst = static_cast<char*>(buffer);
     char* src = new char[BLOCK_SIZE];
@@ -83,6 +86,7 @@ double MemoryBenchmark::measureSequentialWrite(void* buffer, size_t size, int it
 
         elapsed_nanoseconds = timer.elapsedNanoseconds();
         bytes_written = static_cast<double>(size) * actual_iterations;
+        bytes_moved += bytes_written;
 
         // If test completed too quickly, increase iterations and retry
         // Minimum 1 million nanoseconds (1ms) for accurate measurement
@@ -200,13 +204,23 @@ double MemoryBenchmark::measureRandomAccessBatch(void* buffer, size_t size, int
     return ops_per_second;
 }
 
+MemoryBenchmark::MemoryBenchmark(const ThreadPlacement& placement)
+    : placement(placement)
+{
+}
+
 BenchmarkResult MemoryBenchmark::run(int duration_seconds, int iterations, bool verbose)
 {
     BenchmarkResult result;
     result.name = getName();
 
     try {
-        size_t buffer_size = BUFFER_SIZE;
+        CpuPlacement cpu_map = placement.resolve();
+
+        // At least four times all last-level cache so the buffer measures DRAM; a
+        // cgroup memory limit smaller than the buffer would OOM-kill the run
+        const CpuTopology& topology = CpuTopology::host();
+        size_t buffer_size = Cgroup::fitWorkingSet(topology.dramWorkingSet(BUFFER_SIZE)) & ~static_cast<size_t>(4095);
         void* buffer = nullptr;
 
         while (buffer_size >= 16 * 1024 * 1024 && buffer == nullptr) {
@@ -234,13 +248,15 @@ BenchmarkResult MemoryBenchmark::run(int duration_seconds, int iterations, bool
 
         std::memset(buffer, 0x55, buffer_size);
 
-        double read_throughput = measureSequentialRead(buffer, buffer_size, 10);
+        // Every copy the sequential passes make, retries included, counts as work
+        double sequential_bytes = 0.0;
+        double read_throughput = measureSequentialRead(buffer, buffer_size, 10, sequential_bytes);
 
         if (verbose) {
             std::cout << "  Running sequential write test...\n";
         }
 
-        double write_throughput = measureSequentialWrite(buffer, buffer_size, 10);
+        double write_throughput = measureSequentialWrite(buffer, buffer_size, 10, sequential_bytes);
 
         if (verbose) {
             std::cout << "  Running random access test (individual timing for distribution)...\n";
@@ -284,6 +300,9 @@ BenchmarkResult MemoryBenchmark::run(int duration_seconds, int iterations, bool
         result.extra_metrics["random_latency_batch_ns"] = batch_avg_latency_ns;
         result.extra_metrics["random_latency_overhead_us"] = random_stats.getAverage() - batch_avg_latency_us;
         result.extra_metrics["buffer_size_mb"] = buffer_size / (1024.0 * 1024.0);
+        if (const CacheLevel* llc = topology.lastLevelCache()) {
+            result.extra_metrics["llc_total_mb"] = llc->totalBytes() / (1024.0 * 1024.0);
+        }
 
         if (verbose) {
             std::cout << "  Running multi-threaded contention test with CPU affinity...\n";
@@ -292,15 +311,15 @@ BenchmarkResult MemoryBenchmark::run(int duration_seconds, int iterations, bool
         std::atomic<uint64_t> total_ops(0);
         std::atomic<bool> should_stop(false);
         std::vector<std::thread> threads;
-        unsigned int num_threads = std::thread::hardware_concurrency();
+        unsigned int num_threads = static_cast<unsigned int>(cpu_map.max_threads);
 
         Timer mt_timer;
         mt_timer.start();
 
         for (unsigned int i = 0; i < num_threads; ++i) {
             threads.emplace_back([&, i]() {
-                // Pin thread to CPU core for consistent memory performance
-                CPUAffinity::pinThreadToCore(i % CPUAffinity::getNumCores());
+                // Pin thread to its placement slot for consistent memory performance
+                cpu_map.pin(i);
 
                 size_t thread_offset = (buffer_size / num_threads) * i;
                 char* thread_buffer = static_cast<char*>(buffer) + thread_offset;
@@ -327,6 +346,14 @@ BenchmarkResult MemoryBenchmark::run(int duration_seconds, int iterations, bool
         double mt_throughput = (total_ops.load() * 64) / (1024.0 * 1024.0) / mt_elapsed;
         result.extra_metrics["multithread_throughput_mbps"] = mt_throughput;
         result.extra_metrics["threads_used"] = num_threads;
+        cpu_map.record(result, num_threads);
+
+        // Random accesses and contended cache-line updates are the operations;
+        // sequential copies and the contended lines are the bytes
+        double random_accesses = static_cast<double>(iterations) * 100 + static_cast<double>(iterations) * 1000 +
+            std::min(1000, iterations * 1000);
+        result.extra_metrics["work_ops"] = random_accesses + static_cast<double>(total_ops.load());
+        result.extra_metrics["work_bytes"] = sequential_bytes + static_cast<double>(total_ops.load()) * 64;
 
         result.status = "success";
 
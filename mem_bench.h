@@ -2,6 +2,7 @@
 #define MEM_BENCH_H
 
 #include "benchmark.h"
+#include "thread_placement.h"
 #include "utils.h"
 #include <atomic>
 #include <cstring>
@@ -12,13 +13,16 @@ class MemoryBenchmark : public Benchmark {
 private:
     static constexpr size_t BUFFER_SIZE = 256 * 1024 * 1024; // 256MB
     static constexpr size_t BLOCK_SIZE = 4096; // 4KB blocks
+    ThreadPlacement placement;
 
-    double measureSequentialRead(void* buffer, size_t size, int iterations);
-    double measureSequentialWrite(void* buffer, size_t size, int iterations);
+    double measureSequentialRead(void* buffer, size_t size, int iterations, double& bytes_moved);
+    double measureSequentialWrite(void* buffer, size_t size, int iterations, double& bytes_moved);
     double measureRandomAccess(void* buffer, size_t size, int iterations, LatencyStats& stats);
     double measureRandomAccessBatch(void* buffer, size_t size, int iterations, double& avg_latency_ns);
 
 public:
+    explicit MemoryBenchmark(const ThreadPlacement& placement = ThreadPlacement());
+
     BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
     std::string getName() const override { return "Memory"; }
 };
@@ -1,13 +1,239 @@
 #include "net_bench.h"
+#include "load_curve.h"
+#include "pipeline.h"
 #include <chrono>
 #include <cstring>
 #include <errno.h>
 #include <fcntl.h>
 #include <iostream>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <unistd.h>
 
+namespace {
+
+constexpr int RR_PORT = 8090;
+constexpr int RR_CONNECTIONS = 2;
+constexpr size_t RR_MESSAGE_SIZE = 64;
+constexpr int RR_DRAIN_TIMEOUT_MS = 1000;
+
+// TCP request/response over persistent loopback connections: each request is a
+// 64-byte message echoed by a server thread, timed from its scheduled send time.
+class NetRequestResponseWorkload : public RateControlledWorkload {
+private:
+    int listen_fd { -1 };
+    std::vector<int> client_fds;
+    std::vector<int> server_fds;
+    std::vector<std::thread> echo_threads;
+    uint64_t step_id { 0 };
+
+    static void echoLoop(int fd)
+    {
+        char message[RR_MESSAGE_SIZE];
+        while (recv(fd, message, sizeof(message), MSG_WAITALL) == static_cast<ssize_t>(sizeof(message))) {
+            if (send(fd, message, sizeof(message), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(message))) {
+                break;
+            }
+        }
+    }
+
+    // One sender/receiver pair per connection; rate <= 0 keeps one request in flight
+    void driveConnection(int fd, double rate, uint64_t start_ns, uint64_t deadline_ns, uint64_t step,
+        std::atomic<uint64_t>& sent, std::atomic<uint64_t>& completed, SampleReservoir& latency_us,
+        uint64_t& send_end_ns)
+    {
+        std::atomic<uint64_t> local_sent(0);
+        std::atomic<uint64_t> local_completed(0);
+        std::atomic<bool> sender_done(false);
+
+        std::thread sender([&]() {
+            ArrivalSchedule schedule(rate, start_ns, step * RR_CONNECTIONS + fd);
+            char message[RR_MESSAGE_SIZE] = {};
+            while (true) {
+                uint64_t intended = pipelineNowNanoseconds();
+                if (rate > 0.0) {
+                    if (!schedule.waitNext(deadline_ns, intended)) {
+                        break;
+                    }
+                } else {
+                    if (intended >= deadline_ns) {
+                        break;
+                    }
+                    if (local_sent.load(std::memory_order_relaxed) > local_completed.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+                memcpy(message, &intended, sizeof(intended));
+                memcpy(message + sizeof(intended), &step, sizeof(step));
+                if (send(fd, message, sizeof(message), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(message))) {
+                    break;
+                }
+                local_sent.fetch_add(1, std::memory_order_release);
+            }
+            send_end_ns = std::max(send_end_ns, pipelineNowNanoseconds());
+            sender_done.store(true, std::memory_order_release);
+        });
+
+        char message[RR_MESSAGE_SIZE];
+        uint64_t drain_deadline = 0;
+        while (true) {
+            if (sender_done.load(std::memory_order_acquire)) {
+                if (local_completed.load() >= local_sent.load()) {
+                    break;
+                }
+                uint64_t now = pipelineNowNanoseconds();
+                if (drain_deadline == 0) {
+                    drain_deadline = now + static_cast<uint64_t>(RR_DRAIN_TIMEOUT_MS) * 1000000ULL;
+                } else if (now > drain_deadline) {
+                    break;
+                }
+            }
+            pollfd pfd { fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            if (recv(fd, message, sizeof(message), MSG_WAITALL) != static_cast<ssize_t>(sizeof(message))) {
+                break;
+            }
+            uint64_t now = pipelineNowNanoseconds();
+            uint64_t intended = 0;
+            uint64_t reply_step = 0;
+            memcpy(&intended, message, sizeof(intended));
+            memcpy(&reply_step, message + sizeof(intended), sizeof(reply_step));
+            if (reply_step == step) {
+                latency_us.add(now > intended ? (now - intended) / 1000.0 : 0.0);
+                local_completed.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        sender.join();
+        sent.fetch_add(local_sent.load());
+        completed.fetch_add(local_completed.load());
+    }
+
+    void openConnections()
+    {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            throw std::runtime_error("Failed to create TCP RR socket");
+        }
+        int opt = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(RR_PORT);
+        if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, RR_CONNECTIONS) < 0) {
+            throw std::runtime_error("Failed to bind TCP RR socket");
+        }
+
+        for (int i = 0; i < RR_CONNECTIONS; ++i) {
+            int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (client_fd < 0 || connect(client_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+                if (client_fd >= 0) {
+                    close(client_fd);
+                }
+                throw std::runtime_error("Failed to connect TCP RR client");
+            }
+            int server_fd = accept(listen_fd, nullptr, nullptr);
+            if (server_fd < 0) {
+                close(client_fd);
+                throw std::runtime_error("Failed to accept TCP RR connection");
+            }
+            setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+            setsockopt(server_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+            client_fds.push_back(client_fd);
+            server_fds.push_back(server_fd);
+            echo_threads.emplace_back(echoLoop, server_fd);
+        }
+    }
+
+public:
+    ~NetRequestResponseWorkload() override { tearDown(); }
+
+    std::string getName() const override { return "Network TCP RR"; }
+    std::string getRateUnit() const override { return "req/s"; }
+
+    // A failed setUp stops the echo threads it started and closes its sockets
+    void setUp() override
+    {
+        try {
+            openConnections();
+        } catch (...) {
+            tearDown();
+            throw;
+        }
+    }
+
+    void tearDown() override
+    {
+        for (int fd : client_fds) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& t : echo_threads) {
+            t.join();
+        }
+        echo_threads.clear();
+        for (int fd : client_fds) {
+            close(fd);
+        }
+        for (int fd : server_fds) {
+            close(fd);
+        }
+        client_fds.clear();
+        server_fds.clear();
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            listen_fd = -1;
+        }
+    }
+
+    LoadStepResult runAtRate(double rate, int duration_seconds) override
+    {
+        uint64_t step = ++step_id;
+        std::atomic<uint64_t> sent(0);
+        std::atomic<uint64_t> completed(0);
+        std::vector<SampleReservoir> latencies(client_fds.size());
+        std::vector<uint64_t> send_end(client_fds.size(), 0);
+        uint64_t start_ns = pipelineNowNanoseconds();
+        uint64_t deadline_ns = start_ns + static_cast<uint64_t>(duration_seconds) * 1000000000ULL;
+        double per_connection_rate = rate > 0.0 ? rate / client_fds.size() : 0.0;
+
+        std::vector<std::thread> drivers;
+        for (size_t i = 0; i < client_fds.size(); ++i) {
+            drivers.emplace_back([&, i]() {
+                driveConnection(client_fds[i], per_connection_rate, start_ns, deadline_ns, step, sent, completed,
+                    latencies[i], send_end[i]);
+            });
+        }
+        for (auto& t : drivers) {
+            t.join();
+        }
+
+        SampleReservoir merged;
+        for (const auto& reservoir : latencies) {
+            for (double sample : reservoir.samples) {
+                merged.add(sample);
+            }
+        }
+        uint64_t end_ns = *std::max_element(send_end.begin(), send_end.end());
+        return summarizeLoadStep(rate, sent.load(), completed.load(), merged, (end_ns - start_ns) / NANOSECONDS_PER_SECOND);
+    }
+};
+
+}
+
+NetworkBenchmark::NetworkBenchmark(const ThreadPlacement& placement)
+    : placement(placement)
+{
+}
+
 void NetworkBenchmark::tcpServer(int port, LatencyStats& stats)
 {
+    cpu_map.pin(0);
     int server_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (server_fd < 0) {
         throw std::runtime_error("Failed to create TCP socket");
@@ -72,6 +298,7 @@ void NetworkBenchmark::tcpServer(int port, LatencyStats& stats)
 
 void NetworkBenchmark::tcpClient(int port, int duration_seconds, std::atomic<uint64_t>& bytes_transferred)
 {
+    cpu_map.pin(1);
     while (!server_ready.load()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
@@ -112,6 +339,7 @@ void NetworkBenchmark::tcpClient(int port, int duration_seconds, std::atomic<uin
 
 void NetworkBenchmark::udpServer(int port, LatencyStats& stats, std::atomic<uint64_t>& packets_received)
 {
+    cpu_map.pin(0);
     int server_fd = socket(AF_INET, SOCK_DGRAM, 0);
     if (server_fd < 0) {
         throw std::runtime_error("Failed to create UDP socket");
@@ -165,6 +393,7 @@ void NetworkBenchmark::udpServer(int port, LatencyStats& stats, std::atomic<uint
 
 void NetworkBenchmark::udpClient(int port, int duration_seconds, std::atomic<uint64_t>& packets_sent)
 {
+    cpu_map.pin(1);
     while (!server_ready.load()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
@@ -222,6 +451,8 @@ NetworkBenchmark::TCPResult NetworkBenchmark::runTCPBenchmark(int duration_secon
     result.throughput_mbps = (bytes_transferred.load() / (1024.0 * 1024.0)) / duration_seconds;
     result.avg_latency_ms = tcp_stats.getAverage();
     result.p99_latency_ms = tcp_stats.getPercentile(99);
+    result.exchanges = tcp_stats.getCount();
+    result.bytes = bytes_transferred.load();
 
     return result;
 }
@@ -254,6 +485,7 @@ NetworkBenchmark::UDPResult NetworkBenchmark::runUDPBenchmark(int duration_secon
     result.throughput_mbps = (received * 1400 * 8) / (1024.0 * 1024.0) / duration_seconds;
     result.avg_latency_ms = udp_stats.getAverage();
     result.packet_loss_percent = sent > 0 ? ((sent - received) * 100.0) / sent : 0;
+    result.packets_received = received;
 
     return result;
 }
@@ -264,6 +496,7 @@ BenchmarkResult NetworkBenchmark::run(int duration_seconds, int iterations, bool
     result.name = getName();
 
     try {
+        cpu_map = placement.resolve();
         if (verbose) {
             std::cout << "  Running TCP benchmark...\n";
         }
@@ -300,6 +533,11 @@ BenchmarkResult NetworkBenchmark::run(int duration_seconds, int iterations, bool
         result.extra_metrics["udp_avg_latency_ms"] = udp_result.avg_latency_ms;
         result.extra_metrics["udp_packet_loss_percent"] = udp_result.packet_loss_percent;
         result.extra_metrics["loopback_used"] = 1.0;
+        cpu_map.record(result, 2);
+
+        // One operation per TCP echo and per UDP datagram received
+        result.extra_metrics["work_ops"] = static_cast<double>(tcp_result.exchanges + udp_result.packets_received);
+        result.extra_metrics["work_bytes"] = static_cast<double>(tcp_result.bytes + udp_result.packets_received * 1400);
 
         result.status = "success";
 
@@ -309,4 +547,8 @@ BenchmarkResult NetworkBenchmark::run(int duration_seconds, int iterations, bool
     }
 
     return result;
-}
\ No newline at end of file
+}
+std::unique_ptr<RateControlledWorkload> NetworkBenchmark::createRateControlledWorkload()
+{
+    return std::make_unique<NetRequestResponseWorkload>();
+}
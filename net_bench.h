@@ -2,6 +2,7 @@
 #define NET_BENCH_H
 
 #include "benchmark.h"
+#include "thread_placement.h"
 #include "utils.h"
 #include <arpa/inet.h>
 #include <atomic>
@@ -16,17 +17,22 @@ private:
 
     std::atomic<bool> server_ready { false };
     std::atomic<bool> should_stop { false };
+    ThreadPlacement placement;
+    CpuPlacement cpu_map; // servers run on slot 0, clients on slot 1
 
     struct TCPResult {
         double throughput_mbps;
         double avg_latency_ms;
         double p99_latency_ms;
+        uint64_t exchanges;
+        uint64_t bytes;
     };
 
     struct UDPResult {
         double throughput_mbps;
         double avg_latency_ms;
         double packet_loss_percent;
+        uint64_t packets_received;
     };
 
     TCPResult runTCPBenchmark(int duration_seconds, bool verbose);
@@ -39,8 +45,11 @@ private:
     void udpClient(int port, int duration_seconds, std::atomic<uint64_t>& packets_sent);
 
 public:
+    explicit NetworkBenchmark(const ThreadPlacement& placement = ThreadPlacement());
+
     BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
     std::string getName() const override { return "Network"; }
+    std::unique_ptr<RateControlledWorkload> createRateControlledWorkload() override;
 };
 
 #endif
\ No newline at end of file
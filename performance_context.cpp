@@ -1,7 +1,10 @@
 #include "performance_context.h"
+#include "instrumentation.h"
 #include <algorithm>
 #include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <thread>
 
@@ -228,6 +231,87 @@ std::vector<std::string> PerformanceContextAnalyzer::getPreBenchmarkRecommendati
     return env.pre_benchmark_recommendations;
 }
 
+namespace {
+
+template <typename T>
+std::string formatSeries(const std::vector<T>& values)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << (i ? "," : "") << values[i];
+    }
+    return out.str();
+}
+
+// Per-core frequency, idle-state and throttle series; variation between cores
+// and deep C-state exits explain latency variance that averages hide
+void applyPerCoreSeries(BenchmarkResult& result, const ResourceMetrics& avg, const CStateResidency& residency)
+{
+    const auto& frequency = avg.per_core_frequency_mhz;
+    if (!frequency.empty()) {
+        auto range = std::minmax_element(frequency.begin(), frequency.end());
+        result.extra_metrics["cpu_freq_min_core_mhz"] = *range.first;
+        result.extra_metrics["cpu_freq_max_core_mhz"] = *range.second;
+        result.extra_metrics["cpu_freq_spread_mhz"] = *range.second - *range.first;
+        result.extra_info["cpu.per_core.freq_mhz"] = formatSeries(frequency);
+    }
+
+    if (!avg.per_core_deep_idle_percent.empty()) {
+        result.extra_info["cpu.per_core.deep_idle_percent"] = formatSeries(avg.per_core_deep_idle_percent);
+    }
+    for (size_t state = 0; state < residency.names.size(); ++state) {
+        const auto& per_core = residency.per_core_percent[state];
+        double mean = std::accumulate(per_core.begin(), per_core.end(), 0.0) / std::max<size_t>(1, per_core.size());
+        result.extra_metrics["cstate_" + residency.names[state] + "_residency_percent"] = mean;
+        result.extra_info["cpu.per_core.cstate_" + residency.names[state] + "_percent"] = formatSeries(per_core);
+    }
+
+    result.extra_metrics["thermal_throttle_events"] = static_cast<double>(avg.thermal_throttle_events);
+    if (avg.thermal_throttle_events > 0) {
+        result.extra_info["cpu.per_core.throttle_events"] = formatSeries(avg.per_core_throttle_events);
+    }
+}
+
+}
+
+void PerformanceContextAnalyzer::applyInterferenceVerdict(BenchmarkResult& result, const MonitoredAttempt& kept,
+    const std::vector<MonitoredAttempt>& discarded) const
+{
+    result.extra_info["interference.policy"] = interference_policy.describe();
+    result.extra_metrics["interference_attempts"] = static_cast<double>(discarded.size() + 1);
+    result.extra_metrics["interference_discarded_attempts"] = static_cast<double>(discarded.size());
+    result.extra_metrics["interference_disturbed_samples"] = static_cast<double>(kept.disturbed_samples);
+    result.extra_metrics["interference_disturbed_seconds"] = kept.disturbed_seconds;
+
+    std::string verdict;
+    if (kept.disturbed_seconds <= 0.0) {
+        verdict = discarded.empty() ? "clean" : "clean on attempt " + std::to_string(kept.number);
+    } else if (interference_policy.max_reruns > 0) {
+        verdict = "disturbed, retry budget exhausted (kept attempt " + std::to_string(kept.number) + ")";
+    } else {
+        verdict = "disturbed";
+    }
+    result.extra_info["interference.verdict"] = verdict;
+    if (!kept.disturbance.empty()) {
+        result.extra_info["interference.windows"] = kept.disturbance;
+    }
+
+    if (discarded.empty()) {
+        return;
+    }
+    std::ostringstream reasons;
+    for (size_t i = 0; i < discarded.size(); ++i) {
+        const MonitoredAttempt& attempt = discarded[i];
+        if (i) {
+            reasons << " | ";
+        }
+        reasons << "attempt " << attempt.number << " (" << attempt.result.throughput << " "
+                << attempt.result.throughput_unit << "): " << attempt.disturbance;
+    }
+    result.extra_info["interference.discarded"] = reasons.str();
+}
+
 ContextualBenchmarkResult PerformanceContextAnalyzer::runBenchmarkWithContext(
     Benchmark* benchmark, int duration_seconds, int iterations, bool verbose, bool collect_perf_counters)
 {
@@ -245,13 +329,64 @@ ContextualBenchmarkResult PerformanceContextAnalyzer::runBenchmarkWithContext(
     
     // Warmup system
     warmupSystem(3);
+
+    // A disturbed run is repeated up to the retry budget; if every attempt is
+    // disturbed, the one with the least disturbed time is kept
+    std::vector<MonitoredAttempt> discarded;
+    MonitoredAttempt kept;
+    for (int attempt = 0;; ++attempt) {
+        if (attempt > 0) {
+            if (verbose) {
+                std::cout << "Interference detected (" << discarded.back().disturbance
+                          << "), rerunning " << benchmark->getName() << "\n";
+            }
+            cooldownSystem(2);
+        }
+
+        MonitoredAttempt current = runMonitoredAttempt(benchmark, duration_seconds, iterations, verbose,
+            collect_perf_counters);
+        current.number = attempt + 1;
+        bool clean = current.disturbed_seconds <= 0.0 || current.result.status != "success";
+        if (clean || attempt >= interference_policy.max_reruns) {
+            if (!clean && !discarded.empty()) {
+                auto least = std::min_element(discarded.begin(), discarded.end(),
+                    [](const MonitoredAttempt& a, const MonitoredAttempt& b) {
+                        return a.disturbed_seconds < b.disturbed_seconds;
+                    });
+                if (least->disturbed_seconds < current.disturbed_seconds) {
+                    std::swap(*least, current);
+                }
+            }
+            kept = std::move(current);
+            break;
+        }
+        discarded.push_back(std::move(current));
+    }
+
+    BenchmarkResult& bench_result = kept.result;
+    applyInterferenceVerdict(bench_result, kept, discarded);
+
+    for (const auto& entry : getBuildMetadataMap()) {
+        bench_result.extra_info[entry.first] = entry.second;
+    }
     
+    // Cool down system
+    cooldownSystem(2);
+    
+    // Analyze the results
+    return analyzeBenchmarkResult(bench_result, kept.avg_metrics, kept.peak_metrics, kept.interference);
+}
+
+PerformanceContextAnalyzer::MonitoredAttempt PerformanceContextAnalyzer::runMonitoredAttempt(
+    Benchmark* benchmark, int duration_seconds, int iterations, bool verbose, bool collect_perf_counters)
+{
+    MonitoredAttempt attempt;
+
     // Start system monitoring
     system_monitor.startMonitoring();
 
-    PerfCounterSet perf_counters;
-    PerfCounterSample perf_sample;
-    bool perf_enabled = collect_perf_counters && perf_counters.start();
+    BenchmarkInstrumentation instrumentation(collect_perf_counters);
+    instrumentation.start();
     
     // Run the benchmark
     if (verbose) {
@@ -260,43 +395,46 @@ ContextualBenchmarkResult PerformanceContextAnalyzer::runBenchmarkWithContext(
     
     BenchmarkResult bench_result = benchmark->run(duration_seconds, iterations, verbose);
     
-    if (collect_perf_counters) {
-        perf_sample = perf_counters.stop();
-        if (perf_sample.valid) {
-            bench_result.extra_metrics["perf_cpu_cycles"] = static_cast<double>(perf_sample.cycles);
-            bench_result.extra_metrics["perf_cpu_instructions"] = static_cast<double>(perf_sample.instructions);
-            bench_result.extra_metrics["perf_l3_cache_misses"] = static_cast<double>(perf_sample.cache_misses);
-            bench_result.extra_metrics["perf_branches"] = static_cast<double>(perf_sample.branches);
-            bench_result.extra_metrics["perf_branch_misses"] = static_cast<double>(perf_sample.branch_misses);
-            if (perf_sample.instructions > 0) {
-                bench_result.extra_metrics["perf_cpi"] = static_cast<double>(perf_sample.cycles) /
-                    static_cast<double>(perf_sample.instructions);
-            }
-            bench_result.extra_info["perf.counters"] = "perf_event_open";
-        } else {
-            bench_result.extra_info["perf.counters"] = perf_enabled ? "unavailable" : "insufficient_permissions";
-        }
-    } else {
-        bench_result.extra_info["perf.counters"] = "disabled";
-        perf_counters.stop();
-    }
+    instrumentation.finish(bench_result);
     
     // Stop monitoring and collect results
     system_monitor.stopMonitoring();
     
     ResourceMetrics avg_metrics = system_monitor.getAverageMetrics();
-    ResourceMetrics peak_metrics = system_monitor.getPeakMetrics();
     InterferenceReport interference = system_monitor.analyzeInterference();
 
-    for (const auto& entry : getBuildMetadataMap()) {
-        bench_result.extra_info[entry.first] = entry.second;
+    // What the monitor itself cost, so its footprint can be checked against the result
+    bench_result.extra_metrics["monitor_overhead_percent"] = system_monitor.getSelfOverheadPercent();
+    bench_result.extra_metrics["monitor_interval_ms"] = system_monitor.getSampleInterval();
+    bench_result.extra_metrics["monitor_samples"] = static_cast<double>(system_monitor.getSampleCount());
+    bench_result.extra_metrics["monitor_collection_cpu_us"] = avg_metrics.collection_cpu_us;
+    bench_result.extra_metrics["monitor_foreign_cpu_percent"] =
+        std::max(0.0, avg_metrics.avg_cpu_usage_percent - avg_metrics.process_cpu_percent);
+
+    applyPerCoreSeries(bench_result, avg_metrics, system_monitor.getCStateResidency());
+
+    if (interference.psi_available) {
+        bench_result.extra_metrics["psi_cpu_some_percent"] = interference.cpu_stall_percent;
+        bench_result.extra_metrics["psi_memory_some_percent"] = interference.memory_stall_percent;
+        bench_result.extra_metrics["psi_io_some_percent"] = interference.io_stall_percent;
+        bench_result.extra_metrics["psi_memory_full_percent"] = std::max(avg_metrics.memory_psi.full_stall_percent,
+            avg_metrics.cgroup_memory_psi.full_stall_percent);
+        bench_result.extra_metrics["psi_io_full_percent"] = std::max(avg_metrics.io_psi.full_stall_percent,
+            avg_metrics.cgroup_io_psi.full_stall_percent);
+        bench_result.extra_info["psi.scope"] = avg_metrics.cgroup_psi_available ? "system+cgroup" : "system";
+    } else {
+        bench_result.extra_info["psi.scope"] = "unavailable";
     }
-    
-    // Cool down system
-    cooldownSystem(2);
-    
-    // Analyze the results
-    return analyzeBenchmarkResult(bench_result, avg_metrics, peak_metrics, interference);
+
+    const InterferenceWatch& watch = system_monitor.getInterferenceWatch();
+    attempt.result = std::move(bench_result);
+    attempt.avg_metrics = avg_metrics;
+    attempt.peak_metrics = system_monitor.getPeakMetrics();
+    attempt.interference = interference;
+    attempt.disturbed_samples = watch.disturbedSamples();
+    attempt.disturbed_seconds = watch.disturbedSeconds();
+    attempt.disturbance = watch.summary();
+    return attempt;
 }
 
 ContextualBenchmarkResult PerformanceContextAnalyzer::analyzeBenchmarkResult(
@@ -355,6 +493,22 @@ double PerformanceContextAnalyzer::calculateReliabilityScore(
     if (interference.network_congestion) {
         score -= 10.0;
     }
+    if (interference.cpu_contention) {
+        score -= 20.0;
+    }
+
+    // PSI stall time scales the penalty: every 2% of time stalled costs a point
+    if (interference.psi_available) {
+        double stall_percent = std::max({ interference.cpu_stall_percent, interference.memory_stall_percent,
+            interference.io_stall_percent });
+        score -= std::min(20.0, stall_percent / 2.0);
+    }
+    
+    // CFS quota throttling caps throughput no matter how quiet the host is
+    auto throttled = result.extra_metrics.find("cgroup_throttled_period_percent");
+    if (throttled != result.extra_metrics.end() && throttled->second > 5.0) {
+        score -= 25.0;
+    }
     
     // Penalize for insufficient monitoring samples
     if (metrics.sample_count < 10) {
@@ -393,6 +547,27 @@ std::vector<std::string> PerformanceContextAnalyzer::generateContextWarnings(
     if (platform.is_virtualized) {
         warnings.push_back("Running in virtualized environment - results may not reflect bare metal performance");
     }
+
+    auto throttled = result.extra_metrics.find("cgroup_throttled_period_percent");
+    if (throttled != result.extra_metrics.end() && throttled->second > 0.0) {
+        warnings.push_back("cgroup CPU quota throttled the benchmark in " +
+            std::to_string(static_cast<int>(throttled->second)) + "% of scheduler periods");
+    }
+
+    auto vm_stalls = result.extra_info.find("vm.stalls");
+    if (vm_stalls != result.extra_info.end() && vm_stalls->second != "none") {
+        warnings.push_back("Memory allocations stalled during the benchmark (" + vm_stalls->second + ")");
+    }
+
+    auto irq_overlap = result.extra_info.find("irq.overlap");
+    if (irq_overlap != result.extra_info.end() && irq_overlap->second != "none") {
+        warnings.push_back("Device interrupts landed on the benchmark's pinned CPUs: " + irq_overlap->second);
+    }
+
+    auto disturbed = result.extra_info.find("interference.windows");
+    if (disturbed != result.extra_info.end()) {
+        warnings.push_back("Interference during the reported run: " + disturbed->second);
+    }
     
     if (platform.cpu_governor == "powersave") {
         warnings.push_back("CPU governor set to power saving mode - performance may be reduced");
@@ -483,6 +658,7 @@ double PerformanceContextAnalyzer::calculateEnvironmentScore(const PerformanceEn
         if (env.environment_interference.memory_pressure) score -= 8.0;
         if (env.environment_interference.high_io_wait) score -= 12.0;
         if (env.environment_interference.thermal_throttling) score -= 15.0;
+        if (env.environment_interference.cpu_contention) score -= 10.0;
     }
     
     // Configuration optimality (30%)
@@ -60,6 +60,24 @@ class PerformanceContextAnalyzer {
 private:
     PlatformDetector platform_detector;
     SystemMonitor system_monitor;
+    InterferencePolicy interference_policy;
+
+    // One monitored run of a benchmark and what the interference watch saw during it
+    struct MonitoredAttempt {
+        int number { 1 };
+        BenchmarkResult result;
+        ResourceMetrics avg_metrics;
+        ResourceMetrics peak_metrics;
+        InterferenceReport interference;
+        size_t disturbed_samples { 0 };
+        double disturbed_seconds { 0.0 };
+        std::string disturbance;
+    };
+
+    MonitoredAttempt runMonitoredAttempt(Benchmark* benchmark, int duration_seconds, int iterations,
+        bool verbose, bool collect_perf_counters);
+    void applyInterferenceVerdict(BenchmarkResult& result, const MonitoredAttempt& kept,
+        const std::vector<MonitoredAttempt>& discarded) const;
     
     // Analysis methods
     double calculateReliabilityScore(
@@ -83,6 +101,13 @@ private:
 public:
     PerformanceContextAnalyzer();
     ~PerformanceContextAnalyzer();
+
+    void setMonitorSampleInterval(int milliseconds) { system_monitor.setSampleInterval(milliseconds); }
+    void setInterferencePolicy(const InterferencePolicy& policy)
+    {
+        interference_policy = policy;
+        system_monitor.setInterferencePolicy(policy);
+    }
     
     // Environment analysis
     PerformanceEnvironment analyzeCurrentEnvironment();
@@ -0,0 +1,275 @@
+#include "pipeline.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr auto OCCUPANCY_SAMPLE_INTERVAL = std::chrono::milliseconds(1);
+
+}
+
+struct PipelineEngine::WorkerState {
+    SampleReservoir service_us;
+    SampleReservoir e2e_us;
+    uint64_t items { 0 };
+    uint64_t batches { 0 };
+    uint64_t busy_ns { 0 };
+    uint64_t input_stalls { 0 };
+    uint64_t output_stalls { 0 };
+};
+
+PipelineEngine::PipelineEngine(size_t queue_capacity, size_t payload_size)
+    : queue_capacity(queue_capacity)
+    , payload_size(payload_size)
+{
+}
+
+void PipelineEngine::addStage(const PipelineStageConfig& stage)
+{
+    if (!stage.process) {
+        throw std::invalid_argument("Pipeline stage '" + stage.name + "' has no process function");
+    }
+    PipelineStageConfig normalized = stage;
+    normalized.threads = std::max(1, normalized.threads);
+    normalized.batch_size = std::max<size_t>(1, normalized.batch_size);
+    stages.push_back(normalized);
+}
+
+PipelineRunStats PipelineEngine::run(int duration_seconds)
+{
+    if (stages.empty()) {
+        throw std::runtime_error("Pipeline has no stages");
+    }
+
+    const size_t stage_count = stages.size();
+
+    // Enough items to fill every queue plus one in-flight batch per worker
+    size_t pool_size = queue_capacity * stage_count;
+    for (const auto& stage : stages) {
+        pool_size += static_cast<size_t>(stage.threads) * stage.batch_size;
+    }
+
+    std::vector<PipelineItem> items(pool_size);
+    for (auto& item : items) {
+        item.payload.resize(payload_size);
+    }
+
+    // queues[0] recycles items from the last stage back to the first; queues[i]
+    // (i >= 1) connects stage i-1 to stage i.
+    std::vector<std::unique_ptr<StageQueue<PipelineItem*>>> queues;
+    bool recycle_spsc = stages.front().threads == 1 && stages.back().threads == 1;
+    queues.emplace_back(new StageQueue<PipelineItem*>(pool_size, recycle_spsc));
+    for (size_t i = 1; i < stage_count; ++i) {
+        bool spsc = stages[i - 1].threads == 1 && stages[i].threads == 1;
+        queues.emplace_back(new StageQueue<PipelineItem*>(queue_capacity, spsc));
+    }
+
+    for (auto& item : items) {
+        queues[0]->tryPush(&item);
+    }
+
+    std::atomic<bool> should_stop(false);
+    std::atomic<uint64_t> next_sequence(0);
+
+    std::vector<std::vector<WorkerState>> worker_states(stage_count);
+    for (size_t s = 0; s < stage_count; ++s) {
+        worker_states[s].resize(stages[s].threads);
+    }
+
+    auto worker = [&](size_t stage_index, int worker_index) {
+        const PipelineStageConfig& stage = stages[stage_index];
+        StageQueue<PipelineItem*>& input = *queues[stage_index];
+        StageQueue<PipelineItem*>& output = *queues[(stage_index + 1) % stage_count];
+        WorkerState& state = worker_states[stage_index][worker_index];
+        const bool is_source = stage_index == 0;
+        const bool is_sink = stage_index == stage_count - 1;
+
+        std::vector<PipelineItem*> batch;
+        batch.reserve(stage.batch_size);
+
+        while (!should_stop.load(std::memory_order_relaxed)) {
+            batch.clear();
+            PipelineItem* item = nullptr;
+            while (batch.size() < stage.batch_size && input.tryPop(item)) {
+                batch.push_back(item);
+            }
+
+            if (batch.empty()) {
+                ++state.input_stalls;
+                std::this_thread::yield();
+                continue;
+            }
+
+            uint64_t start_ns = pipelineNowNanoseconds();
+            if (is_source) {
+                uint64_t base = next_sequence.fetch_add(batch.size(), std::memory_order_relaxed);
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    batch[i]->sequence = base + i;
+                    batch[i]->ingress_ns = start_ns;
+                }
+            }
+
+            for (PipelineItem* current : batch) {
+                stage.process(*current, worker_index);
+            }
+            if (stage.batch_end) {
+                stage.batch_end(worker_index);
+            }
+
+            uint64_t end_ns = pipelineNowNanoseconds();
+            state.busy_ns += end_ns - start_ns;
+            state.items += batch.size();
+            ++state.batches;
+            state.service_us.add((end_ns - start_ns) / 1000.0 / batch.size());
+
+            if (is_sink) {
+                for (PipelineItem* current : batch) {
+                    state.e2e_us.add((end_ns - current->ingress_ns) / 1000.0);
+                }
+            }
+
+            for (PipelineItem* current : batch) {
+                while (!output.tryPush(current)) {
+                    if (should_stop.load(std::memory_order_relaxed)) {
+                        break;
+                    }
+                    ++state.output_stalls;
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        if (stage.stage_end) {
+            stage.stage_end(worker_index);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    Timer run_timer;
+    run_timer.start();
+
+    for (size_t s = 0; s < stage_count; ++s) {
+        for (int w = 0; w < stages[s].threads; ++w) {
+            threads.emplace_back(worker, s, w);
+        }
+    }
+
+    // Sample queue depth while the pipeline runs
+    struct OccupancyTotals {
+        double sum { 0.0 };
+        size_t max { 0 };
+        uint64_t full { 0 };
+    };
+    std::vector<OccupancyTotals> occupancy(queues.size());
+    uint64_t occupancy_samples = 0;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(duration_seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(OCCUPANCY_SAMPLE_INTERVAL);
+        for (size_t q = 0; q < queues.size(); ++q) {
+            size_t depth = queues[q]->size();
+            occupancy[q].sum += static_cast<double>(depth);
+            if (depth > occupancy[q].max) {
+                occupancy[q].max = depth;
+            }
+            if (depth >= queues[q]->getCapacity()) {
+                ++occupancy[q].full;
+            }
+        }
+        ++occupancy_samples;
+    }
+
+    should_stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    double elapsed_ns = run_timer.elapsedNanoseconds();
+
+    PipelineRunStats stats;
+    stats.elapsed_seconds = elapsed_ns / NANOSECONDS_PER_SECOND;
+    stats.pool_items = pool_size;
+
+    double total_busy_ns = 0.0;
+    int total_threads = 0;
+    double worst_utilization = -1.0;
+    LatencyStats e2e_stats;
+
+    for (size_t s = 0; s < stage_count; ++s) {
+        PipelineStageStats stage_stats;
+        stage_stats.name = stages[s].name;
+        stage_stats.threads = stages[s].threads;
+
+        LatencyStats service_stats;
+        uint64_t busy_ns = 0;
+        for (const auto& state : worker_states[s]) {
+            stage_stats.items += state.items;
+            stage_stats.batches += state.batches;
+            stage_stats.input_stalls += state.input_stalls;
+            stage_stats.output_stalls += state.output_stalls;
+            busy_ns += state.busy_ns;
+            for (double sample : state.service_us.samples) {
+                service_stats.addSample(sample);
+            }
+            if (s == stage_count - 1) {
+                for (double sample : state.e2e_us.samples) {
+                    e2e_stats.addSample(sample);
+                }
+            }
+        }
+
+        if (stage_stats.batches > 0) {
+            stage_stats.avg_batch_size = static_cast<double>(stage_stats.items) / stage_stats.batches;
+        }
+        if (stage_stats.items > 0) {
+            stage_stats.avg_service_us = busy_ns / 1000.0 / stage_stats.items;
+        }
+        stage_stats.p99_service_us = service_stats.getPercentile(99);
+        if (elapsed_ns > 0.0) {
+            stage_stats.utilization_percent = busy_ns / (elapsed_ns * stage_stats.threads) * 100.0;
+        }
+
+        if (stage_stats.utilization_percent > worst_utilization) {
+            worst_utilization = stage_stats.utilization_percent;
+            stats.bottleneck_stage = stage_stats.name;
+        }
+
+        total_busy_ns += static_cast<double>(busy_ns);
+        total_threads += stage_stats.threads;
+        stats.stages.push_back(stage_stats);
+    }
+
+    stats.items_completed = stats.stages.back().items;
+    if (stats.elapsed_seconds > 0.0) {
+        stats.throughput_items_sec = stats.items_completed / stats.elapsed_seconds;
+    }
+    if (elapsed_ns > 0.0 && total_threads > 0) {
+        stats.busy_utilization_percent = total_busy_ns / (elapsed_ns * total_threads) * 100.0;
+    }
+
+    stats.e2e_avg_us = e2e_stats.getAverage();
+    stats.e2e_p50_us = e2e_stats.getPercentile(50);
+    stats.e2e_p90_us = e2e_stats.getPercentile(90);
+    stats.e2e_p99_us = e2e_stats.getPercentile(99);
+    stats.e2e_max_us = e2e_stats.getMax();
+
+    for (size_t q = 0; q < queues.size(); ++q) {
+        PipelineQueueStats queue_stats;
+        if (q == 0) {
+            queue_stats.name = stages.back().name + "->" + stages.front().name;
+        } else {
+            queue_stats.name = stages[q - 1].name + "->" + stages[q].name;
+        }
+        queue_stats.capacity = queues[q]->getCapacity();
+        queue_stats.spsc = queues[q]->isSpsc();
+        queue_stats.max_occupancy = occupancy[q].max;
+        if (occupancy_samples > 0) {
+            queue_stats.avg_occupancy = occupancy[q].sum / occupancy_samples;
+            queue_stats.full_percent = occupancy[q].full * 100.0 / occupancy_samples;
+        }
+        stats.queues.push_back(queue_stats);
+    }
+
+    return stats;
+}
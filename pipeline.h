@@ -0,0 +1,277 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "utils.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Monotonic timestamp shared by pipeline stages for end-to-end latency
+inline uint64_t pipelineNowNanoseconds()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+inline size_t roundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Bounded single-producer/single-consumer ring
+template <typename T>
+class SpscQueue {
+private:
+    alignas(64) std::atomic<size_t> head { 0 };
+    alignas(64) size_t cached_tail { 0 };
+    alignas(64) std::atomic<size_t> tail { 0 };
+    alignas(64) size_t cached_head { 0 };
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<T[]> slots;
+
+public:
+    explicit SpscQueue(size_t requested_capacity)
+        : capacity(roundUpToPowerOfTwo(std::max<size_t>(2, requested_capacity)))
+        , mask(capacity - 1)
+        , slots(new T[capacity])
+    {
+    }
+
+    bool tryPush(const T& value)
+    {
+        size_t current_head = head.load(std::memory_order_relaxed);
+        if (current_head - cached_tail >= capacity) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (current_head - cached_tail >= capacity) {
+                return false;
+            }
+        }
+        slots[current_head & mask] = value;
+        head.store(current_head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+        if (current_tail == cached_head) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (current_tail == cached_head) {
+                return false;
+            }
+        }
+        value = slots[current_tail & mask];
+        tail.store(current_tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        size_t current_head = head.load(std::memory_order_acquire);
+        size_t current_tail = tail.load(std::memory_order_acquire);
+        return current_head >= current_tail ? current_head - current_tail : 0;
+    }
+
+    size_t getCapacity() const { return capacity; }
+};
+
+// Bounded multi-producer/multi-consumer ring (Vyukov sequence-per-cell design)
+template <typename T>
+class MpmcQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueue_pos { 0 };
+    alignas(64) std::atomic<size_t> dequeue_pos { 0 };
+
+public:
+    explicit MpmcQueue(size_t requested_capacity)
+        : capacity(roundUpToPowerOfTwo(std::max<size_t>(2, requested_capacity)))
+        , mask(capacity - 1)
+        , cells(new Cell[capacity])
+    {
+        for (size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T& value)
+    {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        value = cell->data;
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        size_t enq = enqueue_pos.load(std::memory_order_acquire);
+        size_t deq = dequeue_pos.load(std::memory_order_acquire);
+        return enq >= deq ? enq - deq : 0;
+    }
+
+    size_t getCapacity() const { return capacity; }
+};
+
+// Queue connecting two stages; uses the SPSC ring when both sides are single-threaded
+template <typename T>
+class StageQueue {
+private:
+    std::unique_ptr<SpscQueue<T>> spsc;
+    std::unique_ptr<MpmcQueue<T>> mpmc;
+
+public:
+    StageQueue(size_t capacity, bool single_producer_consumer)
+    {
+        if (single_producer_consumer) {
+            spsc.reset(new SpscQueue<T>(capacity));
+        } else {
+            mpmc.reset(new MpmcQueue<T>(capacity));
+        }
+    }
+
+    bool tryPush(const T& value) { return spsc ? spsc->tryPush(value) : mpmc->tryPush(value); }
+    bool tryPop(T& value) { return spsc ? spsc->tryPop(value) : mpmc->tryPop(value); }
+    size_t size() const { return spsc ? spsc->size() : mpmc->size(); }
+    size_t getCapacity() const { return spsc ? spsc->getCapacity() : mpmc->getCapacity(); }
+    bool isSpsc() const { return static_cast<bool>(spsc); }
+};
+
+// Unit of work flowing through the pipeline; allocated once from a fixed pool
+struct PipelineItem {
+    uint64_t sequence { 0 };
+    uint64_t ingress_ns { 0 };
+    uint64_t key { 0 };
+    uint32_t length { 0 };
+    uint32_t checksum { 0 };
+    double value { 0.0 };
+    std::vector<char> payload;
+};
+
+struct PipelineStageConfig {
+    std::string name;
+    int threads { 1 };
+    size_t batch_size { 16 };
+    // Called once per item with the index of the worker thread within the stage
+    std::function<void(PipelineItem&, int)> process;
+    // Optional hook run after each batch (e.g. to flush buffered output)
+    std::function<void(int)> batch_end;
+    // Optional hook run once by each worker when the run stops, inside the timed
+    // window (e.g. to write out a partially filled buffer)
+    std::function<void(int)> stage_end;
+};
+
+struct PipelineStageStats {
+    std::string name;
+    int threads { 0 };
+    uint64_t items { 0 };
+    uint64_t batches { 0 };
+    double avg_batch_size { 0.0 };
+    double avg_service_us { 0.0 };
+    double p99_service_us { 0.0 };
+    double utilization_percent { 0.0 };
+    uint64_t input_stalls { 0 };
+    uint64_t output_stalls { 0 };
+};
+
+struct PipelineQueueStats {
+    std::string name;
+    size_t capacity { 0 };
+    bool spsc { false };
+    double avg_occupancy { 0.0 };
+    size_t max_occupancy { 0 };
+    double full_percent { 0.0 };
+};
+
+struct PipelineRunStats {
+    double elapsed_seconds { 0.0 };
+    size_t pool_items { 0 }; // items in flight at all times; e2e latency grows with it
+    uint64_t items_completed { 0 };
+    double throughput_items_sec { 0.0 };
+    double e2e_avg_us { 0.0 };
+    double e2e_p50_us { 0.0 };
+    double e2e_p90_us { 0.0 };
+    double e2e_p99_us { 0.0 };
+    double e2e_max_us { 0.0 };
+    double busy_utilization_percent { 0.0 };
+    std::string bottleneck_stage;
+    std::vector<PipelineStageStats> stages;
+    std::vector<PipelineQueueStats> queues;
+};
+
+// Generic staged pipeline: stages are connected by bounded queues and a fixed pool
+// of items circulates from the first stage to the last and back again. The loop is
+// closed, so end-to-end latency is pool_items / throughput (Little's law) and
+// measures how full the pool keeps the queues, not an offered-load response time.
+class PipelineEngine {
+private:
+    struct WorkerState;
+
+    size_t queue_capacity;
+    size_t payload_size;
+    std::vector<PipelineStageConfig> stages;
+
+public:
+    PipelineEngine(size_t queue_capacity, size_t payload_size);
+
+    void addStage(const PipelineStageConfig& stage);
+    size_t getStageCount() const { return stages.size(); }
+
+    PipelineRunStats run(int duration_seconds);
+};
+
+#endif
@@ -1,19 +1,28 @@
 #include "platform_detector.h"
+#include "cgroup.h"
+#include "cpu_features.h"
+#include "cpu_topology.h"
 #include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <cstdint>
+#include <cstring>
+#include <cctype>
 
 #ifdef __APPLE__
 #include <sys/mount.h>
 #include <sys/statvfs.h>
 #include <sys/sysctl.h>
 #elif defined(__linux__)
+#include <dirent.h>
+#include <mntent.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <unistd.h>
 #endif
+#include <sys/utsname.h>
 
 // PlatformInfo implementation
 PlatformInfo::PlatformInfo()
@@ -23,10 +32,17 @@ PlatformInfo::PlatformInfo()
     cpu_base_frequency_ghz = 0.0;
     cpu_max_frequency_ghz = 0.0;
     hyperthreading_enabled = false;
+    cpu_family = 0;
+    cpu_model_number = 0;
+    cpu_stepping = 0;
+    invariant_tsc = false;
     
     l1_cache_size_kb = 0;
     l2_cache_size_kb = 0;
     l3_cache_size_kb = 0;
+    cache_line_size = 0;
+    cpu_packages = 0;
+    cpu_dies = 0;
     
     total_memory_gb = 0.0;
     memory_channels = 0;
@@ -37,6 +53,11 @@ PlatformInfo::PlatformInfo()
     storage_capacity_gb = 0.0;
     
     is_virtualized = false;
+    cgroup_v2 = false;
+    cgroup_cpu_limit_cores = 0.0;
+    cgroup_cpuset_cpus = 0;
+    cgroup_memory_limit_gb = 0.0;
+    effective_cpus = 0;
     turbo_boost_enabled = false;
 }
 
@@ -47,14 +68,29 @@ std::string PlatformInfo::toJson() const
     json << "  \"cpu_model\": \"" << cpu_model << "\",\n";
     json << "  \"cpu_cores\": " << cpu_cores << ",\n";
     json << "  \"cpu_threads\": " << cpu_threads << ",\n";
+    json << "  \"cpu_packages\": " << cpu_packages << ",\n";
+    json << "  \"cpu_dies\": " << cpu_dies << ",\n";
     json << "  \"cpu_base_frequency_ghz\": " << cpu_base_frequency_ghz << ",\n";
     json << "  \"cpu_max_frequency_ghz\": " << cpu_max_frequency_ghz << ",\n";
     json << "  \"cpu_architecture\": \"" << cpu_architecture << "\",\n";
     json << "  \"hyperthreading_enabled\": " << (hyperthreading_enabled ? "true" : "false") << ",\n";
     json << "  \"cpu_governor\": \"" << cpu_governor << "\",\n";
+    json << "  \"cpu_vendor\": \"" << cpu_vendor << "\",\n";
+    json << "  \"cpu_family\": " << cpu_family << ",\n";
+    json << "  \"cpu_model_number\": " << cpu_model_number << ",\n";
+    json << "  \"cpu_stepping\": " << cpu_stepping << ",\n";
+    json << "  \"cpu_microarchitecture\": \"" << cpu_microarchitecture << "\",\n";
+    json << "  \"cpu_extensions\": [";
+    for (size_t i = 0; i < cpu_extensions.size(); ++i) {
+        json << (i ? ", " : "") << "\"" << cpu_extensions[i] << "\"";
+    }
+    json << "],\n";
+    json << "  \"invariant_tsc\": " << (invariant_tsc ? "true" : "false") << ",\n";
     json << "  \"l1_cache_size_kb\": " << l1_cache_size_kb << ",\n";
     json << "  \"l2_cache_size_kb\": " << l2_cache_size_kb << ",\n";
     json << "  \"l3_cache_size_kb\": " << l3_cache_size_kb << ",\n";
+    json << "  \"cache_line_size\": " << cache_line_size << ",\n";
+    json << "  \"cache_hierarchy\": \"" << cache_hierarchy << "\",\n";
     json << "  \"total_memory_gb\": " << total_memory_gb << ",\n";
     json << "  \"memory_channels\": " << memory_channels << ",\n";
     json << "  \"memory_frequency_mhz\": " << memory_frequency_mhz << ",\n";
@@ -69,6 +105,12 @@ std::string PlatformInfo::toJson() const
     json << "  \"kernel_version\": \"" << kernel_version << "\",\n";
     json << "  \"is_virtualized\": " << (is_virtualized ? "true" : "false") << ",\n";
     json << "  \"virtualization_type\": \"" << virtualization_type << "\",\n";
+    json << "  \"container_runtime\": \"" << container_runtime << "\",\n";
+    json << "  \"cgroup_v2\": " << (cgroup_v2 ? "true" : "false") << ",\n";
+    json << "  \"cgroup_cpu_limit_cores\": " << cgroup_cpu_limit_cores << ",\n";
+    json << "  \"cgroup_cpuset_cpus\": " << cgroup_cpuset_cpus << ",\n";
+    json << "  \"cgroup_memory_limit_gb\": " << cgroup_memory_limit_gb << ",\n";
+    json << "  \"effective_cpus\": " << effective_cpus << ",\n";
     json << "  \"turbo_boost_enabled\": " << (turbo_boost_enabled ? "true" : "false") << ",\n";
     json << "  \"power_profile\": \"" << power_profile << "\",\n";
     json << "  \"performance_score\": " << getPerformanceScore() << "\n";
@@ -80,6 +122,9 @@ std::string PlatformInfo::getSummary() const
 {
     std::ostringstream summary;
     summary << cpu_model;
+    if (!cpu_microarchitecture.empty()) {
+        summary << " [" << cpu_microarchitecture << "]";
+    }
     if (cpu_cores > 0) {
         summary << " (" << cpu_cores;
         if (cpu_threads > cpu_cores) {
@@ -102,6 +147,16 @@ std::string PlatformInfo::getSummary() const
     if (is_virtualized) {
         summary << " (Virtualized)";
     }
+    if (cgroup_cpu_limit_cores > 0.0 || cgroup_memory_limit_gb > 0.0) {
+        summary << " [cgroup limit:";
+        if (cgroup_cpu_limit_cores > 0.0) {
+            summary << " " << cgroup_cpu_limit_cores << " CPUs";
+        }
+        if (cgroup_memory_limit_gb > 0.0) {
+            summary << " " << cgroup_memory_limit_gb << " GB";
+        }
+        summary << "]";
+    }
     return summary.str();
 }
 
@@ -222,6 +277,15 @@ void PlatformDetector::detectCPUInfo(PlatformInfo& info)
 #elif defined(__linux__)
     detectLinuxInfo(info);
 #endif
+
+    const CpuFeatures& features = CpuFeatures::host();
+    info.cpu_vendor = features.vendor;
+    info.cpu_family = features.family;
+    info.cpu_model_number = features.model;
+    info.cpu_stepping = features.stepping;
+    info.cpu_microarchitecture = features.microarchitecture;
+    info.cpu_extensions = features.extensions();
+    info.invariant_tsc = features.invariant_tsc;
 }
 
 void PlatformDetector::detectLinuxInfo(PlatformInfo& info)
@@ -246,27 +310,27 @@ void PlatformDetector::detectLinuxInfo(PlatformInfo& info)
                     double freq_mhz = std::stod(line.substr(colon + 2));
                     info.cpu_base_frequency_ghz = freq_mhz / 1000.0;
                 }
-            } else if (line.find("cache size") != std::string::npos) {
-                size_t colon = line.find(':');
-                if (colon != std::string::npos) {
-                    std::string cache_str = line.substr(colon + 2);
-                    if (cache_str.find("KB") != std::string::npos) {
-                        info.l3_cache_size_kb = std::stoi(cache_str);
-                    }
-                }
             }
         }
         
         info.cpu_threads = core_count;
     }
     
-    // Get physical core count
-    std::ifstream core_siblings("/sys/devices/system/cpu/cpu0/topology/core_siblings_list");
-    if (core_siblings.is_open()) {
-        std::string siblings;
-        std::getline(core_siblings, siblings);
-        // Count commas + 1 to get core count
-        info.cpu_cores = std::count(siblings.begin(), siblings.end(), ',') + 1;
+    // Cores, packages and caches from sysfs topology
+    const CpuTopology& topology = CpuTopology::host();
+    if (topology.valid) {
+        info.cpu_threads = static_cast<int>(topology.cpus.size());
+        info.cpu_cores = topology.cores;
+        info.cpu_packages = topology.packages;
+        info.cpu_dies = topology.dies;
+        const CacheLevel* l1 = topology.dataCache(1);
+        const CacheLevel* l2 = topology.dataCache(2);
+        const CacheLevel* l3 = topology.dataCache(3);
+        info.l1_cache_size_kb = l1 ? static_cast<int>(l1->size_bytes / 1024) : 0;
+        info.l2_cache_size_kb = l2 ? static_cast<int>(l2->size_bytes / 1024) : 0;
+        info.l3_cache_size_kb = l3 ? static_cast<int>(l3->size_bytes / 1024) : 0;
+        info.cache_line_size = l1 ? l1->line_size : 0;
+        info.cache_hierarchy = topology.describeCaches();
     }
     
     info.hyperthreading_enabled = (info.cpu_threads > info.cpu_cores);
@@ -289,9 +353,9 @@ void PlatformDetector::detectLinuxInfo(PlatformInfo& info)
     }
     
     // Architecture
-    std::string arch_output = executeCommand("uname -m");
-    if (!arch_output.empty()) {
-        info.cpu_architecture = arch_output.substr(0, arch_output.find('\n'));
+    struct utsname system_name;
+    if (uname(&system_name) == 0) {
+        info.cpu_architecture = system_name.machine;
     }
 }
 
@@ -380,10 +444,19 @@ void PlatformDetector::detectMemoryInfo(PlatformInfo& info)
     }
     
     // NUMA information
-    std::string numa_output = executeCommand("ls /sys/devices/system/node/ | grep node | wc -l");
-    if (!numa_output.empty()) {
-        info.numa_nodes = std::stoi(numa_output);
-        info.numa_enabled = (info.numa_nodes > 1);
+    DIR* node_dir = opendir("/sys/devices/system/node");
+    if (node_dir != nullptr) {
+        int nodes = 0;
+        while (struct dirent* entry = readdir(node_dir)) {
+            if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+                ++nodes;
+            }
+        }
+        closedir(node_dir);
+        if (nodes > 0) {
+            info.numa_nodes = nodes;
+            info.numa_enabled = (info.numa_nodes > 1);
+        }
     }
 #endif
 }
@@ -392,25 +465,46 @@ void PlatformDetector::detectStorageInfo(PlatformInfo& info)
 {
     // Try to detect primary storage type
 #ifdef __linux__
-    std::string lsblk_output = executeCommand("lsblk -d -o NAME,ROTA 2>/dev/null | head -2 | tail -1");
-    if (!lsblk_output.empty()) {
-        if (lsblk_output.find("0") != std::string::npos) {
-            // Non-rotating storage (SSD/NVMe)
-            std::string nvme_check = executeCommand("lsblk -d -o NAME | grep nvme");
-            if (!nvme_check.empty()) {
+    // First real block device decides the type; NVMe is recognised by name
+    DIR* block_dir = opendir("/sys/block");
+    if (block_dir != nullptr) {
+        std::vector<std::string> devices;
+        while (struct dirent* entry = readdir(block_dir)) {
+            std::string name = entry->d_name;
+            if (name[0] == '.' || name.compare(0, 4, "loop") == 0 || name.compare(0, 3, "ram") == 0 ||
+                name.compare(0, 4, "zram") == 0) {
+                continue;
+            }
+            devices.push_back(name);
+        }
+        closedir(block_dir);
+        std::sort(devices.begin(), devices.end());
+
+        for (const auto& device : devices) {
+            std::string rotational = readFileContent("/sys/block/" + device + "/queue/rotational");
+            if (rotational.empty()) {
+                continue;
+            }
+            if (rotational[0] == '1') {
+                info.primary_storage_type = "HDD";
+            } else if (device.compare(0, 4, "nvme") == 0) {
                 info.primary_storage_type = "NVMe";
             } else {
                 info.primary_storage_type = "SATA SSD";
             }
-        } else {
-            info.primary_storage_type = "HDD";
+            break;
         }
     }
     
-    // File system type
-    std::string fs_output = executeCommand("df -T / | tail -1 | awk '{print $2}'");
-    if (!fs_output.empty()) {
-        info.filesystem_type = fs_output.substr(0, fs_output.find('\n'));
+    // File system type of the root mount (the last entry for "/" is the visible one)
+    FILE* mounts = setmntent("/proc/self/mounts", "r");
+    if (mounts != nullptr) {
+        while (struct mntent* entry = getmntent(mounts)) {
+            if (strcmp(entry->mnt_dir, "/") == 0) {
+                info.filesystem_type = entry->mnt_type;
+            }
+        }
+        endmntent(mounts);
     }
     
 #elif defined(__APPLE__)
@@ -423,9 +517,9 @@ void PlatformDetector::detectStorageInfo(PlatformInfo& info)
     }
     
     // File system
-    std::string fs_output = executeCommand("df -T / | tail -1 | awk '{print $2}'");
-    if (!fs_output.empty()) {
-        info.filesystem_type = fs_output.substr(0, fs_output.find('\n'));
+    struct statfs root_fs;
+    if (statfs("/", &root_fs) == 0) {
+        info.filesystem_type = root_fs.f_fstypename;
     }
 #endif
     
@@ -438,20 +532,17 @@ void PlatformDetector::detectStorageInfo(PlatformInfo& info)
 
 void PlatformDetector::detectOSInfo(PlatformInfo& info)
 {
-    std::string uname_output = executeCommand("uname -s");
-    if (!uname_output.empty()) {
-        info.os_name = uname_output.substr(0, uname_output.find('\n'));
-    }
-    
-    std::string version_output = executeCommand("uname -r");
-    if (!version_output.empty()) {
-        info.kernel_version = version_output.substr(0, version_output.find('\n'));
+    struct utsname system_name;
+    if (uname(&system_name) == 0) {
+        info.os_name = system_name.sysname;
+        info.kernel_version = system_name.release;
     }
     
 #ifdef __APPLE__
-    std::string sw_vers_output = executeCommand("sw_vers -productVersion");
-    if (!sw_vers_output.empty()) {
-        info.os_version = sw_vers_output.substr(0, sw_vers_output.find('\n'));
+    char product_version[64];
+    size_t size = sizeof(product_version);
+    if (sysctlbyname("kern.osproductversion", product_version, &size, NULL, 0) == 0) {
+        info.os_version = product_version;
     }
     
 #elif defined(__linux__)
@@ -474,32 +565,84 @@ void PlatformDetector::detectOSInfo(PlatformInfo& info)
 
 void PlatformDetector::detectVirtualization(PlatformInfo& info)
 {
-    // Check common virtualization indicators
-    std::string dmi_output = executeCommand("sudo dmidecode -s system-manufacturer 2>/dev/null");
+    // Check common virtualization indicators; sysfs exposes the DMI strings without root
+    std::string dmi_output = readFileContent("/sys/class/dmi/id/sys_vendor") +
+        readFileContent("/sys/class/dmi/id/product_name");
     if (dmi_output.find("VMware") != std::string::npos) {
         info.is_virtualized = true;
         info.virtualization_type = "VMware";
-    } else if (dmi_output.find("QEMU") != std::string::npos) {
+    } else if (dmi_output.find("QEMU") != std::string::npos || dmi_output.find("KVM") != std::string::npos) {
         info.is_virtualized = true;
         info.virtualization_type = "QEMU/KVM";
     } else if (dmi_output.find("VirtualBox") != std::string::npos) {
         info.is_virtualized = true;
         info.virtualization_type = "VirtualBox";
+    } else if (dmi_output.find("Microsoft") != std::string::npos) {
+        info.is_virtualized = true;
+        info.virtualization_type = "Hyper-V";
+    } else if (dmi_output.find("Amazon EC2") != std::string::npos) {
+        info.is_virtualized = true;
+        info.virtualization_type = "AWS Nitro";
+    } else if (dmi_output.find("Google") != std::string::npos) {
+        info.is_virtualized = true;
+        info.virtualization_type = "Google Compute Engine";
     }
-    
-    // Check for Docker/container
-    std::ifstream cgroup("/proc/1/cgroup");
-    if (cgroup.is_open()) {
-        std::string line;
-        while (std::getline(cgroup, line)) {
-            if (line.find("docker") != std::string::npos || 
-                line.find("containerd") != std::string::npos) {
-                info.is_virtualized = true;
-                info.virtualization_type = "Container";
+
+#ifdef __linux__
+    // Hypervisors without telling DMI strings still set the CPUID hypervisor bit
+    if (!info.is_virtualized) {
+        std::string xen = readFileContent("/sys/hypervisor/type");
+        std::string cpuinfo = readFileContent("/proc/cpuinfo");
+        if (!xen.empty()) {
+            info.is_virtualized = true;
+            info.virtualization_type = "Xen";
+        } else if (cpuinfo.find(" hypervisor") != std::string::npos) {
+            info.is_virtualized = true;
+            info.virtualization_type = "Hypervisor";
+        }
+    }
+
+    // Containers: runtime marker files first, then cgroup paths of init and of this process
+    struct stat marker;
+    if (getenv("KUBERNETES_SERVICE_HOST") != nullptr) {
+        info.container_runtime = "kubernetes";
+    } else if (stat("/.dockerenv", &marker) == 0) {
+        info.container_runtime = "docker";
+    } else if (stat("/run/.containerenv", &marker) == 0) {
+        info.container_runtime = "podman";
+    } else {
+        std::string container = readFileContent("/run/systemd/container");
+        if (!container.empty()) {
+            info.container_runtime = container.substr(0, container.find('\n'));
+        }
+    }
+    if (info.container_runtime.empty()) {
+        std::string cgroups = readFileContent("/proc/1/cgroup") + readFileContent("/proc/self/cgroup");
+        const std::pair<const char*, const char*> markers[] = {
+            { "kubepods", "kubernetes" }, { "docker", "docker" }, { "containerd", "containerd" },
+            { "libpod", "podman" }, { "lxc", "lxc" }
+        };
+        for (const auto& entry : markers) {
+            if (cgroups.find(entry.first) != std::string::npos) {
+                info.container_runtime = entry.second;
                 break;
             }
         }
     }
+    if (!info.container_runtime.empty()) {
+        info.virtualization_type = info.is_virtualized
+            ? info.virtualization_type + " + Container (" + info.container_runtime + ")"
+            : "Container (" + info.container_runtime + ")";
+        info.is_virtualized = true;
+    }
+
+    CgroupLimits limits = Cgroup::readLimits();
+    info.cgroup_v2 = limits.available;
+    info.cgroup_cpu_limit_cores = limits.cpu_quota_cores;
+    info.cgroup_cpuset_cpus = static_cast<int>(limits.effective_cpus.size());
+    info.cgroup_memory_limit_gb = limits.memory_max_bytes / (1024.0 * 1024.0 * 1024.0);
+    info.effective_cpus = Cgroup::effectiveCpuCount();
+#endif
 }
 
 void PlatformDetector::detectPerformanceSettings(PlatformInfo& info)
@@ -542,6 +685,15 @@ void PlatformDetector::analyzePerformanceIssues(PlatformInfo& info)
     if (info.is_virtualized) {
         info.performance_issues.push_back("Running in virtualized environment");
     }
+
+    if (info.cgroup_cpu_limit_cores > 0.0 && info.cgroup_cpu_limit_cores < info.cpu_threads) {
+        info.performance_issues.push_back("cgroup CPU quota limits the suite to " +
+            std::to_string(info.cgroup_cpu_limit_cores).substr(0, 4) + " of " + std::to_string(info.cpu_threads) + " CPUs");
+    }
+
+    if (info.cgroup_memory_limit_gb > 0.0 && info.cgroup_memory_limit_gb < info.total_memory_gb) {
+        info.performance_issues.push_back("cgroup memory limit is below physical memory; working sets are shrunk to fit");
+    }
     
     if (info.total_memory_gb < 8.0) {
         info.performance_issues.push_back("Low system memory (< 8GB)");
@@ -615,6 +767,12 @@ OptimizationRecommendations PlatformDetector::getOptimizationRecommendations()
 
 bool PlatformDetector::areComparablePlatforms(const PlatformInfo& info1, const PlatformInfo& info2)
 {
+    // Different usable ISA extensions mean the kernels take different code paths
+    if (!info1.cpu_extensions.empty() && !info2.cpu_extensions.empty() &&
+        info1.cpu_extensions != info2.cpu_extensions) {
+        return false;
+    }
+
     // Platforms are comparable if they have similar performance characteristics
     double score_diff = std::abs(info1.getPerformanceScore() - info2.getPerformanceScore());
     
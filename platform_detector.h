@@ -11,16 +11,29 @@ struct PlatformInfo {
     std::string cpu_model;
     int cpu_cores;
     int cpu_threads;
+    int cpu_packages;
+    int cpu_dies;
     double cpu_base_frequency_ghz;
     double cpu_max_frequency_ghz;
     std::string cpu_architecture;
     bool hyperthreading_enabled;
     std::string cpu_governor; // Linux power governor
-    
-    // Cache hierarchy
+
+    // Identity and usable ISA extensions from CPUID
+    std::string cpu_vendor;
+    int cpu_family;
+    int cpu_model_number;
+    int cpu_stepping;
+    std::string cpu_microarchitecture;
+    std::vector<std::string> cpu_extensions;
+    bool invariant_tsc;
+    
+    // Cache hierarchy, per instance; L1 is the data cache
     int l1_cache_size_kb;
     int l2_cache_size_kb;
     int l3_cache_size_kb;
+    int cache_line_size;
+    std::string cache_hierarchy;
     
     // Memory information
     double total_memory_gb;
@@ -43,6 +56,14 @@ struct PlatformInfo {
     // Virtualization
     bool is_virtualized;
     std::string virtualization_type;
+    std::string container_runtime; // docker, podman, kubernetes, lxc, systemd-nspawn
+
+    // cgroup v2 limits in effect for this process (0 = unlimited)
+    bool cgroup_v2;
+    double cgroup_cpu_limit_cores;
+    int cgroup_cpuset_cpus;
+    double cgroup_memory_limit_gb;
+    int effective_cpus; // usable CPUs after affinity, cpuset and quota
     
     // Performance settings
     bool turbo_boost_enabled;
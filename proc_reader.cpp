@@ -0,0 +1,103 @@
+#include "proc_reader.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+ProcFile::ProcFile(const std::string& path, size_t capacity)
+{
+    open(path, capacity);
+}
+
+ProcFile::~ProcFile()
+{
+    close();
+}
+
+ProcFile::ProcFile(ProcFile&& other) noexcept
+    : fd(other.fd)
+    , buffer(std::move(other.buffer))
+    , length(other.length)
+{
+    other.fd = -1;
+    other.length = 0;
+}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        buffer = std::move(other.buffer);
+        length = other.length;
+        other.fd = -1;
+        other.length = 0;
+    }
+    return *this;
+}
+
+bool ProcFile::open(const std::string& path, size_t capacity)
+{
+    close();
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    buffer.resize(capacity > 0 ? capacity : 4096);
+    return true;
+}
+
+void ProcFile::close()
+{
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    length = 0;
+}
+
+bool readUintFile(ProcFile& file, uint64_t& value)
+{
+    if (!file.read()) {
+        return false;
+    }
+    ProcScanner scan(file);
+    return scan.nextUint(value);
+}
+
+bool readUintFile(const char* path, uint64_t& value)
+{
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[64];
+    ssize_t n = ::read(fd, buffer, sizeof(buffer));
+    ::close(fd);
+    if (n <= 0) {
+        return false;
+    }
+    ProcScanner scan(buffer, static_cast<size_t>(n));
+    return scan.nextUint(value);
+}
+
+bool ProcFile::read()
+{
+    length = 0;
+    if (fd < 0) {
+        return false;
+    }
+    while (true) {
+        ssize_t n = pread(fd, buffer.data() + length, buffer.size() - length, static_cast<off_t>(length));
+        if (n < 0) {
+            length = 0;
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        length += static_cast<size_t>(n);
+        if (length == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,183 @@
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// A /proc or /sys file kept open for repeated sampling. Each read() re-reads
+// the whole file with pread from offset 0 into a buffer that is allocated
+// once, so steady-state sampling performs no opens and no allocations.
+class ProcFile {
+private:
+    int fd { -1 };
+    std::vector<char> buffer;
+    size_t length { 0 };
+
+public:
+    ProcFile() = default;
+    explicit ProcFile(const std::string& path, size_t capacity = 4096);
+    ~ProcFile();
+
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+
+    bool open(const std::string& path, size_t capacity = 4096);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // Refreshes the contents; the buffer only grows if the file outgrows it
+    bool read();
+    const char* data() const { return buffer.data(); }
+    size_t size() const { return length; }
+};
+
+// Allocation-free cursor over text from a ProcFile. Number and token readers
+// skip spaces and tabs but never cross a newline.
+class ProcScanner {
+private:
+    const char* cursor;
+    const char* end;
+
+public:
+    ProcScanner(const char* data, size_t size)
+        : cursor(data)
+        , end(data + size)
+    {
+    }
+
+    explicit ProcScanner(const ProcFile& file)
+        : ProcScanner(file.data(), file.size())
+    {
+    }
+
+    bool atEnd() const { return cursor >= end; }
+    char peek() const { return cursor < end ? *cursor : '\0'; }
+    const char* position() const { return cursor; }
+    bool atLineEnd() const { return cursor >= end || *cursor == '\n'; }
+
+    void skipSpaces()
+    {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t')) {
+            ++cursor;
+        }
+    }
+
+    void skipLine()
+    {
+        while (cursor < end && *cursor != '\n') {
+            ++cursor;
+        }
+        if (cursor < end) {
+            ++cursor;
+        }
+    }
+
+    // Advances past the prefix if the line continues with it
+    bool consume(const char* prefix)
+    {
+        size_t n = strlen(prefix);
+        if (static_cast<size_t>(end - cursor) < n || memcmp(cursor, prefix, n) != 0) {
+            return false;
+        }
+        cursor += n;
+        return true;
+    }
+
+    // Advances to just past the next occurrence of c on this line
+    bool skipPast(char c)
+    {
+        while (cursor < end && *cursor != '\n') {
+            if (*cursor++ == c) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool nextUint(uint64_t& value)
+    {
+        skipSpaces();
+        if (cursor >= end || *cursor < '0' || *cursor > '9') {
+            return false;
+        }
+        value = 0;
+        while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+            value = value * 10 + static_cast<uint64_t>(*cursor - '0');
+            ++cursor;
+        }
+        return true;
+    }
+
+    bool nextInt(int64_t& value)
+    {
+        skipSpaces();
+        bool negative = cursor < end && *cursor == '-';
+        if (negative) {
+            ++cursor;
+        }
+        uint64_t magnitude = 0;
+        if (!nextUint(magnitude)) {
+            return false;
+        }
+        value = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+        return true;
+    }
+
+    // Plain decimal notation only (what /proc and /sys emit)
+    bool nextDouble(double& value)
+    {
+        skipSpaces();
+        bool negative = cursor < end && *cursor == '-';
+        if (negative) {
+            ++cursor;
+        }
+        uint64_t whole = 0;
+        bool has_whole = nextUint(whole);
+        double result = static_cast<double>(whole);
+        bool has_fraction = false;
+        if (cursor < end && *cursor == '.') {
+            ++cursor;
+            double scale = 0.1;
+            while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+                result += (*cursor - '0') * scale;
+                scale *= 0.1;
+                ++cursor;
+                has_fraction = true;
+            }
+        }
+        if (!has_whole && !has_fraction) {
+            return false;
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    // Next run of non-blank characters; the token points into the file buffer
+    bool nextToken(const char*& token, size_t& token_length)
+    {
+        skipSpaces();
+        token = cursor;
+        while (cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\n') {
+            ++cursor;
+        }
+        token_length = static_cast<size_t>(cursor - token);
+        return token_length > 0;
+    }
+};
+
+// One-shot read of a sysfs attribute holding a single unsigned number
+bool readUintFile(const char* path, uint64_t& value);
+// The same for an attribute kept open across samples
+bool readUintFile(ProcFile& file, uint64_t& value);
+
+inline bool tokenEquals(const char* token, size_t length, const char* text)
+{
+    return strlen(text) == length && memcmp(token, text, length) == 0;
+}
+
+#endif
@@ -0,0 +1,620 @@
+#include "rpc_bench.h"
+#include "cgroup.h"
+#include "pipeline.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t FRAME_SIZE = 32;
+constexpr size_t MEMORY_TABLE_BYTES = 64 * 1024 * 1024;
+constexpr size_t DISK_FILE_BYTES = 64 * 1024 * 1024;
+constexpr size_t DISK_READ_SIZE = 4096;
+constexpr int MAX_EPOLL_EVENTS = 64;
+constexpr int DRAIN_TIMEOUT_MS = 1000;
+constexpr int CALIBRATION_SECONDS = 1;
+constexpr uint64_t CALIBRATION_WINDOW_PER_CONNECTION = 8;
+const double DEFAULT_LOAD_FRACTIONS[] = { 0.1, 0.25, 0.4, 0.55, 0.7, 0.8, 0.9, 1.0, 1.15 };
+
+// Request and response share one fixed 32-byte frame
+struct Frame {
+    uint64_t id;
+    uint64_t intended_ns;
+    uint32_t step;
+    uint32_t reserved;
+    uint64_t checksum;
+};
+
+void encodeFrame(char* out, const Frame& frame)
+{
+    memcpy(out, &frame.id, 8);
+    memcpy(out + 8, &frame.intended_ns, 8);
+    memcpy(out + 16, &frame.step, 4);
+    memcpy(out + 20, &frame.reserved, 4);
+    memcpy(out + 24, &frame.checksum, 8);
+}
+
+void decodeFrame(const char* in, Frame& frame)
+{
+    memcpy(&frame.id, in, 8);
+    memcpy(&frame.intended_ns, in + 8, 8);
+    memcpy(&frame.step, in + 16, 4);
+    memcpy(&frame.reserved, in + 20, 4);
+    memcpy(&frame.checksum, in + 24, 8);
+}
+
+bool sendFully(int fd, const char* data, size_t length)
+{
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = send(fd, data + done, length - done, MSG_NOSIGNAL);
+        if (n > 0) {
+            done += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd pfd { fd, POLLOUT, 0 };
+            poll(&pfd, 1, 10);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+class RpcServer {
+private:
+    struct Connection {
+        int fd { -1 };
+        std::mutex write_mutex;
+        std::vector<char> pending;
+    };
+
+    struct Job {
+        Connection* connection;
+        Frame frame;
+    };
+
+    const RpcBenchmarkConfig& config;
+    int listen_fd { -1 };
+    int epoll_fd { -1 };
+    int wake_fd { -1 };
+    int disk_fd { -1 };
+    std::string disk_path;
+    std::vector<uint64_t> memory_table;
+    std::vector<std::unique_ptr<Connection>> connections;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<Job> jobs;
+    bool stopping { false };
+    uint64_t abandoned_jobs { 0 }; // still queued at stop; late work from the final step
+
+    std::thread front_end;
+    std::vector<std::thread> workers;
+    std::atomic<double> sink { 0.0 };
+
+    void frontEndLoop()
+    {
+        epoll_event events[MAX_EPOLL_EVENTS];
+        std::vector<Job> batch;
+
+        while (true) {
+            int ready = epoll_wait(epoll_fd, events, MAX_EPOLL_EVENTS, -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            bool wake = false;
+            batch.clear();
+            for (int i = 0; i < ready; ++i) {
+                if (events[i].data.ptr == nullptr) {
+                    wake = true;
+                    continue;
+                }
+                if (events[i].data.ptr == &listen_fd) {
+                    acceptConnections();
+                    continue;
+                }
+                readRequests(static_cast<Connection*>(events[i].data.ptr), batch);
+            }
+
+            if (!batch.empty()) {
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    jobs.insert(jobs.end(), batch.begin(), batch.end());
+                }
+                if (batch.size() == 1) {
+                    queue_cv.notify_one();
+                } else {
+                    queue_cv.notify_all();
+                }
+            }
+            if (wake) {
+                break;
+            }
+        }
+    }
+
+    void acceptConnections()
+    {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                return;
+            }
+            int opt = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+            connections.emplace_back(new Connection());
+            Connection* connection = connections.back().get();
+            connection->fd = fd;
+            epoll_event event {};
+            event.events = EPOLLIN;
+            event.data.ptr = connection;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        }
+    }
+
+    void readRequests(Connection* connection, std::vector<Job>& batch)
+    {
+        char buffer[FRAME_SIZE * 256];
+        while (true) {
+            ssize_t n = recv(connection->fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                connection->pending.insert(connection->pending.end(), buffer, buffer + n);
+                continue;
+            }
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr);
+                shutdown(connection->fd, SHUT_RDWR);
+            }
+            break;
+        }
+
+        size_t offset = 0;
+        while (connection->pending.size() - offset >= FRAME_SIZE) {
+            Job job;
+            job.connection = connection;
+            decodeFrame(connection->pending.data() + offset, job.frame);
+            batch.push_back(job);
+            offset += FRAME_SIZE;
+        }
+        connection->pending.erase(connection->pending.begin(), connection->pending.begin() + offset);
+    }
+
+    void workerLoop(int worker_id)
+    {
+        KernelWorkspace workspace;
+        uint64_t rng = 0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(worker_id + 1);
+        std::vector<char> disk_buffer(DISK_READ_SIZE);
+        char response[FRAME_SIZE];
+        double local_sink = 0.0;
+
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping) {
+                    break;
+                }
+                job = jobs.front();
+                jobs.pop_front();
+            }
+
+            double value = runWorkloadKernel(config.kernel, workspace, config.work_units);
+            for (size_t i = 0; i < config.memory_touches; ++i) {
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                value += static_cast<double>(memory_table[rng % memory_table.size()] & 0xFF);
+            }
+            for (size_t i = 0; i < config.disk_reads && disk_fd >= 0; ++i) {
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                off_t offset = static_cast<off_t>((rng % (DISK_FILE_BYTES / DISK_READ_SIZE)) * DISK_READ_SIZE);
+                if (pread(disk_fd, disk_buffer.data(), DISK_READ_SIZE, offset) > 0) {
+                    value += disk_buffer[0];
+                }
+            }
+            local_sink += value;
+
+            Frame reply = job.frame;
+            reply.checksum = static_cast<uint64_t>(value);
+            encodeFrame(response, reply);
+            std::lock_guard<std::mutex> lock(job.connection->write_mutex);
+            sendFully(job.connection->fd, response, FRAME_SIZE);
+        }
+
+        sink.store(local_sink, std::memory_order_relaxed);
+    }
+
+public:
+    explicit RpcServer(const RpcBenchmarkConfig& config)
+        : config(config)
+    {
+    }
+
+    ~RpcServer() { stop(); }
+
+    uint64_t abandonedJobs() const { return abandoned_jobs; }
+
+    void start(int worker_count)
+    {
+        if (config.memory_touches > 0) {
+            memory_table.resize(MEMORY_TABLE_BYTES / sizeof(uint64_t));
+            for (size_t i = 0; i < memory_table.size(); ++i) {
+                memory_table[i] = i * 0x9E3779B97F4A7C15ULL;
+            }
+        }
+        if (config.disk_reads > 0) {
+            disk_path = "/tmp/rpc_bench_" + std::to_string(getpid()) + ".dat";
+            int fd = open(disk_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to create RPC disk file");
+            }
+            std::vector<char> chunk(1024 * 1024, 'd');
+            for (size_t written = 0; written < DISK_FILE_BYTES; written += chunk.size()) {
+                if (write(fd, chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size())) {
+                    close(fd);
+                    throw std::runtime_error("Failed to fill RPC disk file");
+                }
+            }
+            disk_fd = fd;
+        }
+
+        listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listen_fd < 0) {
+            throw std::runtime_error("Failed to create RPC listen socket");
+        }
+        int opt = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(config.port));
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd, 128) < 0) {
+            throw std::runtime_error("Failed to bind RPC server to port " + std::to_string(config.port));
+        }
+
+        epoll_fd = epoll_create1(0);
+        wake_fd = eventfd(0, EFD_NONBLOCK);
+        if (epoll_fd < 0 || wake_fd < 0) {
+            throw std::runtime_error("Failed to create RPC epoll instance");
+        }
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.ptr = &listen_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+        event.data.ptr = nullptr;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+        front_end = std::thread(&RpcServer::frontEndLoop, this);
+        for (int i = 0; i < worker_count; ++i) {
+            workers.emplace_back(&RpcServer::workerLoop, this, i);
+        }
+    }
+
+    void stop()
+    {
+        if (front_end.joinable()) {
+            uint64_t one = 1;
+            if (write(wake_fd, &one, sizeof(one)) < 0) {
+                // The front end also exits once epoll_wait fails on close
+            }
+            front_end.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            abandoned_jobs += jobs.size();
+            jobs.clear();
+        }
+
+        for (auto& connection : connections) {
+            close(connection->fd);
+        }
+        connections.clear();
+        for (int* fd : { &listen_fd, &epoll_fd, &wake_fd, &disk_fd }) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+        if (!disk_path.empty()) {
+            unlink(disk_path.c_str());
+            disk_path.clear();
+        }
+    }
+};
+
+// Open-loop client: a sender issues requests on a Poisson schedule regardless
+// of completions; latency is measured from each request's scheduled time.
+class RpcClient {
+private:
+    std::vector<int> fds;
+    std::vector<std::vector<char>> inbound;
+    uint64_t next_id { 0 };
+
+public:
+    ~RpcClient()
+    {
+        for (int fd : fds) {
+            close(fd);
+        }
+    }
+
+    void connectAll(int port, int count)
+    {
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+
+        for (int i = 0; i < count; ++i) {
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+                throw std::runtime_error("RPC client failed to connect");
+            }
+            int opt = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+            fds.push_back(fd);
+        }
+        inbound.resize(fds.size());
+    }
+
+    // rate <= 0 runs closed-loop with a bounded in-flight window to measure capacity
+    LoadStepResult runStep(double rate, int duration_seconds, uint32_t step)
+    {
+        std::atomic<bool> sender_done(false);
+        std::atomic<uint64_t> sent(0);
+        std::atomic<uint64_t> completed(0);
+        SampleReservoir latency_us;
+        uint64_t send_start_ns = pipelineNowNanoseconds();
+        uint64_t send_end_ns = send_start_ns;
+
+        std::thread sender([&]() {
+            uint64_t deadline = send_start_ns + static_cast<uint64_t>(duration_seconds) * 1000000000ULL;
+            ArrivalSchedule schedule(rate, send_start_ns, step + 1);
+            char frame_bytes[FRAME_SIZE];
+            size_t connection = 0;
+
+            while (true) {
+                uint64_t intended = pipelineNowNanoseconds();
+                if (rate > 0.0) {
+                    if (!schedule.waitNext(deadline, intended)) {
+                        break;
+                    }
+                } else {
+                    if (intended >= deadline) {
+                        break;
+                    }
+                    uint64_t window = CALIBRATION_WINDOW_PER_CONNECTION * fds.size();
+                    if (sent.load(std::memory_order_relaxed) - completed.load(std::memory_order_acquire) >= window) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+
+                Frame frame { next_id++, intended, step, 0, 0 };
+                encodeFrame(frame_bytes, frame);
+                if (!sendFully(fds[connection], frame_bytes, FRAME_SIZE)) {
+                    break;
+                }
+                connection = (connection + 1) % fds.size();
+                sent.fetch_add(1, std::memory_order_release);
+            }
+            send_end_ns = pipelineNowNanoseconds();
+            sender_done.store(true, std::memory_order_release);
+        });
+
+        // Receive on the calling thread
+        std::vector<pollfd> pfds(fds.size());
+        for (size_t i = 0; i < fds.size(); ++i) {
+            pfds[i] = pollfd { fds[i], POLLIN, 0 };
+        }
+        char buffer[FRAME_SIZE * 256];
+        uint64_t drain_deadline = 0;
+
+        while (true) {
+            if (sender_done.load(std::memory_order_acquire)) {
+                if (completed.load() >= sent.load(std::memory_order_acquire)) {
+                    break;
+                }
+                uint64_t now = pipelineNowNanoseconds();
+                if (drain_deadline == 0) {
+                    drain_deadline = now + static_cast<uint64_t>(DRAIN_TIMEOUT_MS) * 1000000ULL;
+                } else if (now > drain_deadline) {
+                    break;
+                }
+            }
+
+            if (poll(pfds.data(), pfds.size(), 10) <= 0) {
+                continue;
+            }
+            for (size_t i = 0; i < pfds.size(); ++i) {
+                if (!(pfds[i].revents & POLLIN)) {
+                    continue;
+                }
+                ssize_t n = recv(fds[i], buffer, sizeof(buffer), MSG_DONTWAIT);
+                if (n <= 0) {
+                    continue;
+                }
+                uint64_t now = pipelineNowNanoseconds();
+                std::vector<char>& pending = inbound[i];
+                pending.insert(pending.end(), buffer, buffer + n);
+                size_t offset = 0;
+                while (pending.size() - offset >= FRAME_SIZE) {
+                    Frame frame;
+                    decodeFrame(pending.data() + offset, frame);
+                    offset += FRAME_SIZE;
+                    // Late replies from an earlier step are discarded
+                    if (frame.step == step) {
+                        latency_us.add(now > frame.intended_ns ? (now - frame.intended_ns) / 1000.0 : 0.0);
+                        completed.fetch_add(1, std::memory_order_release);
+                    }
+                }
+                pending.erase(pending.begin(), pending.begin() + offset);
+            }
+        }
+
+        sender.join();
+
+        double send_seconds = (send_end_ns - send_start_ns) / NANOSECONDS_PER_SECOND;
+        return summarizeLoadStep(rate, sent.load(), completed.load(), latency_us, send_seconds);
+    }
+};
+
+}
+
+RpcBenchmark::RpcBenchmark()
+    : RpcBenchmark(RpcBenchmarkConfig())
+{
+}
+
+RpcBenchmark::RpcBenchmark(const RpcBenchmarkConfig& config)
+    : config(config)
+{
+}
+
+BenchmarkResult RpcBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    try {
+        int worker_count = config.workers > 0 ? config.workers : Cgroup::effectiveCpuCount();
+        RpcServer server(config);
+        server.start(worker_count);
+
+        RpcClient client;
+        client.connectAll(config.port, std::max(1, config.connections));
+
+        std::vector<double> rates = config.rates;
+        double capacity = 0.0;
+        uint32_t step_id = 0;
+        if (rates.empty()) {
+            // Calibrate with an unthrottled run, then step through fractions of that capacity
+            if (verbose) {
+                std::cout << "  Calibrating RPC capacity...\n";
+            }
+            LoadStepResult calibration = client.runStep(0.0, CALIBRATION_SECONDS, step_id++);
+            capacity = calibration.achieved_rate;
+            if (capacity <= 0.0) {
+                throw std::runtime_error("RPC calibration completed no requests");
+            }
+            for (double fraction : DEFAULT_LOAD_FRACTIONS) {
+                rates.push_back(capacity * fraction);
+            }
+        }
+        std::sort(rates.begin(), rates.end());
+
+        int remaining = std::max(1, duration_seconds - (capacity > 0.0 ? CALIBRATION_SECONDS : 0));
+        int step_seconds = std::max(1, remaining / static_cast<int>(rates.size()));
+
+        std::vector<LoadStepResult> steps;
+        for (double rate : rates) {
+            LoadStepResult step = client.runStep(rate, step_seconds, step_id++);
+            if (verbose) {
+                std::cout << "  offered " << static_cast<long long>(step.offered_rate) << " req/s -> achieved "
+                          << static_cast<long long>(step.achieved_rate) << " req/s, p50 " << step.p50_us
+                          << " us, p99 " << step.p99_us << " us\n";
+            }
+            steps.push_back(step);
+        }
+
+        server.stop();
+
+        LoadCurveSummary summary = analyzeLoadCurve(steps, config.slo_p99_us);
+        addLoadCurveMetrics(result, "rpc_", steps, summary);
+
+        // Headline: the best step that met the SLO; when none did, the step with
+        // the highest achieved rate, flagged by rpc_slo_met = 0
+        bool slo_met = summary.slo_index >= 0;
+        size_t best_index = 0;
+        uint64_t total_completed = 0;
+        for (size_t i = 0; i < steps.size(); ++i) {
+            total_completed += steps[i].completed;
+            if (steps[i].achieved_rate > steps[best_index].achieved_rate) {
+                best_index = i;
+            }
+        }
+        const LoadStepResult& headline = steps[slo_met ? summary.slo_index : best_index];
+        if (!slo_met && verbose) {
+            std::cout << "  Warning: no RPC step met p99 <= " << config.slo_p99_us
+                      << " us; reporting the best achieved rate\n";
+        }
+
+        result.throughput = slo_met ? summary.max_rate_at_slo : headline.achieved_rate;
+        result.throughput_unit = "req/s";
+        result.avg_latency = headline.avg_us;
+        result.min_latency = headline.min_us;
+        result.max_latency = headline.max_us;
+        result.p50_latency = headline.p50_us;
+        result.p90_latency = headline.p90_us;
+        result.p99_latency = headline.p99_us;
+        result.latency_unit = "us";
+
+        result.extra_metrics["work_ops"] = static_cast<double>(total_completed);
+        result.extra_metrics["rpc_slo_met"] = slo_met ? 1.0 : 0.0;
+        result.extra_metrics["rpc_abandoned_jobs"] = static_cast<double>(server.abandonedJobs());
+        result.extra_metrics["rpc_workers"] = worker_count;
+        result.extra_metrics["rpc_connections"] = config.connections;
+        result.extra_metrics["rpc_work_units"] = static_cast<double>(config.work_units);
+        result.extra_metrics["rpc_memory_touches"] = static_cast<double>(config.memory_touches);
+        result.extra_metrics["rpc_disk_reads"] = static_cast<double>(config.disk_reads);
+        if (capacity > 0.0) {
+            result.extra_metrics["rpc_calibrated_capacity"] = capacity;
+        }
+        result.extra_info["rpc.kernel"] = workloadKernelName(config.kernel);
+        result.extra_info["rpc.arrivals"] = "poisson_open_loop";
+        result.extra_info["rpc.slo_met"] = slo_met ? "true" : "false";
+        result.extra_info["rpc.headline"] = slo_met ? "max_rate_at_slo" : "best_achieved_rate";
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    return result;
+}
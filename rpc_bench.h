@@ -0,0 +1,39 @@
+#ifndef RPC_BENCH_H
+#define RPC_BENCH_H
+
+#include "benchmark.h"
+#include "load_curve.h"
+#include "utils.h"
+#include "workload_kernels.h"
+#include <string>
+#include <vector>
+
+struct RpcBenchmarkConfig {
+    int port { 9400 };
+    int workers { 0 }; // 0 = one per available core
+    int connections { 4 };
+    WorkloadKernel kernel { WorkloadKernel::FLOATING_POINT };
+    size_t work_units { 2000 };
+    size_t memory_touches { 0 }; // random cache-line reads from a 64MB table per request
+    size_t disk_reads { 0 }; // random 4KB preads from a 64MB file per request
+    std::vector<double> rates; // req/s per step; empty = fractions of a calibrated capacity
+    double slo_p99_us { 1000.0 };
+};
+
+// Request/response service: an epoll front end hands framed requests to a
+// worker pool that runs a CPU kernel (plus optional memory/disk access) and
+// replies on the same connection. An open-loop Poisson client steps the
+// offered rate to trace the latency-vs-load curve.
+class RpcBenchmark : public Benchmark {
+private:
+    RpcBenchmarkConfig config;
+
+public:
+    RpcBenchmark();
+    explicit RpcBenchmark(const RpcBenchmarkConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "RPC Service"; }
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include "slo_search.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr double CAPACITY_HEADROOM = 1.25;
+constexpr int MIN_SEARCH_PROBES = 4;
+constexpr int MAX_SEARCH_PROBES = 16;
+constexpr size_t MAX_CONFIRM_STEP_BACKS = 2;
+
+// Two-sided 95% Student t quantiles for 1..10 degrees of freedom
+const double T_QUANTILES_95[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228 };
+
+double tQuantile95(size_t degrees_of_freedom)
+{
+    if (degrees_of_freedom == 0) {
+        return 0.0;
+    }
+    if (degrees_of_freedom <= sizeof(T_QUANTILES_95) / sizeof(T_QUANTILES_95[0])) {
+        return T_QUANTILES_95[degrees_of_freedom - 1];
+    }
+    return 1.96;
+}
+
+void printProbe(const char* label, const LoadStepResult& step, bool pass)
+{
+    std::cout << "  " << label << " offered " << static_cast<long long>(step.offered_rate) << " -> achieved "
+              << static_cast<long long>(step.achieved_rate) << ", p99 " << step.p99_us << " us"
+              << (pass ? " [pass]" : " [fail]") << "\n";
+}
+
+}
+
+SloSearchBenchmark::SloSearchBenchmark(std::unique_ptr<RateControlledWorkload> workload, const SloSearchConfig& config)
+    : workload(std::move(workload))
+    , config(config)
+{
+}
+
+bool SloSearchBenchmark::meetsSlo(const LoadStepResult& step) const
+{
+    return step.completed > 0 && step.p99_us <= config.slo_p99_us &&
+        step.achieved_rate >= step.offered_rate * config.min_achieved_ratio;
+}
+
+BenchmarkResult SloSearchBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    try {
+        if (config.slo_p99_us <= 0.0) {
+            throw std::runtime_error("SLO search requires a positive p99 target");
+        }
+
+        int probe_seconds = std::max(1, config.probe_seconds);
+        int confirm_runs = std::max(1, config.confirm_runs);
+        int budget = duration_seconds / probe_seconds - confirm_runs - 1;
+        int max_probes = std::max(MIN_SEARCH_PROBES, std::min(MAX_SEARCH_PROBES, budget));
+
+        std::vector<LoadStepResult> probes;
+        std::vector<LoadStepResult> confirmations;
+        std::vector<double> passing_rates;
+        double confirmed_rate = 0.0;
+        size_t step_backs = 0;
+        double low_rate = 0.0;
+        double high_rate = 0.0;
+        double capacity = 0.0;
+
+        try {
+            workload->setUp();
+            LoadStepResult calibration = workload->runAtRate(0.0, probe_seconds);
+            capacity = calibration.achieved_rate;
+            if (capacity <= 0.0) {
+                throw std::runtime_error("Capacity probe completed no operations");
+            }
+            if (verbose) {
+                std::cout << "  Closed-loop capacity " << static_cast<long long>(capacity) << " "
+                          << workload->getRateUnit() << ", SLO p99 <= " << config.slo_p99_us << " us\n";
+            }
+
+            // Start just above closed-loop capacity and double while that still passes,
+            // since pipelined open-loop load can outrun a closed-loop client
+            high_rate = capacity * CAPACITY_HEADROOM;
+            bool bracketed = false;
+            while (static_cast<int>(probes.size()) < max_probes) {
+                if (bracketed && low_rate > 0.0 && (high_rate - low_rate) <= high_rate * config.resolution) {
+                    break;
+                }
+                double rate = bracketed ? (low_rate + high_rate) / 2.0 : high_rate;
+                LoadStepResult probe = workload->runAtRate(rate, probe_seconds);
+                bool pass = meetsSlo(probe);
+                if (verbose) {
+                    printProbe("probe", probe, pass);
+                }
+                probes.push_back(probe);
+                if (pass) {
+                    passing_rates.push_back(rate);
+                }
+                if (!bracketed) {
+                    if (pass) {
+                        low_rate = rate;
+                        high_rate = rate * 2.0;
+                    } else {
+                        bracketed = true;
+                    }
+                    continue;
+                }
+                if (pass) {
+                    low_rate = rate;
+                } else {
+                    high_rate = rate;
+                }
+            }
+
+            // A rate is confirmed when most re-runs meet the SLO; otherwise step
+            // back to the next lower rate that passed a probe
+            std::sort(passing_rates.rbegin(), passing_rates.rend());
+            for (size_t candidate = 0; candidate < passing_rates.size() && candidate <= MAX_CONFIRM_STEP_BACKS; ++candidate) {
+                confirmations.clear();
+                step_backs = candidate;
+                int passed = 0;
+                for (int i = 0; i < confirm_runs; ++i) {
+                    LoadStepResult confirmation = workload->runAtRate(passing_rates[candidate], probe_seconds);
+                    bool pass = meetsSlo(confirmation);
+                    if (verbose) {
+                        printProbe("confirm", confirmation, pass);
+                    }
+                    confirmations.push_back(confirmation);
+                    passed += pass ? 1 : 0;
+                }
+                if (passed * 2 > confirm_runs) {
+                    confirmed_rate = passing_rates[candidate];
+                    break;
+                }
+            }
+        } catch (...) {
+            workload->tearDown();
+            throw;
+        }
+        workload->tearDown();
+
+        // 95% t-interval on the achieved rate across confirmation runs
+        double mean_rate = 0.0;
+        double ci_half_width = 0.0;
+        int confirmed = 0;
+        double worst_p99 = 0.0;
+        double avg_us = 0.0;
+        double p50_us = 0.0;
+        double p90_us = 0.0;
+        double min_us = 0.0;
+        double max_us = 0.0;
+        for (const auto& step : confirmations) {
+            mean_rate += step.achieved_rate;
+            confirmed += meetsSlo(step) ? 1 : 0;
+            worst_p99 = std::max(worst_p99, step.p99_us);
+            avg_us += step.avg_us;
+            p50_us += step.p50_us;
+            p90_us += step.p90_us;
+            min_us = min_us == 0.0 ? step.min_us : std::min(min_us, step.min_us);
+            max_us = std::max(max_us, step.max_us);
+        }
+        if (!confirmations.empty()) {
+            double n = static_cast<double>(confirmations.size());
+            mean_rate /= n;
+            avg_us /= n;
+            p50_us /= n;
+            p90_us /= n;
+            double variance = 0.0;
+            for (const auto& step : confirmations) {
+                variance += (step.achieved_rate - mean_rate) * (step.achieved_rate - mean_rate);
+            }
+            if (confirmations.size() > 1) {
+                variance /= n - 1.0;
+                ci_half_width = tQuantile95(confirmations.size() - 1) * std::sqrt(variance / n);
+            }
+        }
+
+        uint64_t total_completed = 0;
+        for (const auto& step : probes) {
+            total_completed += step.completed;
+        }
+        for (const auto& step : confirmations) {
+            total_completed += step.completed;
+        }
+
+        result.throughput = mean_rate;
+        result.throughput_unit = workload->getRateUnit();
+        result.avg_latency = avg_us;
+        result.min_latency = min_us;
+        result.max_latency = max_us;
+        result.p50_latency = p50_us;
+        result.p90_latency = p90_us;
+        result.p99_latency = worst_p99;
+        result.latency_unit = "us";
+
+        result.extra_metrics["work_ops"] = static_cast<double>(total_completed);
+        result.extra_metrics["slo_p99_us"] = config.slo_p99_us;
+        result.extra_metrics["slo_capacity_rate"] = capacity;
+        result.extra_metrics["slo_max_rate"] = mean_rate;
+        result.extra_metrics["slo_max_rate_ci_low"] = std::max(0.0, mean_rate - ci_half_width);
+        result.extra_metrics["slo_max_rate_ci_high"] = mean_rate + ci_half_width;
+        result.extra_metrics["slo_bracket_pass_rate"] = low_rate;
+        result.extra_metrics["slo_bracket_fail_rate"] = high_rate;
+        result.extra_metrics["slo_confirmed_rate"] = confirmed_rate;
+        result.extra_metrics["slo_confirm_step_backs"] = static_cast<double>(step_backs);
+        result.extra_metrics["slo_search_probes"] = static_cast<double>(probes.size());
+        result.extra_metrics["slo_confirm_runs"] = static_cast<double>(confirmations.size());
+        result.extra_metrics["slo_confirm_pass_ratio"] = confirmations.empty() ? 0.0 : static_cast<double>(confirmed) / confirmations.size();
+        for (size_t i = 0; i < probes.size(); ++i) {
+            std::string prefix = "slo_probe" + std::to_string(i) + "_";
+            result.extra_metrics[prefix + "offered_rate"] = probes[i].offered_rate;
+            result.extra_metrics[prefix + "achieved_rate"] = probes[i].achieved_rate;
+            result.extra_metrics[prefix + "p99_us"] = probes[i].p99_us;
+        }
+        result.extra_info["slo.search"] = "binary";
+        result.extra_info["slo.attained"] = confirmed_rate > 0.0 ? "true" : "false";
+        result.extra_info["slo.confidence"] = "95% t-interval over " + std::to_string(confirmations.size()) + " confirmation runs";
+
+        if (confirmed_rate > 0.0) {
+            result.status = "success";
+        } else {
+            result.status = "error";
+            result.error_message = passing_rates.empty()
+                ? "No probed rate met p99 <= " + std::to_string(static_cast<long long>(config.slo_p99_us)) + " us"
+                : "No passing rate held p99 <= " + std::to_string(static_cast<long long>(config.slo_p99_us)) + " us in most confirmation runs";
+        }
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    return result;
+}
+
+bool parseLatencyMicroseconds(const std::string& text, double& microseconds)
+{
+    size_t consumed = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &consumed);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    std::string suffix = text.substr(consumed);
+    if (suffix.empty() || suffix == "ms") {
+        microseconds = value * 1000.0;
+    } else if (suffix == "us") {
+        microseconds = value;
+    } else if (suffix == "s") {
+        microseconds = value * MICROSECONDS_PER_SECOND;
+    } else {
+        return false;
+    }
+    return microseconds > 0.0;
+}
@@ -0,0 +1,38 @@
+#ifndef SLO_SEARCH_H
+#define SLO_SEARCH_H
+
+#include "benchmark.h"
+#include "load_curve.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SloSearchConfig {
+    double slo_p99_us { 0.0 };
+    int probe_seconds { 1 };
+    int confirm_runs { 3 };
+    double resolution { 0.05 }; // stop once the pass/fail bracket is within 5% of its upper end
+    double min_achieved_ratio { 0.95 }; // a probe that cannot keep up with its offered rate fails
+};
+
+// Harness mode for rate-controllable modules: binary-searches the offered rate
+// for the highest one whose p99 stays within the SLO, then re-runs that rate
+// to put confidence bounds on the compliant throughput.
+class SloSearchBenchmark : public Benchmark {
+private:
+    std::unique_ptr<RateControlledWorkload> workload;
+    SloSearchConfig config;
+
+    bool meetsSlo(const LoadStepResult& step) const;
+
+public:
+    SloSearchBenchmark(std::unique_ptr<RateControlledWorkload> workload, const SloSearchConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return workload->getName() + " @ p99 SLO"; }
+};
+
+// Accepts a number with an optional us/ms/s suffix; a bare number is milliseconds
+bool parseLatencyMicroseconds(const std::string& text, double& microseconds);
+
+#endif
@@ -0,0 +1,364 @@
+#include "snapshot_bench.h"
+#include "cgroup.h"
+#include "load_curve.h"
+#include "pipeline.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t RECORD_SIZE = 128;
+constexpr size_t WRITE_CHUNK_BYTES = 1024 * 1024;
+constexpr uint64_t CHILD_POLL_MASK = 63; // check the child every 64 updates
+
+struct Record {
+    uint64_t key;
+    uint64_t version;
+    uint64_t payload[(RECORD_SIZE - 2 * sizeof(uint64_t)) / sizeof(uint64_t)];
+};
+static_assert(sizeof(Record) == RECORD_SIZE, "Record must be 128 bytes");
+
+// Private_Dirty of the whole address space: pages this process no longer
+// shares. In a snapshot child this grows as the parent copy-on-writes pages.
+uint64_t readPrivateDirtyKb()
+{
+    std::ifstream rollup("/proc/self/smaps_rollup");
+    std::ifstream smaps;
+    std::istream* in = &rollup;
+    if (!rollup.is_open()) {
+        smaps.open("/proc/self/smaps");
+        if (!smaps.is_open()) {
+            return 0;
+        }
+        in = &smaps;
+    }
+
+    uint64_t total_kb = 0;
+    std::string line;
+    while (std::getline(*in, line)) {
+        if (line.compare(0, 14, "Private_Dirty:") == 0) {
+            std::istringstream fields(line.substr(14));
+            uint64_t kb = 0;
+            fields >> kb;
+            total_kb += kb;
+        }
+    }
+    return total_kb;
+}
+
+std::string readTransparentHugePageMode()
+{
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string line;
+    if (!std::getline(file, line)) {
+        return "unknown";
+    }
+    size_t open = line.find('[');
+    size_t close = line.find(']');
+    if (open == std::string::npos || close == std::string::npos || close < open) {
+        return "unknown";
+    }
+    return line.substr(open + 1, close - open - 1);
+}
+
+long readMinorFaults()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+struct SnapshotWindow {
+    double fork_ms { 0.0 };
+    double window_seconds { 0.0 };
+    double write_seconds { 0.0 };
+    double sync_seconds { 0.0 };
+    uint64_t bytes_written { 0 };
+    double cow_mb { 0.0 };
+    long minor_faults { 0 };
+};
+
+}
+
+SnapshotBenchmark::SnapshotBenchmark()
+    : SnapshotBenchmark(SnapshotBenchmarkConfig())
+{
+}
+
+SnapshotBenchmark::SnapshotBenchmark(const SnapshotBenchmarkConfig& config)
+    : config(config)
+{
+}
+
+void SnapshotBenchmark::runChild(const char* base, size_t bytes, const std::string& path, int report_fd)
+{
+    ChildReport report;
+    memset(&report, 0, sizeof(report));
+    report.private_dirty_start_kb = readPrivateDirtyKb();
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        report.error = 1;
+    } else {
+        uint64_t start = pipelineNowNanoseconds();
+        size_t offset = 0;
+        while (offset < bytes) {
+            ssize_t n = write(fd, base + offset, std::min(WRITE_CHUNK_BYTES, bytes - offset));
+            if (n <= 0) {
+                report.error = 1;
+                break;
+            }
+            offset += static_cast<size_t>(n);
+        }
+        uint64_t written = pipelineNowNanoseconds();
+        fdatasync(fd);
+        uint64_t synced = pipelineNowNanoseconds();
+        close(fd);
+
+        report.bytes_written = offset;
+        report.write_seconds = (written - start) / NANOSECONDS_PER_SECOND;
+        report.sync_seconds = (synced - written) / NANOSECONDS_PER_SECOND;
+    }
+
+    report.private_dirty_end_kb = readPrivateDirtyKb();
+    ssize_t n = write(report_fd, &report, sizeof(report));
+    (void)n;
+}
+
+BenchmarkResult SnapshotBenchmark::run(int duration_seconds, int iterations, bool verbose)
+{
+    (void)iterations;
+    BenchmarkResult result;
+    result.name = getName();
+
+    std::string path = config.directory + "/snapshot_" + std::to_string(getpid()) + ".rdb";
+    void* mapping = MAP_FAILED;
+    size_t dataset_bytes = 0;
+    int report_pipe[2] = { -1, -1 };
+    pid_t child = -1;
+
+    try {
+        // The dataset can double through copy-on-write while a snapshot child lives
+        size_t fitted_bytes = Cgroup::fitWorkingSet(config.dataset_mb * 1024 * 1024 * 2) / 2;
+        size_t record_count = std::max<size_t>(1024, fitted_bytes / RECORD_SIZE);
+        dataset_bytes = record_count * RECORD_SIZE;
+        mapping = mmap(nullptr, dataset_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Failed to allocate snapshot dataset");
+        }
+        Record* records = static_cast<Record*>(mapping);
+
+        // Populate every page so snapshots copy real data, not the zero page
+        uint64_t rng = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < record_count; ++i) {
+            records[i].key = i;
+            records[i].version = 0;
+            for (auto& word : records[i].payload) {
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                word = rng;
+            }
+        }
+
+        if (pipe(report_pipe) != 0) {
+            throw std::runtime_error("Failed to create snapshot report pipe");
+        }
+
+        int snapshots = std::max(1, config.snapshots);
+        uint64_t duration_ns = static_cast<uint64_t>(std::max(1, duration_seconds)) * 1000000000ULL;
+        uint64_t start_ns = pipelineNowNanoseconds();
+        uint64_t end_ns = start_ns + duration_ns;
+        uint64_t snapshot_interval_ns = duration_ns / (snapshots + 1);
+        uint64_t next_snapshot_ns = start_ns + snapshot_interval_ns;
+
+        if (verbose) {
+            std::cout << "  Dataset " << dataset_bytes / (1024 * 1024) << " MB, " << config.update_rate
+                      << " updates/s, " << snapshots << " snapshots\n";
+        }
+
+        SampleReservoir baseline_us;
+        SampleReservoir snapshot_us;
+        double baseline_max_us = 0.0;
+        double snapshot_max_us = 0.0;
+        uint64_t baseline_updates = 0;
+        uint64_t snapshot_updates = 0;
+        double snapshot_seconds = 0.0;
+        std::vector<SnapshotWindow> windows;
+        SnapshotWindow current;
+        uint64_t window_start_ns = 0;
+        long window_start_faults = 0;
+
+        ArrivalSchedule schedule(config.update_rate, start_ns, 0x5EED5A4Bu);
+        uint64_t updates = 0;
+        while (true) {
+            uint64_t intended_ns = 0;
+            schedule.waitNext(std::numeric_limits<uint64_t>::max(), intended_ns);
+
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            Record& record = records[rng % record_count];
+            ++record.version;
+            record.payload[record.version % (sizeof(record.payload) / sizeof(record.payload[0]))] = rng;
+
+            uint64_t done_ns = pipelineNowNanoseconds();
+            double latency_us = (done_ns - intended_ns) / 1000.0;
+            if (child > 0) {
+                snapshot_us.add(latency_us);
+                snapshot_max_us = std::max(snapshot_max_us, latency_us);
+                ++snapshot_updates;
+            } else {
+                baseline_us.add(latency_us);
+                baseline_max_us = std::max(baseline_max_us, latency_us);
+                ++baseline_updates;
+            }
+
+            if ((++updates & CHILD_POLL_MASK) != 0) {
+                continue;
+            }
+
+            if (child > 0) {
+                int status = 0;
+                pid_t reaped = waitpid(child, &status, WNOHANG);
+                if (reaped == 0) {
+                    continue;
+                }
+                child = -1;
+                ChildReport report;
+                if (reaped < 0 || !WIFEXITED(status) || read(report_pipe[0], &report, sizeof(report)) != sizeof(report) || report.error) {
+                    throw std::runtime_error("Snapshot child failed to write " + path);
+                }
+                uint64_t window_end_ns = pipelineNowNanoseconds();
+                current.window_seconds = (window_end_ns - window_start_ns) / NANOSECONDS_PER_SECOND;
+                current.write_seconds = report.write_seconds;
+                current.sync_seconds = report.sync_seconds;
+                current.bytes_written = report.bytes_written;
+                current.cow_mb = (report.private_dirty_end_kb > report.private_dirty_start_kb
+                                         ? report.private_dirty_end_kb - report.private_dirty_start_kb
+                                         : 0)
+                    / 1024.0;
+                current.minor_faults = readMinorFaults() - window_start_faults;
+                snapshot_seconds += current.window_seconds;
+                windows.push_back(current);
+                if (verbose) {
+                    std::cout << "  Snapshot " << windows.size() << ": fork " << current.fork_ms << " ms, "
+                              << current.bytes_written / (1024.0 * 1024.0) / (current.write_seconds + current.sync_seconds)
+                              << " MB/s, CoW " << current.cow_mb << " MB\n";
+                }
+                continue;
+            }
+
+            if (done_ns >= end_ns) {
+                break;
+            }
+            if (static_cast<int>(windows.size()) < snapshots && done_ns >= next_snapshot_ns) {
+                current = SnapshotWindow();
+                window_start_faults = readMinorFaults();
+                window_start_ns = pipelineNowNanoseconds();
+                child = fork();
+                if (child < 0) {
+                    throw std::runtime_error("Failed to fork snapshot child");
+                }
+                if (child == 0) {
+                    runChild(static_cast<const char*>(mapping), dataset_bytes, path, report_pipe[1]);
+                    _exit(0);
+                }
+                current.fork_ms = (pipelineNowNanoseconds() - window_start_ns) / 1e6;
+                next_snapshot_ns += snapshot_interval_ns;
+            }
+        }
+
+        double baseline_seconds = (pipelineNowNanoseconds() - start_ns) / NANOSECONDS_PER_SECOND - snapshot_seconds;
+        LoadStepResult baseline = summarizeLoadStep(config.update_rate, baseline_updates, baseline_updates, baseline_us, baseline_seconds);
+        LoadStepResult during = summarizeLoadStep(config.update_rate, snapshot_updates, snapshot_updates, snapshot_us, snapshot_seconds);
+
+        double fork_ms_total = 0.0;
+        double fork_ms_max = 0.0;
+        double cow_mb_total = 0.0;
+        double cow_mb_max = 0.0;
+        double persist_seconds = 0.0;
+        double sync_seconds = 0.0;
+        uint64_t bytes_written = 0;
+        long cow_faults = 0;
+        for (const auto& window : windows) {
+            fork_ms_total += window.fork_ms;
+            fork_ms_max = std::max(fork_ms_max, window.fork_ms);
+            cow_mb_total += window.cow_mb;
+            cow_mb_max = std::max(cow_mb_max, window.cow_mb);
+            persist_seconds += window.write_seconds + window.sync_seconds;
+            sync_seconds += window.sync_seconds;
+            bytes_written += window.bytes_written;
+            cow_faults += window.minor_faults;
+        }
+        double count = windows.empty() ? 1.0 : static_cast<double>(windows.size());
+        double dataset_mb = dataset_bytes / (1024.0 * 1024.0);
+        double total_seconds = baseline_seconds + snapshot_seconds;
+
+        result.throughput = total_seconds > 0.0 ? updates / total_seconds : 0.0;
+        result.throughput_unit = "updates/sec";
+        result.avg_latency = during.avg_us;
+        result.min_latency = during.min_us;
+        result.max_latency = snapshot_max_us;
+        result.p50_latency = during.p50_us;
+        result.p90_latency = during.p90_us;
+        result.p99_latency = during.p99_us;
+        result.latency_unit = "us";
+
+        result.extra_metrics["work_ops"] = static_cast<double>(updates);
+        result.extra_metrics["work_bytes"] = static_cast<double>(bytes_written);
+        result.extra_metrics["snapshot_dataset_mb"] = dataset_mb;
+        result.extra_metrics["snapshot_count"] = static_cast<double>(windows.size());
+        result.extra_metrics["snapshot_mbps"] = persist_seconds > 0.0 ? bytes_written / (1024.0 * 1024.0) / persist_seconds : 0.0;
+        result.extra_metrics["snapshot_seconds_avg"] = snapshot_seconds / count;
+        result.extra_metrics["snapshot_sync_seconds_avg"] = sync_seconds / count;
+        result.extra_metrics["snapshot_fork_ms_avg"] = fork_ms_total / count;
+        result.extra_metrics["snapshot_fork_ms_max"] = fork_ms_max;
+        result.extra_metrics["snapshot_cow_mb_avg"] = cow_mb_total / count;
+        result.extra_metrics["snapshot_cow_mb_max"] = cow_mb_max;
+        result.extra_metrics["snapshot_cow_ratio_max"] = dataset_mb > 0.0 ? cow_mb_max / dataset_mb : 0.0;
+        result.extra_metrics["snapshot_cow_faults"] = static_cast<double>(cow_faults);
+        result.extra_metrics["snapshot_baseline_update_rate"] = baseline.achieved_rate;
+        result.extra_metrics["snapshot_baseline_p50_us"] = baseline.p50_us;
+        result.extra_metrics["snapshot_baseline_p99_us"] = baseline.p99_us;
+        result.extra_metrics["snapshot_baseline_p999_us"] = baseline.p999_us;
+        result.extra_metrics["snapshot_baseline_max_us"] = baseline_max_us;
+        result.extra_metrics["snapshot_during_update_rate"] = during.achieved_rate;
+        result.extra_metrics["snapshot_during_p50_us"] = during.p50_us;
+        result.extra_metrics["snapshot_during_p99_us"] = during.p99_us;
+        result.extra_metrics["snapshot_during_p999_us"] = during.p999_us;
+        result.extra_metrics["snapshot_during_max_us"] = snapshot_max_us;
+        result.extra_metrics["snapshot_p99_spike"] = baseline.p99_us > 0.0 ? during.p99_us / baseline.p99_us : 0.0;
+        result.extra_metrics["snapshot_max_spike"] = baseline_max_us > 0.0 ? snapshot_max_us / baseline_max_us : 0.0;
+        result.extra_info["snapshot.transparent_hugepages"] = readTransparentHugePageMode();
+
+        result.status = "success";
+
+    } catch (const std::exception& e) {
+        result.status = "error";
+        result.error_message = e.what();
+    }
+
+    if (child > 0) {
+        waitpid(child, nullptr, 0);
+    }
+    for (int fd : report_pipe) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    if (mapping != MAP_FAILED) {
+        munmap(mapping, dataset_bytes);
+    }
+    unlink(path.c_str());
+    return result;
+}
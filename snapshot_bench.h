@@ -0,0 +1,45 @@
+#ifndef SNAPSHOT_BENCH_H
+#define SNAPSHOT_BENCH_H
+
+#include "benchmark.h"
+#include "utils.h"
+#include <string>
+#include <vector>
+
+struct SnapshotBenchmarkConfig {
+    size_t dataset_mb { 256 };
+    double update_rate { 100000.0 }; // foreground updates per second (open loop)
+    int snapshots { 3 };
+    std::string directory { "/tmp" };
+};
+
+// Fork-and-persist checkpointing (BGSAVE-style): a single foreground thread
+// applies open-loop updates to a large in-memory dataset while forked children
+// periodically serialize it to disk. Measures the update latency spike during
+// snapshots against the quiet baseline, the fork stall, copy-on-write memory
+// and snapshot write bandwidth.
+class SnapshotBenchmark : public Benchmark {
+private:
+    // Written by the child into a pipe before it exits
+    struct ChildReport {
+        double write_seconds;
+        double sync_seconds;
+        uint64_t bytes_written;
+        uint64_t private_dirty_start_kb;
+        uint64_t private_dirty_end_kb;
+        int error;
+    };
+
+    SnapshotBenchmarkConfig config;
+
+    static void runChild(const char* base, size_t bytes, const std::string& path, int report_fd);
+
+public:
+    SnapshotBenchmark();
+    explicit SnapshotBenchmark(const SnapshotBenchmarkConfig& config);
+
+    BenchmarkResult run(int duration_seconds, int iterations, bool verbose) override;
+    std::string getName() const override { return "Fork Snapshot"; }
+};
+
+#endif
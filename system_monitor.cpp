@@ -1,4 +1,5 @@
 #include "system_monitor.h"
+#include "cgroup.h"
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
@@ -7,6 +8,8 @@
 #include <sstream>
 #include <cctype>
 #include <utility>
+#include <cstring>
+#include <ctime>
 
 #ifdef __APPLE__
 #include <mach/mach.h>
@@ -14,11 +17,160 @@
 #include <sys/mount.h>
 #include <sys/sysctl.h>
 #elif defined(__linux__)
+#include <dirent.h>
+#include <sys/resource.h>
 #include <sys/sysinfo.h>
 #include <sys/statvfs.h>
 #include <unistd.h>
 #endif
 
+namespace {
+
+// CPU time consumed by the calling thread only
+double threadCpuSeconds()
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0.0;
+    }
+    return ts.tv_sec + ts.tv_nsec / NANOSECONDS_PER_SECOND;
+}
+
+// Element-wise helpers for per-core series; shorter series are zero-extended
+template <typename T>
+void addSeries(std::vector<T>& total, const std::vector<T>& values)
+{
+    if (total.size() < values.size()) {
+        total.resize(values.size(), T());
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        total[i] += values[i];
+    }
+}
+
+template <typename T>
+void maxSeries(std::vector<T>& peak, const std::vector<T>& values)
+{
+    if (peak.size() < values.size()) {
+        peak.resize(values.size(), T());
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        peak[i] = std::max(peak[i], values[i]);
+    }
+}
+
+TelemetryRecord toTelemetryRecord(const ResourceMetrics& sample)
+{
+    TelemetryRecord record {};
+    record.timestamp_seconds = sample.sample_timestamp_seconds;
+    record.cpu_usage_percent = static_cast<float>(sample.avg_cpu_usage_percent);
+    record.process_cpu_percent = static_cast<float>(sample.process_cpu_percent);
+    record.cpu_frequency_mhz = static_cast<float>(sample.cpu_frequency_mhz);
+    record.io_wait_percent = static_cast<float>(sample.avg_io_wait_percent);
+    record.memory_used_mb = static_cast<float>(sample.memory_used_mb);
+    record.memory_available_mb = static_cast<float>(sample.memory_available_mb);
+    record.memory_usage_percent = static_cast<float>(sample.memory_usage_percent);
+    record.disk_read_mbps = static_cast<float>(sample.disk_read_mbps);
+    record.disk_write_mbps = static_cast<float>(sample.disk_write_mbps);
+    record.network_rx_mbps = static_cast<float>(sample.network_rx_mbps);
+    record.network_tx_mbps = static_cast<float>(sample.network_tx_mbps);
+    record.load_average_1min = static_cast<float>(sample.load_average_1min);
+    record.load_average_5min = static_cast<float>(sample.load_average_5min);
+    record.collection_cpu_us = static_cast<float>(sample.collection_cpu_us);
+    record.cpu_psi_some_percent = static_cast<float>(sample.cpu_psi.some_stall_percent);
+    record.memory_psi_some_percent = static_cast<float>(sample.memory_psi.some_stall_percent);
+    record.memory_psi_full_percent = static_cast<float>(sample.memory_psi.full_stall_percent);
+    record.io_psi_some_percent = static_cast<float>(sample.io_psi.some_stall_percent);
+    record.io_psi_full_percent = static_cast<float>(sample.io_psi.full_stall_percent);
+    record.cgroup_cpu_psi_some_percent = static_cast<float>(sample.cgroup_cpu_psi.some_stall_percent);
+    record.cgroup_memory_psi_some_percent = static_cast<float>(sample.cgroup_memory_psi.some_stall_percent);
+    record.cgroup_memory_psi_full_percent = static_cast<float>(sample.cgroup_memory_psi.full_stall_percent);
+    record.cgroup_io_psi_some_percent = static_cast<float>(sample.cgroup_io_psi.some_stall_percent);
+    record.cgroup_io_psi_full_percent = static_cast<float>(sample.cgroup_io_psi.full_stall_percent);
+    record.active_processes = sample.active_processes;
+    record.thermal_throttle_events = static_cast<uint32_t>(std::min<uint64_t>(sample.thermal_throttle_events, UINT32_MAX));
+    record.page_faults = static_cast<uint32_t>(std::min<uint64_t>(sample.page_faults, UINT32_MAX));
+    record.major_page_faults = static_cast<uint32_t>(std::min<uint64_t>(sample.vmstat.pgmajfault, UINT32_MAX));
+    record.direct_scanned_pages = static_cast<uint32_t>(std::min<uint64_t>(sample.vmstat.pgscan_direct, UINT32_MAX));
+    record.compact_stalls = static_cast<uint32_t>(std::min<uint64_t>(sample.vmstat.compact_stall, UINT32_MAX));
+    record.flags = (sample.thermal_throttling_detected ? TelemetryRecord::THERMAL_THROTTLING : 0u) |
+        (sample.psi_available ? TelemetryRecord::PSI_AVAILABLE : 0u) |
+        (sample.cgroup_psi_available ? TelemetryRecord::CGROUP_PSI_AVAILABLE : 0u);
+    return record;
+}
+
+ResourceMetrics fromTelemetryRecord(const TelemetryRecord& record, const float* core_frequency_mhz,
+    const float* core_deep_idle_percent, size_t cores)
+{
+    ResourceMetrics sample;
+    sample.sample_timestamp_seconds = record.timestamp_seconds;
+    sample.avg_cpu_usage_percent = record.cpu_usage_percent;
+    sample.process_cpu_percent = record.process_cpu_percent;
+    sample.cpu_frequency_mhz = record.cpu_frequency_mhz;
+    sample.avg_io_wait_percent = record.io_wait_percent;
+    sample.memory_used_mb = record.memory_used_mb;
+    sample.memory_available_mb = record.memory_available_mb;
+    sample.memory_usage_percent = record.memory_usage_percent;
+    sample.disk_read_mbps = record.disk_read_mbps;
+    sample.disk_write_mbps = record.disk_write_mbps;
+    sample.network_rx_mbps = record.network_rx_mbps;
+    sample.network_tx_mbps = record.network_tx_mbps;
+    sample.load_average_1min = record.load_average_1min;
+    sample.load_average_5min = record.load_average_5min;
+    sample.collection_cpu_us = record.collection_cpu_us;
+    sample.cpu_psi.some_stall_percent = record.cpu_psi_some_percent;
+    sample.memory_psi.some_stall_percent = record.memory_psi_some_percent;
+    sample.memory_psi.full_stall_percent = record.memory_psi_full_percent;
+    sample.io_psi.some_stall_percent = record.io_psi_some_percent;
+    sample.io_psi.full_stall_percent = record.io_psi_full_percent;
+    sample.cgroup_cpu_psi.some_stall_percent = record.cgroup_cpu_psi_some_percent;
+    sample.cgroup_memory_psi.some_stall_percent = record.cgroup_memory_psi_some_percent;
+    sample.cgroup_memory_psi.full_stall_percent = record.cgroup_memory_psi_full_percent;
+    sample.cgroup_io_psi.some_stall_percent = record.cgroup_io_psi_some_percent;
+    sample.cgroup_io_psi.full_stall_percent = record.cgroup_io_psi_full_percent;
+    sample.active_processes = record.active_processes;
+    sample.thermal_throttle_events = record.thermal_throttle_events;
+    sample.page_faults = record.page_faults;
+    sample.vmstat.valid = true;
+    sample.vmstat.pgfault = record.page_faults;
+    sample.vmstat.pgmajfault = record.major_page_faults;
+    sample.vmstat.pgscan_direct = record.direct_scanned_pages;
+    sample.vmstat.compact_stall = record.compact_stalls;
+    sample.thermal_throttling_detected = (record.flags & TelemetryRecord::THERMAL_THROTTLING) != 0;
+    sample.psi_available = (record.flags & TelemetryRecord::PSI_AVAILABLE) != 0;
+    sample.cgroup_psi_available = (record.flags & TelemetryRecord::CGROUP_PSI_AVAILABLE) != 0;
+    sample.per_core_frequency_mhz.assign(core_frequency_mhz, core_frequency_mhz + cores);
+    sample.per_core_deep_idle_percent.assign(core_deep_idle_percent, core_deep_idle_percent + cores);
+    sample.sample_count = 1;
+    return sample;
+}
+
+}
+
+void PressureStall::add(const PressureStall& other)
+{
+    some_avg10 += other.some_avg10;
+    full_avg10 += other.full_avg10;
+    some_stall_percent += other.some_stall_percent;
+    full_stall_percent += other.full_stall_percent;
+}
+
+void PressureStall::scale(double factor)
+{
+    some_avg10 *= factor;
+    full_avg10 *= factor;
+    some_stall_percent *= factor;
+    full_stall_percent *= factor;
+}
+
+void PressureStall::takeMax(const PressureStall& other)
+{
+    some_avg10 = std::max(some_avg10, other.some_avg10);
+    full_avg10 = std::max(full_avg10, other.full_avg10);
+    some_stall_percent = std::max(some_stall_percent, other.some_stall_percent);
+    full_stall_percent = std::max(full_stall_percent, other.full_stall_percent);
+}
+
 // ResourceMetrics implementation
 ResourceMetrics::ResourceMetrics()
 {
@@ -28,7 +180,12 @@ ResourceMetrics::ResourceMetrics()
 void ResourceMetrics::reset()
 {
     avg_cpu_usage_percent = 0.0;
+    process_cpu_percent = 0.0;
     per_core_usage.clear();
+    per_core_frequency_mhz.clear();
+    per_core_deep_idle_percent.clear();
+    per_core_throttle_events.clear();
+    thermal_throttle_events = 0;
     cpu_frequency_mhz = 0.0;
     thermal_throttling_detected = false;
     context_switches = 0;
@@ -37,6 +194,7 @@ void ResourceMetrics::reset()
     memory_available_mb = 0.0;
     memory_usage_percent = 0.0;
     page_faults = 0;
+    vmstat = VmstatCounters();
     cache_hit_ratio = 0.0;
     
     disk_read_mbps = 0.0;
@@ -54,6 +212,16 @@ void ResourceMetrics::reset()
     monitoring_duration_seconds = 0.0;
     sample_count = 0;
     sample_timestamp_seconds = 0.0;
+    collection_cpu_us = 0.0;
+
+    psi_available = false;
+    cgroup_psi_available = false;
+    cpu_psi = PressureStall();
+    memory_psi = PressureStall();
+    io_psi = PressureStall();
+    cgroup_cpu_psi = PressureStall();
+    cgroup_memory_psi = PressureStall();
+    cgroup_io_psi = PressureStall();
 }
 
 std::string ResourceMetrics::toJson() const
@@ -61,6 +229,7 @@ std::string ResourceMetrics::toJson() const
     std::ostringstream json;
     json << "{\n";
     json << "  \"cpu_usage_percent\": " << avg_cpu_usage_percent << ",\n";
+    json << "  \"process_cpu_percent\": " << process_cpu_percent << ",\n";
     json << "  \"cpu_frequency_mhz\": " << cpu_frequency_mhz << ",\n";
     json << "  \"thermal_throttling\": " << (thermal_throttling_detected ? "true" : "false") << ",\n";
     json << "  \"memory_used_mb\": " << memory_used_mb << ",\n";
@@ -73,8 +242,23 @@ std::string ResourceMetrics::toJson() const
     json << "  \"load_average_1min\": " << load_average_1min << ",\n";
     json << "  \"load_average_5min\": " << load_average_5min << ",\n";
     json << "  \"active_processes\": " << active_processes << ",\n";
+    json << "  \"page_faults\": " << page_faults << ",\n";
+    json << "  \"major_page_faults\": " << vmstat.pgmajfault << ",\n";
+    json << "  \"direct_reclaim_stalls\": " << vmstat.allocstall << ",\n";
+    json << "  \"compact_stalls\": " << vmstat.compact_stall << ",\n";
     json << "  \"monitoring_duration_seconds\": " << monitoring_duration_seconds << ",\n";
-    json << "  \"sample_count\": " << sample_count << "\n";
+    json << "  \"sample_count\": " << sample_count << ",\n";
+    json << "  \"collection_cpu_us\": " << collection_cpu_us << ",\n";
+    json << "  \"psi_available\": " << (psi_available ? "true" : "false") << ",\n";
+    json << "  \"cpu_psi_some_percent\": " << cpu_psi.some_stall_percent << ",\n";
+    json << "  \"memory_psi_some_percent\": " << memory_psi.some_stall_percent << ",\n";
+    json << "  \"memory_psi_full_percent\": " << memory_psi.full_stall_percent << ",\n";
+    json << "  \"io_psi_some_percent\": " << io_psi.some_stall_percent << ",\n";
+    json << "  \"io_psi_full_percent\": " << io_psi.full_stall_percent << ",\n";
+    json << "  \"cgroup_psi_available\": " << (cgroup_psi_available ? "true" : "false") << ",\n";
+    json << "  \"cgroup_cpu_psi_some_percent\": " << cgroup_cpu_psi.some_stall_percent << ",\n";
+    json << "  \"cgroup_memory_psi_some_percent\": " << cgroup_memory_psi.some_stall_percent << ",\n";
+    json << "  \"cgroup_io_psi_some_percent\": " << cgroup_io_psi.some_stall_percent << "\n";
     json << "}";
     return json.str();
 }
@@ -86,13 +270,18 @@ InterferenceReport::InterferenceReport()
     , high_io_wait(false)
     , network_congestion(false)
     , thermal_throttling(false)
+    , cpu_contention(false)
+    , psi_available(false)
+    , cpu_stall_percent(0.0)
+    , memory_stall_percent(0.0)
+    , io_stall_percent(0.0)
 {
 }
 
 bool InterferenceReport::hasInterference() const
 {
     return high_background_cpu_usage || memory_pressure || high_io_wait || 
-           network_congestion || thermal_throttling;
+           network_congestion || thermal_throttling || cpu_contention;
 }
 
 std::string InterferenceReport::getSummary() const
@@ -110,6 +299,7 @@ std::string InterferenceReport::getSummary() const
     if (high_io_wait) issues.push_back("high I/O wait");
     if (network_congestion) issues.push_back("network congestion");
     if (thermal_throttling) issues.push_back("thermal throttling");
+    if (cpu_contention) issues.push_back("CPU contention");
     
     for (size_t i = 0; i < issues.size(); ++i) {
         if (i > 0 && i == issues.size() - 1) {
@@ -159,6 +349,49 @@ void SystemMonitor::stopMonitoring()
     if (monitor_thread.joinable()) {
         monitor_thread.join();
     }
+    telemetry_stream.flush();
+}
+
+void SystemMonitor::setTelemetryCapacity(size_t samples)
+{
+    telemetry_capacity = std::max<size_t>(1, samples);
+}
+
+bool SystemMonitor::openTelemetryStream(const std::string& path)
+{
+    if (monitoring_active.load()) {
+        return false;
+    }
+    return telemetry_stream.open(path, static_cast<size_t>(std::max(1, CPUAffinity::getNumCores())), sample_interval_ms);
+}
+
+bool SystemMonitor::closeTelemetryStream()
+{
+    if (monitoring_active.load()) {
+        stopMonitoring();
+    }
+    return telemetry_stream.close();
+}
+
+CStateResidency SystemMonitor::getCStateResidency() const
+{
+    CStateResidency residency;
+#ifdef __linux__
+    if (cstate_names.empty() || cstate_elapsed_seconds <= 0.0) {
+        return residency;
+    }
+    residency.names = cstate_names;
+    residency.exit_latency_us = cstate_latency_us;
+    double wall_us = cstate_elapsed_seconds * MICROSECONDS_PER_SECOND;
+    for (size_t state = 0; state < cstate_names.size(); ++state) {
+        std::vector<double> per_core(core_count, 0.0);
+        for (size_t core = 0; core < core_count; ++core) {
+            per_core[core] = std::min(100.0, cstate_residency_us[core * cstate_names.size() + state] / wall_us * 100.0);
+        }
+        residency.per_core_percent.push_back(per_core);
+    }
+#endif
+    return residency;
 }
 
 bool SystemMonitor::isMonitoring() const
@@ -166,9 +399,21 @@ bool SystemMonitor::isMonitoring() const
     return monitoring_active.load();
 }
 
+void SystemMonitor::setSampleInterval(int milliseconds)
+{
+    sample_interval_ms = std::max(MIN_SAMPLE_INTERVAL_MS, milliseconds);
+}
+
+double SystemMonitor::getSelfOverheadPercent() const
+{
+    return self_wall_seconds > 0.0 ? self_cpu_seconds / self_wall_seconds * 100.0 : 0.0;
+}
+
 void SystemMonitor::monitoringLoop()
 {
-    const auto sample_interval = std::chrono::milliseconds(250); // 4 samples per second
+    const auto sample_interval = std::chrono::milliseconds(sample_interval_ms);
+    const auto loop_start = std::chrono::steady_clock::now();
+    const double cpu_start = threadCpuSeconds();
 
 #ifdef __linux__
     // Establish baseline readings so subsequent samples use deltas
@@ -179,21 +424,33 @@ void SystemMonitor::monitoringLoop()
     }
 #endif
 
+    // Absolute deadlines keep short intervals from drifting by the collection cost
+    auto next_sample = loop_start + sample_interval;
     while (monitoring_active.load()) {
-        std::this_thread::sleep_for(sample_interval);
+        std::this_thread::sleep_until(next_sample);
         if (!monitoring_active.load()) {
             break;
         }
+        next_sample += sample_interval;
+        auto now = std::chrono::steady_clock::now();
+        if (next_sample < now) {
+            next_sample = now + sample_interval;
+        }
 
         try {
+            double collect_start = threadCpuSeconds();
             ResourceMetrics current = collectCurrentMetrics();
+            current.collection_cpu_us = (threadCpuSeconds() - collect_start) * MICROSECONDS_PER_SECOND;
             current.sample_timestamp_seconds = monitoring_timer.elapsedSeconds();
-            samples.push_back(current);
+            recordSample(current);
         } catch (const std::exception& e) {
             // Continue monitoring even if one sample fails
             std::cerr << "Monitoring sample failed: " << e.what() << std::endl;
         }
     }
+
+    self_cpu_seconds = threadCpuSeconds() - cpu_start;
+    self_wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loop_start).count();
 }
 
 ResourceMetrics SystemMonitor::collectCurrentMetrics()
@@ -212,6 +469,9 @@ ResourceMetrics SystemMonitor::collectCurrentMetrics()
 ResourceMetrics SystemMonitor::collectLinuxMetrics()
 {
     ResourceMetrics metrics;
+    if (!proc_files_opened) {
+        openProcFiles();
+    }
 
     auto now = std::chrono::steady_clock::now();
     double elapsed_seconds = 0.0;
@@ -230,8 +490,19 @@ ResourceMetrics SystemMonitor::collectLinuxMetrics()
             0.0) / metrics.per_core_usage.size();
     }
     metrics.avg_io_wait_percent = last_io_wait_percent;
+
+    // What this process tree used, so the rest of avg_cpu_usage_percent is foreign load
+    double process_cpu_seconds = processTreeCpuSeconds();
+    if (elapsed_seconds > 0.0 && !metrics.per_core_usage.empty()) {
+        double used = std::max(0.0, process_cpu_seconds - previous_process_cpu_seconds);
+        metrics.process_cpu_percent = std::min(100.0,
+            used / (elapsed_seconds * metrics.per_core_usage.size()) * 100.0);
+    }
+    previous_process_cpu_seconds = process_cpu_seconds;
+
     metrics.cpu_frequency_mhz = getCPUFrequency();
     metrics.thermal_throttling_detected = detectThermalThrottling();
+    sampleCoreCounters(elapsed_seconds, metrics);
 
     // Memory information
     getMemoryInfo(metrics.memory_used_mb, metrics.memory_available_mb);
@@ -240,6 +511,8 @@ ResourceMetrics SystemMonitor::collectLinuxMetrics()
             (metrics.memory_used_mb + metrics.memory_available_mb)) * 100.0;
     }
 
+    sampleVmstat(metrics);
+
     // Disk I/O
     getDiskIOStats(elapsed_seconds, metrics.disk_read_mbps, metrics.disk_write_mbps, metrics.disk_operations);
 
@@ -249,6 +522,14 @@ ResourceMetrics SystemMonitor::collectLinuxMetrics()
     // System load
     getSystemLoad(metrics.load_average_1min, metrics.load_average_5min, metrics.active_processes);
 
+    // Pressure stall information
+    PressureStall* system_stalls[] = { &metrics.cpu_psi, &metrics.memory_psi, &metrics.io_psi };
+    PressureStall* cgroup_stalls[] = { &metrics.cgroup_cpu_psi, &metrics.cgroup_memory_psi, &metrics.cgroup_io_psi };
+    for (size_t i = 0; i < PRESSURE_RESOURCES; ++i) {
+        metrics.psi_available |= readPressure(system_pressure[i], elapsed_seconds, *system_stalls[i]);
+        metrics.cgroup_psi_available |= readPressure(cgroup_pressure[i], elapsed_seconds, *cgroup_stalls[i]);
+    }
+
     return metrics;
 }
 #else
@@ -288,43 +569,372 @@ ResourceMetrics SystemMonitor::collectMacOSMetrics()
 }
 
 #ifdef __linux__
-std::vector<SystemMonitor::CpuTimes> SystemMonitor::readCpuTimes(CpuTimes& total_times)
+void SystemMonitor::openProcFiles()
+{
+    stat_file.open("/proc/stat", 16384);
+    meminfo_file.open("/proc/meminfo", 8192);
+    diskstats_file.open("/proc/diskstats", 16384);
+    netdev_file.open("/proc/net/dev", 8192);
+    loadavg_file.open("/proc/loadavg", 256);
+    thermal_file.open("/sys/class/thermal/thermal_zone0/temp", 64);
+    vmstat_file.open("/proc/vmstat", 16384);
+    self_stat_file.open("/proc/self/stat", 1024);
+
+    // cpufreq is one small value; /proc/cpuinfo is the fallback when it is absent
+    frequency_from_cpuinfo = !frequency_file.open("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", 64);
+    if (frequency_from_cpuinfo) {
+        frequency_file.open("/proc/cpuinfo", 65536);
+    }
+    openCoreSources();
+
+    // PSI needs CONFIG_PSI and may be disabled at boot (psi=0); the files are then absent or unreadable
+    const char* resources[PRESSURE_RESOURCES] = { "cpu", "memory", "io" };
+    std::string cgroup_directory = Cgroup::findV2Directory();
+    for (size_t i = 0; i < PRESSURE_RESOURCES; ++i) {
+        system_pressure[i].file.open(std::string("/proc/pressure/") + resources[i], 256);
+        if (!cgroup_directory.empty()) {
+            cgroup_pressure[i].file.open(cgroup_directory + "/" + resources[i] + ".pressure", 256);
+        }
+    }
+    proc_files_opened = true;
+}
+
+void SystemMonitor::openCoreSources()
 {
-    std::vector<CpuTimes> times;
+    core_count = static_cast<size_t>(std::max(1, CPUAffinity::getNumCores()));
+    const std::string cpu_root = "/sys/devices/system/cpu/cpu";
 
-    std::ifstream stat_file("/proc/stat");
-    if (!stat_file.is_open()) {
-        return times;
+    core_frequency_files.clear();
+    core_frequency_files.resize(core_count);
+    for (size_t core = 0; core < core_count; ++core) {
+        core_frequency_files[core].open(cpu_root + std::to_string(core) + "/cpufreq/scaling_cur_freq", 64);
     }
 
-    std::string line;
-    while (std::getline(stat_file, line)) {
-        if (line.compare(0, 3, "cpu") != 0) {
+    // All cores share cpu0's cpuidle driver and state table
+    cstate_names.clear();
+    cstate_latency_us.clear();
+    for (size_t state = 0;; ++state) {
+        std::string state_dir = cpu_root + "0/cpuidle/state" + std::to_string(state);
+        std::ifstream name_file(state_dir + "/name");
+        std::string name;
+        if (!std::getline(name_file, name) || name.empty()) {
             break;
         }
+        uint64_t latency = 0;
+        readUintFile((state_dir + "/latency").c_str(), latency);
+        cstate_names.push_back(name);
+        cstate_latency_us.push_back(latency);
+    }
+
+    // One descriptor per core and state plus two per core for throttling; large
+    // hosts need more than the usual soft limit of 1024
+    size_t needed = core_count * (cstate_names.size() + 3) + 256;
+    struct rlimit files {};
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur != RLIM_INFINITY && files.rlim_cur < needed) {
+        files.rlim_cur = files.rlim_max == RLIM_INFINITY ? needed : std::min<rlim_t>(files.rlim_max, needed);
+        setrlimit(RLIMIT_NOFILE, &files);
+    }
+
+    cstate_time_files.clear();
+    throttle_files.clear();
+    cstate_time_files.resize(core_count * cstate_names.size());
+    throttle_files.resize(core_count * 2);
+    for (size_t core = 0; core < core_count; ++core) {
+        std::string core_dir = cpu_root + std::to_string(core);
+        for (size_t state = 0; state < cstate_names.size(); ++state) {
+            cstate_time_files[core * cstate_names.size() + state].open(
+                core_dir + "/cpuidle/state" + std::to_string(state) + "/time", 64);
+        }
+        throttle_files[core * 2].open(core_dir + "/thermal_throttle/core_throttle_count", 64);
+        throttle_files[core * 2 + 1].open(core_dir + "/thermal_throttle/package_throttle_count", 64);
+    }
+    previous_cstate_time_us.assign(cstate_time_files.size(), 0);
+    cstate_residency_us.assign(cstate_time_files.size(), 0);
+    previous_throttle_counts.assign(throttle_files.size(), 0);
+}
+
+void SystemMonitor::sampleCoreCounters(double elapsed_seconds, ResourceMetrics& metrics)
+{
+    // Per-core frequency from cpufreq, else the per-processor "cpu MHz" lines getCPUFrequency just read
+    metrics.per_core_frequency_mhz.clear();
+    if (frequency_from_cpuinfo) {
+        ProcScanner scan(frequency_file);
+        for (; !scan.atEnd(); scan.skipLine()) {
+            double mhz = 0.0;
+            if (scan.consume("cpu MHz") && scan.skipPast(':') && scan.nextDouble(mhz)) {
+                metrics.per_core_frequency_mhz.push_back(mhz);
+            }
+        }
+    } else {
+        for (auto& file : core_frequency_files) {
+            uint64_t khz = 0;
+            if (file.read()) {
+                ProcScanner scan(file);
+                scan.nextUint(khz);
+            }
+            metrics.per_core_frequency_mhz.push_back(khz / 1000.0);
+        }
+    }
+    if (!metrics.per_core_frequency_mhz.empty()) {
+        metrics.cpu_frequency_mhz = std::accumulate(metrics.per_core_frequency_mhz.begin(),
+            metrics.per_core_frequency_mhz.end(), 0.0) / metrics.per_core_frequency_mhz.size();
+    }
+
+    const uint64_t DEEP_CSTATE_LATENCY_US = 20;
+    const size_t states = cstate_names.size();
+    bool counting = core_counters_initialized && elapsed_seconds > 0.0;
+    double interval_us = elapsed_seconds * MICROSECONDS_PER_SECOND;
+
+    if (states > 0) {
+        metrics.per_core_deep_idle_percent.assign(core_count, 0.0);
+        for (size_t core = 0; core < core_count; ++core) {
+            for (size_t state = 0; state < states; ++state) {
+                size_t index = core * states + state;
+                uint64_t time_us = 0;
+                if (!readUintFile(cstate_time_files[index], time_us)) {
+                    continue;
+                }
+                uint64_t delta = time_us > previous_cstate_time_us[index] ? time_us - previous_cstate_time_us[index] : 0;
+                previous_cstate_time_us[index] = time_us;
+                if (!counting) {
+                    continue;
+                }
+                cstate_residency_us[index] += delta;
+                if (cstate_latency_us[state] >= DEEP_CSTATE_LATENCY_US) {
+                    metrics.per_core_deep_idle_percent[core] += delta / interval_us * 100.0;
+                }
+            }
+            metrics.per_core_deep_idle_percent[core] = std::min(100.0, metrics.per_core_deep_idle_percent[core]);
+        }
+    }
+
+    metrics.per_core_throttle_events.assign(core_count, 0);
+    for (size_t index = 0; index < throttle_files.size(); ++index) {
+        uint64_t count = 0;
+        if (!readUintFile(throttle_files[index], count)) {
+            continue;
+        }
+        uint64_t delta = count > previous_throttle_counts[index] ? count - previous_throttle_counts[index] : 0;
+        previous_throttle_counts[index] = count;
+        if (counting) {
+            metrics.per_core_throttle_events[index / 2] += delta;
+            metrics.thermal_throttle_events += delta;
+        }
+    }
+    if (metrics.thermal_throttle_events > 0) {
+        metrics.thermal_throttling_detected = true;
+    }
+
+    if (counting) {
+        cstate_elapsed_seconds += elapsed_seconds;
+    }
+    core_counters_initialized = true;
+}
+
+void SystemMonitor::sampleVmstat(ResourceMetrics& metrics)
+{
+    VmstatCounters current;
+    if (!vmstat_file.read() || !current.parse(vmstat_file)) {
+        return;
+    }
+    // The first sample only establishes the baseline
+    if (previous_vmstat.valid) {
+        metrics.vmstat = current.delta(previous_vmstat);
+        metrics.page_faults = metrics.vmstat.pgfault;
+    }
+    previous_vmstat = current;
+}
+
+// num_threads is field 20 of /proc/self/stat, counted after the parenthesised command name
+uint64_t SystemMonitor::selfThreadCount()
+{
+    if (!self_stat_file.read()) {
+        return 0;
+    }
+    const char* data = self_stat_file.data();
+    const char* name_end = static_cast<const char*>(memrchr(data, ')', self_stat_file.size()));
+    if (name_end == nullptr) {
+        return 0;
+    }
+    ProcScanner scan(name_end + 1, self_stat_file.size() - static_cast<size_t>(name_end + 1 - data));
+    const char* token = nullptr;
+    size_t length = 0;
+    for (int field = 3; field < 20; ++field) {
+        if (!scan.nextToken(token, length)) {
+            return 0;
+        }
+    }
+    uint64_t threads = 0;
+    scan.nextUint(threads);
+    return threads;
+}
+
+void SystemMonitor::refreshChildTaskFiles()
+{
+    child_task_files.clear();
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks == nullptr) {
+        return;
+    }
+    while (struct dirent* entry = readdir(tasks)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        ProcFile children(std::string("/proc/self/task/") + entry->d_name + "/children", 1024);
+        if (children.isOpen()) {
+            child_task_files.push_back(std::move(children));
+        }
+    }
+    closedir(tasks);
+}
 
-        std::istringstream ss(line);
-        std::string label;
-        CpuTimes snapshot;
+// Forked helpers count as the benchmark: reaped ones through RUSAGE_CHILDREN,
+// running ones through the schedstat run time of each child listed by a task
+double SystemMonitor::processTreeCpuSeconds()
+{
+    double seconds = 0.0;
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0) {
+        seconds = ts.tv_sec + ts.tv_nsec / NANOSECONDS_PER_SECOND;
+    }
+    struct rusage children {};
+    if (getrusage(RUSAGE_CHILDREN, &children) == 0) {
+        seconds += children.ru_utime.tv_sec + children.ru_utime.tv_usec / MICROSECONDS_PER_SECOND +
+            children.ru_stime.tv_sec + children.ru_stime.tv_usec / MICROSECONDS_PER_SECOND;
+    }
+
+    uint64_t threads = selfThreadCount();
+    if (threads != child_task_threads) {
+        refreshChildTaskFiles();
+        child_task_threads = threads;
+    }
 
-        if (!(ss >> label)) {
+    for (auto& source : child_cpu_sources) {
+        source.listed = false;
+    }
+    for (auto& file : child_task_files) {
+        if (!file.read()) {
+            // The thread exited, possibly replaced by another; rescan next sample
+            child_task_threads = 0;
             continue;
         }
+        ProcScanner scan(file);
+        uint64_t pid = 0;
+        while (scan.nextUint(pid)) {
+            auto found = std::find_if(child_cpu_sources.begin(), child_cpu_sources.end(),
+                [pid](const ChildCpuSource& source) { return source.pid == pid; });
+            if (found == child_cpu_sources.end()) {
+                ChildCpuSource source;
+                source.pid = pid;
+                source.schedstat.open("/proc/" + std::to_string(pid) + "/schedstat", 128);
+                child_cpu_sources.push_back(std::move(source));
+                found = child_cpu_sources.end() - 1;
+            }
+            found->listed = true;
+        }
+    }
+    child_cpu_sources.erase(std::remove_if(child_cpu_sources.begin(), child_cpu_sources.end(),
+        [](const ChildCpuSource& source) { return !source.listed; }), child_cpu_sources.end());
+
+    for (auto& source : child_cpu_sources) {
+        uint64_t run_ns = 0;
+        if (source.schedstat.read()) {
+            ProcScanner run(source.schedstat);
+            if (run.nextUint(run_ns)) {
+                seconds += run_ns / NANOSECONDS_PER_SECOND;
+            }
+        }
+    }
+    return seconds;
+}
 
-        ss >> snapshot.user >> snapshot.nice >> snapshot.system >> snapshot.idle;
-        if (!(ss >> snapshot.iowait)) snapshot.iowait = 0;
-        if (!(ss >> snapshot.irq)) snapshot.irq = 0;
-        if (!(ss >> snapshot.softirq)) snapshot.softirq = 0;
-        if (!(ss >> snapshot.steal)) snapshot.steal = 0;
+// Lines look like "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456" with totals in microseconds
 
-        if (label == "cpu") {
-            total_times = snapshot;
-        } else if (label.rfind("cpu", 0) == 0) {
-            times.push_back(snapshot);
+bool SystemMonitor::readPressure(PressureSource& source, double elapsed_seconds, PressureStall& stall)
+{
+    if (!source.file.read() || source.file.size() == 0) {
+        return false;
+    }
+
+    uint64_t some_total = 0;
+    uint64_t full_total = 0;
+    bool parsed = false;
+    ProcScanner scan(source.file);
+    for (; !scan.atEnd(); scan.skipLine()) {
+        bool some = scan.consume("some");
+        if (!some && !scan.consume("full")) {
+            continue;
+        }
+        double avg10 = 0.0;
+        double ignored = 0.0;
+        uint64_t total = 0;
+        if (!scan.skipPast('=') || !scan.nextDouble(avg10) || !scan.skipPast('=') || !scan.nextDouble(ignored) ||
+            !scan.skipPast('=') || !scan.nextDouble(ignored) || !scan.skipPast('=') || !scan.nextUint(total)) {
+            continue;
         }
+        (some ? stall.some_avg10 : stall.full_avg10) = avg10;
+        (some ? some_total : full_total) = total;
+        parsed = parsed || some;
+    }
+    if (!parsed) {
+        return false;
     }
 
-    return times;
+    if (source.has_previous && elapsed_seconds > 0.0) {
+        double interval_us = elapsed_seconds * MICROSECONDS_PER_SECOND;
+        double some_delta = some_total > source.previous_some_total ? some_total - source.previous_some_total : 0;
+        double full_delta = full_total > source.previous_full_total ? full_total - source.previous_full_total : 0;
+        stall.some_stall_percent = std::min(100.0, some_delta / interval_us * 100.0);
+        stall.full_stall_percent = std::min(100.0, full_delta / interval_us * 100.0);
+    }
+    source.previous_some_total = some_total;
+    source.previous_full_total = full_total;
+    source.has_previous = true;
+    return true;
+}
+
+bool SystemMonitor::readCpuTimes(std::vector<CpuTimes>& times, CpuTimes& total_times)
+{
+    times.clear();
+    if (!stat_file.read()) {
+        return false;
+    }
+
+    ProcScanner scan(stat_file);
+    while (!scan.atEnd()) {
+        if (scan.consume("cpu")) {
+            bool aggregate = scan.peek() == ' ';
+            uint64_t index = 0;
+            if (!aggregate && !scan.nextUint(index)) {
+                scan.skipLine();
+                continue;
+            }
+
+            // iowait, irq, softirq and steal are missing on old kernels
+            CpuTimes snapshot;
+            uint64_t* fields[] = { &snapshot.user, &snapshot.nice, &snapshot.system, &snapshot.idle,
+                &snapshot.iowait, &snapshot.irq, &snapshot.softirq, &snapshot.steal };
+            for (uint64_t* field : fields) {
+                if (!scan.nextUint(*field)) {
+                    break;
+                }
+            }
+
+            if (aggregate) {
+                total_times = snapshot;
+            } else {
+                times.push_back(snapshot);
+            }
+        } else if (scan.consume("processes")) {
+            uint64_t processes = 0;
+            if (scan.nextUint(processes)) {
+                last_process_count = static_cast<uint32_t>(processes);
+            }
+        }
+        scan.skipLine();
+    }
+
+    return true;
 }
 #endif
 
@@ -334,29 +944,21 @@ std::vector<double> SystemMonitor::getCPUUsagePerCore()
 
 #ifdef __linux__
     CpuTimes total_times{};
-    auto current_times = readCpuTimes(total_times);
+    readCpuTimes(current_cpu_times, total_times);
 
-    if (!cpu_times_initialized) {
-        previous_cpu_times = current_times;
+    if (!cpu_times_initialized || previous_cpu_times.size() != current_cpu_times.size()) {
+        std::swap(previous_cpu_times, current_cpu_times);
         previous_cpu_total = total_times;
         cpu_times_initialized = true;
         last_io_wait_percent = 0.0;
-        usage.assign(current_times.size(), 0.0);
+        usage.assign(previous_cpu_times.size(), 0.0);
         return usage;
     }
 
-    if (previous_cpu_times.size() != current_times.size()) {
-        previous_cpu_times = current_times;
-        previous_cpu_total = total_times;
-        last_io_wait_percent = 0.0;
-        usage.assign(current_times.size(), 0.0);
-        return usage;
-    }
-
-    usage.reserve(current_times.size());
-    for (size_t i = 0; i < current_times.size(); ++i) {
+    usage.reserve(current_cpu_times.size());
+    for (size_t i = 0; i < current_cpu_times.size(); ++i) {
         const auto& prev = previous_cpu_times[i];
-        const auto& curr = current_times[i];
+        const auto& curr = current_cpu_times[i];
 
         double delta_total = static_cast<double>(curr.total() - prev.total());
         double delta_active = static_cast<double>(curr.active() - prev.active());
@@ -375,7 +977,8 @@ std::vector<double> SystemMonitor::getCPUUsagePerCore()
         last_io_wait_percent = 0.0;
     }
 
-    previous_cpu_times = std::move(current_times);
+    // Swapping keeps both buffers' capacity for the next sample
+    std::swap(previous_cpu_times, current_cpu_times);
     previous_cpu_total = total_times;
 #elif defined(__APPLE__)
     // macOS CPU usage per core is more complex and requires additional frameworks
@@ -405,17 +1008,19 @@ std::vector<double> SystemMonitor::getCPUUsagePerCore()
 double SystemMonitor::getCPUFrequency()
 {
 #ifdef __linux__
-    std::ifstream freq_file("/proc/cpuinfo");
-    if (freq_file.is_open()) {
-        std::string line;
-        while (std::getline(freq_file, line)) {
-            if (line.find("cpu MHz") != std::string::npos) {
-                size_t colon = line.find(':');
-                if (colon != std::string::npos) {
-                    return std::stod(line.substr(colon + 1));
-                }
-            }
+    if (!frequency_file.read()) {
+        return 0.0;
+    }
+    ProcScanner scan(frequency_file);
+    double value = 0.0;
+    if (!frequency_from_cpuinfo) {
+        return scan.nextDouble(value) ? value / 1000.0 : 0.0; // kHz
+    }
+    while (!scan.atEnd()) {
+        if (scan.consume("cpu MHz") && scan.skipPast(':') && scan.nextDouble(value)) {
+            return value;
         }
+        scan.skipLine();
     }
 #elif defined(__APPLE__)
     uint64_t freq = 0;
@@ -432,13 +1037,11 @@ bool SystemMonitor::detectThermalThrottling()
 {
 #ifdef __linux__
     // Check thermal zones for throttling
-    std::ifstream thermal_file("/sys/class/thermal/thermal_zone0/temp");
-    if (thermal_file.is_open()) {
-        std::string temp_str;
-        thermal_file >> temp_str;
-        int temp = std::stoi(temp_str);
+    int64_t temp = 0;
+    if (thermal_file.read()) {
+        ProcScanner scan(thermal_file);
         // Temperature is in millidegrees Celsius
-        return temp > 85000; // Above 85°C suggests potential throttling
+        return scan.nextInt(temp) && temp > 85000; // Above 85°C suggests potential throttling
     }
 #endif
     return false;
@@ -447,28 +1050,21 @@ bool SystemMonitor::detectThermalThrottling()
 void SystemMonitor::getMemoryInfo(double& used_mb, double& available_mb)
 {
 #ifdef __linux__
-    std::ifstream meminfo("/proc/meminfo");
-    if (!meminfo.is_open()) {
+    if (!meminfo_file.read()) {
         used_mb = available_mb = 0.0;
         return;
     }
     
-    std::string line;
     uint64_t total_kb = 0, available_kb = 0;
-    
-    while (std::getline(meminfo, line)) {
-        if (line.find("MemTotal:") == 0) {
-            std::istringstream ss(line);
-            std::string label, value, unit;
-            ss >> label >> value >> unit;
-            total_kb = std::stoull(value);
-        } else if (line.find("MemAvailable:") == 0) {
-            std::istringstream ss(line);
-            std::string label, value, unit;
-            ss >> label >> value >> unit;
-            available_kb = std::stoull(value);
+    ProcScanner scan(meminfo_file);
+    while (!scan.atEnd()) {
+        if (scan.consume("MemTotal:")) {
+            scan.nextUint(total_kb);
+        } else if (scan.consume("MemAvailable:")) {
+            scan.nextUint(available_kb);
             break;
         }
+        scan.skipLine();
     }
     
     available_mb = available_kb / 1024.0;
@@ -491,56 +1087,69 @@ void SystemMonitor::getMemoryInfo(double& used_mb, double& available_mb)
 #endif
 }
 
+#ifdef __linux__
+namespace {
+
+bool tokenContains(const char* token, size_t length, const char* needle)
+{
+    return std::search(token, token + length, needle, needle + strlen(needle)) != token + length;
+}
+
+template <typename Snapshot>
+void copyDeviceName(Snapshot& snapshot, const char* name, size_t length)
+{
+    length = std::min(length, sizeof(snapshot.name) - 1);
+    memcpy(snapshot.name, name, length);
+    snapshot.name[length] = '\0';
+}
+
+template <typename Snapshot>
+const Snapshot* findDevice(const std::vector<Snapshot>& snapshots, const char* name)
+{
+    for (const auto& snapshot : snapshots) {
+        if (strncmp(snapshot.name, name, sizeof(snapshot.name)) == 0) {
+            return &snapshot;
+        }
+    }
+    return nullptr;
+}
+
+}
+#endif
+
 void SystemMonitor::getDiskIOStats(double elapsed_seconds, double& read_mbps, double& write_mbps, uint64_t& operations)
 {
     read_mbps = write_mbps = 0.0;
     operations = 0;
 
 #ifdef __linux__
-    std::ifstream diskstats("/proc/diskstats");
-    if (!diskstats.is_open()) {
+    if (!diskstats_file.read()) {
         return;
     }
 
-    std::map<std::string, DiskSnapshot> current_stats;
-    std::string line;
-    while (std::getline(diskstats, line)) {
-        std::istringstream ss(line);
-        uint64_t major = 0;
-        uint64_t minor = 0;
-        std::string device;
-
-        if (!(ss >> major >> minor >> device)) {
+    current_disk_stats.clear();
+    ProcScanner scan(diskstats_file);
+    for (; !scan.atEnd(); scan.skipLine()) {
+        DiskDeviceCounters snapshot;
+        if (!parseDiskstatsLine(scan, snapshot)) {
             continue;
         }
-
-        if (device.find("loop") != std::string::npos || device.find("ram") != std::string::npos) {
-            continue;
-        }
-
-        DiskSnapshot snapshot;
-        uint64_t reads_merged = 0;
-        uint64_t read_time = 0;
-        uint64_t writes_merged = 0;
-        uint64_t write_time = 0;
-
-        if (!(ss >> snapshot.reads_completed >> reads_merged >> snapshot.read_sectors >> read_time >>
-              snapshot.writes_completed >> writes_merged >> snapshot.write_sectors >> write_time)) {
+        size_t name_length = strlen(snapshot.name);
+        if (tokenContains(snapshot.name, name_length, "loop") || tokenContains(snapshot.name, name_length, "ram")) {
             continue;
         }
-
-        current_stats[device] = snapshot;
+        current_disk_stats.push_back(snapshot);
 
         if (elapsed_seconds <= 0.0) {
             continue;
         }
 
-        auto it = previous_disk_stats.find(device);
-        if (it == previous_disk_stats.end()) {
+        const DiskDeviceCounters* previous = findDevice(previous_disk_stats, snapshot.name);
+        if (previous == nullptr) {
             continue;
         }
 
-        const auto& prev = it->second;
+        const auto& prev = *previous;
         uint64_t read_sector_delta = snapshot.read_sectors >= prev.read_sectors
             ? snapshot.read_sectors - prev.read_sectors
             : 0;
@@ -562,7 +1171,7 @@ void SystemMonitor::getDiskIOStats(double elapsed_seconds, double& read_mbps, do
         operations += read_delta + write_delta;
     }
 
-    previous_disk_stats = std::move(current_stats);
+    std::swap(previous_disk_stats, current_disk_stats);
 #else
     (void)elapsed_seconds;
 #endif
@@ -573,56 +1182,54 @@ void SystemMonitor::getNetworkStats(double elapsed_seconds, double& rx_mbps, dou
     rx_mbps = tx_mbps = 0.0;
 
 #ifdef __linux__
-    std::ifstream net_dev("/proc/net/dev");
-    if (!net_dev.is_open()) {
+    if (!netdev_file.read()) {
         return;
     }
 
-    std::map<std::string, NetSnapshot> current_stats;
-    std::string line;
+    current_net_stats.clear();
+    ProcScanner scan(netdev_file);
     // Skip header lines
-    std::getline(net_dev, line);
-    std::getline(net_dev, line);
+    scan.skipLine();
+    scan.skipLine();
 
-    while (std::getline(net_dev, line)) {
-        size_t colon = line.find(':');
-        if (colon == std::string::npos) {
+    for (; !scan.atEnd(); scan.skipLine()) {
+        scan.skipSpaces();
+        const char* interface = scan.position();
+        if (!scan.skipPast(':')) {
             continue;
         }
-
-        std::string interface = line.substr(0, colon);
-        interface.erase(std::remove_if(interface.begin(), interface.end(), ::isspace), interface.end());
-        if (interface.empty() || interface == "lo") {
+        size_t interface_length = static_cast<size_t>(scan.position() - interface) - 1;
+        if (interface_length == 0 || tokenEquals(interface, interface_length, "lo")) {
             continue;
         }
 
-        std::istringstream ss(line.substr(colon + 1));
         NetSnapshot snapshot;
-        if (!(ss >> snapshot.rx_bytes)) {
+        if (!scan.nextUint(snapshot.rx_bytes)) {
             continue;
         }
         uint64_t dummy = 0;
         for (int i = 0; i < 7; ++i) {
-            if (!(ss >> dummy)) {
+            if (!scan.nextUint(dummy)) {
                 break;
             }
         }
-        if (!(ss >> snapshot.tx_bytes)) {
+        if (!scan.nextUint(snapshot.tx_bytes)) {
             continue;
         }
 
-        current_stats[interface] = snapshot;
+        copyDeviceName(snapshot, interface, interface_length);
+        current_net_stats.push_back(snapshot);
 
         if (elapsed_seconds <= 0.0) {
             continue;
         }
 
-        auto it = previous_net_stats.find(interface);
-        if (it == previous_net_stats.end()) {
+        const NetSnapshot* previous = findDevice(previous_net_stats, snapshot.name);
+        if (previous == nullptr) {
             continue;
         }
 
-        const auto& prev = it->second;
+        const auto& prev = *previous;
         uint64_t rx_delta = snapshot.rx_bytes >= prev.rx_bytes ? snapshot.rx_bytes - prev.rx_bytes : 0;
         uint64_t tx_delta = snapshot.tx_bytes >= prev.tx_bytes ? snapshot.tx_bytes - prev.tx_bytes : 0;
 
@@ -633,7 +1240,7 @@ void SystemMonitor::getNetworkStats(double elapsed_seconds, double& rx_mbps, dou
         tx_mbps += tx_mb / elapsed_seconds;
     }
 
-    previous_net_stats = std::move(current_stats);
+    std::swap(previous_net_stats, current_net_stats);
 #else
     (void)elapsed_seconds;
 #endif
@@ -645,25 +1252,15 @@ void SystemMonitor::getSystemLoad(double& load1, double& load5, uint32_t& proces
     processes = 0;
     
 #ifdef __linux__
-    std::ifstream loadavg("/proc/loadavg");
-    if (loadavg.is_open()) {
-        loadavg >> load1 >> load5;
-    }
-    
-    // Count processes
-    std::ifstream stat_file("/proc/stat");
-    if (stat_file.is_open()) {
-        std::string line;
-        while (std::getline(stat_file, line)) {
-            if (line.find("processes") == 0) {
-                std::istringstream ss(line);
-                std::string label;
-                ss >> label >> processes;
-                break;
-            }
-        }
+    if (loadavg_file.read()) {
+        ProcScanner scan(loadavg_file);
+        scan.nextDouble(load1);
+        scan.nextDouble(load5);
     }
     
+    // Process count comes from the same /proc/stat pass as the CPU times
+    processes = last_process_count;
+    
 #elif defined(__APPLE__)
     double loads[3];
     if (getloadavg(loads, 3) != -1) {
@@ -681,108 +1278,102 @@ void SystemMonitor::getSystemLoad(double& load1, double& load5, uint32_t& proces
 
 bool SystemMonitor::writeSamplesToFile(const std::string& path) const
 {
-    if (path.empty()) {
+    TelemetryWriter writer;
+    if (!writer.open(path, telemetry_ring.coreCount(), sample_interval_ms)) {
         return false;
     }
-
-    auto toLower = [](std::string value) {
-        std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        return value;
-    };
-
-    std::string lower_path = toLower(path);
-    bool as_json = lower_path.size() >= 5 && lower_path.substr(lower_path.size() - 5) == ".json";
-
-    std::ofstream out(path);
-    if (!out.is_open()) {
-        return false;
+    for (size_t i = 0; i < telemetry_ring.size(); ++i) {
+        writer.append(telemetry_ring.sampleIndex(i), telemetry_ring.record(i), telemetry_ring.coreFrequency(i),
+            telemetry_ring.coreDeepIdle(i));
     }
+    return writer.close();
+}
 
-    if (as_json) {
-        out << "[\n";
-        for (size_t i = 0; i < samples.size(); ++i) {
-            const auto& s = samples[i];
-            out << "  {\n";
-            out << "    \"index\": " << i << ",\n";
-            out << "    \"timestamp_s\": " << std::fixed << std::setprecision(3) << s.sample_timestamp_seconds << ",\n";
-            out << "    \"cpu_usage_percent\": " << s.avg_cpu_usage_percent << ",\n";
-            out << "    \"cpu_frequency_mhz\": " << s.cpu_frequency_mhz << ",\n";
-            out << "    \"io_wait_percent\": " << s.avg_io_wait_percent << ",\n";
-            out << "    \"memory_used_mb\": " << s.memory_used_mb << ",\n";
-            out << "    \"memory_available_mb\": " << s.memory_available_mb << ",\n";
-            out << "    \"memory_usage_percent\": " << s.memory_usage_percent << ",\n";
-            out << "    \"disk_read_mbps\": " << s.disk_read_mbps << ",\n";
-            out << "    \"disk_write_mbps\": " << s.disk_write_mbps << ",\n";
-            out << "    \"network_rx_mbps\": " << s.network_rx_mbps << ",\n";
-            out << "    \"network_tx_mbps\": " << s.network_tx_mbps << ",\n";
-            out << "    \"load_average_1min\": " << s.load_average_1min << ",\n";
-            out << "    \"load_average_5min\": " << s.load_average_5min << ",\n";
-            out << "    \"thermal_throttling\": " << (s.thermal_throttling_detected ? "true" : "false") << "\n";
-            out << "  }";
-            if (i + 1 < samples.size()) {
-                out << ",\n";
-            } else {
-                out << "\n";
-            }
-        }
-        out << "]\n";
-    } else {
-        out << "index,timestamp_s,cpu_usage_percent,cpu_frequency_mhz,io_wait_percent,";
-        out << "memory_used_mb,memory_available_mb,memory_usage_percent,disk_read_mbps,disk_write_mbps,";
-        out << "network_rx_mbps,network_tx_mbps,load_average_1min,load_average_5min,thermal_throttling\n";
-        for (size_t i = 0; i < samples.size(); ++i) {
-            const auto& s = samples[i];
-            out << i << ','
-                << std::fixed << std::setprecision(3) << s.sample_timestamp_seconds << ','
-                << s.avg_cpu_usage_percent << ','
-                << s.cpu_frequency_mhz << ','
-                << s.avg_io_wait_percent << ','
-                << s.memory_used_mb << ','
-                << s.memory_available_mb << ','
-                << s.memory_usage_percent << ','
-                << s.disk_read_mbps << ','
-                << s.disk_write_mbps << ','
-                << s.network_rx_mbps << ','
-                << s.network_tx_mbps << ','
-                << s.load_average_1min << ','
-                << s.load_average_5min << ','
-                << (s.thermal_throttling_detected ? 1 : 0) << '\n';
-        }
+void SystemMonitor::recordSample(const ResourceMetrics& sample)
+{
+    ResourceMetrics& sum = accumulated_metrics;
+    sum.avg_cpu_usage_percent += sample.avg_cpu_usage_percent;
+    sum.process_cpu_percent += sample.process_cpu_percent;
+    sum.cpu_frequency_mhz += sample.cpu_frequency_mhz;
+    sum.memory_used_mb += sample.memory_used_mb;
+    sum.memory_available_mb += sample.memory_available_mb;
+    sum.memory_usage_percent += sample.memory_usage_percent;
+    sum.disk_read_mbps += sample.disk_read_mbps;
+    sum.disk_write_mbps += sample.disk_write_mbps;
+    sum.avg_io_wait_percent += sample.avg_io_wait_percent;
+    sum.network_rx_mbps += sample.network_rx_mbps;
+    sum.network_tx_mbps += sample.network_tx_mbps;
+    sum.load_average_1min += sample.load_average_1min;
+    sum.load_average_5min += sample.load_average_5min;
+    accumulated_processes += sample.active_processes;
+    sum.collection_cpu_us += sample.collection_cpu_us;
+    addSeries(sum.per_core_frequency_mhz, sample.per_core_frequency_mhz);
+    addSeries(sum.per_core_deep_idle_percent, sample.per_core_deep_idle_percent);
+    addSeries(sum.per_core_throttle_events, sample.per_core_throttle_events);
+    sum.thermal_throttle_events += sample.thermal_throttle_events;
+    sum.page_faults += sample.page_faults;
+    sum.vmstat.add(sample.vmstat);
+    sum.psi_available |= sample.psi_available;
+    sum.cgroup_psi_available |= sample.cgroup_psi_available;
+    sum.cpu_psi.add(sample.cpu_psi);
+    sum.memory_psi.add(sample.memory_psi);
+    sum.io_psi.add(sample.io_psi);
+    sum.cgroup_cpu_psi.add(sample.cgroup_cpu_psi);
+    sum.cgroup_memory_psi.add(sample.cgroup_memory_psi);
+    sum.cgroup_io_psi.add(sample.cgroup_io_psi);
+    sum.thermal_throttling_detected |= sample.thermal_throttling_detected;
+
+    ResourceMetrics& peak = peak_metrics;
+    peak.avg_cpu_usage_percent = std::max(peak.avg_cpu_usage_percent, sample.avg_cpu_usage_percent);
+    peak.process_cpu_percent = std::max(peak.process_cpu_percent, sample.process_cpu_percent);
+    peak.cpu_frequency_mhz = std::max(peak.cpu_frequency_mhz, sample.cpu_frequency_mhz);
+    peak.memory_used_mb = std::max(peak.memory_used_mb, sample.memory_used_mb);
+    peak.memory_usage_percent = std::max(peak.memory_usage_percent, sample.memory_usage_percent);
+    peak.disk_read_mbps = std::max(peak.disk_read_mbps, sample.disk_read_mbps);
+    peak.disk_write_mbps = std::max(peak.disk_write_mbps, sample.disk_write_mbps);
+    peak.avg_io_wait_percent = std::max(peak.avg_io_wait_percent, sample.avg_io_wait_percent);
+    peak.network_rx_mbps = std::max(peak.network_rx_mbps, sample.network_rx_mbps);
+    peak.network_tx_mbps = std::max(peak.network_tx_mbps, sample.network_tx_mbps);
+    peak.load_average_1min = std::max(peak.load_average_1min, sample.load_average_1min);
+    peak.load_average_5min = std::max(peak.load_average_5min, sample.load_average_5min);
+    peak.active_processes = std::max(peak.active_processes, sample.active_processes);
+    peak.collection_cpu_us = std::max(peak.collection_cpu_us, sample.collection_cpu_us);
+    maxSeries(peak.per_core_frequency_mhz, sample.per_core_frequency_mhz);
+    maxSeries(peak.per_core_deep_idle_percent, sample.per_core_deep_idle_percent);
+    maxSeries(peak.per_core_throttle_events, sample.per_core_throttle_events);
+    peak.thermal_throttle_events = std::max(peak.thermal_throttle_events, sample.thermal_throttle_events);
+    peak.page_faults = std::max(peak.page_faults, sample.page_faults);
+    peak.vmstat.takeMax(sample.vmstat);
+    peak.psi_available |= sample.psi_available;
+    peak.cgroup_psi_available |= sample.cgroup_psi_available;
+    peak.cpu_psi.takeMax(sample.cpu_psi);
+    peak.memory_psi.takeMax(sample.memory_psi);
+    peak.io_psi.takeMax(sample.io_psi);
+    peak.cgroup_cpu_psi.takeMax(sample.cgroup_cpu_psi);
+    peak.cgroup_memory_psi.takeMax(sample.cgroup_memory_psi);
+    peak.cgroup_io_psi.takeMax(sample.cgroup_io_psi);
+    peak.thermal_throttling_detected |= sample.thermal_throttling_detected;
+    ++sample_total;
+    interference_watch.observe(sample);
+
+    telemetry_ring.push(toTelemetryRecord(sample), sample.per_core_frequency_mhz, sample.per_core_deep_idle_percent);
+    if (telemetry_stream.isOpen()) {
+        size_t newest = telemetry_ring.size() - 1;
+        telemetry_stream.append(telemetry_ring.sampleIndex(newest), telemetry_ring.record(newest),
+            telemetry_ring.coreFrequency(newest), telemetry_ring.coreDeepIdle(newest));
     }
-
-    return true;
 }
 
 ResourceMetrics SystemMonitor::getAverageMetrics()
 {
-    if (samples.empty()) {
+    if (sample_total == 0) {
         return ResourceMetrics();
     }
     
-    ResourceMetrics avg;
-    
-    for (const auto& sample : samples) {
-        avg.avg_cpu_usage_percent += sample.avg_cpu_usage_percent;
-        avg.cpu_frequency_mhz += sample.cpu_frequency_mhz;
-        avg.memory_used_mb += sample.memory_used_mb;
-        avg.memory_available_mb += sample.memory_available_mb;
-        avg.memory_usage_percent += sample.memory_usage_percent;
-        avg.disk_read_mbps += sample.disk_read_mbps;
-        avg.disk_write_mbps += sample.disk_write_mbps;
-        avg.avg_io_wait_percent += sample.avg_io_wait_percent;
-        avg.network_rx_mbps += sample.network_rx_mbps;
-        avg.network_tx_mbps += sample.network_tx_mbps;
-        avg.load_average_1min += sample.load_average_1min;
-        avg.load_average_5min += sample.load_average_5min;
-        avg.active_processes += sample.active_processes;
-        
-        if (sample.thermal_throttling_detected) {
-            avg.thermal_throttling_detected = true;
-        }
-    }
-    
-    size_t count = samples.size();
+    ResourceMetrics avg = accumulated_metrics;
+    size_t count = sample_total;
     avg.avg_cpu_usage_percent /= count;
+    avg.process_cpu_percent /= count;
     avg.cpu_frequency_mhz /= count;
     avg.memory_used_mb /= count;
     avg.memory_available_mb /= count;
@@ -794,7 +1385,18 @@ ResourceMetrics SystemMonitor::getAverageMetrics()
     avg.network_tx_mbps /= count;
     avg.load_average_1min /= count;
     avg.load_average_5min /= count;
-    avg.active_processes /= count;
+    avg.active_processes = static_cast<uint32_t>(accumulated_processes / count);
+    avg.collection_cpu_us /= count;
+    for (auto& value : avg.per_core_frequency_mhz) {
+        value /= count;
+    }
+    for (auto& value : avg.per_core_deep_idle_percent) {
+        value /= count;
+    }
+    for (PressureStall* stall : { &avg.cpu_psi, &avg.memory_psi, &avg.io_psi,
+             &avg.cgroup_cpu_psi, &avg.cgroup_memory_psi, &avg.cgroup_io_psi }) {
+        stall->scale(1.0 / count);
+    }
     
     avg.monitoring_duration_seconds = monitoring_timer.elapsedSeconds();
     avg.sample_count = count;
@@ -804,47 +1406,33 @@ ResourceMetrics SystemMonitor::getAverageMetrics()
 
 ResourceMetrics SystemMonitor::getPeakMetrics()
 {
-    if (samples.empty()) {
+    if (sample_total == 0) {
         return ResourceMetrics();
     }
     
-    ResourceMetrics peak;
-    
-    for (const auto& sample : samples) {
-        peak.avg_cpu_usage_percent = std::max(peak.avg_cpu_usage_percent, sample.avg_cpu_usage_percent);
-        peak.cpu_frequency_mhz = std::max(peak.cpu_frequency_mhz, sample.cpu_frequency_mhz);
-        peak.memory_used_mb = std::max(peak.memory_used_mb, sample.memory_used_mb);
-        peak.memory_usage_percent = std::max(peak.memory_usage_percent, sample.memory_usage_percent);
-        peak.disk_read_mbps = std::max(peak.disk_read_mbps, sample.disk_read_mbps);
-        peak.disk_write_mbps = std::max(peak.disk_write_mbps, sample.disk_write_mbps);
-        peak.avg_io_wait_percent = std::max(peak.avg_io_wait_percent, sample.avg_io_wait_percent);
-        peak.network_rx_mbps = std::max(peak.network_rx_mbps, sample.network_rx_mbps);
-        peak.network_tx_mbps = std::max(peak.network_tx_mbps, sample.network_tx_mbps);
-        peak.load_average_1min = std::max(peak.load_average_1min, sample.load_average_1min);
-        peak.load_average_5min = std::max(peak.load_average_5min, sample.load_average_5min);
-        peak.active_processes = std::max(peak.active_processes, sample.active_processes);
-        
-        if (sample.thermal_throttling_detected) {
-            peak.thermal_throttling_detected = true;
-        }
-    }
-    
+    ResourceMetrics peak = peak_metrics;
     peak.monitoring_duration_seconds = monitoring_timer.elapsedSeconds();
-    peak.sample_count = samples.size();
+    peak.sample_count = sample_total;
     
     return peak;
 }
 
 std::vector<ResourceMetrics> SystemMonitor::getAllSamples()
 {
-    return samples;
+    std::vector<ResourceMetrics> retained;
+    retained.reserve(telemetry_ring.size());
+    for (size_t i = 0; i < telemetry_ring.size(); ++i) {
+        retained.push_back(fromTelemetryRecord(telemetry_ring.record(i), telemetry_ring.coreFrequency(i),
+            telemetry_ring.coreDeepIdle(i), telemetry_ring.coreCount()));
+    }
+    return retained;
 }
 
 InterferenceReport SystemMonitor::analyzeInterference()
 {
     InterferenceReport report;
     
-    if (samples.empty()) {
+    if (sample_total == 0) {
         return report;
     }
     
@@ -860,6 +1448,32 @@ InterferenceReport SystemMonitor::analyzeInterference()
     report.memory_pressure = (avg.memory_usage_percent > HIGH_MEMORY_THRESHOLD);
     report.high_io_wait = (avg.avg_io_wait_percent > HIGH_IO_WAIT_THRESHOLD);
     report.thermal_throttling = avg.thermal_throttling_detected;
+
+    // PSI measures stall time directly, so it replaces the memory and I/O utilization heuristics
+    if (avg.psi_available || avg.cgroup_psi_available) {
+        const double CPU_STALL_THRESHOLD = 10.0; // some task waited for a CPU >10% of the time
+        const double MEMORY_STALL_THRESHOLD = 5.0;
+        const double MEMORY_FULL_STALL_THRESHOLD = 1.0; // all tasks stalled on reclaim/swap-in
+        const double IO_STALL_THRESHOLD = 10.0;
+        const double IO_FULL_STALL_THRESHOLD = 5.0;
+
+        PressureStall cpu = avg.cpu_psi;
+        PressureStall memory = avg.memory_psi;
+        PressureStall io = avg.io_psi;
+        cpu.takeMax(avg.cgroup_cpu_psi);
+        memory.takeMax(avg.cgroup_memory_psi);
+        io.takeMax(avg.cgroup_io_psi);
+
+        report.psi_available = true;
+        report.cpu_stall_percent = cpu.some_stall_percent;
+        report.memory_stall_percent = memory.some_stall_percent;
+        report.io_stall_percent = io.some_stall_percent;
+        report.cpu_contention = cpu.some_stall_percent > CPU_STALL_THRESHOLD;
+        report.memory_pressure = memory.some_stall_percent > MEMORY_STALL_THRESHOLD ||
+            memory.full_stall_percent > MEMORY_FULL_STALL_THRESHOLD;
+        report.high_io_wait = io.some_stall_percent > IO_STALL_THRESHOLD ||
+            io.full_stall_percent > IO_FULL_STALL_THRESHOLD;
+    }
     
     // Generate specific warnings
     if (report.high_background_cpu_usage) {
@@ -867,12 +1481,23 @@ InterferenceReport SystemMonitor::analyzeInterference()
             std::to_string(static_cast<int>(avg.avg_cpu_usage_percent)) + "%)");
     }
     
-    if (report.memory_pressure) {
+    if (report.cpu_contention) {
+        report.performance_warnings.push_back("CPU pressure stalls detected (" +
+            std::to_string(static_cast<int>(report.cpu_stall_percent)) + "% of time waiting for a CPU)");
+    }
+
+    if (report.memory_pressure && report.psi_available) {
+        report.performance_warnings.push_back("Memory pressure stalls detected (" +
+            std::to_string(static_cast<int>(report.memory_stall_percent)) + "% of time)");
+    } else if (report.memory_pressure) {
         report.performance_warnings.push_back("High memory usage detected (" + 
             std::to_string(static_cast<int>(avg.memory_usage_percent)) + "%)");
     }
     
-    if (report.high_io_wait) {
+    if (report.high_io_wait && report.psi_available) {
+        report.performance_warnings.push_back("I/O pressure stalls detected (" +
+            std::to_string(static_cast<int>(report.io_stall_percent)) + "% of time)");
+    } else if (report.high_io_wait) {
         report.performance_warnings.push_back("High I/O wait detected (" + 
             std::to_string(static_cast<int>(avg.avg_io_wait_percent)) + "%)");
     }
@@ -910,6 +1535,10 @@ std::vector<std::string> SystemMonitor::getPerformanceRecommendations()
         recommendations.push_back("Verify disk health and available space");
     }
     
+    if (interference.cpu_contention) {
+        recommendations.push_back("Reduce runnable threads or pin the benchmark away from other busy processes");
+    }
+    
     if (interference.thermal_throttling) {
         recommendations.push_back("Check CPU cooling and reduce ambient temperature");
         recommendations.push_back("Clean dust from cooling system");
@@ -924,17 +1553,33 @@ std::vector<std::string> SystemMonitor::getPerformanceRecommendations()
 
 void SystemMonitor::reset()
 {
-    samples.clear();
     accumulated_metrics.reset();
+    peak_metrics.reset();
+    accumulated_processes = 0;
+    sample_total = 0;
+    telemetry_ring.reset(telemetry_capacity, static_cast<size_t>(std::max(1, CPUAffinity::getNumCores())));
+    interference_watch.reset(interference_policy);
 #ifdef __linux__
     previous_cpu_times.clear();
     previous_cpu_total = CpuTimes{};
     cpu_times_initialized = false;
     last_io_wait_percent = 0.0;
     has_last_sample_time = false;
+    last_process_count = 0;
     previous_disk_stats.clear();
     previous_net_stats.clear();
+    previous_vmstat = VmstatCounters();
+    previous_process_cpu_seconds = 0.0;
+    for (size_t i = 0; i < PRESSURE_RESOURCES; ++i) {
+        system_pressure[i].has_previous = false;
+        cgroup_pressure[i].has_previous = false;
+    }
+    std::fill(cstate_residency_us.begin(), cstate_residency_us.end(), 0);
+    cstate_elapsed_seconds = 0.0;
+    core_counters_initialized = false;
 #endif
+    self_cpu_seconds = 0.0;
+    self_wall_seconds = 0.0;
 }
 
 bool SystemMonitor::isSystemBusy()
@@ -1,6 +1,11 @@
 #ifndef SYSTEM_MONITOR_H
 #define SYSTEM_MONITOR_H
 
+#include "diskstats.h"
+#include "interference_policy.h"
+#include "proc_reader.h"
+#include "telemetry.h"
+#include "vmstat.h"
 #include "utils.h"
 #include <atomic>
 #include <chrono>
@@ -10,20 +15,40 @@
 #include <vector>
 #include <cstdint>
 
+// Pressure stall information for one resource. avg10 is the kernel's 10 s
+// running average; the stall percents come from the cumulative totals and are
+// the share of the sample interval in which some / all runnable tasks stalled.
+struct PressureStall {
+    double some_avg10 { 0.0 };
+    double full_avg10 { 0.0 };
+    double some_stall_percent { 0.0 };
+    double full_stall_percent { 0.0 };
+
+    void add(const PressureStall& other);
+    void scale(double factor);
+    void takeMax(const PressureStall& other);
+};
+
 // Resource metrics collected during benchmark execution
 struct ResourceMetrics {
     // CPU metrics
     double avg_cpu_usage_percent;
+    double process_cpu_percent; // this process and its children, same scale as avg_cpu_usage_percent
     std::vector<double> per_core_usage;
     double cpu_frequency_mhz;
     bool thermal_throttling_detected;
+    std::vector<double> per_core_frequency_mhz;
+    std::vector<double> per_core_deep_idle_percent; // interval share in C-states with exit latency >= 20us
+    std::vector<uint64_t> per_core_throttle_events; // thermal_throttle core + package count deltas
+    uint64_t thermal_throttle_events;
     uint64_t context_switches;
     
     // Memory metrics
     double memory_used_mb;
     double memory_available_mb;
     double memory_usage_percent;
-    uint64_t page_faults;
+    uint64_t page_faults; // pgfault events in the interval (totals in averages)
+    VmstatCounters vmstat; // /proc/vmstat events in the interval
     double cache_hit_ratio;
     
     // I/O metrics
@@ -40,17 +65,35 @@ struct ResourceMetrics {
     double load_average_1min;
     double load_average_5min;
     uint32_t active_processes;
+
+    // PSI from /proc/pressure, and from this process's cgroup when it exposes *.pressure
+    bool psi_available;
+    bool cgroup_psi_available;
+    PressureStall cpu_psi;
+    PressureStall memory_psi;
+    PressureStall io_psi;
+    PressureStall cgroup_cpu_psi;
+    PressureStall cgroup_memory_psi;
+    PressureStall cgroup_io_psi;
     
     // Timing
     double monitoring_duration_seconds;
     size_t sample_count;
     double sample_timestamp_seconds;
+    double collection_cpu_us; // monitor thread CPU time spent taking this sample
     
     ResourceMetrics();
     void reset();
     std::string toJson() const;
 };
 
+// cpuidle residency accumulated over a monitoring run, [state][core] in percent of wall time
+struct CStateResidency {
+    std::vector<std::string> names;
+    std::vector<uint64_t> exit_latency_us;
+    std::vector<std::vector<double>> per_core_percent;
+};
+
 // System interference detection
 struct InterferenceReport {
     bool high_background_cpu_usage;
@@ -58,6 +101,13 @@ struct InterferenceReport {
     bool high_io_wait;
     bool network_congestion;
     bool thermal_throttling;
+    bool cpu_contention; // runnable tasks stalled waiting for a CPU (PSI)
+
+    // Worst of system-wide and cgroup "some" stall shares when PSI is available
+    bool psi_available;
+    double cpu_stall_percent;
+    double memory_stall_percent;
+    double io_stall_percent;
     std::vector<std::string> performance_warnings;
     
     InterferenceReport();
@@ -66,15 +116,35 @@ struct InterferenceReport {
 };
 
 class SystemMonitor {
+public:
+    static constexpr int DEFAULT_SAMPLE_INTERVAL_MS = 250;
+    static constexpr int MIN_SAMPLE_INTERVAL_MS = 10;
+
 private:
     std::atomic<bool> monitoring_active;
     std::thread monitor_thread;
+    // Running sums and peaks over every sample, so averages cover the whole run
+    // even after the ring has overwritten its oldest entries
     ResourceMetrics accumulated_metrics;
-    std::vector<ResourceMetrics> samples;
+    ResourceMetrics peak_metrics;
+    uint64_t accumulated_processes { 0 };
+    size_t sample_total { 0 };
+
+    TelemetryRing telemetry_ring;
+    size_t telemetry_capacity { TelemetryRing::DEFAULT_CAPACITY };
+    TelemetryWriter telemetry_stream;
+    InterferencePolicy interference_policy;
+    InterferenceWatch interference_watch;
     Timer monitoring_timer;
+    int sample_interval_ms { DEFAULT_SAMPLE_INTERVAL_MS };
+
+    // Monitor thread CPU time against wall time over the last monitoring run
+    double self_cpu_seconds { 0.0 };
+    double self_wall_seconds { 0.0 };
     
     // Platform-specific monitoring implementations
     void monitoringLoop();
+    void recordSample(const ResourceMetrics& sample);
     ResourceMetrics collectLinuxMetrics();
     ResourceMetrics collectMacOSMetrics();
     
@@ -101,27 +171,88 @@ private:
         uint64_t active() const { return total() - idle - iowait; }
     };
 
-    std::vector<CpuTimes> readCpuTimes(CpuTimes& total_times);
+    // Kept open for the monitor's lifetime and re-read with pread each sample
+    ProcFile stat_file;
+    ProcFile meminfo_file;
+    ProcFile diskstats_file;
+    ProcFile netdev_file;
+    ProcFile loadavg_file;
+    ProcFile frequency_file;
+    ProcFile thermal_file;
+    ProcFile vmstat_file;
+    VmstatCounters previous_vmstat;
+    void sampleVmstat(ResourceMetrics& metrics);
+    double previous_process_cpu_seconds{0.0};
+    double processTreeCpuSeconds();
+
+    // Forked helpers: every thread's children list and every live child's
+    // schedstat stay open; the task list is only rescanned when threads change
+    struct ChildCpuSource {
+        uint64_t pid{0};
+        ProcFile schedstat;
+        bool listed{false};
+    };
+    ProcFile self_stat_file;
+    uint64_t child_task_threads{0};
+    std::vector<ProcFile> child_task_files;
+    std::vector<ChildCpuSource> child_cpu_sources;
+    uint64_t selfThreadCount();
+    void refreshChildTaskFiles();
+    std::vector<ProcFile> core_frequency_files;
+    bool frequency_from_cpuinfo{false};
+    bool proc_files_opened{false};
+    void openProcFiles();
+
+    bool readCpuTimes(std::vector<CpuTimes>& times, CpuTimes& total_times);
+
+    struct PressureSource {
+        ProcFile file;
+        uint64_t previous_some_total{0};
+        uint64_t previous_full_total{0};
+        bool has_previous{false};
+    };
+    // cpu, memory and io under /proc/pressure, then the same for the cgroup
+    static constexpr size_t PRESSURE_RESOURCES = 3;
+    PressureSource system_pressure[PRESSURE_RESOURCES];
+    PressureSource cgroup_pressure[PRESSURE_RESOURCES];
+    bool readPressure(PressureSource& source, double elapsed_seconds, PressureStall& stall);
+
+    // Per-core cpuidle and thermal_throttle counters, opened once like the /proc sources;
+    // files that do not exist stay closed and are skipped
+    size_t core_count{0};
+    std::vector<std::string> cstate_names;
+    std::vector<uint64_t> cstate_latency_us;
+    std::vector<ProcFile> cstate_time_files; // [core * states + state]
+    std::vector<ProcFile> throttle_files;    // [core * 2 + core/package]
+    std::vector<uint64_t> previous_cstate_time_us;
+    std::vector<uint64_t> previous_throttle_counts;
+    std::vector<uint64_t> cstate_residency_us;
+    double cstate_elapsed_seconds{0.0};
+    bool core_counters_initialized{false};
+    void openCoreSources();
+    void sampleCoreCounters(double elapsed_seconds, ResourceMetrics& metrics);
     std::vector<CpuTimes> previous_cpu_times;
+    std::vector<CpuTimes> current_cpu_times;
     CpuTimes previous_cpu_total;
     bool cpu_times_initialized{false};
     double last_io_wait_percent{0.0};
+    uint32_t last_process_count{0};
     bool has_last_sample_time{false};
     std::chrono::steady_clock::time_point last_sample_time{};
 
-    struct DiskSnapshot {
-        uint64_t read_sectors{0};
-        uint64_t write_sectors{0};
-        uint64_t reads_completed{0};
-        uint64_t writes_completed{0};
-    };
-    std::map<std::string, DiskSnapshot> previous_disk_stats;
+    // Device and interface tables are matched by name and reused across samples
+    static constexpr size_t DEVICE_NAME_LENGTH = 32;
+
+    std::vector<DiskDeviceCounters> previous_disk_stats;
+    std::vector<DiskDeviceCounters> current_disk_stats;
 
     struct NetSnapshot {
+        char name[DEVICE_NAME_LENGTH]{};
         uint64_t rx_bytes{0};
         uint64_t tx_bytes{0};
     };
-    std::map<std::string, NetSnapshot> previous_net_stats;
+    std::vector<NetSnapshot> previous_net_stats;
+    std::vector<NetSnapshot> current_net_stats;
 #endif
 
 public:
@@ -132,11 +263,36 @@ public:
     void startMonitoring();
     void stopMonitoring();
     bool isMonitoring() const;
+
+    // Sampling period, clamped to MIN_SAMPLE_INTERVAL_MS; takes effect on the next start
+    void setSampleInterval(int milliseconds);
+    int getSampleInterval() const { return sample_interval_ms; }
+
+    // CPU the monitor thread itself used, as a percentage of one core
+    double getSelfOverheadPercent() const;
+    double getSelfCpuSeconds() const { return self_cpu_seconds; }
     
+    CStateResidency getCStateResidency() const;
+
+    // Samples kept in memory for getAllSamples() and writeSamplesToFile(); takes effect on the next start
+    void setTelemetryCapacity(size_t samples);
+    // Streams every sample to path (.csv, .json or .bin) as it is taken, across
+    // start/stop cycles, until closeTelemetryStream()
+    bool openTelemetryStream(const std::string& path);
+    bool closeTelemetryStream();
+    uint64_t getStreamedSampleCount() const { return telemetry_stream.recordsWritten(); }
+
+    // Every sample is checked against the policy; takes effect on the next start
+    void setInterferencePolicy(const InterferencePolicy& policy) { interference_policy = policy; }
+    const InterferenceWatch& getInterferenceWatch() const { return interference_watch; }
+
     // Results retrieval
     ResourceMetrics getAverageMetrics();
     ResourceMetrics getPeakMetrics();
+    size_t getSampleCount() const { return sample_total; }
+    // The retained window only: the most recent samples up to the ring capacity
     std::vector<ResourceMetrics> getAllSamples();
+    uint64_t getOverwrittenSampleCount() const { return telemetry_ring.overwritten(); }
     ResourceMetrics collectCurrentMetrics();
     bool writeSamplesToFile(const std::string& path) const;
     
@@ -0,0 +1,340 @@
+#include "telemetry.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+
+namespace {
+
+// Binary files start with this header; records use the writer's native byte order
+struct TelemetryFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t core_count;
+    uint32_t sample_interval_ms;
+};
+
+const char TELEMETRY_MAGIC[8] = { 'P', 'T', 'T', 'E', 'L', 'E', 'M', '\0' };
+const uint32_t TELEMETRY_VERSION = 3;
+const size_t WRITE_BUFFER_BYTES = 64 * 1024;
+
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value, "TelemetryRecord is written as raw bytes");
+// One double, 24 floats and 8 uint32 fields with no padding anywhere, so the
+// raw bytes of a record are exactly its fields
+static_assert(sizeof(TelemetryRecord) == sizeof(double) + 24 * sizeof(float) + 8 * sizeof(uint32_t),
+    "TelemetryRecord must have no padding");
+
+bool endsWith(const std::string& value, const char* suffix)
+{
+    size_t n = strlen(suffix);
+    if (value.size() < n) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(value[value.size() - n + i])) != suffix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void writeSeries(std::ostream& out, const float* values, size_t count, char separator)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (i) {
+            out << separator;
+        }
+        out << values[i];
+    }
+}
+
+}
+
+void TelemetryRing::reset(size_t capacity, size_t core_count)
+{
+    slots = std::max<size_t>(1, capacity);
+    cores = core_count;
+    records.assign(slots, TelemetryRecord {});
+    core_values.assign(slots * cores * 2, 0.0f);
+    next_slot = 0;
+    count = 0;
+    pushed = 0;
+}
+
+void TelemetryRing::push(const TelemetryRecord& record, const std::vector<double>& core_frequency_mhz,
+    const std::vector<double>& core_deep_idle_percent)
+{
+    if (slots == 0) {
+        return;
+    }
+    records[next_slot] = record;
+    float* frequency = &core_values[next_slot * cores * 2];
+    float* deep_idle = frequency + cores;
+    for (size_t core = 0; core < cores; ++core) {
+        frequency[core] = core < core_frequency_mhz.size() ? static_cast<float>(core_frequency_mhz[core]) : 0.0f;
+        deep_idle[core] = core < core_deep_idle_percent.size() ? static_cast<float>(core_deep_idle_percent[core]) : 0.0f;
+    }
+    next_slot = (next_slot + 1) % slots;
+    count = std::min(count + 1, slots);
+    ++pushed;
+}
+
+TelemetryFormat telemetryFormatForPath(const std::string& path)
+{
+    if (endsWith(path, ".bin")) {
+        return TelemetryFormat::Binary;
+    }
+    if (endsWith(path, ".json")) {
+        return TelemetryFormat::Json;
+    }
+    return TelemetryFormat::Csv;
+}
+
+TelemetryWriter::~TelemetryWriter()
+{
+    close();
+}
+
+bool TelemetryWriter::open(const std::string& path, size_t core_count, int sample_interval_ms)
+{
+    close();
+    if (path.empty()) {
+        return false;
+    }
+    TelemetryFormat path_format = telemetryFormatForPath(path);
+
+    // The buffer has to be installed before the file is opened to take effect
+    file_buffer.resize(WRITE_BUFFER_BYTES);
+    file.rdbuf()->pubsetbuf(file_buffer.data(), static_cast<std::streamsize>(file_buffer.size()));
+    file.open(path, path_format == TelemetryFormat::Binary ? std::ios::out | std::ios::binary | std::ios::trunc
+                                                           : std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    return open(file, path_format, core_count, sample_interval_ms);
+}
+
+bool TelemetryWriter::open(std::ostream& stream, TelemetryFormat stream_format, size_t core_count,
+    int sample_interval_ms)
+{
+    out = &stream;
+    format = stream_format;
+    cores = core_count;
+    written = 0;
+    writeHeader(sample_interval_ms);
+    return out->good();
+}
+
+void TelemetryWriter::writeHeader(int sample_interval_ms)
+{
+    switch (format) {
+    case TelemetryFormat::Binary: {
+        TelemetryFileHeader header {};
+        memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+        header.version = TELEMETRY_VERSION;
+        header.record_size = sizeof(TelemetryRecord);
+        header.core_count = static_cast<uint32_t>(cores);
+        header.sample_interval_ms = static_cast<uint32_t>(std::max(0, sample_interval_ms));
+        out->write(reinterpret_cast<const char*>(&header), sizeof(header));
+        break;
+    }
+    case TelemetryFormat::Json:
+        *out << "[\n";
+        break;
+    case TelemetryFormat::Csv:
+        *out << "index,timestamp_s,cpu_usage_percent,cpu_frequency_mhz,io_wait_percent,";
+        *out << "memory_used_mb,memory_available_mb,memory_usage_percent,disk_read_mbps,disk_write_mbps,";
+        *out << "network_rx_mbps,network_tx_mbps,load_average_1min,load_average_5min,thermal_throttling,collection_cpu_us,";
+        *out << "cpu_psi_some_percent,memory_psi_some_percent,memory_psi_full_percent,io_psi_some_percent,io_psi_full_percent,";
+        // Per-core series are ';'-separated within a single column
+        *out << "thermal_throttle_events,per_core_frequency_mhz,per_core_deep_idle_percent,";
+        // Columns added later go at the end so positional readers keep working
+        *out << "page_faults,major_page_faults,direct_scanned_pages,compact_stalls,process_cpu_percent,";
+        *out << "cgroup_cpu_psi_some_percent,cgroup_memory_psi_some_percent,cgroup_memory_psi_full_percent,";
+        *out << "cgroup_io_psi_some_percent,cgroup_io_psi_full_percent,active_processes\n";
+        break;
+    }
+}
+
+void TelemetryWriter::append(uint64_t index, const TelemetryRecord& s, const float* core_frequency_mhz,
+    const float* core_deep_idle_percent)
+{
+    if (out == nullptr) {
+        return;
+    }
+    bool throttling = (s.flags & TelemetryRecord::THERMAL_THROTTLING) != 0;
+
+    switch (format) {
+    case TelemetryFormat::Binary:
+        out->write(reinterpret_cast<const char*>(&s), sizeof(s));
+        out->write(reinterpret_cast<const char*>(core_frequency_mhz), static_cast<std::streamsize>(cores * sizeof(float)));
+        out->write(reinterpret_cast<const char*>(core_deep_idle_percent), static_cast<std::streamsize>(cores * sizeof(float)));
+        break;
+    case TelemetryFormat::Json:
+        if (written > 0) {
+            *out << ",\n";
+        }
+        *out << "  {\n";
+        *out << "    \"index\": " << index << ",\n";
+        *out << "    \"timestamp_s\": " << std::fixed << std::setprecision(3) << s.timestamp_seconds << ",\n";
+        *out << "    \"cpu_usage_percent\": " << s.cpu_usage_percent << ",\n";
+        *out << "    \"process_cpu_percent\": " << s.process_cpu_percent << ",\n";
+        *out << "    \"cpu_frequency_mhz\": " << s.cpu_frequency_mhz << ",\n";
+        *out << "    \"io_wait_percent\": " << s.io_wait_percent << ",\n";
+        *out << "    \"memory_used_mb\": " << s.memory_used_mb << ",\n";
+        *out << "    \"memory_available_mb\": " << s.memory_available_mb << ",\n";
+        *out << "    \"memory_usage_percent\": " << s.memory_usage_percent << ",\n";
+        *out << "    \"disk_read_mbps\": " << s.disk_read_mbps << ",\n";
+        *out << "    \"disk_write_mbps\": " << s.disk_write_mbps << ",\n";
+        *out << "    \"network_rx_mbps\": " << s.network_rx_mbps << ",\n";
+        *out << "    \"network_tx_mbps\": " << s.network_tx_mbps << ",\n";
+        *out << "    \"load_average_1min\": " << s.load_average_1min << ",\n";
+        *out << "    \"load_average_5min\": " << s.load_average_5min << ",\n";
+        *out << "    \"thermal_throttling\": " << (throttling ? "true" : "false") << ",\n";
+        *out << "    \"collection_cpu_us\": " << s.collection_cpu_us << ",\n";
+        *out << "    \"cpu_psi_some_percent\": " << s.cpu_psi_some_percent << ",\n";
+        *out << "    \"memory_psi_some_percent\": " << s.memory_psi_some_percent << ",\n";
+        *out << "    \"memory_psi_full_percent\": " << s.memory_psi_full_percent << ",\n";
+        *out << "    \"io_psi_some_percent\": " << s.io_psi_some_percent << ",\n";
+        *out << "    \"io_psi_full_percent\": " << s.io_psi_full_percent << ",\n";
+        *out << "    \"thermal_throttle_events\": " << s.thermal_throttle_events << ",\n";
+        *out << "    \"page_faults\": " << s.page_faults << ",\n";
+        *out << "    \"major_page_faults\": " << s.major_page_faults << ",\n";
+        *out << "    \"direct_scanned_pages\": " << s.direct_scanned_pages << ",\n";
+        *out << "    \"compact_stalls\": " << s.compact_stalls << ",\n";
+        *out << "    \"cgroup_cpu_psi_some_percent\": " << s.cgroup_cpu_psi_some_percent << ",\n";
+        *out << "    \"cgroup_memory_psi_some_percent\": " << s.cgroup_memory_psi_some_percent << ",\n";
+        *out << "    \"cgroup_memory_psi_full_percent\": " << s.cgroup_memory_psi_full_percent << ",\n";
+        *out << "    \"cgroup_io_psi_some_percent\": " << s.cgroup_io_psi_some_percent << ",\n";
+        *out << "    \"cgroup_io_psi_full_percent\": " << s.cgroup_io_psi_full_percent << ",\n";
+        *out << "    \"active_processes\": " << s.active_processes << ",\n";
+        *out << "    \"per_core_frequency_mhz\": [";
+        writeSeries(*out, core_frequency_mhz, cores, ',');
+        *out << "],\n";
+        *out << "    \"per_core_deep_idle_percent\": [";
+        writeSeries(*out, core_deep_idle_percent, cores, ',');
+        *out << "]\n";
+        *out << "  }";
+        break;
+    case TelemetryFormat::Csv:
+        *out << index << ','
+             << std::fixed << std::setprecision(3) << s.timestamp_seconds << ','
+             << s.cpu_usage_percent << ','
+             << s.cpu_frequency_mhz << ','
+             << s.io_wait_percent << ','
+             << s.memory_used_mb << ','
+             << s.memory_available_mb << ','
+             << s.memory_usage_percent << ','
+             << s.disk_read_mbps << ','
+             << s.disk_write_mbps << ','
+             << s.network_rx_mbps << ','
+             << s.network_tx_mbps << ','
+             << s.load_average_1min << ','
+             << s.load_average_5min << ','
+             << (throttling ? 1 : 0) << ','
+             << s.collection_cpu_us << ','
+             << s.cpu_psi_some_percent << ','
+             << s.memory_psi_some_percent << ','
+             << s.memory_psi_full_percent << ','
+             << s.io_psi_some_percent << ','
+             << s.io_psi_full_percent << ','
+             << s.thermal_throttle_events << ',';
+        writeSeries(*out, core_frequency_mhz, cores, ';');
+        *out << ',';
+        writeSeries(*out, core_deep_idle_percent, cores, ';');
+        *out << ','
+             << s.page_faults << ','
+             << s.major_page_faults << ','
+             << s.direct_scanned_pages << ','
+             << s.compact_stalls << ','
+             << s.process_cpu_percent << ','
+             << s.cgroup_cpu_psi_some_percent << ','
+             << s.cgroup_memory_psi_some_percent << ','
+             << s.cgroup_memory_psi_full_percent << ','
+             << s.cgroup_io_psi_some_percent << ','
+             << s.cgroup_io_psi_full_percent << ','
+             << s.active_processes << '\n';
+        break;
+    }
+    ++written;
+}
+
+void TelemetryWriter::flush()
+{
+    if (out != nullptr) {
+        out->flush();
+    }
+}
+
+bool TelemetryWriter::close()
+{
+    if (out == nullptr) {
+        return false;
+    }
+    if (format == TelemetryFormat::Json) {
+        *out << (written > 0 ? "\n]\n" : "]\n");
+    }
+    out->flush();
+    bool ok = out->good();
+    out = nullptr;
+    if (file.is_open()) {
+        file.close();
+        ok = ok && !file.fail();
+    }
+    return ok;
+}
+
+bool decodeTelemetryFile(const std::string& input_path, const std::string& output_path, std::string& error)
+{
+    std::ifstream in(input_path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "cannot open " + input_path;
+        return false;
+    }
+
+    TelemetryFileHeader header {};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, TELEMETRY_MAGIC, sizeof(header.magic)) != 0) {
+        error = input_path + " is not a binary telemetry file";
+        return false;
+    }
+    if (header.version != TELEMETRY_VERSION || header.record_size != sizeof(TelemetryRecord)) {
+        error = "unsupported telemetry version " + std::to_string(header.version) + " (record size " +
+            std::to_string(header.record_size) + "); this build reads only version " +
+            std::to_string(TELEMETRY_VERSION) + " (record size " + std::to_string(sizeof(TelemetryRecord)) +
+            "), decode the file with the build that wrote it";
+        return false;
+    }
+
+    TelemetryWriter writer;
+    bool opened = output_path.empty()
+        ? writer.open(std::cout, TelemetryFormat::Csv, header.core_count, static_cast<int>(header.sample_interval_ms))
+        : writer.open(output_path, header.core_count, static_cast<int>(header.sample_interval_ms));
+    if (!opened) {
+        error = "cannot write " + output_path;
+        return false;
+    }
+
+    TelemetryRecord record {};
+    std::vector<float> core_values(static_cast<size_t>(header.core_count) * 2, 0.0f);
+    const std::streamsize core_bytes = static_cast<std::streamsize>(core_values.size() * sizeof(float));
+    for (uint64_t index = 0;; ++index) {
+        if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            // A run that was killed mid-write leaves a partial last record
+            break;
+        }
+        if (core_bytes > 0 && !in.read(reinterpret_cast<char*>(core_values.data()), core_bytes)) {
+            break;
+        }
+        writer.append(index, record, core_values.data(), core_values.data() + header.core_count);
+    }
+
+    if (!writer.close()) {
+        error = "error writing " + (output_path.empty() ? std::string("stdout") : output_path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,133 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// One system monitor sample in a fixed layout. This is what the in-memory
+// ring retains and what a binary telemetry stream stores, followed by the
+// per-core frequency and deep-idle series (core_count floats each).
+struct TelemetryRecord {
+    enum Flags : uint32_t {
+        THERMAL_THROTTLING = 1u << 0,
+        PSI_AVAILABLE = 1u << 1,
+        CGROUP_PSI_AVAILABLE = 1u << 2,
+    };
+
+    double timestamp_seconds;
+    float cpu_usage_percent;
+    float process_cpu_percent;
+    float cpu_frequency_mhz;
+    float io_wait_percent;
+    float memory_used_mb;
+    float memory_available_mb;
+    float memory_usage_percent;
+    float disk_read_mbps;
+    float disk_write_mbps;
+    float network_rx_mbps;
+    float network_tx_mbps;
+    float load_average_1min;
+    float load_average_5min;
+    float collection_cpu_us;
+    float cpu_psi_some_percent;
+    float memory_psi_some_percent;
+    float memory_psi_full_percent;
+    float io_psi_some_percent;
+    float io_psi_full_percent;
+    float cgroup_cpu_psi_some_percent;
+    float cgroup_memory_psi_some_percent;
+    float cgroup_memory_psi_full_percent;
+    float cgroup_io_psi_some_percent;
+    float cgroup_io_psi_full_percent;
+    uint32_t active_processes;
+    uint32_t thermal_throttle_events;
+    uint32_t page_faults;
+    uint32_t major_page_faults;
+    uint32_t direct_scanned_pages; // pages scanned by direct reclaim
+    uint32_t compact_stalls;
+    uint32_t flags;
+    uint32_t reserved; // keeps the size a multiple of 8
+};
+
+// Fixed-capacity ring of the most recent samples. All storage is allocated
+// by reset(), so memory stays flat however long the monitor runs; once full,
+// each push overwrites the oldest sample.
+class TelemetryRing {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+private:
+    std::vector<TelemetryRecord> records;
+    std::vector<float> core_values; // [slot][frequency cores..., deep idle cores...]
+    size_t slots { 0 };
+    size_t cores { 0 };
+    size_t next_slot { 0 };
+    size_t count { 0 };
+    uint64_t pushed { 0 };
+
+    size_t slotOf(size_t position) const { return (next_slot + slots - count + position) % slots; }
+
+public:
+    void reset(size_t capacity, size_t core_count);
+    void push(const TelemetryRecord& record, const std::vector<double>& core_frequency_mhz,
+        const std::vector<double>& core_deep_idle_percent);
+
+    size_t size() const { return count; }
+    size_t capacity() const { return slots; }
+    size_t coreCount() const { return cores; }
+    uint64_t totalPushed() const { return pushed; }
+    uint64_t overwritten() const { return pushed - count; }
+
+    // Position 0 is the oldest retained sample
+    const TelemetryRecord& record(size_t position) const { return records[slotOf(position)]; }
+    const float* coreFrequency(size_t position) const { return &core_values[slotOf(position) * cores * 2]; }
+    const float* coreDeepIdle(size_t position) const { return coreFrequency(position) + cores; }
+    uint64_t sampleIndex(size_t position) const { return pushed - count + position; }
+};
+
+enum class TelemetryFormat { Csv, Json, Binary };
+
+// ".bin" selects the binary format, ".json" JSON, anything else CSV
+TelemetryFormat telemetryFormatForPath(const std::string& path);
+
+// Writes samples one at a time as they are taken. CSV and binary files are
+// valid after every record; JSON gets its closing bracket from close().
+class TelemetryWriter {
+private:
+    std::ofstream file;
+    std::vector<char> file_buffer;
+    std::ostream* out { nullptr };
+    TelemetryFormat format { TelemetryFormat::Csv };
+    size_t cores { 0 };
+    uint64_t written { 0 };
+
+    void writeHeader(int sample_interval_ms);
+
+public:
+    TelemetryWriter() = default;
+    ~TelemetryWriter();
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    bool open(const std::string& path, size_t core_count, int sample_interval_ms);
+    bool open(std::ostream& stream, TelemetryFormat stream_format, size_t core_count, int sample_interval_ms);
+    bool isOpen() const { return out != nullptr; }
+
+    void append(uint64_t index, const TelemetryRecord& record, const float* core_frequency_mhz,
+        const float* core_deep_idle_percent);
+    void flush();
+    bool close();
+
+    uint64_t recordsWritten() const { return written; }
+};
+
+// Converts a binary telemetry file to CSV or JSON, picked by the extension of
+// output_path; an empty output_path writes CSV to stdout
+bool decodeTelemetryFile(const std::string& input_path, const std::string& output_path, std::string& error);
+
+#endif
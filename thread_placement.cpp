@@ -0,0 +1,316 @@
+#include "thread_placement.h"
+#include "cgroup.h"
+#include "cpu_topology.h"
+#include "utils.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace {
+
+struct PolicyName {
+    PlacementPolicy policy;
+    const char* name;
+};
+
+const PolicyName POLICY_NAMES[] = {
+    { PlacementPolicy::SCATTER, "scatter" },
+    { PlacementPolicy::COMPACT, "compact" },
+    { PlacementPolicy::PHYSICAL_CORES, "physical-cores-only" },
+    { PlacementPolicy::PER_NUMA_NODE, "per-numa-node" },
+    { PlacementPolicy::ISOLATED_CPUS, "isolated-cpus-only" },
+};
+
+// Ranges where they save space: "0-3,8"
+std::string formatCpuList(const std::vector<int>& cpus)
+{
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        out << (i ? "," : "") << cpus[i];
+        if (j >= i + 2) {
+            out << "-" << cpus[j];
+        } else if (j == i + 1) {
+            out << "," << cpus[j];
+        }
+        i = j + 1;
+    }
+    return out.str();
+}
+
+// Where a CPU sits; hosts without sysfs topology get one core per CPU
+LogicalCpu locate(const CpuTopology& topology, int id)
+{
+    for (const auto& cpu : topology.cpus) {
+        if (cpu.id == id) {
+            return cpu;
+        }
+    }
+    LogicalCpu cpu;
+    cpu.id = id;
+    cpu.core = id;
+    cpu.smt_siblings.push_back(id);
+    return cpu;
+}
+
+std::tuple<int, int, int, int> compactKey(const LogicalCpu& cpu)
+{
+    return std::make_tuple(cpu.package, cpu.die, cpu.core, cpu.id);
+}
+
+std::vector<int> intersect(const std::vector<int>& wanted, const std::vector<int>& allowed)
+{
+    std::vector<int> cpus;
+    for (int cpu : wanted) {
+        if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+}
+
+bool CpuPlacement::pin(size_t thread_index) const
+{
+    if (slots.empty()) {
+        return false;
+    }
+    const std::vector<int>& cpus = slots[thread_index % slots.size()];
+    if (cpus.size() == 1) {
+        return CPUAffinity::pinThreadToCore(cpus.front());
+    }
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &cpuset);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    return false;
+#endif
+}
+
+std::string CpuPlacement::describe(size_t threads) const
+{
+    std::ostringstream out;
+    for (size_t i = 0; i < threads && !slots.empty(); ++i) {
+        out << (i ? " " : "") << i << ":" << formatCpuList(slots[i % slots.size()]);
+    }
+    return out.str();
+}
+
+void CpuPlacement::record(BenchmarkResult& result, size_t threads) const
+{
+    result.extra_info["placement.policy"] = policy;
+    result.extra_info["placement.cpu_map"] = describe(threads);
+    result.extra_metrics["placement_threads"] = static_cast<double>(threads);
+}
+
+bool ThreadPlacement::parse(const std::string& text, ThreadPlacement& placement)
+{
+    for (const auto& entry : POLICY_NAMES) {
+        if (text == entry.name) {
+            placement.policy = entry.policy;
+            placement.cpus.clear();
+            return true;
+        }
+    }
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c)) && c != ',' && c != '-') {
+            return false;
+        }
+    }
+    placement.policy = PlacementPolicy::EXPLICIT;
+    placement.cpus = Cgroup::parseCpuList(text);
+    return !placement.cpus.empty();
+}
+
+std::string ThreadPlacement::name() const
+{
+    if (policy == PlacementPolicy::EXPLICIT) {
+        return "cpus " + formatCpuList(cpus);
+    }
+    for (const auto& entry : POLICY_NAMES) {
+        if (entry.policy == policy) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+CpuPlacement ThreadPlacement::resolve() const
+{
+    const CpuTopology& topology = CpuTopology::host();
+    CgroupLimits limits = Cgroup::readLimits();
+
+    // Isolated CPUs are normally outside the inherited affinity mask, so
+    // they and explicit lists are only held to the cgroup cpuset
+    std::vector<int> allowed;
+    if (policy == PlacementPolicy::ISOLATED_CPUS || policy == PlacementPolicy::EXPLICIT) {
+        allowed = limits.effective_cpus;
+        if (allowed.empty()) {
+            for (const auto& cpu : topology.cpus) {
+                allowed.push_back(cpu.id);
+            }
+        }
+        if (allowed.empty()) {
+            allowed = CPUAffinity::getCurrentAffinity();
+        }
+    } else {
+        allowed = CPUAffinity::getCurrentAffinity();
+        if (!limits.effective_cpus.empty()) {
+            std::vector<int> narrowed = intersect(allowed, limits.effective_cpus);
+            if (!narrowed.empty()) {
+                allowed = narrowed;
+            }
+        }
+    }
+    if (allowed.empty()) {
+        allowed.push_back(0);
+    }
+
+    std::vector<LogicalCpu> cpus;
+    for (int id : allowed) {
+        cpus.push_back(locate(topology, id));
+    }
+    std::sort(cpus.begin(), cpus.end(), [](const LogicalCpu& a, const LogicalCpu& b) {
+        return compactKey(a) < compactKey(b);
+    });
+
+    CpuPlacement placement;
+    placement.policy = name();
+    switch (policy) {
+    case PlacementPolicy::COMPACT:
+        for (const auto& cpu : cpus) {
+            placement.slots.push_back({ cpu.id });
+        }
+        break;
+    case PlacementPolicy::PHYSICAL_CORES: {
+        std::set<std::tuple<int, int, int>> seen;
+        for (const auto& cpu : cpus) {
+            if (seen.insert(std::make_tuple(cpu.package, cpu.die, cpu.core)).second) {
+                placement.slots.push_back({ cpu.id });
+            }
+        }
+        break;
+    }
+    case PlacementPolicy::SCATTER: {
+        // Cores grouped by (node, package); the k-th core of every group is
+        // taken before any group's (k+1)-th, and first siblings before second
+        std::map<std::pair<int, int>, std::vector<std::vector<int>>> domains;
+        std::map<std::tuple<int, int, int>, std::pair<int, int>> core_domain;
+        std::map<std::tuple<int, int, int>, size_t> core_index;
+        for (const auto& cpu : cpus) {
+            auto core = std::make_tuple(cpu.package, cpu.die, cpu.core);
+            auto found = core_index.find(core);
+            if (found == core_index.end()) {
+                std::pair<int, int> domain(cpu.node, cpu.package);
+                core_domain[core] = domain;
+                core_index[core] = domains[domain].size();
+                domains[domain].push_back({ cpu.id });
+            } else {
+                domains[core_domain[core]][found->second].push_back(cpu.id);
+            }
+        }
+        size_t max_cores = 0;
+        size_t max_threads_per_core = 0;
+        for (const auto& domain : domains) {
+            max_cores = std::max(max_cores, domain.second.size());
+            for (const auto& core : domain.second) {
+                max_threads_per_core = std::max(max_threads_per_core, core.size());
+            }
+        }
+        for (size_t rank = 0; rank < max_threads_per_core; ++rank) {
+            for (size_t k = 0; k < max_cores; ++k) {
+                for (const auto& domain : domains) {
+                    if (k < domain.second.size() && rank < domain.second[k].size()) {
+                        placement.slots.push_back({ domain.second[k][rank] });
+                    }
+                }
+            }
+        }
+        break;
+    }
+    case PlacementPolicy::PER_NUMA_NODE: {
+        std::map<int, std::vector<int>> nodes;
+        for (const auto& cpu : cpus) {
+            nodes[cpu.node].push_back(cpu.id);
+        }
+        for (auto& node : nodes) {
+            std::sort(node.second.begin(), node.second.end());
+            placement.slots.push_back(node.second);
+        }
+        break;
+    }
+    case PlacementPolicy::ISOLATED_CPUS: {
+        std::ifstream file("/sys/devices/system/cpu/isolated");
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> isolated = Cgroup::parseCpuList(line);
+        for (const auto& cpu : cpus) {
+            if (std::find(isolated.begin(), isolated.end(), cpu.id) != isolated.end()) {
+                placement.slots.push_back({ cpu.id });
+            }
+        }
+        if (placement.slots.empty()) {
+            throw std::runtime_error("No isolated CPUs available (/sys/devices/system/cpu/isolated is \"" + line + "\")");
+        }
+        break;
+    }
+    case PlacementPolicy::EXPLICIT:
+        for (int cpu : this->cpus) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) == allowed.end()) {
+                throw std::runtime_error("CPU " + std::to_string(cpu) + " is not online or not in this cgroup's cpuset");
+            }
+            placement.slots.push_back({ cpu });
+        }
+        break;
+    }
+
+    std::set<int> distinct;
+    for (const auto& slot : placement.slots) {
+        distinct.insert(slot.begin(), slot.end());
+    }
+    placement.max_threads = std::max(1, static_cast<int>(distinct.size()));
+    // More runnable threads than the quota only buys throttling
+    if (limits.cpu_quota_cores > 0.0) {
+        placement.max_threads = std::max(1, std::min(placement.max_threads, static_cast<int>(std::ceil(limits.cpu_quota_cores))));
+    }
+    return placement;
+}
+
+ScopedThreadPin::ScopedThreadPin(const CpuPlacement& placement, size_t thread_index)
+{
+#ifdef __linux__
+    CPU_ZERO(&previous);
+    restore = pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &previous) == 0 && placement.pin(thread_index);
+#else
+    placement.pin(thread_index);
+#endif
+}
+
+ScopedThreadPin::~ScopedThreadPin()
+{
+#ifdef __linux__
+    if (restore) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &previous);
+    }
+#endif
+}
@@ -0,0 +1,66 @@
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+#include "benchmark.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// How benchmark worker threads are spread over the CPUs they may use
+enum class PlacementPolicy {
+    SCATTER, // one thread per physical core, alternating NUMA nodes and packages; SMT siblings last
+    COMPACT, // SMT siblings of a core first, then the next core, then the next package
+    PHYSICAL_CORES, // one CPU per physical core in compact order; SMT siblings are never used
+    PER_NUMA_NODE, // each thread bound to all CPUs of one node, nodes taken in turn
+    ISOLATED_CPUS, // only CPUs in /sys/devices/system/cpu/isolated, in compact order
+    EXPLICIT // a given CPU list, in the given order
+};
+
+// A policy resolved against this host: worker thread i runs on slots[i % slots.size()]
+struct CpuPlacement {
+    std::string policy;
+    std::vector<std::vector<int>> slots;
+    int max_threads { 1 }; // distinct CPUs in the slots, capped by the cgroup CPU quota
+
+    // Pins the calling thread to its slot; false when the call failed
+    bool pin(size_t thread_index) const;
+    // Thread to CPU map of the first threads, e.g. "0:0 1:2 2:1,3"
+    std::string describe(size_t threads) const;
+    // Adds placement.policy, placement.cpu_map and placement_threads to a result
+    void record(BenchmarkResult& result, size_t threads) const;
+};
+
+struct ThreadPlacement {
+    PlacementPolicy policy { PlacementPolicy::SCATTER };
+    std::vector<int> cpus; // EXPLICIT only
+
+    // "scatter", "compact", "physical-cores-only", "per-numa-node",
+    // "isolated-cpus-only" or a CPU list such as "0-3,8"
+    static bool parse(const std::string& text, ThreadPlacement& placement);
+    std::string name() const;
+
+    // Maps the policy onto the CPUs the calling thread may use (the cgroup
+    // cpuset for isolated and explicit CPUs); throws when no CPU qualifies
+    CpuPlacement resolve() const;
+};
+
+// Pins the calling thread to one placement slot and restores its previous
+// affinity when it goes out of scope
+class ScopedThreadPin {
+private:
+#ifdef __linux__
+    cpu_set_t previous;
+#endif
+    bool restore { false };
+
+public:
+    ScopedThreadPin(const CpuPlacement& placement, size_t thread_index);
+    ~ScopedThreadPin();
+    ScopedThreadPin(const ScopedThreadPin&) = delete;
+    ScopedThreadPin& operator=(const ScopedThreadPin&) = delete;
+};
+
+#endif
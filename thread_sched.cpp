@@ -0,0 +1,306 @@
+#include "thread_sched.h"
+#include "utils.h"
+#include <algorithm>
+#include <dirent.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+uint64_t deltaOrZero(uint64_t end, uint64_t start)
+{
+    return end > start ? end - start : 0;
+}
+
+struct ThreadDelta {
+    int tid { 0 };
+    double run_seconds { 0.0 };
+    double wait_seconds { 0.0 };
+    uint64_t voluntary_switches { 0 };
+    uint64_t involuntary_switches { 0 };
+};
+
+}
+
+ThreadSchedTracker::ThreadSchedTracker(int sample_interval_ms)
+    : sample_interval_ms(std::max(10, sample_interval_ms))
+{
+}
+
+ThreadSchedTracker::~ThreadSchedTracker()
+{
+    stop();
+}
+
+bool ThreadSchedTracker::readSample(ThreadRecord& record, ThreadSchedSample& sample)
+{
+    // schedstat: "<run ns> <run-queue wait ns> <timeslices>"
+    bool has_schedstat = false;
+    if (record.schedstat.read() && record.schedstat.size() > 0) {
+        ProcScanner scan(record.schedstat);
+        has_schedstat = scan.nextUint(sample.run_ns) && scan.nextUint(sample.wait_ns) &&
+            scan.nextUint(sample.timeslices);
+    }
+
+    bool has_status = false;
+    if (record.status.read() && record.status.size() > 0) {
+        ProcScanner scan(record.status);
+        while (!scan.atEnd()) {
+            if (scan.consume("Cpus_allowed_list:")) {
+                // "0-3,8,10-11"; the flag vector only grows for CPUs beyond its size
+                std::fill(record.allowed_cpus.begin(), record.allowed_cpus.end(), 0);
+                uint64_t first = 0;
+                while (scan.nextUint(first)) {
+                    uint64_t last = first;
+                    if (scan.consume("-")) {
+                        scan.nextUint(last);
+                    }
+                    if (last >= record.allowed_cpus.size()) {
+                        record.allowed_cpus.resize(last + 1, 0);
+                    }
+                    std::fill(record.allowed_cpus.begin() + first, record.allowed_cpus.begin() + last + 1, 1);
+                    if (!scan.consume(",")) {
+                        break;
+                    }
+                }
+            } else if (scan.consume("voluntary_ctxt_switches:")) {
+                has_status = scan.nextUint(sample.voluntary_switches);
+            } else if (scan.consume("nonvoluntary_ctxt_switches:")) {
+                scan.nextUint(sample.involuntary_switches);
+                break;
+            }
+            scan.skipLine();
+        }
+    }
+
+    return has_schedstat || has_status;
+}
+
+uint64_t ThreadSchedTracker::sampleThreads(bool initial)
+{
+#ifdef __linux__
+    DIR* task_dir = opendir("/proc/self/task");
+    if (task_dir != nullptr) {
+        while (struct dirent* entry = readdir(task_dir)) {
+            if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+                continue;
+            }
+            int tid = std::atoi(entry->d_name);
+            if (tid == sampler_tid) {
+                continue;
+            }
+
+            auto it = records.find(tid);
+            if (it != records.end() && !it->second->alive) {
+                // The kernel reused the id of a thread that already exited
+                retired.push_back(std::move(it->second));
+                records.erase(it);
+                it = records.end();
+            }
+            if (it == records.end()) {
+                auto record = std::make_unique<ThreadRecord>();
+                std::string base = std::string("/proc/self/task/") + entry->d_name;
+                record->schedstat.open(base + "/schedstat", 128);
+                record->status.open(base + "/status", 4096);
+                // Threads born during the run are charged from zero
+                if (initial) {
+                    readSample(*record, record->baseline);
+                }
+                it = records.emplace(tid, std::move(record)).first;
+            }
+        }
+        closedir(task_dir);
+    }
+
+    uint64_t total_wait_ns = 0;
+    for (auto& entry : records) {
+        ThreadRecord& record = *entry.second;
+        if (record.alive) {
+            ThreadSchedSample sample;
+            if (readSample(record, sample)) {
+                record.latest = sample;
+            } else {
+                record.alive = false;
+                record.schedstat.close();
+                record.status.close();
+            }
+        }
+        total_wait_ns += deltaOrZero(record.latest.wait_ns, record.baseline.wait_ns);
+    }
+    for (const auto& record : retired) {
+        total_wait_ns += deltaOrZero(record->latest.wait_ns, record->baseline.wait_ns);
+    }
+    ++samples_taken;
+    return total_wait_ns;
+#else
+    (void)initial;
+    return 0;
+#endif
+}
+
+void ThreadSchedTracker::samplerLoop()
+{
+#ifdef __linux__
+    sampler_tid = static_cast<long>(syscall(SYS_gettid));
+#endif
+    const auto interval = std::chrono::milliseconds(sample_interval_ms);
+    auto previous_time = std::chrono::steady_clock::now();
+    uint64_t previous_wait_ns = sampleThreads(false);
+
+    while (active.load()) {
+        std::this_thread::sleep_for(interval);
+        auto now = std::chrono::steady_clock::now();
+        uint64_t wait_ns = sampleThreads(false);
+
+        // Threads waiting per wall second; 1.0 means one thread was always queued
+        double elapsed_ns = std::chrono::duration<double, std::nano>(now - previous_time).count();
+        if (elapsed_ns > 0.0) {
+            peak_wait_ratio = std::max(peak_wait_ratio, deltaOrZero(wait_ns, previous_wait_ns) / elapsed_ns);
+        }
+        previous_time = now;
+        previous_wait_ns = wait_ns;
+    }
+}
+
+void ThreadSchedTracker::start()
+{
+    if (active.load()) {
+        return;
+    }
+    records.clear();
+    retired.clear();
+    sampler_tid = -1;
+    peak_wait_ratio = 0.0;
+    samples_taken = 0;
+    wall_seconds = 0.0;
+
+    start_time = std::chrono::steady_clock::now();
+    sampleThreads(true);
+    active = true;
+    sampler = std::thread(&ThreadSchedTracker::samplerLoop, this);
+}
+
+void ThreadSchedTracker::stop()
+{
+    if (!active.exchange(false)) {
+        return;
+    }
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+    sampleThreads(false);
+    wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+std::vector<int> ThreadSchedTracker::pinnedCpus() const
+{
+    size_t online = static_cast<size_t>(std::max(1, CPUAffinity::getNumCores()));
+    std::vector<uint8_t> pinned;
+    auto collect = [&](const ThreadRecord& record) {
+        bool ran = record.latest.run_ns > record.baseline.run_ns ||
+            record.latest.voluntary_switches + record.latest.involuntary_switches >
+                record.baseline.voluntary_switches + record.baseline.involuntary_switches;
+        size_t allowed = static_cast<size_t>(std::count(record.allowed_cpus.begin(), record.allowed_cpus.end(), 1));
+        if (!ran || allowed == 0 || allowed >= online) {
+            return;
+        }
+        if (pinned.size() < record.allowed_cpus.size()) {
+            pinned.resize(record.allowed_cpus.size(), 0);
+        }
+        for (size_t cpu = 0; cpu < record.allowed_cpus.size(); ++cpu) {
+            pinned[cpu] |= record.allowed_cpus[cpu];
+        }
+    };
+    for (const auto& entry : records) {
+        collect(*entry.second);
+    }
+    for (const auto& record : retired) {
+        collect(*record);
+    }
+
+    std::vector<int> cpus;
+    for (size_t cpu = 0; cpu < pinned.size(); ++cpu) {
+        if (pinned[cpu]) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+void ThreadSchedTracker::apply(BenchmarkResult& result) const
+{
+    std::vector<ThreadDelta> threads;
+    auto collect = [&](int tid, const ThreadRecord& record) {
+        ThreadDelta delta;
+        delta.tid = tid;
+        delta.run_seconds = deltaOrZero(record.latest.run_ns, record.baseline.run_ns) / NANOSECONDS_PER_SECOND;
+        delta.wait_seconds = deltaOrZero(record.latest.wait_ns, record.baseline.wait_ns) / NANOSECONDS_PER_SECOND;
+        delta.voluntary_switches = deltaOrZero(record.latest.voluntary_switches, record.baseline.voluntary_switches);
+        delta.involuntary_switches = deltaOrZero(record.latest.involuntary_switches, record.baseline.involuntary_switches);
+        // Threads that never ran during the benchmark are not workers
+        if (delta.run_seconds > 0.0 || delta.wait_seconds > 0.0) {
+            threads.push_back(delta);
+        }
+    };
+    for (const auto& entry : records) {
+        collect(entry.first, *entry.second);
+    }
+    for (const auto& record : retired) {
+        collect(0, *record);
+    }
+
+    if (threads.empty() || wall_seconds <= 0.0) {
+        result.extra_info["sched.source"] = "unavailable";
+        return;
+    }
+
+    double run_total = 0.0;
+    double wait_total = 0.0;
+    double worker_share_sum = 0.0;
+    double worker_share_max = 0.0;
+    uint64_t voluntary_total = 0;
+    uint64_t involuntary_total = 0;
+    for (const auto& thread : threads) {
+        run_total += thread.run_seconds;
+        wait_total += thread.wait_seconds;
+        voluntary_total += thread.voluntary_switches;
+        involuntary_total += thread.involuntary_switches;
+        double share = std::min(1.0, thread.wait_seconds / wall_seconds);
+        worker_share_sum += share;
+        worker_share_max = std::max(worker_share_max, share);
+    }
+
+    result.extra_metrics["sched_threads"] = static_cast<double>(threads.size());
+    result.extra_metrics["sched_run_seconds"] = run_total;
+    result.extra_metrics["sched_wait_seconds"] = wait_total;
+    result.extra_metrics["sched_wait_share"] = run_total + wait_total > 0.0 ? wait_total / (run_total + wait_total) : 0.0;
+    result.extra_metrics["sched_worker_wait_share_avg"] = worker_share_sum / threads.size();
+    result.extra_metrics["sched_worker_wait_share_max"] = worker_share_max;
+    result.extra_metrics["sched_peak_wait_ratio"] = peak_wait_ratio;
+    result.extra_metrics["sched_voluntary_switches"] = static_cast<double>(voluntary_total);
+    result.extra_metrics["sched_involuntary_switches"] = static_cast<double>(involuntary_total);
+    result.extra_metrics["sched_samples"] = static_cast<double>(samples_taken);
+
+    // The threads that waited longest for a CPU, as share of the run's wall time
+    std::sort(threads.begin(), threads.end(), [](const ThreadDelta& a, const ThreadDelta& b) {
+        return a.wait_seconds > b.wait_seconds;
+    });
+    std::ostringstream top;
+    top << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < std::min<size_t>(4, threads.size()); ++i) {
+        const auto& thread = threads[i];
+        top << (i ? "; " : "") << "tid " << (thread.tid > 0 ? std::to_string(thread.tid) : std::string("exited"))
+            << ": run " << thread.run_seconds * MILLISECONDS_PER_SECOND << "ms, wait "
+            << thread.wait_seconds * MILLISECONDS_PER_SECOND << "ms ("
+            << thread.wait_seconds / wall_seconds * 100.0 << "% of wall), "
+            << thread.voluntary_switches << "/" << thread.involuntary_switches << " vol/invol switches";
+    }
+    result.extra_info["sched.top_waiters"] = top.str();
+    result.extra_info["sched.source"] = run_total > 0.0 ? "schedstat" : "status_only";
+}
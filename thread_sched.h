@@ -0,0 +1,73 @@
+#ifndef THREAD_SCHED_H
+#define THREAD_SCHED_H
+
+#include "benchmark.h"
+#include "proc_reader.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Scheduler counters for one thread from /proc/self/task/<tid>/{schedstat,status}
+struct ThreadSchedSample {
+    uint64_t run_ns { 0 };
+    uint64_t wait_ns { 0 };
+    uint64_t timeslices { 0 };
+    uint64_t voluntary_switches { 0 };
+    uint64_t involuntary_switches { 0 };
+};
+
+// Per-thread scheduling accounting for the threads of this process. Threads
+// are sampled at start, every sample interval and at stop, so workers that
+// start and exit during the run are still captured. Run-queue wait is the
+// time a runnable thread spent waiting for a CPU, which CPU% averages hide.
+class ThreadSchedTracker {
+private:
+    struct ThreadRecord {
+        ProcFile schedstat;
+        ProcFile status;
+        ThreadSchedSample baseline;
+        ThreadSchedSample latest;
+        std::vector<uint8_t> allowed_cpus; // latest Cpus_allowed_list as a per-CPU flag
+        bool alive { true };
+    };
+
+    int sample_interval_ms;
+    std::atomic<bool> active { false };
+    std::thread sampler;
+    std::map<int, std::unique_ptr<ThreadRecord>> records;
+    std::vector<std::unique_ptr<ThreadRecord>> retired;
+    long sampler_tid { -1 };
+    std::chrono::steady_clock::time_point start_time;
+    double wall_seconds { 0.0 };
+    double peak_wait_ratio { 0.0 };
+    uint64_t samples_taken { 0 };
+
+    static bool readSample(ThreadRecord& record, ThreadSchedSample& sample);
+    uint64_t sampleThreads(bool initial);
+    void samplerLoop();
+
+public:
+    static constexpr int DEFAULT_SAMPLE_INTERVAL_MS = 100;
+
+    explicit ThreadSchedTracker(int sample_interval_ms = DEFAULT_SAMPLE_INTERVAL_MS);
+    ~ThreadSchedTracker();
+
+    ThreadSchedTracker(const ThreadSchedTracker&) = delete;
+    ThreadSchedTracker& operator=(const ThreadSchedTracker&) = delete;
+
+    void start();
+    void stop();
+
+    // Adds sched_* metrics and the busiest threads to the result
+    void apply(BenchmarkResult& result) const;
+
+    // Union of the CPUs that threads with a narrowed affinity were last allowed
+    // on; empty when no thread that ran during the benchmark was pinned
+    std::vector<int> pinnedCpus() const;
+};
+
+#endif
@@ -90,6 +90,32 @@ public:
     }
 };
 
+// Fixed-size reservoir so long runs keep a bounded, unbiased latency sample
+struct SampleReservoir {
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+    std::vector<double> samples;
+    size_t capacity { DEFAULT_CAPACITY };
+    uint64_t seen { 0 };
+    uint64_t rng { 0x9E3779B97F4A7C15ULL };
+
+    void add(double value)
+    {
+        ++seen;
+        if (samples.size() < capacity) {
+            samples.push_back(value);
+            return;
+        }
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        uint64_t slot = rng % seen;
+        if (slot < capacity) {
+            samples[slot] = value;
+        }
+    }
+};
+
 inline std::string getSystemInfo()
 {
     std::string info;
@@ -261,6 +287,7 @@ private:
         attr.exclude_kernel = 1;
         attr.exclude_hv = 1;
         attr.exclude_idle = 0;
+        attr.inherit = 1; // count worker threads spawned by the benchmark
         attr.read_format = 0;
 
         int fd = static_cast<int>(sys_perf_event_open(&attr, 0, -1, -1, 0));
@@ -0,0 +1,172 @@
+#include "vmstat.h"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+using VmstatField = uint64_t VmstatCounters::*;
+
+const VmstatField ALL_FIELDS[] = {
+    &VmstatCounters::pgfault, &VmstatCounters::pgmajfault, &VmstatCounters::pgpgin, &VmstatCounters::pgpgout,
+    &VmstatCounters::pswpin, &VmstatCounters::pswpout, &VmstatCounters::pgscan_kswapd,
+    &VmstatCounters::pgscan_direct, &VmstatCounters::pgsteal_kswapd, &VmstatCounters::pgsteal_direct,
+    &VmstatCounters::allocstall, &VmstatCounters::workingset_refault, &VmstatCounters::compact_stall,
+    &VmstatCounters::compact_fail, &VmstatCounters::compact_success, &VmstatCounters::thp_fault_alloc,
+    &VmstatCounters::thp_fault_fallback, &VmstatCounters::thp_collapse_alloc, &VmstatCounters::numa_hit,
+    &VmstatCounters::numa_miss, &VmstatCounters::numa_foreign, &VmstatCounters::numa_local,
+    &VmstatCounters::numa_other,
+};
+
+// Prefix rules sum a counter's per-zone or per-type variants
+struct VmstatRule {
+    const char* name;
+    bool prefix;
+    VmstatField field;
+};
+
+const VmstatRule RULES[] = {
+    { "pgfault", false, &VmstatCounters::pgfault },
+    { "pgmajfault", false, &VmstatCounters::pgmajfault },
+    { "pgpgin", false, &VmstatCounters::pgpgin },
+    { "pgpgout", false, &VmstatCounters::pgpgout },
+    { "pswpin", false, &VmstatCounters::pswpin },
+    { "pswpout", false, &VmstatCounters::pswpout },
+    { "pgscan_direct_throttle", false, nullptr },
+    { "pgscan_kswapd", true, &VmstatCounters::pgscan_kswapd },
+    { "pgscan_direct", true, &VmstatCounters::pgscan_direct },
+    { "pgsteal_kswapd", true, &VmstatCounters::pgsteal_kswapd },
+    { "pgsteal_direct", true, &VmstatCounters::pgsteal_direct },
+    { "allocstall", true, &VmstatCounters::allocstall },
+    { "workingset_refault", true, &VmstatCounters::workingset_refault },
+    { "compact_stall", false, &VmstatCounters::compact_stall },
+    { "compact_fail", false, &VmstatCounters::compact_fail },
+    { "compact_success", false, &VmstatCounters::compact_success },
+    { "thp_fault_alloc", false, &VmstatCounters::thp_fault_alloc },
+    { "thp_fault_fallback", false, &VmstatCounters::thp_fault_fallback },
+    { "thp_collapse_alloc", false, &VmstatCounters::thp_collapse_alloc },
+    { "numa_hit", false, &VmstatCounters::numa_hit },
+    { "numa_miss", false, &VmstatCounters::numa_miss },
+    { "numa_foreign", false, &VmstatCounters::numa_foreign },
+    { "numa_local", false, &VmstatCounters::numa_local },
+    { "numa_other", false, &VmstatCounters::numa_other },
+};
+
+const VmstatRule* findRule(const char* name, size_t length)
+{
+    for (const auto& rule : RULES) {
+        size_t rule_length = strlen(rule.name);
+        if (rule.prefix ? length >= rule_length && memcmp(name, rule.name, rule_length) == 0
+                        : tokenEquals(name, length, rule.name)) {
+            return &rule;
+        }
+    }
+    return nullptr;
+}
+
+}
+
+VmstatCounters VmstatCounters::capture()
+{
+    VmstatCounters counters;
+#ifdef __linux__
+    ProcFile file("/proc/vmstat", 16384);
+    if (file.read()) {
+        counters.parse(file);
+    }
+#endif
+    return counters;
+}
+
+bool VmstatCounters::parse(const ProcFile& file)
+{
+    *this = VmstatCounters();
+    ProcScanner scan(file);
+    for (; !scan.atEnd(); scan.skipLine()) {
+        const char* name = nullptr;
+        size_t length = 0;
+        uint64_t value = 0;
+        if (!scan.nextToken(name, length) || !scan.nextUint(value)) {
+            continue;
+        }
+        const VmstatRule* rule = findRule(name, length);
+        if (rule != nullptr && rule->field != nullptr) {
+            this->*(rule->field) += value;
+        }
+        valid = true;
+    }
+    return valid;
+}
+
+VmstatCounters VmstatCounters::delta(const VmstatCounters& earlier) const
+{
+    VmstatCounters result;
+    result.valid = valid && earlier.valid;
+    if (!result.valid) {
+        return result;
+    }
+    for (VmstatField field : ALL_FIELDS) {
+        result.*field = this->*field > earlier.*field ? this->*field - earlier.*field : 0;
+    }
+    return result;
+}
+
+void VmstatCounters::add(const VmstatCounters& other)
+{
+    valid |= other.valid;
+    for (VmstatField field : ALL_FIELDS) {
+        this->*field += other.*field;
+    }
+}
+
+void VmstatCounters::takeMax(const VmstatCounters& other)
+{
+    valid |= other.valid;
+    for (VmstatField field : ALL_FIELDS) {
+        this->*field = std::max(this->*field, other.*field);
+    }
+}
+
+void applyVmstatDelta(BenchmarkResult& result, const VmstatCounters& start, const VmstatCounters& end)
+{
+    VmstatCounters events = end.delta(start);
+    if (!events.valid) {
+        return;
+    }
+
+    // System-wide: other processes' faults and reclaim are included
+    result.extra_metrics["vm_page_faults"] = static_cast<double>(events.pgfault);
+    result.extra_metrics["vm_major_faults"] = static_cast<double>(events.pgmajfault);
+    result.extra_metrics["vm_swap_in_pages"] = static_cast<double>(events.pswpin);
+    result.extra_metrics["vm_swap_out_pages"] = static_cast<double>(events.pswpout);
+    result.extra_metrics["vm_kswapd_scanned_pages"] = static_cast<double>(events.pgscan_kswapd);
+    result.extra_metrics["vm_kswapd_reclaimed_pages"] = static_cast<double>(events.pgsteal_kswapd);
+    result.extra_metrics["vm_direct_scanned_pages"] = static_cast<double>(events.pgscan_direct);
+    result.extra_metrics["vm_direct_reclaimed_pages"] = static_cast<double>(events.pgsteal_direct);
+    result.extra_metrics["vm_direct_reclaim_stalls"] = static_cast<double>(events.allocstall);
+    result.extra_metrics["vm_workingset_refaults"] = static_cast<double>(events.workingset_refault);
+    result.extra_metrics["vm_compact_stalls"] = static_cast<double>(events.compact_stall);
+    result.extra_metrics["vm_compact_failures"] = static_cast<double>(events.compact_fail);
+    result.extra_metrics["vm_thp_fault_alloc"] = static_cast<double>(events.thp_fault_alloc);
+    result.extra_metrics["vm_thp_fault_fallback"] = static_cast<double>(events.thp_fault_fallback);
+    result.extra_metrics["vm_thp_collapse_alloc"] = static_cast<double>(events.thp_collapse_alloc);
+    if (events.thp_fault_alloc + events.thp_fault_fallback > 0) {
+        result.extra_metrics["vm_thp_fallback_percent"] =
+            100.0 * events.thp_fault_fallback / (events.thp_fault_alloc + events.thp_fault_fallback);
+    }
+    result.extra_metrics["vm_numa_hit"] = static_cast<double>(events.numa_hit);
+    result.extra_metrics["vm_numa_miss"] = static_cast<double>(events.numa_miss);
+    if (events.numa_hit + events.numa_miss > 0) {
+        result.extra_metrics["vm_numa_miss_percent"] = 100.0 * events.numa_miss / (events.numa_hit + events.numa_miss);
+    }
+
+    std::ostringstream stalls;
+    if (events.allocstall > 0) {
+        stalls << "direct reclaim: " << events.allocstall << " stalls, " << events.pgscan_direct << " pages scanned";
+    }
+    if (events.compact_stall > 0) {
+        stalls << (events.allocstall > 0 ? "; " : "") << "compaction: " << events.compact_stall << " stalls ("
+               << events.compact_fail << " failed)";
+    }
+    std::string summary = stalls.str();
+    result.extra_info["vm.stalls"] = summary.empty() ? "none" : summary;
+}
@@ -0,0 +1,51 @@
+#ifndef VMSTAT_H
+#define VMSTAT_H
+
+#include "benchmark.h"
+#include "proc_reader.h"
+#include <cstdint>
+
+// Selected /proc/vmstat event counters: cumulative since boot after capture()
+// or parse(), events in an interval after delta(). Per-zone and per-type
+// variants of a counter (pgscan_kswapd_normal, allocstall_movable, ...) are
+// summed so old and new kernels report the same totals.
+struct VmstatCounters {
+    bool valid { false };
+    uint64_t pgfault { 0 };
+    uint64_t pgmajfault { 0 };
+    uint64_t pgpgin { 0 }; // KB read from block devices
+    uint64_t pgpgout { 0 };
+    uint64_t pswpin { 0 };
+    uint64_t pswpout { 0 };
+    uint64_t pgscan_kswapd { 0 };
+    uint64_t pgscan_direct { 0 };
+    uint64_t pgsteal_kswapd { 0 };
+    uint64_t pgsteal_direct { 0 };
+    uint64_t allocstall { 0 }; // allocations that entered direct reclaim
+    uint64_t workingset_refault { 0 };
+    uint64_t compact_stall { 0 };
+    uint64_t compact_fail { 0 };
+    uint64_t compact_success { 0 };
+    uint64_t thp_fault_alloc { 0 };
+    uint64_t thp_fault_fallback { 0 };
+    uint64_t thp_collapse_alloc { 0 };
+    uint64_t numa_hit { 0 };
+    uint64_t numa_miss { 0 };
+    uint64_t numa_foreign { 0 };
+    uint64_t numa_local { 0 };
+    uint64_t numa_other { 0 };
+
+    static VmstatCounters capture();
+    // Replaces the counters with the contents of an already read /proc/vmstat
+    bool parse(const ProcFile& file);
+
+    VmstatCounters delta(const VmstatCounters& earlier) const;
+    void add(const VmstatCounters& other);
+    void takeMax(const VmstatCounters& other);
+};
+
+// Adds vm_* event counts between two captures to the result, and a vm.stalls
+// summary when allocations stalled in direct reclaim or compaction
+void applyVmstatDelta(BenchmarkResult& result, const VmstatCounters& start, const VmstatCounters& end);
+
+#endif
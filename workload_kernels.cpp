@@ -0,0 +1,140 @@
+#include "workload_kernels.h"
+#include <cmath>
+#include <random>
+
+namespace {
+
+constexpr size_t KERNEL_INPUT_SIZE = 4096;
+constexpr size_t MATRIX_DIM = 16;
+
+double floatingPointKernel(const std::vector<double>& values, size_t work_units)
+{
+    double result = 0.0;
+    size_t mask = values.size() - 1;
+    for (size_t i = 0; i < work_units; ++i) {
+        double a = values[i & mask];
+        double b = values[(i + 1) & mask];
+        result += std::sin(a) * std::cos(b);
+        result += std::sqrt(a * b);
+    }
+    return result;
+}
+
+double integerKernel(const std::vector<int>& values, size_t work_units)
+{
+    long long result = 0;
+    size_t mask = values.size() - 1;
+    for (size_t i = 0; i < work_units; ++i) {
+        int x = values[i & mask];
+        int y = values[(i + 1) & mask];
+        result += static_cast<long long>(x) * y;
+        result ^= static_cast<long long>(x) << 3;
+        result += x / (y | 1);
+    }
+    return static_cast<double>(result);
+}
+
+// FNV-1a over work_units bytes, wrapping around the input buffer
+double hashKernel(const std::vector<char>& bytes, size_t work_units)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    size_t mask = bytes.size() - 1;
+    for (size_t i = 0; i < work_units; ++i) {
+        hash ^= static_cast<unsigned char>(bytes[i & mask]);
+        hash *= 0x100000001B3ULL;
+    }
+    return static_cast<double>(hash & 0xFFFFFFFF);
+}
+
+// One work unit is one 16x16 row-times-matrix product
+double matrixKernel(KernelWorkspace& workspace, size_t work_units)
+{
+    const double* a = workspace.matrix_a.data();
+    const double* b = workspace.matrix_b.data();
+    double* c = workspace.matrix_c.data();
+    for (size_t unit = 0; unit < work_units; ++unit) {
+        size_t row = unit % MATRIX_DIM;
+        for (size_t j = 0; j < MATRIX_DIM; ++j) {
+            double sum = 0.0;
+            for (size_t k = 0; k < MATRIX_DIM; ++k) {
+                sum += a[row * MATRIX_DIM + k] * b[k * MATRIX_DIM + j];
+            }
+            c[row * MATRIX_DIM + j] = sum;
+        }
+    }
+    return c[0] + c[MATRIX_DIM * MATRIX_DIM - 1];
+}
+
+}
+
+KernelWorkspace::KernelWorkspace()
+    : doubles(KERNEL_INPUT_SIZE)
+    , integers(KERNEL_INPUT_SIZE)
+    , bytes(KERNEL_INPUT_SIZE)
+    , matrix_a(MATRIX_DIM * MATRIX_DIM)
+    , matrix_b(MATRIX_DIM * MATRIX_DIM)
+    , matrix_c(MATRIX_DIM * MATRIX_DIM)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> real_dis(0.1, 100.0);
+    std::uniform_int_distribution<> int_dis(1, 1000000);
+    for (auto& v : doubles) {
+        v = real_dis(gen);
+    }
+    for (auto& v : integers) {
+        v = int_dis(gen);
+    }
+    for (auto& v : bytes) {
+        v = static_cast<char>(gen() & 0xFF);
+    }
+    for (size_t i = 0; i < matrix_a.size(); ++i) {
+        matrix_a[i] = real_dis(gen);
+        matrix_b[i] = real_dis(gen);
+    }
+}
+
+bool parseWorkloadKernel(const std::string& name, WorkloadKernel& kernel)
+{
+    if (name == "fp" || name == "float") {
+        kernel = WorkloadKernel::FLOATING_POINT;
+    } else if (name == "int" || name == "integer") {
+        kernel = WorkloadKernel::INTEGER;
+    } else if (name == "hash") {
+        kernel = WorkloadKernel::HASH;
+    } else if (name == "matrix") {
+        kernel = WorkloadKernel::MATRIX;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* workloadKernelName(WorkloadKernel kernel)
+{
+    switch (kernel) {
+    case WorkloadKernel::FLOATING_POINT:
+        return "fp";
+    case WorkloadKernel::INTEGER:
+        return "int";
+    case WorkloadKernel::HASH:
+        return "hash";
+    case WorkloadKernel::MATRIX:
+        return "matrix";
+    }
+    return "unknown";
+}
+
+double runWorkloadKernel(WorkloadKernel kernel, KernelWorkspace& workspace, size_t work_units)
+{
+    switch (kernel) {
+    case WorkloadKernel::FLOATING_POINT:
+        return floatingPointKernel(workspace.doubles, work_units);
+    case WorkloadKernel::INTEGER:
+        return integerKernel(workspace.integers, work_units);
+    case WorkloadKernel::HASH:
+        return hashKernel(workspace.bytes, work_units);
+    case WorkloadKernel::MATRIX:
+        return matrixKernel(workspace, work_units);
+    }
+    return 0.0;
+}
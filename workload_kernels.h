@@ -0,0 +1,35 @@
+#ifndef WORKLOAD_KERNELS_H
+#define WORKLOAD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Small CPU kernels that macro workloads use as per-request work. Each call
+// performs a fixed amount of work proportional to work_units.
+enum class WorkloadKernel {
+    FLOATING_POINT,
+    INTEGER,
+    HASH,
+    MATRIX
+};
+
+struct KernelWorkspace {
+    std::vector<double> doubles;
+    std::vector<int> integers;
+    std::vector<char> bytes;
+    std::vector<double> matrix_a;
+    std::vector<double> matrix_b;
+    std::vector<double> matrix_c;
+
+    KernelWorkspace();
+};
+
+bool parseWorkloadKernel(const std::string& name, WorkloadKernel& kernel);
+const char* workloadKernelName(WorkloadKernel kernel);
+
+// Returns a value derived from the computation so callers can keep it live
+double runWorkloadKernel(WorkloadKernel kernel, KernelWorkspace& workspace, size_t work_units);
+
+#endif